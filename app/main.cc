@@ -18,9 +18,36 @@
 */
 
 #include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <exception>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 #include <world_builder/assert.h>
 #include <world_builder/utilities.h>
@@ -30,17 +57,964 @@
 
 using namespace WorldBuilder::Utilities;
 
+
+/**
+ * A pipeline which streams the items of a data file, such as its lines or
+ * the indices of its points, through a number of threads. One thread reads
+ * the items in chunks, the worker threads evaluate the chunks into their
+ * output, and the calling thread writes the output of the chunks in the
+ * order in which they have been read. Only a limited number of chunks is
+ * kept in memory at the same time, so the memory use does not depend on the
+ * size of the data file.
+ */
+template<typename Item>
+class DataPipeline
+{
+  public:
+    /**
+     * A function which reads the next item and returns false at the end of
+     * the input.
+     */
+    typedef std::function<bool(Item &item)> ItemReader;
+
+    /**
+     * A function which evaluates a chunk of items and writes the result to
+     * the output. The number of the first item in the chunk is passed for
+     * the error messages. The items may also be changed to hold results,
+     * which the writer receives with the chunk.
+     */
+    typedef std::function<void(std::vector<Item> &items, const size_t first_item_number, std::ostream &output)> ChunkEvaluator;
+
+    /**
+     * A function which writes the output of an evaluated chunk of items.
+     */
+    typedef std::function<void(const std::vector<Item> &items, const std::string &output)> ChunkWriter;
+
+    /**
+     * Constructor
+     */
+    DataPipeline(const size_t number_of_threads_, const size_t items_per_chunk_, const size_t max_chunks_)
+      :
+      number_of_threads(std::max(number_of_threads_, static_cast<size_t>(1))),
+      items_per_chunk(std::max(items_per_chunk_, static_cast<size_t>(1))),
+      max_chunks(std::max(max_chunks_, number_of_threads + 1))
+    {}
+
+    /**
+     * Reads all the items, evaluates them and writes the results to the
+     * output. When the evaluation of a chunk throws an exception, the
+     * output of the chunks before it and the output which the chunk wrote
+     * before the exception are written, and the exception is rethrown.
+     */
+    void run(const ItemReader &read_item, const size_t first_item_number, const ChunkEvaluator &evaluate, std::ostream &output)
+    {
+      run(read_item, first_item_number, evaluate, [&output](const std::vector<Item> &, const std::string &chunk_output)
+      {
+        output << chunk_output;
+      });
+      output.flush();
+    }
+
+    /**
+     * Same as above, but the output of every chunk is passed to a function,
+     * so that the chunks can be written to different outputs. The chunks are
+     * still passed in the order in which they have been read.
+     */
+    void run(const ItemReader &read_item, const size_t first_item_number, const ChunkEvaluator &evaluate, const ChunkWriter &write)
+    {
+      /**
+       * The items of a chunk, and the output of the items once they have
+       * been evaluated.
+       */
+      struct Chunk
+      {
+        size_t first_item_number;
+        std::vector<Item> items;
+        std::string output;
+        std::exception_ptr error;
+        bool evaluated;
+      };
+
+      std::mutex mutex;
+      std::condition_variable condition;
+
+      // The chunks which have been read, but not been written yet, in the
+      // order in which they have been read.
+      std::deque<std::unique_ptr<Chunk> > chunks;
+      size_t n_read = 0;
+      size_t n_taken = 0;
+      size_t n_written = 0;
+      bool done_reading = false;
+      bool failed = false;
+
+      std::thread reader([&]()
+      {
+        size_t item_number = first_item_number;
+        bool more_items = true;
+        while (more_items)
+          {
+            std::unique_ptr<Chunk> chunk(new Chunk());
+            chunk->first_item_number = item_number;
+            chunk->evaluated = false;
+            chunk->items.reserve(items_per_chunk);
+            Item item;
+            while (chunk->items.size() < items_per_chunk && (more_items = read_item(item)))
+              chunk->items.push_back(item);
+            item_number += chunk->items.size();
+
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]() {return chunks.size() < max_chunks || failed;});
+            if (failed)
+              return;
+            if (chunk->items.size() > 0)
+              {
+                chunks.push_back(std::move(chunk));
+                ++n_read;
+              }
+            condition.notify_all();
+          }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        done_reading = true;
+        condition.notify_all();
+      });
+
+      std::vector<std::thread> workers(number_of_threads);
+      for (std::thread &worker : workers)
+        worker = std::thread([&]()
+        {
+          while (true)
+            {
+              Chunk *chunk = nullptr;
+              {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() {return n_taken < n_read || done_reading || failed;});
+                if (failed || n_taken == n_read)
+                  return;
+                chunk = chunks[n_taken - n_written].get();
+                ++n_taken;
+              }
+
+              std::ostringstream stream;
+              try
+                {
+                  evaluate(chunk->items, chunk->first_item_number, stream);
+                }
+              catch (...)
+                {
+                  chunk->error = std::current_exception();
+                }
+              chunk->output = stream.str();
+
+              std::lock_guard<std::mutex> lock(mutex);
+              chunk->evaluated = true;
+              condition.notify_all();
+            }
+        });
+
+      std::exception_ptr error;
+      while (!error)
+        {
+          std::unique_ptr<Chunk> chunk;
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]() {return (chunks.size() > 0 && chunks.front()->evaluated) || (done_reading && chunks.size() == 0);});
+            if (chunks.size() == 0)
+              break;
+            chunk = std::move(chunks.front());
+            chunks.pop_front();
+            ++n_written;
+            if (chunk->error)
+              failed = true;
+            condition.notify_all();
+          }
+
+          write(chunk->items, chunk->output);
+          error = chunk->error;
+        }
+
+      reader.join();
+      for (std::thread &worker : workers)
+        worker.join();
+
+      if (error)
+        std::rethrow_exception(error);
+    }
+
+  private:
+    size_t number_of_threads;
+    size_t items_per_chunk;
+    size_t max_chunks;
+};
+
+
+/**
+ * A file which is mapped into memory for reading. When the file can not be
+ * mapped, for example on Windows or when it is empty, it is read into memory
+ * instead.
+ */
+class MappedFile
+{
+  public:
+    /**
+     * Constructor
+     */
+    explicit MappedFile(const std::string &filename)
+      :
+      data(nullptr),
+      size(0),
+      mapping(nullptr)
+    {
+#ifndef _WIN32
+      const int file = open(filename.c_str(), O_RDONLY);
+      WBAssertThrow(file >= 0, "Could not open the data file " << filename << ".");
+      struct stat file_status;
+      if (fstat(file, &file_status) == 0 && S_ISREG(file_status.st_mode) && file_status.st_size > 0)
+        {
+          size = static_cast<size_t>(file_status.st_size);
+          mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+          if (mapping == MAP_FAILED)
+            mapping = nullptr;
+        }
+      close(file);
+#endif
+      if (mapping == nullptr)
+        {
+          std::ifstream file_stream(filename.c_str(), std::ios::binary);
+          WBAssertThrow(file_stream.good(), "Could not open the data file " << filename << ".");
+          copy.assign(std::istreambuf_iterator<char>(file_stream), std::istreambuf_iterator<char>());
+          size = copy.size();
+          data = copy.data();
+        }
+      else
+        data = static_cast<const char *>(mapping);
+    }
+
+    /**
+     * Destructor
+     */
+    ~MappedFile()
+    {
+#ifndef _WIN32
+      if (mapping != nullptr)
+        munmap(mapping, size);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * The contents of the file.
+     */
+    const char *data;
+    size_t size;
+
+  private:
+    void *mapping;
+    std::vector<char> copy;
+};
+
+
+/**
+ * Evaluates the points of the data file and writes the input columns of a
+ * point, followed by the temperature, the compositions and the grains, in
+ * the output format. The evaluator does not change after construction, so
+ * it can be used by multiple threads at the same time.
+ */
+class PointEvaluator
+{
+  public:
+    /**
+     * Constructor
+     */
+    PointEvaluator(const WorldBuilder::World &world_,
+                   const DataFormat output_format_,
+                   const unsigned int dim_,
+                   const unsigned int compositions,
+                   const unsigned int grain_compositions,
+                   const size_t number_of_grains_)
+      :
+      world(world_),
+      output_format(output_format_),
+      dim(dim_),
+      composition_numbers(compositions),
+      grains_composition_numbers(grain_compositions),
+      number_of_grains(number_of_grains_)
+    {
+      // All the properties of a point are computed in one go.
+      for (unsigned int c = 0; c < compositions; ++c)
+        composition_numbers[c] = c;
+
+      for (unsigned int gc = 0; gc < grain_compositions; ++gc)
+        grains_composition_numbers[gc] = gc;
+    }
+
+    /**
+     * Returns the number of columns of a point in the output.
+     */
+    size_t n_output_columns() const
+    {
+      return dim + 3 + composition_numbers.size() + grains_composition_numbers.size() * number_of_grains * 10;
+    }
+
+    /**
+     * Evaluates the point, which are the coordinates, the depth and the
+     * gravity, and writes it to the output. When the point has been read
+     * from a text file, the text of its dim + 2 columns, each followed by a
+     * space, is passed as well, so the text output can repeat the input
+     * exactly.
+     */
+    void evaluate(const double *point,
+                  const char *point_text,
+                  const size_t point_text_length,
+                  std::ostream &output,
+                  WorldBuilder::properties &properties) const
+    {
+      if (dim == 2)
+        {
+          const std::array<double,2> coords = {{point[0], point[1]}};
+          world.properties(coords, point[2], point[3], composition_numbers, grains_composition_numbers, number_of_grains, properties);
+        }
+      else
+        {
+          const std::array<double,3> coords = {{point[0], point[1], point[2]}};
+          world.properties(coords, point[3], point[4], composition_numbers, grains_composition_numbers, number_of_grains, properties);
+        }
+
+      if (output_format == DataFormat::text && point_text != nullptr)
+        output.write(point_text, static_cast<std::streamsize>(point_text_length));
+      else
+        for (unsigned int i = 0; i < dim + 2; ++i)
+          write_value(output, point[i]);
+
+      write_value(output, properties.temperature);
+
+      for (unsigned int c = 0; c < composition_numbers.size(); ++c)
+        write_value(output, properties.compositions[c]);
+
+      for (unsigned int gc = 0; gc < grains_composition_numbers.size(); ++gc)
+        {
+          const WorldBuilder::grains &grains = properties.grains[gc];
+          for (unsigned int g = 0; g < number_of_grains; ++g)
+            {
+              write_value(output, grains.sizes[g]);
+              for (unsigned int r = 0; r < 3; ++r)
+                for (unsigned int c = 0; c < 3; ++c)
+                  write_value(output, grains.rotation_matrices[g][r][c]);
+            }
+        }
+
+      if (output_format == DataFormat::text)
+        output << "\n";
+    }
+
+  private:
+    /**
+     * Writes a single value as text followed by a space, or as a little
+     * endian double.
+     */
+    void write_value(std::ostream &output, const double value) const
+    {
+      if (output_format == DataFormat::text)
+        output << value << " ";
+      else
+        output.write(reinterpret_cast<const char *>(&value), sizeof(double));
+    }
+
+    const WorldBuilder::World &world;
+    const DataFormat output_format;
+    const unsigned int dim;
+    std::vector<unsigned int> composition_numbers;
+    std::vector<unsigned int> grains_composition_numbers;
+    const size_t number_of_grains;
+};
+
+
 bool find_command_line_option(char **begin, char **end, const std::string &option)
 {
   return std::find(begin, end, option) != end;
 }
 
+
+std::vector<std::string> split_data_line(const std::string &line)
+{
+  std::istringstream buffer(line);
+  std::vector<std::string> entries((std::istream_iterator<std::string>(buffer)),
+                                   std::istream_iterator<std::string>());
+
+  // remove the comma's in case it is a comma separated file.
+  // TODO: make it split for comma's and/or spaces
+  for (unsigned int i = 0; i < entries.size(); ++i)
+    entries[i].erase(std::remove(entries[i].begin(), entries[i].end(), ','), entries[i].end());
+
+  return entries;
+}
+
+
+bool read_configuration_line(const std::vector<std::string> &line,
+                             unsigned int &dim,
+                             unsigned int &compositions,
+                             unsigned int &grain_compositions,
+                             size_t &number_of_grains)
+{
+  if (line.size() >= 4 && line[0] == "#" && line[1] == "dim" && line[2] == "=")
+    dim = string_to_unsigned_int(line[3]);
+  else if (line.size() >= 4 && line[0] == "#" && line[1] == "compositions" && line[2] == "=")
+    compositions = string_to_unsigned_int(line[3]);
+  else if (line.size() >= 5 && line[0] == "#" && line[1] == "grain" && line[2] == "compositions" && line[3] == "=")
+    grain_compositions = string_to_unsigned_int(line[4]);
+  else if (line.size() >= 6 && line[0] == "#" && line[1] == "number" && line[2] == "of" && line[3] == "grains" && line[4] == "=")
+    number_of_grains = string_to_unsigned_int(line[5]);
+  else
+    return false;
+
+  return true;
+}
+
+
+bool read_point_line(const std::vector<std::string> &line,
+                     const size_t line_number,
+                     const unsigned int dim,
+                     double *point)
+{
+  if (line.size() == 0)
+    return false;
+
+  if (line[0] == "#")
+    {
+      // The options have already been read, so only their values are needed
+      // to check that this is not an option.
+      unsigned int other_dim = dim;
+      unsigned int compositions = 0;
+      unsigned int grain_compositions = 0;
+      size_t number_of_grains = 0;
+      WBAssertThrow(!read_configuration_line(line, other_dim, compositions, grain_compositions, number_of_grains),
+                    "The option on line " << line_number << " of the data file has to be given before the first point.");
+      return false;
+    }
+
+  WBAssertThrow(line.size() == dim + 2, "The file needs to contain dim + 2 entries, but contains " << line.size() << " entries "
+                " on line " << line_number << " of the data file. Dim is " << dim << ".");
+  for (unsigned int j = 0; j < dim + 2; ++j)
+    point[j] = string_to_double(line[j]);
+
+  return true;
+}
+
+
+void write_header(std::ostream &output,
+                  const unsigned int dim,
+                  const unsigned int compositions,
+                  const unsigned int grain_compositions,
+                  const size_t number_of_grains)
+{
+  output << (dim == 2 ? "# x z d g T " : "# x y z d g T ");
+
+  for (unsigned int c = 0; c < compositions; ++c)
+    output << "c" << c << " ";
+
+  for (unsigned int gc = 0; gc < grain_compositions; ++gc)
+    for (size_t g = 0; g < number_of_grains; g++)
+      output << "gs" << gc << "-" << g << " " // gs = grain size, gm = grain rotation matrix
+             << "gm" << gc << "-" << g << "[0:0] " << "gm" << gc << "-" << g << "[0:1] " << "gm" << gc << "-" << g << "[0:2] "
+             << "gm" << gc << "-" << g << "[1:0] " << "gm" << gc << "-" << g << "[1:1] " << "gm" << gc << "-" << g << "[1:2] "
+             << "gm" << gc << "-" << g << "[2:0] " << "gm" << gc << "-" << g << "[2:1] " << "gm" << gc << "-" << g << "[2:2] ";
+
+  output << "\n";
+}
+
+
+DataFormat string_to_data_format(const std::string &format)
+{
+  if (format == "text")
+    return DataFormat::text;
+  if (format == "binary")
+    return DataFormat::binary;
+  WBAssertThrow(format == "npy", "The data format " << format << " is not known. The formats are text, binary and npy.");
+  return DataFormat::npy;
+}
+
+
+bool is_little_endian()
+{
+  const std::uint16_t one = 1;
+  unsigned char first_byte = 0;
+  std::memcpy(&first_byte, &one, 1);
+  return first_byte == 1;
+}
+
+
+void write_npy_header(std::ostream &output, const size_t n_rows, const size_t n_columns, const size_t min_size)
+{
+  std::string header = "{'descr': '<f8', 'fortran_order': False, 'shape': ("
+                       + std::to_string(n_rows) + ", " + std::to_string(n_columns) + "), }";
+
+  // The magic string, the version, the length of the header and the header
+  // with its closing newline are padded to a multiple of 64 bytes, so the
+  // data is aligned. It is padded to at least min_size bytes, so a header
+  // which has been written before the number of rows was known can be
+  // replaced in place.
+  const size_t size = 10 + header.size() + 1;
+  header.append(std::max((size + 63) / 64 * 64, min_size) - size, ' ');
+  header += '\n';
+
+  const char magic[8] = {'\x93', 'N', 'U', 'M', 'P', 'Y', '\x01', '\x00'};
+  const char header_length[2] = {static_cast<char>(header.size() & 0xff), static_cast<char>(header.size() >> 8)};
+  output.write(magic, 8);
+  output.write(header_length, 2);
+  output << header;
+}
+
+
+size_t read_npy_header(const char *data, const size_t size, size_t &n_rows, size_t &n_columns)
+{
+  WBAssertThrow(size >= 10 && std::memcmp(data, "\x93NUMPY", 6) == 0, "The data file is not an npy file.");
+
+  const unsigned char major_version = static_cast<unsigned char>(data[6]);
+  const unsigned char *length_bytes = reinterpret_cast<const unsigned char *>(data + 8);
+  size_t header_offset = 10;
+  size_t header_length = length_bytes[0] | static_cast<size_t>(length_bytes[1]) << 8;
+  if (major_version >= 2)
+    {
+      WBAssertThrow(size >= 12, "The header of the npy data file is truncated.");
+      header_offset = 12;
+      header_length |= static_cast<size_t>(length_bytes[2]) << 16 | static_cast<size_t>(length_bytes[3]) << 24;
+    }
+  WBAssertThrow(header_offset + header_length <= size, "The header of the npy data file is truncated.");
+
+  // Remove the white space, so the entries can be found independent of the
+  // formatting of the header.
+  std::string header(data + header_offset, header_length);
+  header.erase(std::remove_if(header.begin(), header.end(), [](char c)
+  {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+  }), header.end());
+
+  WBAssertThrow(header.find("'descr':'<f8'") != std::string::npos,
+                "The npy data file needs to contain little endian doubles (<f8), but the header is " << header << ".");
+  WBAssertThrow(header.find("'fortran_order':False") != std::string::npos,
+                "The npy data file needs to be stored in C order, but the header is " << header << ".");
+
+  const size_t shape = header.find("'shape':(");
+  WBAssertThrow(shape != std::string::npos, "The npy data file has no shape, the header is " << header << ".");
+  const char *shape_begin = header.c_str() + shape + 9;
+  char *shape_end = nullptr;
+  // strtoul accepts a sign, so a negative shape would wrap around.
+  WBAssertThrow(std::isdigit(static_cast<unsigned char>(*shape_begin)) != 0,
+                "The npy data file needs to contain a two dimensional array, but the header is " << header << ".");
+  n_rows = std::strtoul(shape_begin, &shape_end, 10);
+  WBAssertThrow(shape_end != shape_begin && *shape_end == ',', "The npy data file needs to contain a two dimensional array, but the header is " << header << ".");
+  shape_begin = shape_end + 1;
+  WBAssertThrow(std::isdigit(static_cast<unsigned char>(*shape_begin)) != 0,
+                "The npy data file needs to contain a two dimensional array, but the header is " << header << ".");
+  n_columns = std::strtoul(shape_begin, &shape_end, 10);
+  WBAssertThrow(shape_end != shape_begin && (*shape_end == ')' || (shape_end[0] == ',' && shape_end[1] == ')')),
+                "The npy data file needs to contain a two dimensional array, but the header is " << header << ".");
+
+  // The size of the data is not computed, because a large shape would make
+  // it overflow.
+  WBAssertThrow(n_columns > 0, "The npy data file needs to contain at least one column, but the header is " << header << ".");
+  WBAssertThrow(n_rows <= (size - header_offset - header_length) / sizeof(double) / n_columns, "The npy data file is truncated.");
+  return header_offset + header_length;
+}
+
+
+size_t count_text_points(const std::string &data_file)
+{
+  std::ifstream data_stream(data_file);
+  size_t n_points = 0;
+  std::string text;
+  while (std::getline(data_stream, text))
+    {
+      const std::vector<std::string> line = split_data_line(text);
+      if (line.size() > 0 && line[0] != "#")
+        ++n_points;
+    }
+  return n_points;
+}
+
+
+size_t read_bytes(const int file, char *data, const size_t size)
+{
+  size_t n_read = 0;
+  while (n_read < size)
+    {
+#ifdef _WIN32
+      const int result = _read(file, data + n_read, static_cast<unsigned int>(std::min(size - n_read, static_cast<size_t>(1) << 30)));
+#else
+      const ssize_t result = read(file, data + n_read, size - n_read);
+#endif
+      if (result <= 0)
+        break;
+      n_read += static_cast<size_t>(result);
+    }
+  return n_read;
+}
+
+
+void write_bytes(const int file, const char *data, const size_t size)
+{
+  size_t n_written = 0;
+  while (n_written < size)
+    {
+#ifdef _WIN32
+      const int result = _write(file, data + n_written, static_cast<unsigned int>(std::min(size - n_written, static_cast<size_t>(1) << 30)));
+#else
+      const ssize_t result = write(file, data + n_written, size - n_written);
+#endif
+      WBAssertThrow(result > 0, "Could not write the response of the server.");
+      n_written += static_cast<size_t>(result);
+    }
+}
+
+
+/**
+ * A counter of a limited number of units, such as the threads which
+ * evaluate the requests of the server, or the connections which it serves
+ * at the same time.
+ */
+class CountingSemaphore
+{
+  public:
+    /**
+     * Units which are taken from the semaphore on construction, and given
+     * back on destruction.
+     */
+    class Units
+    {
+      public:
+        /**
+         * Constructor, which waits until at least one unit is available and
+         * takes up to max_units of the available units.
+         */
+        Units(CountingSemaphore &semaphore_, const size_t max_units)
+          :
+          semaphore(semaphore_),
+          n_units(semaphore.acquire(max_units))
+        {}
+
+        ~Units()
+        {
+          semaphore.release(n_units);
+        }
+
+        /**
+         * Returns the number of units which have been taken.
+         */
+        size_t size() const
+        {
+          return n_units;
+        }
+
+      private:
+        CountingSemaphore &semaphore;
+        const size_t n_units;
+    };
+
+    /**
+     * Constructor
+     */
+    explicit CountingSemaphore(const size_t n_units)
+      :
+      n_available(std::max(n_units, static_cast<size_t>(1)))
+    {}
+
+    /**
+     * Waits until at least one unit is available, and takes up to max_units
+     * of the available units. Returns the number of units which have been
+     * taken.
+     */
+    size_t acquire(const size_t max_units)
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      available.wait(lock, [this]()
+      {
+        return n_available > 0;
+      });
+      const size_t n_units = std::min(std::max(max_units, static_cast<size_t>(1)), n_available);
+      n_available -= n_units;
+      return n_units;
+    }
+
+    /**
+     * Gives back units which have been taken by acquire.
+     */
+    void release(const size_t n_units)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        n_available += n_units;
+      }
+      available.notify_all();
+    }
+
+  private:
+    std::mutex mutex;
+    std::condition_variable available;
+    size_t n_available;
+};
+
+
+/**
+ * The largest number of compositions, grain compositions or grains, and the
+ * largest number of output columns, which the server accepts in a request.
+ * Every point of a request is written as this many doubles, so the output
+ * of a request is limited to a fixed multiple of its input.
+ */
+const std::uint64_t max_request_columns = 65536;
+
+
+/**
+ * The largest size in bytes of the points of a request, which the server
+ * keeps in memory while it evaluates them. The output is written to the
+ * connection in chunks of at most about max_chunk_bytes bytes.
+ */
+const std::uint64_t max_request_bytes = static_cast<std::uint64_t>(64) << 20;
+const std::uint64_t max_chunk_bytes = static_cast<std::uint64_t>(1) << 20;
+
+
+/**
+ * The number of connections which the server serves at the same time. Other
+ * clients wait until a connection is closed.
+ */
+const size_t max_connections = 64;
+
+
+void serve_requests(const int input,
+                    const int output,
+                    const WorldBuilder::World &world,
+                    const size_t number_of_threads,
+                    CountingSemaphore &evaluation_threads)
+{
+  // The request header contains the dimension, the number of compositions,
+  // the number of grain compositions and the number of grains as 32 bit
+  // unsigned integers, and the number of points as a 64 bit unsigned
+  // integer. The points follow as dim + 2 doubles each.
+  char request_header[24];
+  size_t n_header_bytes = 0;
+  while ((n_header_bytes = read_bytes(input, request_header, sizeof(request_header))) == sizeof(request_header))
+    {
+      std::uint32_t options[4];
+      std::uint64_t n_points = 0;
+      std::memcpy(options, request_header, sizeof(options));
+      std::memcpy(&n_points, request_header + sizeof(options), sizeof(n_points));
+      const unsigned int dim = options[0];
+
+      // A request which can not be answered gets the status 1, followed by
+      // the length of the message and the message.
+      const auto write_error = [output](const std::string &message)
+      {
+        const std::uint32_t status = 1;
+        const std::uint64_t message_length = message.size();
+        std::string response(reinterpret_cast<const char *>(&status), sizeof(status));
+        response.append(reinterpret_cast<const char *>(&message_length), sizeof(message_length));
+        response += message;
+        write_bytes(output, response.data(), response.size());
+      };
+
+      // The rest of a request can not be found when its dimension is not
+      // valid, so the connection is closed after the error.
+      if ((dim != 2 && dim != 3) || n_points > std::numeric_limits<std::uint64_t>::max() / (8 * (dim + 2)))
+        {
+          write_error("The request is invalid, it has dimension " + std::to_string(dim)
+                      + " and " + std::to_string(n_points) + " points.");
+          return;
+        }
+
+      // The number of output columns of a request is limited, so that a
+      // small request can not make the server allocate an unreasonable
+      // amount of memory. The points of the request are not read, so the
+      // connection is closed after the error as well.
+      if (options[1] > max_request_columns || options[2] > max_request_columns || options[3] > max_request_columns
+          || dim + 3 + static_cast<std::uint64_t>(options[1]) + static_cast<std::uint64_t>(options[2]) * options[3] * 10 > max_request_columns)
+        {
+          write_error("The request is invalid, it asks for " + std::to_string(options[1]) + " compositions, "
+                      + std::to_string(options[2]) + " grain compositions and " + std::to_string(options[3])
+                      + " grains, which is more than " + std::to_string(max_request_columns) + " columns.");
+          return;
+        }
+
+      // The points of a request are kept in memory while they are evaluated,
+      // so their size is limited as well.
+      if (n_points > max_request_bytes / (8 * (dim + 2)))
+        {
+          write_error("The request is invalid, it has " + std::to_string(n_points) + " points, which is more than the "
+                      + std::to_string(max_request_bytes / (8 * (dim + 2))) + " points of dimension " + std::to_string(dim)
+                      + " which fit in a request.");
+          return;
+        }
+
+      // The points are read in pieces, so that the memory of a request only
+      // grows with the data which the client has actually sent, instead of
+      // being allocated up front for a number of points which may be wrong.
+      std::vector<double> points;
+      const std::uint64_t n_values = n_points * (dim + 2);
+      const std::uint64_t values_per_piece = static_cast<std::uint64_t>(65536) * (dim + 2);
+      while (points.size() < n_values)
+        {
+          const size_t n_read_values = points.size();
+          const size_t n_piece_values = static_cast<size_t>(std::min(values_per_piece, n_values - n_read_values));
+          points.resize(n_read_values + n_piece_values);
+          if (read_bytes(input, reinterpret_cast<char *>(points.data() + n_read_values), n_piece_values * sizeof(double))
+              != n_piece_values * sizeof(double))
+            return;
+        }
+
+      std::unique_ptr<PointEvaluator> point_evaluator;
+      try
+        {
+          point_evaluator.reset(new PointEvaluator(world, DataFormat::binary, dim, options[1], options[2], options[3]));
+        }
+      catch (std::exception &e)
+        {
+          write_error(e.what());
+          continue;
+        }
+
+      // The header of the response is known before the points are evaluated,
+      // so the output of every chunk of points is written to the connection
+      // as soon as it has been evaluated, instead of keeping the output of
+      // the whole request in memory. The chunks are small enough that their
+      // output stays below max_chunk_bytes. An error during the evaluation
+      // can not be answered with a status anymore, so it closes the
+      // connection.
+      const std::uint64_t n_columns = point_evaluator->n_output_columns();
+      {
+        const std::uint32_t status = 0;
+        char response_header[sizeof(status) + sizeof(n_points) + sizeof(n_columns)];
+        std::memcpy(response_header, &status, sizeof(status));
+        std::memcpy(response_header + sizeof(status), &n_points, sizeof(n_points));
+        std::memcpy(response_header + sizeof(status) + sizeof(n_points), &n_columns, sizeof(n_columns));
+        write_bytes(output, response_header, sizeof(response_header));
+      }
+
+      const DataPipeline<size_t>::ChunkEvaluator evaluate = [&](const std::vector<size_t> &point_indices, const size_t, std::ostream &chunk_output)
+      {
+        WorldBuilder::properties properties;
+        for (size_t i = 0; i < point_indices.size(); ++i)
+          point_evaluator->evaluate(points.data() + point_indices[i] * (dim + 2), nullptr, 0, chunk_output, properties);
+      };
+      const DataPipeline<size_t>::ChunkWriter write_chunk = [output](const std::vector<size_t> &, const std::string &chunk_output)
+      {
+        write_bytes(output, chunk_output.data(), chunk_output.size());
+      };
+
+      // The threads are shared with the requests of the other connections.
+      // A request waits until at least one of them is free, and uses the
+      // other ones which are free at that moment. Small requests are
+      // evaluated directly, because starting the threads would take longer
+      // than evaluating the points.
+      const size_t points_per_chunk = std::max(static_cast<size_t>(max_chunk_bytes / (n_columns * sizeof(double))), static_cast<size_t>(1));
+      const CountingSemaphore::Units threads(evaluation_threads, n_points <= points_per_chunk ? 1 : number_of_threads);
+      if (threads.size() == 1)
+        {
+          std::vector<size_t> point_indices;
+          for (size_t first_point = 0; first_point < n_points; first_point += points_per_chunk)
+            {
+              point_indices.clear();
+              for (size_t i = first_point; i < std::min(first_point + points_per_chunk, static_cast<size_t>(n_points)); ++i)
+                point_indices.push_back(i);
+              std::ostringstream stream;
+              evaluate(point_indices, first_point, stream);
+              write_chunk(point_indices, stream.str());
+            }
+        }
+      else
+        {
+          size_t next_point = 0;
+          DataPipeline<size_t> pipeline(threads.size(), points_per_chunk, 4 * threads.size());
+          pipeline.run([&](size_t &point_index) -> bool
+          {
+            point_index = next_point++;
+            return point_index < n_points;
+          }, 0, evaluate, write_chunk);
+        }
+    }
+}
+
+
+void serve_socket(const std::string &socket_path,
+                  const WorldBuilder::World &world,
+                  const size_t number_of_threads)
+{
+#ifdef _WIN32
+  (void)world;
+  (void)number_of_threads;
+  WBAssertThrow(false, "Serving on the socket " << socket_path << " is not supported on Windows.");
+#else
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  WBAssertThrow(socket_path.size() < sizeof(address.sun_path), "The socket path " << socket_path << " is too long.");
+  std::strcpy(address.sun_path, socket_path.c_str());
+
+  // Remove a socket which has been left behind by an earlier server.
+  struct stat file_status;
+  if (stat(socket_path.c_str(), &file_status) == 0 && S_ISSOCK(file_status.st_mode))
+    unlink(socket_path.c_str());
+
+  const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  WBAssertThrow(server >= 0, "Could not create the socket " << socket_path << ".");
+  WBAssertThrow(bind(server, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0 && listen(server, 16) == 0,
+                "Could not listen on the socket " << socket_path << ".");
+
+  // A client which closes its connection early should not stop the server.
+  std::signal(SIGPIPE, SIG_IGN);
+
+  // The connection threads are detached, so they share the ownership of the
+  // semaphores with this function.
+  const std::shared_ptr<CountingSemaphore> connections(new CountingSemaphore(max_connections));
+  const std::shared_ptr<CountingSemaphore> evaluation_threads(new CountingSemaphore(number_of_threads));
+  std::chrono::milliseconds backoff(10);
+  while (true)
+    {
+      connections->acquire(1);
+      const int connection = accept(server, nullptr, nullptr);
+      if (connection < 0)
+        {
+          const int error = errno;
+          connections->release(1);
+          if (error == EINTR || error == ECONNABORTED)
+            continue;
+
+          // The server may run out of file descriptors or memory while other
+          // connections are open, so wait for them to be closed instead of
+          // trying again right away.
+          WBAssertThrow(error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM,
+                        "Could not accept a connection on the socket " << socket_path << ": " << std::strerror(error));
+          std::this_thread::sleep_for(backoff);
+          backoff = std::min(2 * backoff, std::chrono::milliseconds(1000));
+          continue;
+        }
+      backoff = std::chrono::milliseconds(10);
+
+      // Every connection is served by its own thread, which evaluates the
+      // requests of the connection in order.
+      std::thread([connection, &world, number_of_threads, connections, evaluation_threads]()
+      {
+        try
+          {
+            serve_requests(connection, connection, world, number_of_threads, *evaluation_threads);
+          }
+        catch (std::exception &e)
+          {
+            std::cerr << "Closing a connection after an error: " << e.what() << std::endl;
+          }
+        close(connection);
+        connections->release(1);
+      }).detach();
+    }
+#endif
+}
+
+
 int main(int argc, char **argv)
 {
   /**
    * First parse the command line options
    */
-  std::string wb_file;
+  std::vector<std::string> wb_files;
   std::string data_file;
 
   unsigned int dim = 3;
@@ -53,11 +1027,93 @@ int main(int argc, char **argv)
       std::cout << "This program allows to use the world builder library directly with a world builder file and a data file. "
                 "The data file will be filled with intitial conditions from the world as set by the world builder file." << std::endl
                 << "Besides providing two files, where the first is the world builder file and the second is the data file, the available options are: " << std::endl
-                << "-h or --help to get this help screen." << std::endl;
+                << "More than one world builder file may be given before the data file to evaluate all of them over the same points. "
+                "The points are then only read once, and the output of every world is written to a file named after its world builder file "
+                "with the extension .dat, .bin or .npy, depending on the output format." << std::endl
+                << "-h or --help to get this help screen." << std::endl
+                << "-j the number of threads the app is allowed to use to evaluate the data file." << std::endl
+                << "--output-dir the directory in which the output of every world is written when more than one world builder file is given. "
+                "By default this is the current directory." << std::endl
+                << "--input-format and --output-format to read and write the data as text (default), as raw little endian doubles (binary) "
+                "or as a two dimensional numpy array of doubles (npy). A point consists of the coordinates, the depth and the gravity. "
+                "In the output they are followed by the temperature, the compositions and for every grain its size and rotation matrix. "
+                "When a text data file is written in the npy format to something else than a file, such as a pipe, the data file is "
+                "read twice, first to count the points for the header." << std::endl
+                << "--serve to load the world once and answer requests on stdin and stdout, or on the Unix domain socket given by "
+                "--socket. Only the world builder file is given in this mode. A request consists of the dimension, the number of "
+                "compositions, grain compositions and grains as 32 bit unsigned integers, the number of points as a 64 bit unsigned "
+                "integer and the points as dim + 2 doubles each. The response consists of a 32 bit status, which is zero on success, "
+                "followed by the number of points and columns as 64 bit unsigned integers and the columns of the binary output format, "
+                "or by the length of an error message as a 64 bit unsigned integer and the message. The points of a request may take at "
+                "most 64 MiB. The output is written while it is evaluated, so an error during the evaluation closes the connection. At "
+                "most 64 connections are served at the same time, and they share the threads given by -j." << std::endl
+                << "--dim, --compositions, --grain-compositions and --number-of-grains to set these options for binary input. "
+                "In a text file they are set with lines like \"# dim = 2\", and the dimension of an npy file follows from its shape." << std::endl
+                << "--write-declarations to write the declarations of the world builder file to world_buider_declarations.tex "
+                "and world_buider_declarations.schema.json next to the world builder file." << std::endl;
       return 0;
     }
 
-  if (argc == 1)
+  // The declarations are only written when this is explicitly requested.
+  bool write_declarations = false;
+  size_t number_of_threads = 1;
+  DataFormat input_format = DataFormat::text;
+  DataFormat output_format = DataFormat::text;
+  bool serve = false;
+  std::string socket_path;
+  std::string output_dir;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i)
+    {
+      if (std::string(argv[i]) == "--write-declarations")
+        write_declarations = true;
+      else if (std::string(argv[i]) == "-j")
+        {
+          WBAssertThrow(i + 1 < argc, "The option -j needs to be followed by the number of threads.");
+          number_of_threads = string_to_unsigned_int(argv[++i]);
+          WBAssertThrow(number_of_threads > 0, "The number of threads needs to be larger than zero.");
+        }
+      else if (std::string(argv[i]) == "--serve")
+        serve = true;
+      else if (std::string(argv[i]) == "--socket")
+        {
+          WBAssertThrow(i + 1 < argc, "The option --socket needs to be followed by the path of the socket.");
+          socket_path = argv[++i];
+          serve = true;
+        }
+      else if (std::string(argv[i]) == "--output-dir")
+        {
+          WBAssertThrow(i + 1 < argc, "The option --output-dir needs to be followed by a directory.");
+          output_dir = argv[++i];
+          if (output_dir.size() > 0 && output_dir.back() != '/' && output_dir.back() != '\\')
+            output_dir += "/";
+        }
+      else if (std::string(argv[i]) == "--input-format" || std::string(argv[i]) == "--output-format")
+        {
+          WBAssertThrow(i + 1 < argc, "The option " << argv[i] << " needs to be followed by a format.");
+          (std::string(argv[i]) == "--input-format" ? input_format : output_format) = string_to_data_format(argv[i+1]);
+          ++i;
+        }
+      else if (std::string(argv[i]) == "--dim" || std::string(argv[i]) == "--compositions"
+               || std::string(argv[i]) == "--grain-compositions" || std::string(argv[i]) == "--number-of-grains")
+        {
+          WBAssertThrow(i + 1 < argc, "The option " << argv[i] << " needs to be followed by a number.");
+          const unsigned int value = string_to_unsigned_int(argv[i+1]);
+          if (std::string(argv[i]) == "--dim")
+            dim = value;
+          else if (std::string(argv[i]) == "--compositions")
+            compositions = value;
+          else if (std::string(argv[i]) == "--grain-compositions")
+            grain_compositions = value;
+          else
+            number_of_grains = value;
+          ++i;
+        }
+      else
+        files.push_back(argv[i]);
+    }
+
+  if (files.size() == 0)
     {
       std::cout << "Error: There where no files passed to the World Builder, use --help for more " << std::endl
                 << "information on how  to use the World Builder app." << std::endl;
@@ -65,31 +1121,33 @@ int main(int argc, char **argv)
     }
 
 
-  if (argc == 2)
+  if (files.size() == 1 && !serve)
     {
       std::cout << "Error:  The World Builder app requires at least two files, a World Builder file " << std::endl
                 << "and a data file to convert." << std::endl;
       return 0;
     }
 
-  if (argc != 3)
+  if (serve && files.size() != 1)
     {
-      std::cout << "Only two command line arguments may be given, which should be the world builder file location and the data file location (in that order). " << std::endl;
+      std::cout << "Only the world builder file may be given when serving requests. " << std::endl;
       return 0;
     }
 
-  wb_file = argv[1];
-  data_file = argv[2];
+  wb_files.assign(files.begin(), serve ? files.end() : files.end() - 1);
+  if (!serve)
+    data_file = files.back();
 
   /**
    * Try to start the world builder
    */
-  std::unique_ptr<WorldBuilder::World> world;
+  std::vector<std::unique_ptr<WorldBuilder::World> > worlds;
   //try
-  {
-    std::string output_dir = wb_file.substr(0,wb_file.find_last_of("/\\") + 1);
-    world = std::unique_ptr<WorldBuilder::World>(new WorldBuilder::World(wb_file, true, output_dir));
-  }
+  for (const std::string &wb_file : wb_files)
+    {
+      std::string declarations_dir = wb_file.substr(0,wb_file.find_last_of("/\\") + 1);
+      worlds.push_back(std::unique_ptr<WorldBuilder::World>(new WorldBuilder::World(wb_file, write_declarations, declarations_dir)));
+    }
   /*catch (std::exception &e)
     {
       std::cerr << "Could not start the World builder, error: " << e.what() << "\n";
@@ -102,159 +1160,436 @@ int main(int argc, char **argv)
     }*/
 
 
+  WBAssertThrow((input_format == DataFormat::text && output_format == DataFormat::text && !serve) || is_little_endian(),
+                "The binary and npy formats are only supported on little endian machines.");
+
   /**
-   * Read the data from the data files
+   * In the server mode the world stays loaded, and every request is only
+   * evaluated.
    */
-  std::ifstream data_stream(data_file);
+  if (serve)
+    {
+      if (socket_path.size() > 0)
+        serve_socket(socket_path, *worlds[0], number_of_threads);
+      else
+        {
+#ifdef _WIN32
+          _setmode(_fileno(stdin), _O_BINARY);
+          _setmode(_fileno(stdout), _O_BINARY);
+#endif
+          std::cout.flush();
+          CountingSemaphore evaluation_threads(number_of_threads);
+          serve_requests(0, 1, *worlds[0], number_of_threads, evaluation_threads);
+        }
+      return 0;
+    }
 
-  // move the data into a vector of strings
-  std::vector<std::vector<std::string> > data;
-  std::string temp;
+  /**
+   * Read the options at the top of a text data file. They have to be given
+   * before the first point, because the header of the output depends on
+   * them. A binary data file is mapped into memory, and the points are read
+   * from it directly.
+   */
+  std::ifstream data_stream;
+  std::unique_ptr<MappedFile> mapped_data;
+  const char *points = nullptr;
+  size_t n_points = 0;
 
-  while (std::getline(data_stream, temp))
+  size_t line_number = 0;
+  std::string first_point;
+  bool has_first_point = false;
+  if (input_format == DataFormat::text)
     {
-      std::istringstream buffer(temp);
-      std::vector<std::string> line((std::istream_iterator<std::string>(buffer)),
-                                    std::istream_iterator<std::string>());
-
-      // remove the comma's in case it is a comma separated file.
-      // TODO: make it split for comma's and/or spaces
-      for (unsigned int i = 0; i < line.size(); ++i)
-        line[i].erase(std::remove(line[i].begin(), line[i].end(), ','), line[i].end());
+      data_stream.open(data_file);
+      while (!has_first_point && std::getline(data_stream, first_point))
+        {
+          ++line_number;
+          const std::vector<std::string> line = split_data_line(first_point);
+          if (line.size() > 0 && line[0] != "#")
+            has_first_point = true;
+          else
+            read_configuration_line(line, dim, compositions, grain_compositions, number_of_grains);
+        }
+    }
+  else
+    {
+      mapped_data.reset(new MappedFile(data_file));
+      if (input_format == DataFormat::npy)
+        {
+          size_t n_columns = 0;
+          points = mapped_data->data + read_npy_header(mapped_data->data, mapped_data->size, n_points, n_columns);
+          WBAssertThrow(n_columns == 4 || n_columns == 5, "The npy data file needs to contain dim + 2 columns, but contains "
+                        << n_columns << " columns.");
+          dim = static_cast<unsigned int>(n_columns - 2);
+        }
+      else
+        {
+          const size_t point_size = (dim + 2) * sizeof(double);
+          WBAssertThrow(mapped_data->size % point_size == 0, "The binary data file needs to contain dim + 2 doubles for every point, "
+                        "but its size is not a multiple of " << point_size << " bytes. Dim is " << dim << ".");
+          points = mapped_data->data;
+          n_points = mapped_data->size / point_size;
+        }
+    }
 
-      data.push_back(line);
+  if (dim != 2 && dim != 3)
+    {
+      std::cout << "The World Builder can only be run in 2d and 3d but a different space dimension " << std::endl
+                << "is given: dim = " << dim << ".";
+      return 0;
     }
 
-  // Read config from data if pressent
-  for (unsigned int i = 0; i < data.size(); ++i)
+  /**
+   * With more than one world builder file, the points are read only once and
+   * every world is evaluated over them. Every block of points is an item of
+   * the pipeline, which is evaluated for all the worlds by the same thread,
+   * so the lines of a text data file are only parsed once. The output of
+   * every world is kept in the block and appended to the output file of the
+   * world by the writer, so the memory use does not depend on the size of
+   * the data file.
+   */
+  if (worlds.size() > 1)
     {
-      if (data[i].size() > 0 && data[i][0] == "#" && data[i][1] == "dim" && data[i][2] == "=")
+      const std::string extension = output_format == DataFormat::text ? ".dat" : (output_format == DataFormat::binary ? ".bin" : ".npy");
+      std::vector<std::string> output_files;
+      std::vector<std::unique_ptr<std::ofstream> > outputs;
+      std::vector<PointEvaluator> point_evaluators;
+      point_evaluators.reserve(worlds.size());
+
+      // The number of points of a text data file is only known once it has
+      // been read, so the npy header is written with the largest number of
+      // points and replaced at the end.
+      std::vector<size_t> npy_header_sizes(worlds.size(), 0);
+      for (size_t w = 0; w < worlds.size(); ++w)
         {
-          dim = string_to_unsigned_int(data[i][3]);
-        }
+          const std::string base_filename = wb_files[w].substr(wb_files[w].find_last_of("/\\") + 1);
+          const std::string output_file = output_dir + base_filename.substr(0, base_filename.find_last_of('.')) + extension;
+          WBAssertThrow(std::find(output_files.begin(), output_files.end(), output_file) == output_files.end(),
+                        "The output of the world builder file " << wb_files[w] << " would overwrite the output of another world builder "
+                        "file in " << output_file << ".");
+          output_files.push_back(output_file);
 
-      if (data[i].size() > 0 && data[i][0] == "#" && data[i][1] == "compositions" && data[i][2] == "=")
-        compositions = string_to_unsigned_int(data[i][3]);
+          outputs.push_back(std::unique_ptr<std::ofstream>(new std::ofstream(output_file.c_str(), output_format == DataFormat::text
+                                                                               ? std::ios::out : std::ios::out | std::ios::binary)));
+          WBAssertThrow(outputs.back()->good(), "Could not open the output file " << output_file << ".");
 
-      if (data[i].size() > 0 && data[i][0] == "#" && data[i][1] == "grain" && data[i][2] == "compositions" && data[i][3] == "=")
-        grain_compositions = string_to_unsigned_int(data[i][4]);
+          point_evaluators.emplace_back(*worlds[w], output_format, dim, compositions, grain_compositions, number_of_grains);
 
-      if (data[i].size() > 0 && data[i][0] == "#" && data[i][1] == "number" && data[i][2] == "of" && data[i][3] == "grains" && data[i][4] == "=")
-        number_of_grains = string_to_unsigned_int(data[i][5]);
+          if (output_format == DataFormat::text)
+            write_header(*outputs.back(), dim, compositions, grain_compositions, number_of_grains);
+          else if (output_format == DataFormat::npy)
+            {
+              std::ostringstream header;
+              write_npy_header(header, input_format == DataFormat::text ? std::numeric_limits<size_t>::max() : n_points,
+                               point_evaluators.back().n_output_columns());
+              npy_header_sizes[w] = header.str().size();
+              *outputs.back() << header.str();
+            }
+        }
 
-    }
+      /**
+       * A block of points, given by the lines of a text data file or by the
+       * range of the points in a binary data file, and the output of every
+       * world for the points.
+       */
+      struct PointBlock
+      {
+        std::vector<std::string> lines;
+        size_t first_line_number;
+        size_t first_point;
+        size_t end_point;
+        size_t n_points;
+        std::vector<std::string> outputs;
+      };
 
-  switch (dim)
-    {
-      case 2:
-        // set the header
-        std::cout << "# x z d g T ";
+      const size_t points_per_block = 4096;
+      size_t next_point = 0;
+      const DataPipeline<PointBlock>::ItemReader read_block = [&](PointBlock &block) -> bool
+      {
+        block.lines.clear();
+        block.outputs.clear();
+        block.n_points = 0;
+        if (input_format == DataFormat::text)
+          {
+            block.first_line_number = line_number;
+            std::string line;
+            while (block.lines.size() < points_per_block)
+              {
+                if (has_first_point)
+                  {
+                    line.swap(first_point);
+                    has_first_point = false;
+                  }
+                else if (!std::getline(data_stream, line))
+                  break;
+                block.lines.push_back(line);
+                ++line_number;
+              }
+            return block.lines.size() > 0;
+          }
 
-        for (unsigned int c = 0; c < compositions; ++c)
-          std::cout << "c" << c << " ";
+        block.first_point = next_point;
+        next_point = std::min(next_point + points_per_block, n_points);
+        block.end_point = next_point;
+        return block.end_point > block.first_point;
+      };
 
-        for (unsigned int gc = 0; gc < grain_compositions; ++gc)
-          for (size_t g = 0; g < number_of_grains; g++)
-            std::cout << "gs" << gc << "-" << g << " " // gs = grain size, gm = grain rotation matrix
-                      << "gm" << gc << "-" << g << "[0:0] " << "gm" << gc << "-" << g << "[0:1] " << "gm" << gc << "-" << g << "[0:2] "
-                      << "gm" << gc << "-" << g << "[1:0] " << "gm" << gc << "-" << g << "[1:1] " << "gm" << gc << "-" << g << "[1:2] "
-                      << "gm" << gc << "-" << g << "[2:0] " << "gm" << gc << "-" << g << "[2:1] " << "gm" << gc << "-" << g << "[2:2] ";
+      const DataPipeline<PointBlock>::ChunkEvaluator evaluate = [&](std::vector<PointBlock> &blocks, const size_t, std::ostream &)
+      {
+        // The text of the points is kept in one string, with the offset of
+        // every point in point_text_offsets, so the text output can repeat
+        // the input exactly without keeping a string for every column.
+        std::vector<double> point_values;
+        std::string point_texts;
+        std::vector<size_t> point_text_offsets;
+        WorldBuilder::properties properties;
+        for (PointBlock &block : blocks)
+          {
+            point_values.clear();
+            point_texts.clear();
+            point_text_offsets.assign(1, 0);
+            if (input_format == DataFormat::text)
+              {
+                std::vector<double> point(dim + 2);
+                for (size_t i = 0; i < block.lines.size(); ++i)
+                  {
+                    const std::vector<std::string> line = split_data_line(block.lines[i]);
+                    if (read_point_line(line, block.first_line_number + i, dim, point.data()))
+                      {
+                        point_values.insert(point_values.end(), point.begin(), point.end());
+                        for (unsigned int c = 0; c < dim + 2; ++c)
+                          {
+                            point_texts += line[c];
+                            point_texts += ' ';
+                          }
+                        point_text_offsets.push_back(point_texts.size());
+                      }
+                  }
+              }
+            else
+              {
+                // The points in a binary file do not have to be aligned, so
+                // they are copied out.
+                point_values.resize((block.end_point - block.first_point) * (dim + 2));
+                std::memcpy(point_values.data(), points + block.first_point * (dim + 2) * sizeof(double), point_values.size() * sizeof(double));
+              }
 
-        std::cout <<std::endl;
+            // The outputs are only stored once every world has been
+            // evaluated, so a block which fails is not written at all.
+            const size_t n_block_points = point_values.size() / (dim + 2);
+            std::vector<std::string> block_outputs(worlds.size());
+            for (size_t w = 0; w < worlds.size(); ++w)
+              {
+                std::ostringstream stream;
+                for (size_t p = 0; p < n_block_points; ++p)
+                  if (input_format == DataFormat::text)
+                    point_evaluators[w].evaluate(point_values.data() + p * (dim + 2), point_texts.data() + point_text_offsets[p],
+                                                 point_text_offsets[p + 1] - point_text_offsets[p], stream, properties);
+                  else
+                    point_evaluators[w].evaluate(point_values.data() + p * (dim + 2), nullptr, 0, stream, properties);
+                block_outputs[w] = stream.str();
+              }
+            block.outputs.swap(block_outputs);
+            block.n_points = n_block_points;
+          }
+      };
 
-        // set the values
-        for (unsigned int i = 0; i < data.size(); ++i)
-          if (data[i][0] != "#")
-            {
+      size_t n_written_points = 0;
+      const DataPipeline<PointBlock>::ChunkWriter write_block = [&](const std::vector<PointBlock> &blocks, const std::string &)
+      {
+        for (const PointBlock &block : blocks)
+          {
+            for (size_t w = 0; w < block.outputs.size(); ++w)
+              *outputs[w] << block.outputs[w];
+            n_written_points += block.n_points;
+          }
+      };
 
-              WBAssertThrow(data[i].size() == dim + 2, "The file needs to contain dim + 2 entries, but contains " << data[i].size() << " entries "
-                            " on line " << i+1 << " of the data file.  Dim is " << dim << ".");
+      // The npy headers of a text data file are replaced with the number of
+      // points which have been written, also when the evaluation stops with
+      // an error.
+      const auto finish_outputs = [&]()
+      {
+        for (size_t w = 0; w < outputs.size(); ++w)
+          {
+            if (output_format == DataFormat::npy && input_format == DataFormat::text)
+              {
+                std::ostringstream header;
+                write_npy_header(header, n_written_points, point_evaluators[w].n_output_columns(), npy_header_sizes[w]);
+                outputs[w]->seekp(0);
+                *outputs[w] << header.str();
+              }
+            outputs[w]->close();
+          }
+      };
 
-              std::array<double,2> coords = {{
-                  string_to_double(data[i][0]),
-                  string_to_double(data[i][1])
-                }
-              };
-              std::cout << data[i][0] << " " << data[i][1] << " " << data[i][2] << " " << data[i][3] << " ";
-              std::cout << world->temperature(coords, string_to_double(data[i][2]), string_to_double(data[i][3]))  << " ";
+      DataPipeline<PointBlock> pipeline(number_of_threads, 1, 4 * number_of_threads);
+      try
+        {
+          pipeline.run(read_block, 0, evaluate, write_block);
+        }
+      catch (...)
+        {
+          finish_outputs();
+          throw;
+        }
+      finish_outputs();
 
-              for (unsigned int c = 0; c < compositions; ++c)
-                {
-                  std::cout << world->composition(coords, string_to_double(data[i][2]), c)  << " ";
-                }
+      for (size_t w = 0; w < outputs.size(); ++w)
+        WBAssertThrow(!outputs[w]->fail(), "Could not write the output file " << output_files[w] << ".");
+      return 0;
+    }
 
-              for (unsigned int gc = 0; gc < grain_compositions; ++gc)
-                {
-                  WorldBuilder::grains grains = world->grains(coords, string_to_double(data[i][2]), gc, number_of_grains);
-                  for (unsigned int g = 0; g < number_of_grains; ++g)
-                    {
-                      std::cout << grains.sizes[g]  << " "
-                                << grains.rotation_matrices[g][0][0] << " " << grains.rotation_matrices[g][0][1] << " " << grains.rotation_matrices[g][0][2] << " "
-                                << grains.rotation_matrices[g][1][0] << " " << grains.rotation_matrices[g][1][1] << " " << grains.rotation_matrices[g][1][2] << " "
-                                << grains.rotation_matrices[g][2][0] << " " << grains.rotation_matrices[g][2][1] << " " << grains.rotation_matrices[g][2][2] << " ";
-                    }
-                }
-              std::cout << std::endl;
+  const PointEvaluator point_evaluator(*worlds[0], output_format, dim, compositions, grain_compositions, number_of_grains);
 
-            }
-        break;
-      case 3:
-        // set the header
-        std::cout << "# x y z d g T ";
+#ifdef _WIN32
+  if (output_format != DataFormat::text)
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
 
-        for (unsigned int c = 0; c < compositions; ++c)
-          std::cout << "c" << c << " ";
+  // The number of points of a text data file is only known once it has been
+  // read. When the output is written to a file, the npy header is written
+  // with the largest number of points and replaced once the points have been
+  // evaluated. Otherwise the data file is read twice, first to count the
+  // points.
+  bool replace_npy_header = false;
+  size_t npy_header_size = 0;
+#ifndef _WIN32
+  off_t npy_header_offset = 0;
+#endif
+  if (output_format == DataFormat::text)
+    write_header(std::cout, dim, compositions, grain_compositions, number_of_grains);
+  else if (output_format == DataFormat::npy && input_format != DataFormat::text)
+    write_npy_header(std::cout, n_points, point_evaluator.n_output_columns());
+  else if (output_format == DataFormat::npy)
+    {
+#ifndef _WIN32
+      std::cout.flush();
+      struct stat output_status;
+      npy_header_offset = lseek(1, 0, SEEK_CUR);
+      replace_npy_header = npy_header_offset >= 0 && fstat(1, &output_status) == 0 && S_ISREG(output_status.st_mode)
+                           && (fcntl(1, F_GETFL) & O_APPEND) == 0;
+#endif
+      if (replace_npy_header)
+        {
+          std::ostringstream header;
+          write_npy_header(header, std::numeric_limits<size_t>::max(), point_evaluator.n_output_columns());
+          npy_header_size = header.str().size();
+          std::cout << header.str();
+        }
+      else
+        write_npy_header(std::cout, count_text_points(data_file), point_evaluator.n_output_columns());
+    }
 
-        for (unsigned int gc = 0; gc < grain_compositions; ++gc)
-          for (size_t g = 0; g < number_of_grains; g++)
-            std::cout << "gs" << gc << "-" << g << " " // gs = grain size, gm = grain rotation matrix
-                      << "gm" << gc << "-" << g << "[0:0] " << "gm" << gc << "-" << g << "[0:1] " << "gm" << gc << "-" << g << "[0:2] "
-                      << "gm" << gc << "-" << g << "[1:0] " << "gm" << gc << "-" << g << "[1:1] " << "gm" << gc << "-" << g << "[1:2] "
-                      << "gm" << gc << "-" << g << "[2:0] " << "gm" << gc << "-" << g << "[2:1] " << "gm" << gc << "-" << g << "[2:2] ";
+  /**
+   * Stream the points through the world builder. The output is only flushed
+   * once per chunk of points, and the chunks are written in the same order
+   * as they are read.
+   */
+  if (input_format == DataFormat::text)
+    {
+#ifndef _WIN32
+      // The number of rows follows from the bytes which have been written, so
+      // the header also matches the output when the evaluation stops with an
+      // error. A partially written row is removed.
+      const auto finish_npy_header = [&]() -> bool
+      {
+        std::cout.flush();
+        const off_t data_offset = npy_header_offset + static_cast<off_t>(npy_header_size);
+        const off_t row_size = static_cast<off_t>(point_evaluator.n_output_columns() * sizeof(double));
+        const off_t end = lseek(1, 0, SEEK_CUR);
+        if (end < data_offset)
+          return false;
+        const off_t n_rows = (end - data_offset) / row_size;
+        if (data_offset + n_rows * row_size != end
+            && (ftruncate(1, data_offset + n_rows * row_size) != 0 || lseek(1, 0, SEEK_END) < 0))
+          return false;
 
-        std::cout <<std::endl;
+        std::ostringstream stream;
+        write_npy_header(stream, static_cast<size_t>(n_rows), point_evaluator.n_output_columns(), npy_header_size);
+        const std::string header = stream.str();
+        return pwrite(1, header.data(), header.size(), npy_header_offset) == static_cast<ssize_t>(header.size());
+      };
+#endif
 
-        // set the values
-        for (unsigned int i = 0; i < data.size(); ++i)
-          if (data[i][0] != "#")
+      try
+        {
+          if (has_first_point)
             {
-              WBAssertThrow(data[i].size() == dim + 2, "The file needs to contain dim + 2 entries, but contains " << data[i].size() << " entries "
-                            " on line " << i+1 << " of the data file. Dim is " << dim << ".");
-              std::array<double,3> coords = {{
-                  string_to_double(data[i][0]),
-                  string_to_double(data[i][1]),
-                  string_to_double(data[i][2])
-                }
+              const DataPipeline<std::string>::ItemReader read_line = [&](std::string &line) -> bool
+              {
+                if (has_first_point)
+                  {
+                    line.swap(first_point);
+                    has_first_point = false;
+                    return true;
+                  }
+                return static_cast<bool>(std::getline(data_stream, line));
               };
 
+              const DataPipeline<std::string>::ChunkEvaluator evaluate = [&](const std::vector<std::string> &lines, const size_t first_line_number, std::ostream &output)
+              {
+                WorldBuilder::properties properties;
+                std::vector<double> point(dim + 2);
+                std::string point_text;
+                for (size_t i = 0; i < lines.size(); ++i)
+                  {
+                    const std::vector<std::string> line = split_data_line(lines[i]);
+                    if (read_point_line(line, first_line_number + i, dim, point.data()))
+                      {
+                        point_text.clear();
+                        for (unsigned int c = 0; c < dim + 2; ++c)
+                          {
+                            point_text += line[c];
+                            point_text += ' ';
+                          }
+                        point_evaluator.evaluate(point.data(), point_text.data(), point_text.size(), output, properties);
+                      }
+                  }
+              };
 
-              std::cout << data[i][0] << " " << data[i][1] << " " << data[i][2] << " " << data[i][3] << " " << data[i][4] << " ";
-              std::cout << world->temperature(coords, string_to_double(data[i][3]), string_to_double(data[i][4]))  << " ";
+              DataPipeline<std::string> pipeline(number_of_threads, 4096, 4 * number_of_threads);
+              pipeline.run(read_line, line_number, evaluate, std::cout);
+            }
+        }
+      catch (...)
+        {
+#ifndef _WIN32
+          if (replace_npy_header)
+            finish_npy_header();
+#endif
+          throw;
+        }
 
-              for (unsigned int c = 0; c < compositions; ++c)
-                {
-                  std::cout << world->composition(coords, string_to_double(data[i][3]), c)  << " ";
-                }
+#ifndef _WIN32
+      if (replace_npy_header)
+        WBAssertThrow(std::cout.good() && finish_npy_header(), "Could not write the header of the npy output.");
+#endif
+    }
+  else
+    {
+      size_t next_point = 0;
+      const DataPipeline<size_t>::ItemReader read_point = [&](size_t &point_index) -> bool
+      {
+        point_index = next_point++;
+        return point_index < n_points;
+      };
 
-              for (unsigned int gc = 0; gc < grain_compositions; ++gc)
-                {
-                  WorldBuilder::grains grains = world->grains(coords, string_to_double(data[i][3]), gc, number_of_grains);
-                  for (unsigned int g = 0; g < number_of_grains; ++g)
-                    {
-                      std::cout << grains.sizes[g]  << " "
-                                << grains.rotation_matrices[g][0][0] << " " << grains.rotation_matrices[g][0][1] << " " << grains.rotation_matrices[g][0][2] << " "
-                                << grains.rotation_matrices[g][1][0] << " " << grains.rotation_matrices[g][1][1] << " " << grains.rotation_matrices[g][1][2] << " "
-                                << grains.rotation_matrices[g][2][0] << " " << grains.rotation_matrices[g][2][1] << " " << grains.rotation_matrices[g][2][2] << " ";
-                    }
-                }
-              std::cout << std::endl;
+      const DataPipeline<size_t>::ChunkEvaluator evaluate = [&](const std::vector<size_t> &point_indices, const size_t, std::ostream &output)
+      {
+        WorldBuilder::properties properties;
+        std::vector<double> point(dim + 2);
+        for (size_t i = 0; i < point_indices.size(); ++i)
+          {
+            // The points in the file do not have to be aligned, so they are
+            // copied out.
+            std::memcpy(point.data(), points + point_indices[i] * point.size() * sizeof(double), point.size() * sizeof(double));
+            point_evaluator.evaluate(point.data(), nullptr, 0, output, properties);
+          }
+      };
 
-            }
-        break;
-      default:
-        std::cout << "The World Builder can only be run in 2d and 3d but a different space dimension " << std::endl
-                  << "is given: dim = " << dim << ".";
-        return 0;
+      DataPipeline<size_t> pipeline(number_of_threads, 4096, 4 * number_of_threads);
+      pipeline.run(read_point, 0, evaluate, std::cout);
     }
 
   return 0;
@@ -20,6 +20,61 @@
 #ifndef WORLD_BUILDER_APP_MAIN_H_
 #define WORLD_BUILDER_APP_MAIN_H_
 
+/**
+ * The formats in which the app can read and write the points.
+ */
+enum class DataFormat
+{
+  text,
+  binary,
+  npy
+};
+
 bool find_command_line_option(char **begin, char **end, const std::string &option);
 
+std::vector<std::string> split_data_line(const std::string &line);
+
+bool read_configuration_line(const std::vector<std::string> &line,
+                             unsigned int &dim,
+                             unsigned int &compositions,
+                             unsigned int &grain_compositions,
+                             size_t &number_of_grains);
+
+bool read_point_line(const std::vector<std::string> &line,
+                     const size_t line_number,
+                     const unsigned int dim,
+                     double *point);
+
+void write_header(std::ostream &output,
+                  const unsigned int dim,
+                  const unsigned int compositions,
+                  const unsigned int grain_compositions,
+                  const size_t number_of_grains);
+
+DataFormat string_to_data_format(const std::string &format);
+
+bool is_little_endian();
+
+void write_npy_header(std::ostream &output, const size_t n_rows, const size_t n_columns, const size_t min_size = 0);
+
+size_t read_npy_header(const char *data, const size_t size, size_t &n_rows, size_t &n_columns);
+
+size_t count_text_points(const std::string &data_file);
+
+size_t read_bytes(const int file, char *data, const size_t size);
+
+void write_bytes(const int file, const char *data, const size_t size);
+
+class CountingSemaphore;
+
+void serve_requests(const int input,
+                    const int output,
+                    const WorldBuilder::World &world,
+                    const size_t number_of_threads,
+                    CountingSemaphore &evaluation_threads);
+
+void serve_socket(const std::string &socket_path,
+                  const WorldBuilder::World &world,
+                  const size_t number_of_threads);
+
 #endif
@@ -29,6 +29,8 @@ void lay_points(double x1, double y1, double z1,
                 std::vector<double> &x, std::vector<double> &y, std::vector<double> &z,
                 std::vector<bool> &hull, size_t level);
 
+size_t group_columns(const std::vector<double> &x, const std::vector<double> &y, std::vector<size_t> &columns);
+
 std::vector<std::string> get_command_line_options_vector(int argc, char **argv);
 
 bool find_command_line_option(char **begin, char **end, const std::string &option);
@@ -0,0 +1,246 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_adaptive_baked_world_h
+#define _world_builder_adaptive_baked_world_h
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <world_builder/baked_world.h>
+#include <world_builder/coordinate_system.h>
+
+namespace WorldBuilder
+{
+  class World;
+
+  /**
+   * A world which is baked into an adaptive octree over a region of the
+   * model. Like the BakedWorld, the octree covers a box in the surface part
+   * of the natural coordinates and in depth, and the values are interpolated
+   * trilinearly between the corners of the leaves. Instead of using a
+   * uniform grid, a cell is only refined when the trilinear interpolation of
+   * the temperature from its corners differs more than the temperature
+   * tolerance from the world at the center of the cell or at the centers of
+   * its faces, or when a composition changes more than the composition
+   * tolerance between these points. The cells far away from the features are
+   * therefore large, and the cells near the boundaries of the features are
+   * small.
+   *
+   * After the refinement the octree is balanced, so that the levels of
+   * leaves which touch each other differ by at most one. The temperature at
+   * a corner of a leaf which lies on a face or an edge of a coarser leaf is
+   * replaced by the interpolation over that face or edge of the coarser
+   * leaf, which makes the interpolated temperature continuous. The
+   * tolerances are only checked at the seven points of every cell, so the
+   * error is not bounded at other points, and the values at the constrained
+   * corners can differ more than the tolerance from the world. The
+   * compositions are not constrained, so that the nearest interpolation
+   * always returns a value of the world.
+   *
+   * The corners are shared between neighboring leaves, and every node of the
+   * tree is stored as a single integer, so the memory use scales with the
+   * number of leaves.
+   */
+  class AdaptiveBakedWorld
+  {
+    public:
+      /**
+       * Constructor which bakes the world into an octree. The region is
+       * given in the same way as for the BakedWorld. All the cells are
+       * refined at least min_level times and at most max_level times, so the
+       * smallest cells are 2^max_level times smaller than the region in
+       * every direction.
+       */
+      AdaptiveBakedWorld(const World &world,
+                         const std::array<double,2> &min_surface,
+                         const std::array<double,2> &max_surface,
+                         const double min_depth,
+                         const double max_depth,
+                         const double surface_depth_coordinate,
+                         const double gravity_norm,
+                         const std::vector<unsigned int> &composition_numbers,
+                         const double temperature_tolerance,
+                         const double composition_tolerance,
+                         const unsigned int min_level,
+                         const unsigned int max_level);
+
+      /**
+       * Sets how the compositions are computed from the corners of a leaf.
+       * The default is nearest.
+       */
+      void set_composition_interpolation(const BakedWorld::CompositionInterpolation composition_interpolation);
+
+      /**
+       * Returns the temperature at a 3d Cartesian point and the depth in the
+       * model at that point. The point has to be within the region.
+       */
+      double temperature(const std::array<double,3> &point,
+                         const double depth) const;
+
+      /**
+       * Returns the value of a baked composition at a 3d Cartesian point and
+       * the depth in the model at that point. The point has to be within the
+       * region.
+       */
+      double composition(const std::array<double,3> &point,
+                         const double depth,
+                         const unsigned int composition_number) const;
+
+      /**
+       * Returns whether the given 3d Cartesian point and depth lie within
+       * the region of the octree.
+       */
+      bool contains(const std::array<double,3> &point,
+                    const double depth) const;
+
+      /**
+       * Returns the number of leaves of the octree.
+       */
+      size_t n_leaves() const;
+
+      /**
+       * Returns the number of distinct corners of the leaves, which is the
+       * number of points at which the values are stored.
+       */
+      size_t n_vertices() const;
+
+    private:
+      /**
+       * The location of a query in the octree: the leaf and the position
+       * within the leaf, between zero and one, in each direction.
+       */
+      struct LeafLocation
+      {
+        size_t leaf;
+        std::array<double,3> fraction;
+      };
+
+      /**
+       * Finds the leaf which contains the given point and depth. Returns
+       * false if it lies outside of the region.
+       */
+      bool locate(const std::array<double,3> &point,
+                  const double depth,
+                  LeafLocation &location) const;
+
+      /**
+       * The data which is only needed while the octree is built.
+       */
+      struct BuildData;
+
+      /**
+       * Builds the node with the given index, which is the cell at the given
+       * level with its first corner at the given vertex coordinates, and
+       * refines it when needed.
+       */
+      void build_node(BuildData &data,
+                      const size_t node_index,
+                      const unsigned int level,
+                      const std::array<std::uint64_t,3> &origin);
+
+      /**
+       * Splits the given leaf into eight leaves at the next level. The first
+       * of them keeps the index of the leaf.
+       */
+      void split_leaf(BuildData &data,
+                      const size_t leaf);
+
+      /**
+       * Returns the index of the leaf which contains the cell at the
+       * maximum level with the given vertex coordinates of its first corner.
+       */
+      size_t find_leaf(const std::array<std::uint64_t,3> &cell) const;
+
+      /**
+       * Splits leaves until the levels of all the leaves which touch each
+       * other differ by at most one.
+       */
+      void balance(BuildData &data);
+
+      /**
+       * Replaces the temperature at the corners of leaves which lie on a
+       * face or an edge of a coarser leaf by the interpolation of that
+       * leaf.
+       */
+      void constrain_hanging_vertices(BuildData &data);
+
+      /**
+       * Returns the index of the vertex at the given vertex coordinates, and
+       * evaluates the world at that vertex if it has not been evaluated yet.
+       */
+      std::uint32_t get_vertex(BuildData &data,
+                               const std::array<std::uint64_t,3> &coordinates);
+
+      /**
+       * Returns the index of the n-th corner of a leaf in the vertex arrays.
+       */
+      std::uint32_t corner(const size_t leaf, const unsigned int n) const;
+
+      /**
+       * Interpolates the values with the given stride and offset trilinearly
+       * at the location.
+       */
+      double interpolate(const std::vector<double> &values,
+                         const size_t stride,
+                         const size_t offset,
+                         const LeafLocation &location) const;
+
+      /**
+       * The flag which marks a node as a leaf. The other bits of a leaf
+       * node are the index of the leaf, and the bits of any other node are
+       * the index of its first child. The eight children of a node are
+       * stored next to each other.
+       */
+      static const std::uint32_t leaf_flag = 0x80000000u;
+
+      CoordinateSystem coordinate_system;
+      std::array<double,3> min_coordinates;
+      std::array<double,3> max_coordinates;
+      double gravity_norm;
+      std::vector<unsigned int> composition_numbers;
+      double temperature_tolerance;
+      double composition_tolerance;
+      unsigned int min_level;
+      unsigned int max_level;
+
+      std::vector<std::uint32_t> nodes;
+
+      /**
+       * The indices of the eight corners of every leaf.
+       */
+      std::vector<std::array<std::uint32_t,8> > leaves;
+
+      /**
+       * The temperature at every vertex.
+       */
+      std::vector<double> temperatures;
+
+      /**
+       * The compositions at every vertex. The compositions of a vertex are
+       * stored next to each other.
+       */
+      std::vector<double> compositions;
+
+      BakedWorld::CompositionInterpolation composition_interpolation;
+  };
+}
+
+#endif
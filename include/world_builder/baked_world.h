@@ -0,0 +1,208 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_baked_world_h
+#define _world_builder_baked_world_h
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <world_builder/coordinate_system.h>
+
+namespace WorldBuilder
+{
+  class World;
+
+  /**
+   * A world which is baked into a uniform grid over a region of the model.
+   * The grid is uniform in the surface part of the natural coordinates and
+   * in depth, so for a spherical model the grid is uniform in longitude,
+   * latitude and depth. The temperature is interpolated trilinearly between
+   * the grid points and the compositions are either taken from the nearest
+   * grid point or interpolated trilinearly, which gives the fraction of the
+   * composition. The cost of a query does not depend on the number of
+   * features in the world.
+   *
+   * The grid can be saved to a file and loaded again, so that a world only
+   * has to be baked once when many models are initialized from it. The file
+   * is written in the byte order of the machine.
+   *
+   * Optionally, a world can be set as fallback. The queries within a band
+   * of cells around a change in composition and the queries outside of the
+   * region are then evaluated exactly by the world.
+   */
+  class BakedWorld
+  {
+    public:
+      /**
+       * How the compositions are computed from the grid.
+       */
+      enum CompositionInterpolation
+      {
+        nearest,
+        fraction
+      };
+
+      /**
+       * Constructor which bakes the world into a grid with n_points grid
+       * points in each of the two surface directions and in depth. The grid
+       * covers min_surface to max_surface in the surface part of the natural
+       * coordinates and min_depth to max_depth in depth. The surface depth
+       * coordinate is the depth coordinate of the natural coordinates at
+       * depth zero, which is the height of the surface for a Cartesian model
+       * and its radius for a spherical model. Only the given composition
+       * numbers are baked. Cells which are within interface_band cells of a
+       * cell in which a composition changes are marked to be evaluated by the
+       * fallback world.
+       */
+      BakedWorld(const World &world,
+                 const std::array<double,2> &min_surface,
+                 const std::array<double,2> &max_surface,
+                 const double min_depth,
+                 const double max_depth,
+                 const std::array<size_t,3> &n_points,
+                 const double surface_depth_coordinate,
+                 const double gravity_norm,
+                 const std::vector<unsigned int> &composition_numbers,
+                 const unsigned int interface_band = 1);
+
+      /**
+       * Constructor which loads a baked world from a file written by save.
+       */
+      explicit BakedWorld(const std::string &filename);
+
+      /**
+       * Saves the baked world to a file.
+       */
+      void save(const std::string &filename) const;
+
+      /**
+       * Sets the world which is used to evaluate the queries near a change
+       * in composition and outside of the region exactly. This should be
+       * the world from which the grid was baked. A null pointer disables
+       * the fallback, which is the default.
+       */
+      void set_fallback(const World *world);
+
+      /**
+       * Sets how the compositions are computed from the grid. The default
+       * is nearest.
+       */
+      void set_composition_interpolation(const CompositionInterpolation composition_interpolation);
+
+      /**
+       * Returns the temperature at a 3d Cartesian point and the depth in the
+       * model at that point. Without a fallback world, the point has to be
+       * within the region of the grid.
+       */
+      double temperature(const std::array<double,3> &point,
+                         const double depth) const;
+
+      /**
+       * Returns the value of a baked composition at a 3d Cartesian point and
+       * the depth in the model at that point. Without a fallback world, the
+       * point has to be within the region of the grid.
+       */
+      double composition(const std::array<double,3> &point,
+                         const double depth,
+                         const unsigned int composition_number) const;
+
+      /**
+       * Returns whether the given 3d Cartesian point and depth lie within
+       * the region of the grid.
+       */
+      bool contains(const std::array<double,3> &point,
+                    const double depth) const;
+
+    private:
+      /**
+       * The location of a query in the grid: the cell and the position
+       * within the cell, between zero and one, in each direction.
+       */
+      struct GridLocation
+      {
+        std::array<size_t,3> cell;
+        std::array<double,3> fraction;
+      };
+
+      /**
+       * Finds the location of the given point and depth in the grid. Returns
+       * false if it lies outside of the region.
+       */
+      bool locate(const std::array<double,3> &point,
+                  const double depth,
+                  GridLocation &location) const;
+
+      /**
+       * Returns the index of a grid point in the value arrays.
+       */
+      size_t point_index(const size_t i, const size_t j, const size_t k) const;
+
+      /**
+       * Returns the index of a cell in near_interface.
+       */
+      size_t cell_index(const std::array<size_t,3> &cell) const;
+
+      /**
+       * Interpolates the values with the given stride and offset trilinearly
+       * at the location.
+       */
+      double interpolate(const std::vector<double> &values,
+                         const size_t stride,
+                         const size_t offset,
+                         const GridLocation &location) const;
+
+      CoordinateSystem coordinate_system;
+      std::array<double,2> min_surface;
+      std::array<double,2> max_surface;
+      double min_depth;
+      double max_depth;
+      std::array<size_t,3> n_points;
+      std::array<double,3> spacing;
+      double gravity_norm;
+
+      /**
+       * The baked composition numbers, in the order in which they are
+       * stored in compositions.
+       */
+      std::vector<unsigned int> composition_numbers;
+
+      /**
+       * The temperature at every grid point.
+       */
+      std::vector<double> temperatures;
+
+      /**
+       * The compositions at every grid point. The compositions of a grid
+       * point are stored next to each other.
+       */
+      std::vector<double> compositions;
+
+      /**
+       * Whether a cell is near a change in composition.
+       */
+      std::vector<unsigned char> near_interface;
+
+      CompositionInterpolation composition_interpolation;
+      const World *fallback_world;
+  };
+}
+
+#endif
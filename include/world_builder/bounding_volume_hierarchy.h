@@ -0,0 +1,118 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_bounding_volume_hierarchy_h
+#define _world_builder_bounding_volume_hierarchy_h
+
+#include <array>
+#include <vector>
+
+namespace WorldBuilder
+{
+  /**
+   * An axis aligned box in the surface part of the natural coordinates and
+   * in depth. A default constructed box contains everything.
+   */
+  struct BoundingBox
+  {
+    /**
+     * Constructor, creating a box which contains everything.
+     */
+    BoundingBox();
+
+    /**
+     * Returns whether the given point in the surface part of the natural
+     * coordinates and depth lies within the box. If spherical is true, the
+     * longitude of the point is also checked shifted by 2 pi, in the same way
+     * as Utilities::polygon_contains_point does.
+     */
+    bool contains(const std::array<double,2> &surface_point,
+                  const double depth,
+                  const bool spherical) const;
+
+    /**
+     * Enlarges this box so that it also contains the given box.
+     */
+    void extend(const BoundingBox &other);
+
+    std::array<double,2> min_surface;
+    std::array<double,2> max_surface;
+    double min_depth;
+    double max_depth;
+  };
+
+  /**
+   * A bounding volume hierarchy over a list of bounding boxes. It returns
+   * the indices of all the boxes which contain a point, in increasing order,
+   * with a cost which scales with the number of boxes which overlap the point
+   * instead of with the total number of boxes.
+   */
+  class BoundingVolumeHierarchy
+  {
+    public:
+      /**
+       * Constructor, creating an empty hierarchy.
+       */
+      BoundingVolumeHierarchy();
+
+      /**
+       * Builds the hierarchy for the given boxes. The indices returned by
+       * query refer to the position of the boxes in this vector.
+       */
+      void build(const std::vector<BoundingBox> &boxes,
+                 const bool spherical);
+
+      /**
+       * Fills the candidates with the indices of the boxes which contain the
+       * given point, sorted in increasing order.
+       */
+      void query(const std::array<double,2> &surface_point,
+                 const double depth,
+                 std::vector<size_t> &candidates) const;
+
+    private:
+      /**
+       * A node of the tree. A node is a leaf when count is not zero, in which
+       * case it stores the boxes indices[first] to indices[first+count-1].
+       * Otherwise its children are stored at first and first+1.
+       */
+      struct Node
+      {
+        BoundingBox box;
+        size_t first;
+        size_t count;
+      };
+
+      /**
+       * Recursively builds the node with the given index for the indices
+       * from begin to end.
+       */
+      void build_node(const size_t node_index,
+                      const size_t begin,
+                      const size_t end,
+                      const std::vector<std::array<double,2> > &centers);
+
+      std::vector<BoundingBox> boxes;
+      std::vector<Node> nodes;
+      std::vector<size_t> indices;
+      bool spherical;
+  };
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include <world_builder/features/interface.h>
 #include <world_builder/world.h>
 #include <world_builder/types/segment.h>
+#include <world_builder/utilities.h>
 
 #include <world_builder/features/fault_models/temperature/interface.h>
 #include <world_builder/features/fault_models/composition/interface.h>
@@ -70,6 +71,7 @@ namespace WorldBuilder
          * gravity and current temperature.
          */
         double temperature(const Point<3> &position,
+                           const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                            const double depth,
                            const double gravity,
                            double temperature) const override final;
@@ -81,6 +83,7 @@ namespace WorldBuilder
          * of that composition at this location and depth.
          */
         double composition(const Point<3> &position,
+                           const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                            const double depth,
                            const unsigned int composition_number,
                            double composition_value) const override final;
@@ -94,13 +97,77 @@ namespace WorldBuilder
         virtual
         WorldBuilder::grains
         grains(const Point<3> &position,
+               const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                const double depth,
                const unsigned int composition_number,
                WorldBuilder::grains value) const override final;
 
+        /**
+         * Updates the temperature, the requested compositions and the requested
+         * grains in the properties while computing the geometry of this feature
+         * only once.
+         */
+        void properties(const Point<3> &position,
+                        const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                        const double depth,
+                        const double gravity,
+                        const std::vector<unsigned int> &composition_numbers,
+                        const std::vector<unsigned int> &grains_composition_numbers,
+                        WorldBuilder::properties &properties) const override final;
+
+        /**
+         * Updates the properties of a column of points. The part of the
+         * distance to the curved planes which only depends on the surface
+         * coordinates is computed once for the whole column.
+         */
+        void properties_column(const std::vector<Point<3> > &positions,
+                               const std::vector<WorldBuilder::Utilities::NaturalCoordinate> &natural_coordinates,
+                               const std::vector<double> &depths,
+                               const double gravity,
+                               const std::vector<unsigned int> &composition_numbers,
+                               const std::vector<unsigned int> &grains_composition_numbers,
+                               std::vector<WorldBuilder::properties> &properties) const override final;
+
 
 
       private:
+        /**
+         * Updates the properties of a point. This is shared by all the
+         * functions which compute the properties of a single point, so that
+         * the geometry of this feature is only implemented once. The
+         * temperature is only updated when it is not a null pointer. The
+         * n_compositions compositions and n_grains grains are updated in
+         * place, so that the functions for a single property can pass their
+         * value directly instead of building a properties object.
+         */
+        void properties_at_point(const Point<3> &position,
+                                 const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                                 const double depth,
+                                 const double gravity,
+                                 double *temperature,
+                                 const size_t n_compositions,
+                                 const unsigned int *composition_numbers,
+                                 double *compositions,
+                                 const size_t n_grains,
+                                 const unsigned int *grains_composition_numbers,
+                                 WorldBuilder::grains *grains) const;
+
+        /**
+         * Updates the properties of a point from its distance to the curved
+         * planes of this feature, in the same way as properties_at_point.
+         */
+        void properties_from_distance(const Point<3> &position,
+                                      const double depth,
+                                      const double gravity,
+                                      WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance_from_planes,
+                                      double *temperature,
+                                      const size_t n_compositions,
+                                      const unsigned int *composition_numbers,
+                                      double *compositions,
+                                      const size_t n_grains,
+                                      const unsigned int *grains_composition_numbers,
+                                      WorldBuilder::grains *grains) const;
+
         std::vector<std::shared_ptr<Features::FaultModels::Temperature::Interface> > default_temperature_models;
         std::vector<std::shared_ptr<Features::FaultModels::Composition::Interface>  > default_composition_models;
         std::vector<std::shared_ptr<Features::FaultModels::Grains::Interface>  > default_grains_models;
@@ -159,6 +226,13 @@ namespace WorldBuilder
         double maximum_total_slab_length;
         double maximum_slab_thickness;
 
+        /**
+         * The point independent part of the geometry of the fault, which
+         * is computed once in parse_entries and reused for every point
+         * by distance_point_from_curved_planes.
+         */
+        WorldBuilder::Utilities::CurvedPlanesGeometry curved_planes_geometry;
+
 
     };
   }
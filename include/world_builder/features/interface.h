@@ -20,12 +20,16 @@
 #ifndef _world_builder_features_interface_h
 #define _world_builder_features_interface_h
 
+#include <array>
 #include <map>
 #include <vector>
 
+#include <world_builder/bounding_volume_hierarchy.h>
 #include <world_builder/world.h>
 #include <world_builder/parameters.h>
 #include <world_builder/point.h>
+#include <world_builder/properties.h>
+#include <world_builder/utilities.h>
 
 namespace WorldBuilder
 {
@@ -85,19 +89,44 @@ namespace WorldBuilder
 
 
         /**
-         * takes temperature and position and returns a temperature.
+         * takes temperature and position and returns a temperature. This
+         * converts the position to natural coordinates and calls the
+         * function below.
+         */
+        double temperature(const Point<3> &position,
+                           const double depth,
+                           const double gravity,
+                           double temperature) const;
+
+        /**
+         * takes temperature and position, both in Cartesian and in natural
+         * coordinates, and returns a temperature. The world converts the
+         * position only once to natural coordinates for all the features.
          */
         virtual
         double temperature(const Point<3> &position,
+                           const Utilities::NaturalCoordinate &natural_coordinate,
                            const double depth,
                            const double gravity,
                            double temperature) const = 0;
+
         /**
          * Returns a value for the requested composition (0 is not present,
          * 1 is present) based on the given position and
          */
+        double composition(const Point<3> &position,
+                           const double depth,
+                           const unsigned int composition_number,
+                           double value) const;
+
+        /**
+         * Returns a value for the requested composition (0 is not present,
+         * 1 is present) based on the given position, both in Cartesian and
+         * in natural coordinates.
+         */
         virtual
         double composition(const Point<3> &position,
+                           const Utilities::NaturalCoordinate &natural_coordinate,
                            const double depth,
                            const unsigned int composition_number,
                            double value) const = 0;
@@ -106,12 +135,87 @@ namespace WorldBuilder
          * Returns a value for the requested grains based on the
          * given position and composition number
          */
+        WorldBuilder::grains grains(const Point<3> &position,
+                                    const double depth,
+                                    const unsigned int composition_number,
+                                    WorldBuilder::grains value) const;
+
+        /**
+         * Returns a value for the requested grains based on the given
+         * position, both in Cartesian and in natural coordinates, and
+         * composition number
+         */
         virtual
         WorldBuilder::grains grains(const Point<3> &position,
+                                    const Utilities::NaturalCoordinate &natural_coordinate,
                                     const double depth,
                                     const unsigned int composition_number,
                                     WorldBuilder::grains value) const = 0;
 
+        /**
+         * Updates the temperature, the requested compositions and the
+         * requested grains in one go based on the given position. The
+         * compositions and grains in the properties are ordered in the same
+         * way as the composition_numbers and grains_composition_numbers.
+         * This converts the position to natural coordinates and calls the
+         * function below.
+         */
+        void properties(const Point<3> &position,
+                        const double depth,
+                        const double gravity,
+                        const std::vector<unsigned int> &composition_numbers,
+                        const std::vector<unsigned int> &grains_composition_numbers,
+                        WorldBuilder::properties &properties) const;
+
+        /**
+         * Updates the temperature, the requested compositions and the
+         * requested grains in one go based on the given position, both in
+         * Cartesian and in natural coordinates.
+         * Features can override this to compute their geometry only once for
+         * all properties. The default implementation calls the temperature,
+         * composition and grains functions.
+         */
+        virtual
+        void properties(const Point<3> &position,
+                        const Utilities::NaturalCoordinate &natural_coordinate,
+                        const double depth,
+                        const double gravity,
+                        const std::vector<unsigned int> &composition_numbers,
+                        const std::vector<unsigned int> &grains_composition_numbers,
+                        WorldBuilder::properties &properties) const;
+
+        /**
+         * Updates the properties of a column of points, which all have the
+         * same surface coordinates but a different depth. The positions,
+         * natural coordinates, depths and properties are ordered in the same
+         * way. Features can override this to compute the part of their
+         * geometry which only depends on the surface coordinates once for the
+         * whole column. The default implementation calls the properties
+         * function for every point within the bounding box of this feature.
+         */
+        virtual
+        void properties_column(const std::vector<Point<3> > &positions,
+                               const std::vector<Utilities::NaturalCoordinate> &natural_coordinates,
+                               const std::vector<double> &depths,
+                               const double gravity,
+                               const std::vector<unsigned int> &composition_numbers,
+                               const std::vector<unsigned int> &grains_composition_numbers,
+                               std::vector<WorldBuilder::properties> &properties) const;
+
+
+        /**
+         * Returns whether the given point, in the surface part of the natural
+         * coordinates, and depth lie within the bounding box of this feature.
+         * The bounding box is conservative: when it returns false, the feature
+         * does not change any property of the point, so the world can skip it.
+         */
+        bool bounding_box_contains(const std::array<double,2> &surface_point,
+                                   const double depth) const;
+
+        /**
+         * Returns the bounding box of this feature.
+         */
+        const BoundingBox &get_bounding_box() const;
 
         /**
          * A function to register a new type. This is part of the automatic
@@ -167,6 +271,30 @@ namespace WorldBuilder
         std::vector<double> one_dimensional_coordinates;
 
 
+        /**
+         * Sets the bounding box of this feature from the coordinates. The
+         * surface part of the bounding box is enlarged by the surface margin
+         * in every direction. A surface margin of infinity disables the surface
+         * part of the bounding box. This should be called at the end of
+         * parse_entries by features which know their extent.
+         */
+        void set_bounding_box(const double min_depth,
+                              const double max_depth,
+                              const double surface_margin);
+
+        /**
+         * The bounding box of the feature in the surface part of the natural
+         * coordinates and in depth. By default it contains everything.
+         */
+        BoundingBox bounding_box;
+
+        /**
+         * Whether the surface coordinates are spherical, in which case the
+         * longitude of the point is also checked shifted by 2 pi, in the same
+         * way as Utilities::polygon_contains_point does.
+         */
+        bool bounding_box_spherical;
+
         /**
          * The name of the temperature submodule used by this feature.
          */
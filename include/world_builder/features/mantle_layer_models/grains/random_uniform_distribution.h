@@ -21,6 +21,7 @@
 #define _world_builder_features_mantle_layer_grains_random_uniform_distribution_h
 
 #include <world_builder/features/mantle_layer_models/grains/interface.h>
+#include <world_builder/random_number_generator.h>
 #include <world_builder/world.h>
 
 namespace WorldBuilder
@@ -99,6 +100,13 @@ namespace WorldBuilder
             std::string operation;
             std::vector<double> grain_sizes;
             std::vector<bool> normalize_grain_sizes;
+
+            /**
+             * The stream of the random numbers of this model, which is
+             * computed from its path in the world builder file. Other random
+             * grains models at the same position draw different numbers.
+             */
+            std::uint64_t random_number_stream;
         };
       } // namespace Grains
     }   // namespace MantleLayerModels
@@ -70,6 +70,7 @@ namespace WorldBuilder
          * gravity and current temperature.
          */
         double temperature(const Point<3> &position,
+                           const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                            const double depth,
                            const double gravity,
                            double temperature) const override final;
@@ -82,6 +83,7 @@ namespace WorldBuilder
          * of that composition at this location and depth.
          */
         double composition(const Point<3> &position,
+                           const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                            const double depth,
                            const unsigned int composition_number,
                            double value) const override final;
@@ -96,13 +98,52 @@ namespace WorldBuilder
         virtual
         WorldBuilder::grains
         grains(const Point<3> &position,
+               const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                const double depth,
                const unsigned int composition_number,
                WorldBuilder::grains value) const override final;
 
+        /**
+         * Updates the temperature, the requested compositions and the requested
+         * grains in the properties while computing the geometry of this feature
+         * only once.
+         */
+        void properties(const Point<3> &position,
+                        const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                        const double depth,
+                        const double gravity,
+                        const std::vector<unsigned int> &composition_numbers,
+                        const std::vector<unsigned int> &grains_composition_numbers,
+                        WorldBuilder::properties &properties) const override final;
+
+        /**
+         * Updates the properties of a column of points. The polygon is only
+         * checked once for the whole column.
+         */
+        void properties_column(const std::vector<Point<3> > &positions,
+                               const std::vector<WorldBuilder::Utilities::NaturalCoordinate> &natural_coordinates,
+                               const std::vector<double> &depths,
+                               const double gravity,
+                               const std::vector<unsigned int> &composition_numbers,
+                               const std::vector<unsigned int> &grains_composition_numbers,
+                               std::vector<WorldBuilder::properties> &properties) const override final;
+
 
 
       private:
+        /**
+         * Updates the properties of a point which lies within the polygon and
+         * between the minimum and maximum depth of this feature. The temperature
+         * is only updated when compute_temperature is true.
+         */
+        void properties_inside(const Point<3> &position,
+                               const double depth,
+                               const double gravity,
+                               const bool compute_temperature,
+                               const std::vector<unsigned int> &composition_numbers,
+                               const std::vector<unsigned int> &grains_composition_numbers,
+                               WorldBuilder::properties &properties) const;
+
         /**
          * A vector containing all the pointers to the temperature models. This vector is
          * responsible for the features and has ownership over them. Therefore
@@ -129,6 +170,12 @@ namespace WorldBuilder
 
         double min_depth;
         double max_depth;
+
+        /**
+         * The polygon of the coordinates of the feature, prepared in
+         * parse_entries for the point in polygon tests.
+         */
+        WorldBuilder::Utilities::Polygon polygon;
     };
   }
 }
@@ -26,6 +26,8 @@
 #include <world_builder/world.h>
 #include <world_builder/parameters.h>
 #include <world_builder/point.h>
+#include <world_builder/properties.h>
+#include <world_builder/utilities.h>
 
 
 namespace WorldBuilder
@@ -84,6 +86,23 @@ namespace WorldBuilder
                                    double temperature,
                                    const double feature_min_depth,
                                    const double feature_max_depth) const = 0;
+
+            /**
+             * takes a column of points which share the same surface position
+             * and sets the temperature of every point within the feature depth
+             * range. The default implementation calls get_temperature for each
+             * point; models which depend on the surface position can override
+             * it to only compute that part once per column.
+             */
+            virtual
+            void get_temperatures(const std::vector<Point<3> > &positions,
+                                  const std::vector<WorldBuilder::Utilities::NaturalCoordinate> &natural_coordinates,
+                                  const std::vector<double> &depths,
+                                  const double gravity,
+                                  const double feature_min_depth,
+                                  const double feature_max_depth,
+                                  std::vector<WorldBuilder::properties> &properties) const;
+
             /**
              * A function to register a new type. This is part of the automatic
              * registration of the object factory.
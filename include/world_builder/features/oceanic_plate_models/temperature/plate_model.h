@@ -75,8 +75,37 @@ namespace WorldBuilder
                                    const double feature_min_depth,
                                    const double feature_max_depth) const override final;
 
+            /**
+             * Sets the temperatures of a column of points which share the same
+             * surface position. The distance to the ridge is only computed once
+             * for the whole column.
+             */
+            void get_temperatures(const std::vector<Point<3> > &positions,
+                                  const std::vector<WorldBuilder::Utilities::NaturalCoordinate> &natural_coordinates,
+                                  const std::vector<double> &depths,
+                                  const double gravity,
+                                  const double feature_min_depth,
+                                  const double feature_max_depth,
+                                  std::vector<WorldBuilder::properties> &properties) const override final;
+
 
           private:
+            /**
+             * Returns the distance along the surface to the closest ridge segment
+             * for the given surface coordinates, measured at the given depth
+             * coordinate (the radius for spherical coordinate systems).
+             */
+            double distance_to_ridge(const std::array<double,2> &surface_coordinates,
+                                     const double depth_coordinate) const;
+
+            /**
+             * Returns the plate model temperature at the given depth for a point
+             * at the given distance from the ridge.
+             */
+            double plate_temperature(const double depth,
+                                     const double gravity_norm,
+                                     const double distance_ridge) const;
+
             // plate model temperature submodule parameters
             double min_depth;
             double max_depth;
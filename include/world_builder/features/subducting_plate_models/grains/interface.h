@@ -26,6 +26,7 @@
 #include <world_builder/world.h>
 #include <world_builder/parameters.h>
 #include <world_builder/point.h>
+#include <world_builder/utilities.h>
 
 
 namespace WorldBuilder
@@ -85,7 +86,7 @@ namespace WorldBuilder
                        WorldBuilder::grains grains,
                        const double feature_min_depth,
                        const double feature_max_depth,
-                       const std::map<std::string,double> &distance_from_planes) const = 0;
+                       const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const = 0;
             /**
              * A function to register a new type. This is part of the automatic
              * registration of the object factory.
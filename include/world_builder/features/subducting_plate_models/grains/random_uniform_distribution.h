@@ -21,6 +21,7 @@
 #define _world_builder_features_subducting_plate_grains_random_uniform_distribution_h
 
 #include <world_builder/features/subducting_plate_models/grains/interface.h>
+#include <world_builder/random_number_generator.h>
 #include <world_builder/world.h>
 
 namespace WorldBuilder
@@ -90,7 +91,7 @@ namespace WorldBuilder
                        WorldBuilder::grains grains,
                        const double feature_min_depth,
                        const double feature_max_depth,
-                       const std::map<std::string,double> &distance_from_planes) const override final;
+                       const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const override final;
 
           private:
             // uniform grains submodule parameters
@@ -101,6 +102,13 @@ namespace WorldBuilder
             std::string operation;
             std::vector<double> grain_sizes;
             std::vector<bool> normalize_grain_sizes;
+
+            /**
+             * The stream of the random numbers of this model, which is
+             * computed from its path in the world builder file. Other random
+             * grains models at the same position draw different numbers.
+             */
+            std::uint64_t random_number_stream;
         };
       } // namespace Grains
     }   // namespace SubductingPlateModels
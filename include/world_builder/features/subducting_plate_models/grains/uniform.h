@@ -90,7 +90,7 @@ namespace WorldBuilder
                        WorldBuilder::grains grains,
                        const double feature_min_depth,
                        const double feature_max_depth,
-                       const std::map<std::string,double> &distance_from_planes) const override final;
+                       const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const override final;
 
           private:
             // uniform grains submodule parameters
@@ -25,6 +25,7 @@
 #include <unordered_map>
 #include <map>
 #include <memory>
+#include <utility>
 
 
 #include <rapidjson/document.h>
@@ -58,6 +59,7 @@ namespace WorldBuilder
   }
 
   class World;
+  class SchemaDeclarations;
 
   /**
    * A class to hold all the parameters needed by the world builder. Internally
@@ -88,12 +90,95 @@ namespace WorldBuilder
       ~Parameters();
 
       /**
-       * Initializes the parameter file
+       * Initializes the parameter file and validates it against the schema
+       * of the shared declarations if they are set, or else against the
+       * schema of the declarations of this class.
        * \param filename A string with the path to the world builder file
-       * \param has_output_dir A bool indicating whether the world builder may write out information.
-       * \param output_dir A string with the path to the directory where it can output information if allowed by has_output_dir
        */
-      void initialize(std::string &filename, bool has_output_dir = false, std::string output_dir = "");
+      void initialize(std::string &filename);
+
+      /**
+       * Initializes the parameters from the text of a world builder file in
+       * memory, in the same way as initialize does for a file. The text does
+       * not need to be null terminated and is not used after this function
+       * returns.
+       * \param json_text The text of the world builder file
+       * \param json_text_size The number of characters in the text
+       */
+      void initialize_from_buffer(const char *json_text, const size_t json_text_size);
+
+      /**
+       * Sets the declarations which are used to validate the world builder
+       * file and to look up the default values, instead of the declarations
+       * of this class. The shared declarations have to outlive this class.
+       */
+      void set_shared_declarations(const SchemaDeclarations &shared_declarations);
+
+      /**
+       * Returns whether there are declarations to look up default values in,
+       * either the shared declarations or the declarations of this class. A
+       * world which is read from a compiled world has neither, so any lookup
+       * of a default value would fail.
+       */
+      bool has_declarations() const;
+
+      /**
+       * Releases the parsed parameters and the text of the world builder
+       * file. This is done by the world once it has parsed all the entries,
+       * because the values are stored in the world and the features after
+       * that. No parameters can be retrieved after this function is called.
+       */
+      void release_parameters();
+
+      /**
+       * Makes the get functions write every default value which they take
+       * from the declarations into the parameters, so that the parameters
+       * can be written to a compiled world file and parsed without the
+       * declarations. This is off by default, because only compiling a world
+       * needs it.
+       */
+      void write_default_values_on_get();
+
+      /**
+       * Returns whether the given file is a compiled world file, written by
+       * write_compiled_world. A file which is not a regular file, such as a
+       * pipe, can only be read once, so it is not checked here and false is
+       * returned. The initialize function recognizes a compiled world in
+       * such a file once it has been read.
+       */
+      static
+      bool is_compiled_world_file(const std::string &filename);
+
+      /**
+       * Returns whether the given buffer contains a compiled world, written
+       * by write_compiled_world.
+       */
+      static
+      bool is_compiled_world_buffer(const char *buffer, const size_t buffer_size);
+
+      /**
+       * Initializes the parameters from a compiled world file. The file
+       * contains the parameters with all the default values filled in, so
+       * no declarations are needed and the parameters are not validated
+       * again.
+       * \param filename A string with the path to the compiled world file
+       */
+      void initialize_from_compiled_world(const std::string &filename);
+
+      /**
+       * Initializes the parameters from a compiled world in memory, for
+       * example the contents of a compiled world file which have been
+       * received from another process.
+       */
+      void initialize_from_compiled_world_buffer(const char *buffer, const size_t buffer_size);
+
+      /**
+       * Writes the parameters to a compiled world file. This should be done
+       * after the parameters have been parsed, because the default values
+       * which are used are only added to the parameters while parsing.
+       * \param filename A string with the path to the compiled world file
+       */
+      void write_compiled_world(const std::string &filename) const;
 
       /**
        * A generic get function to retrieve setting from the parameter file.
@@ -279,7 +364,103 @@ namespace WorldBuilder
       //std::string get_full_path_without_arrays() const;
 
     private:
+      /**
+       * Returns the shared declarations if they are set, and otherwise the
+       * declarations of this class.
+       */
+      const rapidjson::Document &get_declarations() const;
+
+      /**
+       * The declarations which are shared between the worlds, or a null
+       * pointer if the declarations of this class are used.
+       */
+      const SchemaDeclarations *shared_declarations;
 
+      /**
+       * Whether the get functions write the default values they use into
+       * the parameters. See write_default_values_on_get.
+       */
+      bool write_default_values;
+
+      /**
+       * The text of the world builder file, which is kept while the document
+       * with the parameters points into it.
+       */
+      struct InsituBuffer;
+      std::unique_ptr<InsituBuffer> insitu_buffer;
+
+      /**
+       * Checks the result of parsing the world builder file and validates it
+       * against the schema. The text is only used in the error messages.
+       */
+      void validate_parsed_parameters(const char *json_text, const size_t json_text_size);
+
+      /**
+       * Reads a compiled world from the buffer. The source describes where
+       * the buffer comes from and is only used in the error messages.
+       */
+      void read_compiled_world(const char *buffer, const size_t buffer_size, const std::string &source);
+
+      /**
+       * Resets the cursors to the current path, which is needed when the
+       * parameters or the declarations are replaced.
+       */
+      void reset_cursors();
+
+      /**
+       * Returns the value in the parameters at the first depth entries of
+       * the path, or a null pointer if it does not exist.
+       */
+      rapidjson::Value *get_value_at_depth(const size_t depth) const;
+
+      /**
+       * Returns the value in the parameters with the given name, relative
+       * to the current path, or a null pointer if it does not exist. The
+       * name may contain several levels separated by a slash.
+       */
+      rapidjson::Value *get_value(const std::string &name) const;
+
+      /**
+       * Returns the node in the declarations which describes the entries at
+       * the current path, or a null pointer if it does not exist. This is
+       * the same node as the one get_full_json_schema_path() points to.
+       */
+      const rapidjson::Value *get_current_declaration() const;
+
+      /**
+       * Returns the node in the declarations with the given name, relative
+       * to get_current_declaration(), or a null pointer if it does not
+       * exist. The name may contain several levels separated by a slash.
+       */
+      const rapidjson::Value *get_declaration(const std::string &name) const;
+
+      /**
+       * The values in the parameters at every level of the path, starting
+       * with the root of the parameters. These are found when a subsection
+       * is entered, so that the get functions do not have to look up the
+       * whole path again. A null pointer means that the value did not exist
+       * yet when the subsection was entered, in which case it is looked up
+       * again from the closest existing parent.
+       */
+      std::vector<rapidjson::Value *> value_cursor;
+
+      /**
+       * The nodes in the declarations for the levels of the path for which
+       * they have been looked up, together with the number of entries of
+       * the path they belong to. An array with several possible types uses
+       * two entries of the path at once, so not every level has a node.
+       * These are only looked up when a default value is needed.
+       */
+      mutable std::vector<std::pair<size_t, const rapidjson::Value *> > declaration_cursor;
+
+      /**
+       * Adds a default value, which was taken from the declarations, to the
+       * parameters, so that the parameters contain every value which was
+       * used. This allows a compiled world to be parsed without the
+       * declarations. This only happens after write_default_values_on_get
+       * has been called.
+       */
+      void set_default_value(const std::string &name, const rapidjson::Value &value);
 
       /**
        * This is used for the get relative path functions. It stores how many
@@ -22,7 +22,9 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <array>
+#include <limits>
 
+#include <world_builder/assert.h>
 #include <world_builder/coordinate_system.h>
 
 namespace WorldBuilder
@@ -32,6 +34,9 @@ namespace WorldBuilder
    * and the coordinate system which the coordinates can be used for. It also
    * implements several operations such as the computation of the l2 norm and the
    * dot product.
+   *
+   * All the functions are defined in this header, so that the compiler can
+   * inline them into the geometry functions. The class is trivially copyable.
    */
   template<int dim>
   class Point
@@ -41,122 +46,207 @@ namespace WorldBuilder
        * Constructor. Constructs a Point at (0,0) in 2d or (0,0,0) in 3d
        * with a Cartesian coordinate system.
        */
-      Point(CoordinateSystem coordinate_system);
+      constexpr
+      Point(const CoordinateSystem coordinate_system_)
+        :
+        point(),
+        coordinate_system(coordinate_system_)
+      {}
 
       /**
        * Constructor. Constructs a Point from a std::array<double,dim> and
        * a coordinate system.
        */
-      Point(const std::array<double,dim> &location, CoordinateSystem coordinate_system);
+      constexpr
+      Point(const std::array<double,dim> &location, const CoordinateSystem coordinate_system_)
+        :
+        point(location),
+        coordinate_system(coordinate_system_)
+      {}
 
       /**
        * Constructor. Constructs a Point from an other Point and
        * a coordinate system.
        */
-      Point(const Point<dim> &point, CoordinateSystem coordinate_system);
-
-      /**
-       * Constructor. Constructs a Point from an other Point.
-       */
-      Point(const Point<dim> &point);
+      constexpr
+      Point(const Point<dim> &point_, const CoordinateSystem coordinate_system_)
+        :
+        point(point_.point),
+        coordinate_system(coordinate_system_)
+      {}
 
       /**
        * Constructor. Constructs a 2d Point from two doubles and
        * a coordinate system.
        */
-      Point(const double x, const double y, CoordinateSystem coordinate_system);
+      Point(const double x, const double y, const CoordinateSystem coordinate_system);
 
       /**
        * Constructor. Constructs a 3d Point from three doubles and
        * a coordinate system.
        */
-      Point(const double x, const double y, const double z, CoordinateSystem coordinate_system);
-
-      /**
-       * Destructor
-       */
-      ~Point();
-
-      Point<dim> &operator=(const Point<dim> &point);
+      Point(const double x, const double y, const double z, const CoordinateSystem coordinate_system);
 
       /**
        * dot product
        */
-      double operator*(const Point<dim> &point) const;
+      inline
+      double operator*(const Point<dim> &point_) const
+      {
+        double dot_product = 0;
+        for (unsigned int i = 0; i < dim; ++i)
+          dot_product += point[i] * point_.point[i];
+        return dot_product;
+      }
 
 
       /**
        * Multiply the vector with a scalar
        */
-      Point<dim> operator*(const double scalar) const;
+      inline
+      Point<dim> operator*(const double scalar) const
+      {
+        Point<dim> point_tmp(*this);
+        point_tmp *= scalar;
+        return point_tmp;
+      }
 
       /**
        * Divide the vector through a scalar
        */
-      Point<dim> operator/(const double scalar) const;
+      inline
+      Point<dim> operator/(const double scalar) const
+      {
+        Point<dim> point_tmp(*this);
+        point_tmp *= 1/scalar;
+        return point_tmp;
+      }
 
       /**
        * add two points
        */
-      Point<dim> operator+(const Point<dim> &point) const;
+      inline
+      Point<dim> operator+(const Point<dim> &point_) const
+      {
+        WBAssert(coordinate_system == point_.get_coordinate_system(),
+                 "Cannot add two points which represent different coordinate systems.");
+        Point<dim> point_tmp(*this);
+        point_tmp += point_;
+        return point_tmp;
+      }
 
 
       /**
        * Substract two points
        */
-      Point<dim> operator-(const Point<dim> &point) const;
+      inline
+      Point<dim> operator-(const Point<dim> &point_) const
+      {
+        WBAssert(coordinate_system == point_.get_coordinate_system(),
+                 "Cannot substract two points which represent different coordinate systems. Internal has type " << static_cast<int>(coordinate_system)
+                 << ", other point has type " << static_cast<int>(point_.get_coordinate_system()));
+        Point<dim> point_tmp(*this);
+        point_tmp -= point_;
+        return point_tmp;
+      }
 
 
 
       /**
        * Multiply the vector with a scalar
        */
-      Point<dim> &operator*=(const double scalar);
+      inline
+      Point<dim> &operator*=(const double scalar)
+      {
+        for (unsigned int i = 0; i < dim; ++i)
+          point[i] *= scalar;
+        return *this;
+      }
 
       /**
        * Divide the vector through a scalar
        */
-      Point<dim> &operator/=(const double scalar);
+      inline
+      Point<dim> &operator/=(const double scalar)
+      {
+        for (unsigned int i = 0; i < dim; ++i)
+          point[i] /= scalar;
+        return *this;
+      }
 
       /**
        * add two points
        */
-      Point<dim> &operator+=(const Point<dim> &point);
+      inline
+      Point<dim> &operator+=(const Point<dim> &point_)
+      {
+        for (unsigned int i = 0; i < dim; ++i)
+          point[i] += point_.point[i];
+        return *this;
+      }
 
 
       /**
        * substract two points
        */
-      Point<dim> &operator-=(const Point<dim> &point);
+      inline
+      Point<dim> &operator-=(const Point<dim> &point_)
+      {
+        for (unsigned int i = 0; i < dim; ++i)
+          point[i] -= point_.point[i];
+        return *this;
+      }
 
       /**
        * access index (const)
        */
-      const double &operator[](const unsigned int index) const;
+      inline
+      const double &operator[](const unsigned int index) const
+      {
+        WBAssert(index < dim, "Can't ask for element " << index << " in an point with dimension " << dim << ".");
+        return point[index];
+      }
 
 
       /**
        * access index
        */
-      double &operator[](const unsigned int index);
+      inline
+      double &operator[](const unsigned int index)
+      {
+        WBAssert(index < dim, "Can't ask for element " << index << " in an point with dimension " << dim << ".");
+        return point[index];
+      }
 
 
       /**
        * return the internal array which stores the point data.
        */
-      const std::array<double,dim> &get_array() const;
+      constexpr
+      const std::array<double,dim> &get_array() const
+      {
+        return point;
+      }
 
 
       /**
        * returns the coordinate system associated with the data.
        */
-      CoordinateSystem get_coordinate_system() const;
+      constexpr
+      CoordinateSystem get_coordinate_system() const
+      {
+        return coordinate_system;
+      }
 
 
       /**
       * Computes the L2 norm: sqrt(x_i * x_i + y_i * y_i + z_i * z_i) in 3d.
       */
-      double norm() const;
+      inline
+      double norm() const
+      {
+        return std::sqrt(this->norm_square());
+      }
 
 
       /**
@@ -172,10 +262,86 @@ namespace WorldBuilder
 
   };
 
+
+  template<>
+  inline
+  Point<2>::Point(const double x, const double y, const CoordinateSystem coordinate_system_)
+    :
+    point({{x,y}}),
+  coordinate_system(coordinate_system_)
+  {}
+
+  template<>
+  inline
+  Point<3>::Point(const double /*x*/, const double /*y*/, const CoordinateSystem coordinate_system_)
+    :
+    point({{std::numeric_limits<double>::signaling_NaN(),std::numeric_limits<double>::signaling_NaN(), std::numeric_limits<double>::signaling_NaN()}}),
+  coordinate_system(coordinate_system_)
+  {
+    WBAssertThrow(false,"Can't use the 2d constructor in 3d.");
+  }
+
+
+  template<>
+  inline
+  Point<2>::Point(const double /*x*/, const double /*y*/, const double /*z*/, const CoordinateSystem coordinate_system_)
+    :
+    point({{std::numeric_limits<double>::signaling_NaN(),std::numeric_limits<double>::signaling_NaN()}}),
+  coordinate_system(coordinate_system_)
+  {
+    WBAssertThrow(false,"Can't use the 3d constructor in 2d.");
+  }
+
+
+  template<>
+  inline
+  Point<3>::Point(const double x, const double y, const double z, const CoordinateSystem coordinate_system_)
+    :
+    point({{x,y,z}}),
+  coordinate_system(coordinate_system_)
+  {}
+
+
+  template<>
+  inline
+  double
+  Point<2>::norm_square() const
+  {
+    return (point[0] * point[0]) + (point[1] * point[1]);
+  }
+
+  template<>
+  inline
+  double
+  Point<3>::norm_square() const
+  {
+    return (point[0] * point[0]) + (point[1] * point[1]) + (point[2] * point[2]);
+  }
+
+
+  /**
+   * Multiplies a point with a scalar.
+   */
   template<int dim>
-  Point<dim> operator*(const double scalar, const Point<dim> &point);
+  inline
+  Point<dim>
+  operator*(const double scalar, const Point<dim> &point)
+  {
+    return point*scalar;
+  }
 
+  /**
+   * Divides a scalar by a point: output_vector[i] = scalar / point[i].
+   */
   template<int dim>
-  Point<dim> operator/(const double scalar, const Point<dim> &point);
+  inline
+  Point<dim>
+  operator/(const double scalar, const Point<dim> &point)
+  {
+    std::array<double,dim> array;
+    for (unsigned int i = 0; i < dim; ++i)
+      array[i] = scalar / point[i];
+    return Point<dim>(array,point.get_coordinate_system());
+  }
 }
 #endif
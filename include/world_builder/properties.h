@@ -0,0 +1,47 @@
+/*
+  Copyright (C) 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_properties_h
+#define _world_builder_properties_h
+#include <vector>
+
+#include <world_builder/grains.h>
+
+namespace WorldBuilder
+{
+  /**
+   * This is a simple structure to store all the properties which can be
+   * computed at a single location in one go. The compositions and grains
+   * vectors store the values in the same order as the composition numbers
+   * which were requested.
+   */
+  struct properties
+  {
+    // The temperature
+    double temperature;
+
+    // The values of the requested compositions
+    std::vector<double> compositions;
+
+    // The grains of the requested grains compositions
+    std::vector<WorldBuilder::grains> grains;
+  };
+}
+
+#endif
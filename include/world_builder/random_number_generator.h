@@ -0,0 +1,94 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_random_number_generator_h
+#define _world_builder_random_number_generator_h
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <world_builder/point.h>
+
+namespace WorldBuilder
+{
+  /**
+   * A counter based random number generator, using the Philox4x32-10
+   * algorithm (Salmon et al., 2011, "Parallel random numbers: as easy as
+   * 1, 2, 3"). Instead of having a state which is changed by every draw,
+   * the random numbers are computed from a key and a counter. The key is
+   * made from the seed of the world and the counter from the position, the
+   * composition number, the stream of the model which draws the numbers and
+   * the number of the draw. The random numbers drawn for a query therefore
+   * only depend on the query and the model, and not on which
+   * queries were made before it or on which thread the query is made. This
+   * makes it safe to use from multiple threads at the same time.
+   */
+  class CounterBasedRandomNumberGenerator
+  {
+    public:
+      /**
+       * Constructor. The same seed, position, composition number and stream
+       * always give the same sequence of random numbers. Every model which
+       * draws random numbers should use its own stream, so that two models
+       * at the same position do not draw the same numbers, see
+       * get_stream().
+       */
+      CounterBasedRandomNumberGenerator(const unsigned long seed,
+                                        const Point<3> &position,
+                                        const unsigned int composition_number,
+                                        const std::uint64_t stream);
+
+      /**
+       * Returns a stream for the model at the given json path in the world
+       * builder file, for example /features/2/grains models/1. The path
+       * contains the index of the feature and of the model, so every model
+       * gets a different stream. The stream is computed from the characters
+       * of the path only, so it is the same on every platform.
+       */
+      static
+      std::uint64_t get_stream(const std::string &path);
+
+      /**
+       * Returns the next random number from a uniform distribution between 0
+       * (inclusive) and 1 (exclusive). The random numbers are computed with
+       * integer arithmetic only, so they are the same on every platform.
+       */
+      double uniform();
+
+    private:
+      /**
+       * Computes the next block of four random 32 bit integers from the
+       * counter and increases the counter.
+       */
+      void generate_block();
+
+      std::array<std::uint32_t,2> key;
+      std::array<std::uint32_t,4> counter;
+      std::array<std::uint32_t,4> block;
+
+      /**
+       * The number of 64 bit values which have been used from the current
+       * block.
+       */
+      unsigned int n_used;
+  };
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef _world_builder_schema_declarations_h
+#define _world_builder_schema_declarations_h
+
+#include <memory>
+#include <string>
+
+#include <rapidjson/document.h>
+#include "rapidjson/schema.h"
+
+namespace WorldBuilder
+{
+  class World;
+
+  /**
+   * The declarations of all the entries of a world builder file, which
+   * describe every registered plugin, and the json schema which is compiled
+   * from them. The declarations do not depend on the world builder file, so
+   * they are only built once per process, the first time a world builder
+   * file has to be validated, and are shared by all the worlds. The object
+   * is immutable after it has been built, so the worlds can use it from
+   * multiple threads at the same time.
+   */
+  class SchemaDeclarations
+  {
+    public:
+      /**
+       * Returns the declarations of this process, and builds them if this
+       * is the first call. The world is only needed to build the
+       * declarations and is not stored.
+       */
+      static
+      const SchemaDeclarations &get(World &world);
+
+      /**
+       * Returns the declarations as a json document.
+       */
+      const rapidjson::Document &get_declarations() const;
+
+      /**
+       * Returns the schema which is compiled from the declarations and is
+       * used to validate the world builder files.
+       */
+      const rapidjson::SchemaDocument &get_schema() const;
+
+      /**
+       * Writes the declarations to world_buider_declarations.tex and
+       * world_buider_declarations.schema.json in the output directory.
+       * \param output_dir A string with the path to the directory, which
+       * should end with a path separator.
+       */
+      void write(const std::string &output_dir) const;
+
+    private:
+      /**
+       * Constructor which builds the declarations through
+       * World::declare_entries.
+       */
+      explicit SchemaDeclarations(World &world);
+
+      rapidjson::Document declarations;
+      std::unique_ptr<rapidjson::SchemaDocument> schema;
+  };
+}
+
+#endif
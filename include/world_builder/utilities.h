@@ -61,6 +61,95 @@ namespace WorldBuilder
     polygon_contains_point_implementation(const std::vector<Point<2> > &point_list,
                                           const Point<2> &point);
 
+    /**
+     * A polygon which is prepared once for fast point in polygon tests. The
+     * edges are stored as a structure of arrays, with the start point and the
+     * direction of every edge precomputed, together with the bounding box of
+     * the polygon. The contains function gives the same answer as
+     * polygon_contains_point, except that edges of zero length are ignored.
+     * It tests the point and, for spherical
+     * coordinates, the point shifted by 2 pi in a single loop without
+     * branches, which the compiler can vectorize.
+     */
+    class Polygon
+    {
+      public:
+        /**
+         * Constructor, creating an empty polygon, which contains no points.
+         */
+        Polygon();
+
+        /**
+         * Constructor, creating the polygon from a list of points in the
+         * given natural coordinate system. If use_raster is true, a raster
+         * over the bounding box of the polygon is created, which stores for
+         * every cell whether it is completely inside, completely outside or
+         * crossed by the boundary of the polygon. The edges then only have to
+         * be tested for points in cells which are crossed by the boundary.
+         */
+        Polygon(const std::vector<Point<2> > &point_list,
+                const CoordinateSystem coordinate_system,
+                const bool use_raster = true);
+
+        /**
+         * Returns whether the point, in the surface part of the natural
+         * coordinates, lies within the polygon or on its boundary.
+         */
+        bool contains(const std::array<double,2> &point) const;
+
+      private:
+        /**
+         * Computes for one point whether it lies within the polygon or on its
+         * boundary.
+         */
+        bool contains_implementation(const double point_x,
+                                     const double point_y) const;
+
+        /**
+         * Computes for one point within the bounding box whether it lies within
+         * the polygon or on its boundary, using the raster when it is available.
+         */
+        bool raster_contains(const double point_x,
+                             const double point_y) const;
+
+        /**
+         * Fills the raster, after the edges and the bounding box are set.
+         */
+        void build_raster();
+
+        /**
+         * The classification of a cell of the raster.
+         */
+        enum CellType : unsigned char
+        {
+          cell_outside,
+          cell_inside,
+          cell_boundary
+        };
+
+        // The start point of every edge, the second coordinate of the end
+        // point and the vector from the start point to the end point.
+        std::vector<double> start_x;
+        std::vector<double> start_y;
+        std::vector<double> end_y;
+        std::vector<double> edge_x;
+        std::vector<double> edge_y;
+        std::vector<double> edge_squared_length;
+
+        // The bounding box of the polygon.
+        std::array<double,2> min_point;
+        std::array<double,2> max_point;
+
+        bool spherical;
+
+        // The number of cells and the size of the cells of the raster in both
+        // directions, and the classification of the cells, ordered by row. The
+        // raster is empty when it is not used.
+        std::array<size_t,2> n_cells;
+        std::array<double,2> cell_size;
+        std::vector<CellType> cells;
+    };
+
     /**
      * Given a 2d point and a list of points which form a polygon, compute the smallest
      * distance of the point to the polygon. The sign is negative for points outside of
@@ -93,7 +182,7 @@ namespace WorldBuilder
          * Returns the coordinates in the given coordinate system, which may
          * not be Cartesian.
          */
-        const std::array<double,3> &get_coordinates();
+        const std::array<double,3> &get_coordinates() const;
 
         /**
          * The coordinate that represents the 'surface' directions in the
@@ -107,6 +196,13 @@ namespace WorldBuilder
          */
         double get_depth_coordinate() const;
 
+        /**
+         * Sets the coordinate that represents the 'depth' direction in the
+         * chosen coordinate system, which moves the coordinate up or down
+         * without changing its surface coordinates.
+         */
+        void set_depth_coordinate(const double depth_coordinate);
+
         /**
          * get the coordinate system type of this coordinate.
          */
@@ -142,6 +238,25 @@ namespace WorldBuilder
     Point<3>
     spherical_to_cartesian_coordinates(const std::array<double,3> &scoord);
 
+    /**
+     * Returns the surface part of the natural coordinates of a Cartesian
+     * point in the given natural coordinate system, in the same way as
+     * NaturalCoordinate::get_surface_coordinates does.
+     */
+    std::array<double,2>
+    cartesian_to_natural_surface_coordinates(const std::array<double,3> &position,
+                                             const CoordinateSystem coordinate_system);
+
+    /**
+     * Returns the natural coordinates of a point in the given natural
+     * coordinate system from its surface coordinates and its depth
+     * coordinate.
+     */
+    std::array<double,3>
+    surface_to_natural_coordinates(const std::array<double,2> &surface_coordinates,
+                                   const double depth_coordinate,
+                                   const CoordinateSystem coordinate_system);
+
     /**
      * Returns ellipsoidal coordinates of a Cartesian point. The returned array
      * is filled with phi, theta and radius.
@@ -201,6 +316,38 @@ namespace WorldBuilder
      */
     Point<3> cross_product(const Point<3> &a, const Point<3> &b);
 
+    /**
+     * A struct which stores the results of the distance_point_from_curved_planes
+     * function. The local thickness is not computed by that function, but is
+     * filled in by the features which know the thickness of the plane.
+     */
+    struct PointDistanceFromCurvedPlanes
+    {
+      // The distance of the point to the plane.
+      double distance_from_plane;
+
+      // The distance along the plane from the surface to the closest point on the plane.
+      double distance_along_plane;
+
+      // The fraction of the section (horizontal) where the closest point on the plane is.
+      double fraction_of_section;
+
+      // The fraction of the segment (vertical) where the closest point on the plane is.
+      double fraction_of_segment;
+
+      // The section in which the closest point on the plane is.
+      size_t section;
+
+      // The segment in which the closest point on the plane is.
+      size_t segment;
+
+      // The average angle of the plane between the surface and the closest point on the plane.
+      double average_angle;
+
+      // The local thickness of the plane, set by the feature.
+      double local_thickness;
+    };
+
     /**
      * Computes the distance of a point to a curved plane.
      * TODO: add more info on how this works/is implemented.
@@ -236,15 +383,165 @@ namespace WorldBuilder
      * the original number. Note that no whole numbers may be skiped. So for a list of 4 points,
      * {0,0.5,1,2} is allowed, but {0,2,3,4} is not.
      */
-    std::map<std::string,double> distance_point_from_curved_planes(const Point<3> &point,
-                                                                   const Point<2> &reference_point,
-                                                                   const std::vector<Point<2> > &point_list,
-                                                                   const std::vector<std::vector<double> > &plane_segment_lengths,
-                                                                   const std::vector<std::vector<Point<2> > > &plane_segment_angles,
-                                                                   const double start_depth,
-                                                                   const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
-                                                                   const bool only_positive,
-                                                                   std::vector<double> global_x_list = {});
+    PointDistanceFromCurvedPlanes distance_point_from_curved_planes(const Point<3> &point,
+                                                                    const Point<2> &reference_point,
+                                                                    const std::vector<Point<2> > &point_list,
+                                                                    const std::vector<std::vector<double> > &plane_segment_lengths,
+                                                                    const std::vector<std::vector<Point<2> > > &plane_segment_angles,
+                                                                    const double start_depth,
+                                                                    const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                                                    const bool only_positive,
+                                                                    std::vector<double> global_x_list = {});
+
+    /**
+     * This class stores all the information which distance_point_from_curved_planes
+     * needs and which only depends on the definition of the curved planes and not on
+     * the point. Features which use curved planes can create it once when they are
+     * parsed, instead of recomputing it for every point.
+     */
+    class CurvedPlanesGeometry
+    {
+      public:
+        /**
+         * The information of a single section, which is the part of the
+         * curved planes between two consecutive points of the point list.
+         */
+        struct Section
+        {
+          Section(const Point<2> &P1, const Point<2> &P2);
+
+          // The first and second point of the section at the surface and the
+          // vector between them.
+          Point<2> P1;
+          Point<2> P1P2;
+          Point<2> unit_P1P2;
+          double P1P2_squared_norm;
+          double P1P2_norm;
+
+          // On what side of the line P1P2 the reference point is.
+          double reference_on_side_of_line;
+
+          // The original section and the position of this section in the
+          // one dimensional coordinates.
+          size_t original_current_section;
+          double global_x_fraction;
+          double global_x_length;
+        };
+
+        /**
+         * The information of a single segment of an original section. The
+         * changes are the difference with the same segment in the next
+         * original section.
+         */
+        struct Segment
+        {
+          double angle_top;
+          double angle_top_change;
+          double angle_bottom;
+          double angle_bottom_change;
+          double length;
+          double length_change;
+        };
+
+        /**
+         * Default constructor, creating an empty geometry.
+         */
+        CurvedPlanesGeometry();
+
+        /**
+         * Constructor. The arguments are the same as those with the same name of
+         * distance_point_from_curved_planes.
+         */
+        CurvedPlanesGeometry(const Point<2> &reference_point,
+                             const std::vector<Point<2> > &point_list,
+                             const std::vector<std::vector<double> > &plane_segment_lengths,
+                             const std::vector<std::vector<Point<2> > > &plane_segment_angles,
+                             const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                             std::vector<double> global_x_list = {});
+
+        /**
+         * The sections, one for every pair of consecutive points in the point list.
+         */
+        std::vector<Section> sections;
+
+        /**
+         * The segments for every original section.
+         */
+        std::vector<std::vector<Segment> > segments;
+
+        /**
+         * The natural coordinate system and the depth method of the coordinate system.
+         */
+        CoordinateSystem natural_coordinate_system;
+        DepthMethod depth_method;
+    };
+
+    /**
+     * Computes the distance of a point to a curved plane, in the same way as the
+     * function above, but with the parts which do not depend on the point already
+     * computed in the provided geometry. The point is provided both in Cartesian
+     * and in natural coordinates, so it does not have to be converted again.
+     * The coordinate system is taken from the geometry and only selects once
+     * between implementations which are compiled for a specific coordinate
+     * system, so no virtual functions are called for the point.
+     */
+    PointDistanceFromCurvedPlanes distance_point_from_curved_planes(const Point<3> &point,
+                                                                    const NaturalCoordinate &natural_coordinate,
+                                                                    const CurvedPlanesGeometry &geometry,
+                                                                    const double start_radius,
+                                                                    const bool only_positive);
+
+    /**
+     * The part of distance_point_from_curved_planes which only depends on the
+     * surface position of the point and the start radius. For each section of
+     * the curved planes next to the point, it stores the closest point on the
+     * line at the surface and the axes of the plane through it. It can be
+     * computed once for a column of points with the same surface position, so
+     * that only the part which depends on the depth is computed for every
+     * point in the column.
+     */
+    class CurvedPlanesColumn
+    {
+      public:
+        /**
+         * The part of a section which only depends on the surface position,
+         * in Cartesian coordinates.
+         */
+        struct Section
+        {
+          Section();
+
+          size_t section;
+          size_t original_section;
+          double fraction;
+          Point<3> closest_point_on_line;
+          Point<3> closest_point_on_line_bottom;
+          Point<3> x_axis;
+          Point<3> y_axis;
+          Point<2> begin_segment;
+        };
+
+        /**
+         * Constructor. The natural coordinate can be the natural coordinate of
+         * any point of the column.
+         */
+        CurvedPlanesColumn(const NaturalCoordinate &natural_coordinate,
+                           const CurvedPlanesGeometry &geometry,
+                           const double start_radius);
+
+        std::vector<Section> sections;
+    };
+
+    /**
+     * Computes the distance of a point to a curved plane, in the same way as the
+     * function above, but with the part which only depends on the surface
+     * position already computed in the provided column. The check point is in
+     * Cartesian coordinates.
+     */
+    PointDistanceFromCurvedPlanes distance_point_from_curved_planes(const Point<3> &point,
+                                                                    const CurvedPlanesColumn &column,
+                                                                    const CurvedPlanesGeometry &geometry,
+                                                                    const bool only_positive);
 
     /**
      * Class for linear and monotone spline interpolation
@@ -22,8 +22,10 @@
 
 #include <random>
 
+#include <world_builder/bounding_volume_hierarchy.h>
 #include <world_builder/parameters.h>
 #include <world_builder/grains.h>
+#include <world_builder/properties.h>
 
 
 
@@ -44,22 +46,39 @@ namespace WorldBuilder
        * are optional.
        * \param filename  a string with the location of
        * the world builder file to initialize the world.
-       * \param has_output_dir a bool indicating whether the world builder is allowed to
-       * write out information to a directly.
+       * \param has_output_dir a bool indicating whether the world builder should write the
+       * declarations of the world builder file, as world_buider_declarations.tex and
+       * world_buider_declarations.schema.json, to a directory. This is off by default.
        * \param output_dir a string with the location of the directory where the world builder
-       * is allowed to write information to if it is allowed by the bool has_output_dir.
+       * writes the declarations to if it is enabled by the bool has_output_dir.
        * \param random_number_seed a double containing a seed for the random number generator.
        * The world builder uses a deterministic random number generator for some plugins. This
        * is a deterministic random number generator on prorpose because even though you might
        * want to use random numbers to initialize some fields, the result should be reproducable.
-       * Note that when the world builder is used in for example MPI programs you should supply
-       * the world builder created each MPI process a different seed. You can use the MPI RANK
-       * for this (seed is seed + MPI_RANK). Because the generator is deterministic (known and
+       * The random numbers used by the plugins only depend on the seed, the position and the
+       * composition, so the results are the same independent of the order of the queries or the
+       * number of threads or MPI processes. Because the generator is deterministic (known and
        * documented algorithm), we can test the results and they should be the same even for different
        * compilers and machines.
        */
       World(std::string filename, bool has_output_dir = false, std::string output_dir = "", unsigned long random_number_seed = 1);
 
+      /**
+       * Constructor which reads the world from a buffer in memory instead of
+       * from a file. The buffer contains either the text of a world builder
+       * file or the contents of a compiled world file, which is detected
+       * automatically. This allows a program to read the file once, for
+       * example on the first MPI process, and send it to the other processes,
+       * instead of letting every process read the same file. The buffer is
+       * not used after the constructor returns.
+       * \param buffer a pointer to the contents of the world builder file.
+       * The contents do not need to be null terminated.
+       * \param buffer_size the number of characters in the buffer.
+       * \param random_number_seed the seed for the random number generator,
+       * see the other constructor.
+       */
+      World(const char *buffer, const size_t buffer_size, unsigned long random_number_seed);
+
       /**
        * Destructor
        */
@@ -76,6 +95,18 @@ namespace WorldBuilder
        */
       void parse_entries(Parameters &parameters);
 
+      /**
+       * Reads a world builder file and writes the parsed world to a compiled
+       * world file. Passing a compiled world file to the constructor instead
+       * of the world builder file gives the same world, but skips building
+       * the declarations, parsing the json and validating it. A compiled
+       * world file can only be read by the same version of the World Builder
+       * which wrote it. A world which has been constructed normally can not
+       * be written, because it releases the parameters after parsing them.
+       */
+      static
+      void compile(const std::string &world_builder_file, const std::string &compiled_world_file);
+
       /**
        * Returns the temperature based on a 2d Cartesian point, the depth in the
        * model at that point and the gravity norm at that point.
@@ -119,12 +150,181 @@ namespace WorldBuilder
                                   size_t number_of_grains) const;
 
 
+      /**
+       * Computes the temperature, the requested compositions and the grains of
+       * the requested grains compositions based on a 2d Cartesian point, the
+       * depth in the model at that point and the gravity norm at that point.
+       * The geometry of every feature is only computed once for all these
+       * properties. The results are stored in properties, with the compositions
+       * and grains in the same order as composition_numbers and
+       * grains_composition_numbers.
+       */
+      void properties(const std::array<double, 2> &point,
+                      const double depth,
+                      const double gravity_norm,
+                      const std::vector<unsigned int> &composition_numbers,
+                      const std::vector<unsigned int> &grains_composition_numbers,
+                      const size_t number_of_grains,
+                      WorldBuilder::properties &properties) const;
+
+      /**
+       * Computes the temperature, the requested compositions and the grains of
+       * the requested grains compositions based on a 3d Cartesian point, the
+       * depth in the model at that point and the gravity norm at that point.
+       * The geometry of every feature is only computed once for all these
+       * properties. The results are stored in properties, with the compositions
+       * and grains in the same order as composition_numbers and
+       * grains_composition_numbers.
+       */
+      void properties(const std::array<double, 3> &point,
+                      const double depth,
+                      const double gravity_norm,
+                      const std::vector<unsigned int> &composition_numbers,
+                      const std::vector<unsigned int> &grains_composition_numbers,
+                      const size_t number_of_grains,
+                      WorldBuilder::properties &properties) const;
+
+      /**
+       * Computes the properties of a column of points below a 2d Cartesian
+       * point at the surface, one for every depth in depths. The part of the
+       * geometry of the features which only depends on the surface position,
+       * like the polygon of a plate or the location along the trench of a
+       * slab, is only computed once for the whole column. properties is
+       * resized to the number of depths.
+       *
+       * The results are the same as calling the properties function for
+       * every point up to round off. The points of the column are computed
+       * from the natural coordinates of the surface point and the depths, so
+       * they can differ in the last bits from points which the caller
+       * computes in another way, which is nearly always the case in a
+       * spherical model.
+       * The random grains depend on the exact bits of the position, so they
+       * are only the same when the points are exactly the same.
+       */
+      void column(const std::array<double, 2> &surface_point,
+                  const std::vector<double> &depths,
+                  const double gravity_norm,
+                  const std::vector<unsigned int> &composition_numbers,
+                  const std::vector<unsigned int> &grains_composition_numbers,
+                  const size_t number_of_grains,
+                  std::vector<WorldBuilder::properties> &properties) const;
+
+      /**
+       * Computes the properties of a column of points below a 3d Cartesian
+       * point at the surface, one for every depth in depths. The part of the
+       * geometry of the features which only depends on the surface position,
+       * like the polygon of a plate or the location along the trench of a
+       * slab, is only computed once for the whole column. properties is
+       * resized to the number of depths.
+       *
+       * The results are the same as calling the properties function for
+       * every point up to round off. The points of the column are computed
+       * from the natural coordinates of the surface point and the depths, so
+       * they can differ in the last bits from points which the caller
+       * computes in another way, which is nearly always the case in a
+       * spherical model.
+       * The random grains depend on the exact bits of the position, so they
+       * are only the same when the points are exactly the same.
+       */
+      void column(const std::array<double, 3> &surface_point,
+                  const std::vector<double> &depths,
+                  const double gravity_norm,
+                  const std::vector<unsigned int> &composition_numbers,
+                  const std::vector<unsigned int> &grains_composition_numbers,
+                  const size_t number_of_grains,
+                  std::vector<WorldBuilder::properties> &properties) const;
+
+      /**
+       * Computes the temperature for n_points 2d Cartesian points at once. The
+       * coordinates, depths and gravity norms are given as separate arrays of
+       * length n_points and the temperatures are written to the array
+       * temperatures, which needs to be of length n_points as well. The results
+       * are identical to calling the single point function for each point.
+       */
+      void temperature(const size_t n_points,
+                       const double x[],
+                       const double z[],
+                       const double depth[],
+                       const double gravity_norm[],
+                       double temperatures[]) const;
+
+      /**
+       * Computes the temperature for n_points 3d Cartesian points at once. The
+       * coordinates, depths and gravity norms are given as separate arrays of
+       * length n_points and the temperatures are written to the array
+       * temperatures, which needs to be of length n_points as well. The results
+       * are identical to calling the single point function for each point.
+       */
+      void temperature(const size_t n_points,
+                       const double x[],
+                       const double y[],
+                       const double z[],
+                       const double depth[],
+                       const double gravity_norm[],
+                       double temperatures[]) const;
+
+      /**
+       * Computes the composition value for n_points 2d Cartesian points at
+       * once and writes them to the array compositions of length n_points.
+       */
+      void composition(const size_t n_points,
+                       const double x[],
+                       const double z[],
+                       const double depth[],
+                       const unsigned int composition_number,
+                       double compositions[]) const;
+
+      /**
+       * Computes the composition value for n_points 3d Cartesian points at
+       * once and writes them to the array compositions of length n_points.
+       */
+      void composition(const size_t n_points,
+                       const double x[],
+                       const double y[],
+                       const double z[],
+                       const double depth[],
+                       const unsigned int composition_number,
+                       double compositions[]) const;
+
+      /**
+       * Computes the grain orientations and sizes for n_points 2d Cartesian
+       * points at once and writes them to the array grains_out of length n_points.
+       */
+      void grains(const size_t n_points,
+                  const double x[],
+                  const double z[],
+                  const double depth[],
+                  const unsigned int composition_number,
+                  const size_t number_of_grains,
+                  WorldBuilder::grains grains_out[]) const;
+
+      /**
+       * Computes the grain orientations and sizes for n_points 3d Cartesian
+       * points at once and writes them to the array grains_out of length n_points.
+       */
+      void grains(const size_t n_points,
+                  const double x[],
+                  const double y[],
+                  const double z[],
+                  const double depth[],
+                  const unsigned int composition_number,
+                  const size_t number_of_grains,
+                  WorldBuilder::grains grains_out[]) const;
+
+
       /**
        * Return a reference to the mt19937 random number.
        * The seed is provided to the world builder at construction.
        */
       std::mt19937 &get_random_number_engine();
 
+      /**
+       * Return the seed which was provided to the world builder at
+       * construction. The plugins use it as the key of a counter based
+       * random number generator, see CounterBasedRandomNumberGenerator.
+       */
+      unsigned long get_random_number_seed() const;
+
       /**
        * This is the parameter class, which stores all the values loaded in
        * from the parameter file or which are set directly.
@@ -183,6 +383,20 @@ namespace WorldBuilder
 
 
     private:
+      /**
+       * Constructor which reads the world builder file in the same way as
+       * the public constructor. When compiling is true, the default values
+       * are written into the parameters while parsing and the parameters
+       * are kept afterwards, so that they can be written to a compiled
+       * world file.
+       */
+      World(const std::string &filename, bool has_output_dir, const std::string &output_dir, unsigned long random_number_seed, const bool compiling);
+
+      /**
+       * Converts a 2d point in the cross section to a 3d Cartesian point.
+       */
+      std::array<double,3> cross_section_to_cartesian(const std::array<double,2> &point) const;
+
       /**
        * The minimum dimension. If cross section data is provided, it is set
        * to 2, which means the 2d function of temperature and composition can
@@ -197,6 +411,17 @@ namespace WorldBuilder
        */
       std::mt19937 random_number_engine;
 
+      /**
+       * The seed of the random number generators.
+       */
+      unsigned long random_number_seed;
+
+      /**
+       * A bounding volume hierarchy over the bounding boxes of the features.
+       * It is used to only ask the features which can influence a point.
+       */
+      BoundingVolumeHierarchy feature_hierarchy;
+
 
 
   };
@@ -21,6 +21,7 @@
 #define _world_builder_wrapper_c_h
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +34,15 @@ extern "C" {
  */
 void create_world(void **ptr_ptr_world, const char *world_builder_file, bool *has_output_dir, const char *output_dir, const unsigned long random_number_seed);
 
+/**
+ * This function creates an object of the world builder from the contents of a
+ * world builder file or a compiled world file in memory, and returns a pointer
+ * to it. The buffer does not need to be null terminated and can be freed after
+ * this function returns. When done call the release world function to destroy
+ * the object.
+ */
+void create_world_from_buffer(void **ptr_ptr_world, const char *buffer, const size_t buffer_size, const unsigned long random_number_seed);
+
 /**
  * This function return the temperature at a specific location given x, z, depth and
  * gravity.
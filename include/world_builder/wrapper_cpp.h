@@ -20,6 +20,7 @@
 #ifndef _world_builder_wrapper_cpp_h
 #define _world_builder_wrapper_cpp_h
 
+#include <cstddef>
 #include <string>
 
 namespace wrapper_cpp
@@ -38,6 +39,12 @@ namespace wrapper_cpp
        */
       WorldBuilderWrapper(std::string filename, bool has_output_dir = false, std::string output_dir = "", const unsigned long random_number_seed = 1.0);
 
+      /**
+       * constructor which reads the world from the contents of a world builder
+       * file or a compiled world file in memory.
+       */
+      WorldBuilderWrapper(const char *buffer, const size_t buffer_size, const unsigned long random_number_seed);
+
       /**
        * destructor
        */
@@ -0,0 +1,598 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include <world_builder/adaptive_baked_world.h>
+#include <world_builder/assert.h>
+#include <world_builder/coordinate_systems/interface.h>
+#include <world_builder/utilities.h>
+#include <world_builder/world.h>
+
+namespace WorldBuilder
+{
+  const std::uint32_t AdaptiveBakedWorld::leaf_flag;
+
+
+  struct AdaptiveBakedWorld::BuildData
+  {
+    BuildData(const World &world_,
+              const double surface_depth_coordinate_,
+              const std::uint64_t n_vertices_per_direction_)
+      :
+      world(world_),
+      surface_depth_coordinate(surface_depth_coordinate_),
+      n_vertices_per_direction(n_vertices_per_direction_)
+    {}
+
+    const World &world;
+    const double surface_depth_coordinate;
+
+    /**
+     * The number of vertices in every direction when the whole region is
+     * refined to the maximum level.
+     */
+    const std::uint64_t n_vertices_per_direction;
+
+    /**
+     * The index of every vertex which has been evaluated, by the number of
+     * its vertex coordinates.
+     */
+    std::unordered_map<std::uint64_t,std::uint32_t> vertex_indices;
+
+    /**
+     * The vertex coordinates of every vertex which has been evaluated.
+     */
+    std::vector<std::array<std::uint64_t,3> > vertex_coordinates;
+
+    /**
+     * The node, the level and the vertex coordinates of the first corner
+     * of every leaf.
+     */
+    std::vector<size_t> leaf_nodes;
+    std::vector<unsigned int> leaf_levels;
+    std::vector<std::array<std::uint64_t,3> > leaf_origins;
+  };
+
+
+  AdaptiveBakedWorld::AdaptiveBakedWorld(const World &world,
+                                         const std::array<double,2> &min_surface,
+                                         const std::array<double,2> &max_surface,
+                                         const double min_depth,
+                                         const double max_depth,
+                                         const double surface_depth_coordinate,
+                                         const double gravity_norm_,
+                                         const std::vector<unsigned int> &composition_numbers_,
+                                         const double temperature_tolerance_,
+                                         const double composition_tolerance_,
+                                         const unsigned int min_level_,
+                                         const unsigned int max_level_)
+    :
+    coordinate_system(world.parameters.coordinate_system->natural_coordinate_system()),
+    min_coordinates({{min_surface[0], min_surface[1], min_depth}}),
+    max_coordinates({{max_surface[0], max_surface[1], max_depth}}),
+    gravity_norm(gravity_norm_),
+    composition_numbers(composition_numbers_),
+    temperature_tolerance(temperature_tolerance_),
+    composition_tolerance(composition_tolerance_),
+    min_level(min_level_),
+    max_level(max_level_),
+    composition_interpolation(BakedWorld::nearest)
+  {
+    WBAssertThrow(max_coordinates[0] > min_coordinates[0] && max_coordinates[1] > min_coordinates[1] && max_coordinates[2] > min_coordinates[2],
+                  "The region of an adaptive baked world may not be empty.");
+    // The vertex coordinates of all three directions have to fit in a
+    // single 64 bit key.
+    WBAssertThrow(max_level <= 20, "The maximum level of an adaptive baked world can not be larger than 20, but is " << max_level << ".");
+    WBAssertThrow(min_level <= max_level, "The minimum level of an adaptive baked world can not be larger than the maximum level.");
+
+    BuildData data(world, surface_depth_coordinate, (static_cast<std::uint64_t>(1) << max_level) + 1);
+
+    nodes.resize(1);
+    build_node(data, 0, 0, {{0,0,0}});
+    balance(data);
+    constrain_hanging_vertices(data);
+
+    // The values at the centers of the cells and their faces are only
+    // needed to decide whether to refine, so only keep the corners of the
+    // leaves.
+    const size_t n_compositions = composition_numbers.size();
+    std::vector<std::uint32_t> new_index(temperatures.size(), leaf_flag);
+    std::vector<double> used_temperatures;
+    std::vector<double> used_compositions;
+    for (auto &leaf : leaves)
+      for (auto &vertex : leaf)
+        {
+          if (new_index[vertex] == leaf_flag)
+            {
+              new_index[vertex] = static_cast<std::uint32_t>(used_temperatures.size());
+              used_temperatures.push_back(temperatures[vertex]);
+              used_compositions.insert(used_compositions.end(),
+                                       compositions.begin() + static_cast<std::ptrdiff_t>(vertex * n_compositions),
+                                       compositions.begin() + static_cast<std::ptrdiff_t>((vertex + 1) * n_compositions));
+            }
+          vertex = new_index[vertex];
+        }
+    temperatures.swap(used_temperatures);
+    compositions.swap(used_compositions);
+    temperatures.shrink_to_fit();
+    compositions.shrink_to_fit();
+    nodes.shrink_to_fit();
+    leaves.shrink_to_fit();
+  }
+
+
+  void
+  AdaptiveBakedWorld::build_node(BuildData &data,
+                                 const size_t node_index,
+                                 const unsigned int level,
+                                 const std::array<std::uint64_t,3> &origin)
+  {
+    const std::uint64_t size = static_cast<std::uint64_t>(1) << (max_level - level);
+    const size_t n_compositions = composition_numbers.size();
+
+    std::array<std::uint32_t,8> corners;
+    for (unsigned int n = 0; n < 8; ++n)
+      corners[n] = get_vertex(data, {{origin[0] + (n & 1) * size,
+                                      origin[1] + ((n >> 1) & 1) * size,
+                                      origin[2] + ((n >> 2) & 1) * size
+                                     }
+                                    });
+
+    bool refine = level < min_level;
+    if (!refine && level < max_level)
+      {
+        // Compare the trilinear interpolation from the corners with the
+        // world at the center of the cell and at the centers of its faces.
+        const std::uint64_t half = size / 2;
+        const std::array<std::array<std::uint64_t,3>,7> check_points = {{{{1,1,1}}, {{0,1,1}}, {{2,1,1}}, {{1,0,1}}, {{1,2,1}}, {{1,1,0}}, {{1,1,2}}}};
+        for (size_t p = 0; p < check_points.size() && !refine; ++p)
+          {
+            const std::uint32_t vertex = get_vertex(data, {{origin[0] + check_points[p][0] * half,
+                                                            origin[1] + check_points[p][1] * half,
+                                                            origin[2] + check_points[p][2] * half
+                                                           }
+                                                          });
+            double interpolated_temperature = 0;
+            for (unsigned int n = 0; n < 8; ++n)
+              {
+                double weight = 1;
+                for (unsigned int i = 0; i < 3; ++i)
+                  {
+                    const double fraction = 0.5 * static_cast<double>(check_points[p][i]);
+                    weight *= ((n >> i) & 1) == 1 ? fraction : 1.0 - fraction;
+                  }
+                interpolated_temperature += weight * temperatures[corners[n]];
+              }
+            refine = std::fabs(interpolated_temperature - temperatures[vertex]) > temperature_tolerance;
+
+            for (size_t c = 0; c < n_compositions && !refine; ++c)
+              for (unsigned int n = 0; n < 8 && !refine; ++n)
+                refine = std::fabs(compositions[vertex * n_compositions + c] - compositions[corners[n] * n_compositions + c]) > composition_tolerance;
+          }
+      }
+
+    if (refine)
+      {
+        const size_t first_child = nodes.size();
+        WBAssertThrow(first_child + 8 < leaf_flag, "The adaptive baked world has too many nodes.");
+        nodes.resize(nodes.size() + 8);
+        nodes[node_index] = static_cast<std::uint32_t>(first_child);
+
+        const std::uint64_t half = size / 2;
+        for (unsigned int n = 0; n < 8; ++n)
+          build_node(data, first_child + n, level + 1, {{origin[0] + (n & 1) * half,
+                                                         origin[1] + ((n >> 1) & 1) * half,
+                                                         origin[2] + ((n >> 2) & 1) * half
+                                                        }
+                                                       });
+      }
+    else
+      {
+        WBAssertThrow(leaves.size() < leaf_flag, "The adaptive baked world has too many leaves.");
+        nodes[node_index] = leaf_flag | static_cast<std::uint32_t>(leaves.size());
+        leaves.push_back(corners);
+        data.leaf_nodes.push_back(node_index);
+        data.leaf_levels.push_back(level);
+        data.leaf_origins.push_back(origin);
+      }
+  }
+
+
+  void
+  AdaptiveBakedWorld::split_leaf(BuildData &data,
+                                 const size_t leaf)
+  {
+    const size_t node_index = data.leaf_nodes[leaf];
+    const unsigned int level = data.leaf_levels[leaf] + 1;
+    const std::array<std::uint64_t,3> origin = data.leaf_origins[leaf];
+    const std::uint64_t size = static_cast<std::uint64_t>(1) << (max_level - level);
+
+    const size_t first_child = nodes.size();
+    WBAssertThrow(first_child + 8 < leaf_flag, "The adaptive baked world has too many nodes.");
+    nodes.resize(nodes.size() + 8);
+    nodes[node_index] = static_cast<std::uint32_t>(first_child);
+
+    // The first child takes over the index of the leaf, and the other
+    // children are added at the end.
+    for (unsigned int n = 0; n < 8; ++n)
+      {
+        const std::array<std::uint64_t,3> child_origin = {{origin[0] + (n & 1) * size,
+                                                           origin[1] + ((n >> 1) & 1) * size,
+                                                           origin[2] + ((n >> 2) & 1) * size
+                                                          }
+                                                         };
+        std::array<std::uint32_t,8> corners;
+        for (unsigned int c = 0; c < 8; ++c)
+          corners[c] = get_vertex(data, {{child_origin[0] + (c & 1) * size,
+                                          child_origin[1] + ((c >> 1) & 1) * size,
+                                          child_origin[2] + ((c >> 2) & 1) * size
+                                         }
+                                        });
+
+        const size_t child_leaf = n == 0 ? leaf : leaves.size();
+        WBAssertThrow(child_leaf < leaf_flag, "The adaptive baked world has too many leaves.");
+        nodes[first_child + n] = leaf_flag | static_cast<std::uint32_t>(child_leaf);
+        if (n == 0)
+          {
+            leaves[leaf] = corners;
+            data.leaf_nodes[leaf] = first_child;
+            data.leaf_levels[leaf] = level;
+          }
+        else
+          {
+            leaves.push_back(corners);
+            data.leaf_nodes.push_back(first_child + n);
+            data.leaf_levels.push_back(level);
+            data.leaf_origins.push_back(child_origin);
+          }
+      }
+  }
+
+
+  size_t
+  AdaptiveBakedWorld::find_leaf(const std::array<std::uint64_t,3> &cell) const
+  {
+    std::array<std::uint64_t,3> origin = {{0,0,0}};
+    std::uint64_t size = static_cast<std::uint64_t>(1) << max_level;
+    std::uint32_t node = nodes[0];
+    while ((node & leaf_flag) == 0)
+      {
+        size /= 2;
+        unsigned int child = 0;
+        for (unsigned int i = 0; i < 3; ++i)
+          if (cell[i] >= origin[i] + size)
+            {
+              child |= 1u << i;
+              origin[i] += size;
+            }
+        node = nodes[node + child];
+      }
+    return node & ~leaf_flag;
+  }
+
+
+  void
+  AdaptiveBakedWorld::balance(BuildData &data)
+  {
+    // Every leaf which touches a leaf more than one level finer, through a
+    // face, an edge or a corner, is split until the levels of all the
+    // neighboring leaves differ by at most one. A split leaf can in turn
+    // be too fine for its own neighbors, so its children are checked again.
+    const std::uint64_t n_cells = static_cast<std::uint64_t>(1) << max_level;
+    std::vector<size_t> unchecked_leaves(leaves.size());
+    for (size_t leaf = 0; leaf < leaves.size(); ++leaf)
+      unchecked_leaves[leaf] = leaf;
+
+    while (!unchecked_leaves.empty())
+      {
+        const size_t leaf = unchecked_leaves.back();
+        unchecked_leaves.pop_back();
+
+        const unsigned int level = data.leaf_levels[leaf];
+        const std::array<std::uint64_t,3> origin = data.leaf_origins[leaf];
+        const std::uint64_t size = static_cast<std::uint64_t>(1) << (max_level - level);
+        for (unsigned int direction = 0; direction < 27; ++direction)
+          {
+            // The first cell of the neighbor of the same size as the leaf in
+            // this direction, if it is inside of the region.
+            std::array<std::uint64_t,3> cell;
+            bool inside = direction != 13;
+            for (unsigned int i = 0, d = direction; i < 3; ++i, d /= 3)
+              {
+                if ((d % 3 == 0 && origin[i] < size) || (d % 3 == 2 && origin[i] + size >= n_cells))
+                  inside = false;
+                cell[i] = origin[i] + (d % 3) * size - size;
+              }
+            if (!inside)
+              continue;
+
+            for (size_t neighbor = find_leaf(cell); data.leaf_levels[neighbor] + 1 < level; neighbor = find_leaf(cell))
+              {
+                const size_t n_leaves_before_split = leaves.size();
+                split_leaf(data, neighbor);
+                unchecked_leaves.push_back(neighbor);
+                for (size_t new_leaf = n_leaves_before_split; new_leaf < leaves.size(); ++new_leaf)
+                  unchecked_leaves.push_back(new_leaf);
+              }
+          }
+      }
+  }
+
+
+  void
+  AdaptiveBakedWorld::constrain_hanging_vertices(BuildData &data)
+  {
+    // A hanging vertex is a corner of a leaf which lies on a face or an
+    // edge of a coarser neighboring leaf, without being one of its corners.
+    // The coarser leaf interpolates the temperature over that face from its
+    // own corners, so the temperature at the hanging vertex is replaced by
+    // that interpolation. The interpolation of the finer leaves over the
+    // face is then the same as the one of the coarser leaf, which makes the
+    // temperature continuous between all the leaves. The corners of a leaf
+    // can only hang on leaves which are even coarser, so the vertices are
+    // constrained from the coarsest leaves to the finest ones.
+    const std::uint64_t n_cells = static_cast<std::uint64_t>(1) << max_level;
+    std::vector<bool> is_corner(temperatures.size(), false);
+    for (auto &leaf : leaves)
+      for (auto &vertex : leaf)
+        is_corner[vertex] = true;
+
+    struct Constraint
+    {
+      unsigned int level;
+      std::uint32_t vertex;
+      size_t leaf;
+    };
+    std::vector<Constraint> constraints;
+    for (std::uint32_t vertex = 0; vertex < is_corner.size(); ++vertex)
+      {
+        if (!is_corner[vertex])
+          continue;
+
+        const std::array<std::uint64_t,3> &coordinates = data.vertex_coordinates[vertex];
+        Constraint constraint = {max_level + 1, vertex, 0};
+        for (unsigned int octant = 0; octant < 8; ++octant)
+          {
+            // The cell next to the vertex in this octant.
+            std::array<std::uint64_t,3> cell;
+            bool inside = true;
+            for (unsigned int i = 0; i < 3; ++i)
+              {
+                const bool upper = ((octant >> i) & 1) == 1;
+                inside = inside && (upper ? coordinates[i] < n_cells : coordinates[i] > 0);
+                cell[i] = upper ? coordinates[i] : coordinates[i] - 1;
+              }
+            if (!inside)
+              continue;
+
+            const size_t leaf = find_leaf(cell);
+            const std::uint64_t size = static_cast<std::uint64_t>(1) << (max_level - data.leaf_levels[leaf]);
+            bool is_leaf_corner = true;
+            for (unsigned int i = 0; i < 3; ++i)
+              is_leaf_corner = is_leaf_corner && (coordinates[i] == data.leaf_origins[leaf][i] || coordinates[i] == data.leaf_origins[leaf][i] + size);
+            if (!is_leaf_corner && data.leaf_levels[leaf] < constraint.level)
+              constraint = {data.leaf_levels[leaf], vertex, leaf};
+          }
+        if (constraint.level <= max_level)
+          constraints.push_back(constraint);
+      }
+
+    std::stable_sort(constraints.begin(), constraints.end(),
+                     [](const Constraint &a, const Constraint &b)
+    {
+      return a.level < b.level;
+    });
+
+    for (auto &constraint : constraints)
+      {
+        const double size = static_cast<double>(static_cast<std::uint64_t>(1) << (max_level - constraint.level));
+        LeafLocation location;
+        location.leaf = constraint.leaf;
+        for (unsigned int i = 0; i < 3; ++i)
+          location.fraction[i] = static_cast<double>(data.vertex_coordinates[constraint.vertex][i] - data.leaf_origins[constraint.leaf][i]) / size;
+        temperatures[constraint.vertex] = interpolate(temperatures, 1, 0, location);
+      }
+  }
+
+
+  std::uint32_t
+  AdaptiveBakedWorld::get_vertex(BuildData &data,
+                                 const std::array<std::uint64_t,3> &coordinates)
+  {
+    const std::uint64_t key = coordinates[0] + data.n_vertices_per_direction * (coordinates[1] + data.n_vertices_per_direction * coordinates[2]);
+    const std::unordered_map<std::uint64_t,std::uint32_t>::const_iterator it = data.vertex_indices.find(key);
+    if (it != data.vertex_indices.end())
+      return it->second;
+
+    // The vertex coordinates are divided by a power of two, so the
+    // positions of the vertices are the same for all the cells which share
+    // them.
+    const double n_cells = static_cast<double>(data.n_vertices_per_direction - 1);
+    std::array<double,3> natural;
+    for (unsigned int i = 0; i < 3; ++i)
+      natural[i] = min_coordinates[i] + (max_coordinates[i] - min_coordinates[i]) * (static_cast<double>(coordinates[i]) / n_cells);
+
+    const double depth = natural[2];
+    const std::array<double,3> natural_coordinates = Utilities::surface_to_natural_coordinates({{natural[0], natural[1]}},
+                                                     data.surface_depth_coordinate - depth,
+                                                     coordinate_system);
+    const std::array<double,3> point = data.world.parameters.coordinate_system->natural_to_cartesian_coordinates(natural_coordinates);
+
+    WorldBuilder::properties properties;
+    data.world.properties(point, depth, gravity_norm, composition_numbers, {}, 0, properties);
+
+    WBAssertThrow(temperatures.size() < leaf_flag, "The adaptive baked world has too many vertices.");
+    const std::uint32_t index = static_cast<std::uint32_t>(temperatures.size());
+    temperatures.push_back(properties.temperature);
+    compositions.insert(compositions.end(), properties.compositions.begin(), properties.compositions.end());
+    data.vertex_indices[key] = index;
+    data.vertex_coordinates.push_back(coordinates);
+    return index;
+  }
+
+
+  void
+  AdaptiveBakedWorld::set_composition_interpolation(const BakedWorld::CompositionInterpolation composition_interpolation_)
+  {
+    composition_interpolation = composition_interpolation_;
+  }
+
+
+  double
+  AdaptiveBakedWorld::temperature(const std::array<double,3> &point,
+                                  const double depth) const
+  {
+    LeafLocation location;
+    WBAssertThrow(locate(point, depth, location), "The point " << point[0] << ":" << point[1] << ":" << point[2]
+                  << " at depth " << depth << " is outside of the adaptive baked world.");
+
+    return interpolate(temperatures, 1, 0, location);
+  }
+
+
+  double
+  AdaptiveBakedWorld::composition(const std::array<double,3> &point,
+                                  const double depth,
+                                  const unsigned int composition_number) const
+  {
+    LeafLocation location;
+    WBAssertThrow(locate(point, depth, location), "The point " << point[0] << ":" << point[1] << ":" << point[2]
+                  << " at depth " << depth << " is outside of the adaptive baked world.");
+
+    const std::vector<unsigned int>::const_iterator it = std::find(composition_numbers.begin(), composition_numbers.end(), composition_number);
+    WBAssertThrow(it != composition_numbers.end(), "The composition " << composition_number << " has not been baked.");
+    const size_t offset = static_cast<size_t>(it - composition_numbers.begin());
+
+    // The weights of the trilinear interpolation only sum to one up to round
+    // off, so the fraction is clamped to the range of a fraction.
+    if (composition_interpolation == BakedWorld::fraction)
+      return std::min(std::max(interpolate(compositions, composition_numbers.size(), offset, location), 0.0), 1.0);
+
+    const unsigned int nearest_corner = (location.fraction[0] < 0.5 ? 0 : 1)
+                                        + (location.fraction[1] < 0.5 ? 0 : 2)
+                                        + (location.fraction[2] < 0.5 ? 0 : 4);
+    return compositions[corner(location.leaf, nearest_corner) * composition_numbers.size() + offset];
+  }
+
+
+  bool
+  AdaptiveBakedWorld::contains(const std::array<double,3> &point,
+                               const double depth) const
+  {
+    LeafLocation location;
+    return locate(point, depth, location);
+  }
+
+
+  size_t
+  AdaptiveBakedWorld::n_leaves() const
+  {
+    return leaves.size();
+  }
+
+
+  size_t
+  AdaptiveBakedWorld::n_vertices() const
+  {
+    return temperatures.size();
+  }
+
+
+  bool
+  AdaptiveBakedWorld::locate(const std::array<double,3> &point,
+                             const double depth,
+                             LeafLocation &location) const
+  {
+    const std::array<double,2> surface = Utilities::cartesian_to_natural_surface_coordinates(point, coordinate_system);
+    std::array<double,3> coordinates = {{surface[0], surface[1], depth}};
+
+    // The longitude may also be inside of the region when shifted by 2 pi.
+    if (coordinate_system == spherical && (coordinates[0] < min_coordinates[0] || coordinates[0] > max_coordinates[0]))
+      {
+        const double other_longitude = coordinates[0] + (coordinates[0] < 0 ? 2.0 * Utilities::const_pi : -2.0 * Utilities::const_pi);
+        if (other_longitude >= min_coordinates[0] && other_longitude <= max_coordinates[0])
+          coordinates[0] = other_longitude;
+      }
+
+    // The position in the region between zero and one. Allow for round off
+    // in the conversion to natural coordinates, so that points on the
+    // boundary of the region are inside of it.
+    std::array<double,3> position;
+    for (unsigned int i = 0; i < 3; ++i)
+      {
+        position[i] = (coordinates[i] - min_coordinates[i]) / (max_coordinates[i] - min_coordinates[i]);
+        if (position[i] < -1e-9 || position[i] > 1.0 + 1e-9)
+          return false;
+        position[i] = std::min(std::max(position[i], 0.0), 1.0);
+      }
+
+    // The sizes of the cells are powers of two, so the corners of the cells
+    // are computed exactly.
+    std::array<double,3> lower_corner = {{0,0,0}};
+    double size = 1;
+    std::uint32_t node = nodes[0];
+    while ((node & leaf_flag) == 0)
+      {
+        size *= 0.5;
+        unsigned int child = 0;
+        for (unsigned int i = 0; i < 3; ++i)
+          if (position[i] >= lower_corner[i] + size)
+            {
+              child |= 1u << i;
+              lower_corner[i] += size;
+            }
+        node = nodes[node + child];
+      }
+
+    location.leaf = node & ~leaf_flag;
+    for (unsigned int i = 0; i < 3; ++i)
+      location.fraction[i] = std::min(std::max((position[i] - lower_corner[i]) / size, 0.0), 1.0);
+    return true;
+  }
+
+
+  std::uint32_t
+  AdaptiveBakedWorld::corner(const size_t leaf, const unsigned int n) const
+  {
+    return leaves[leaf][n];
+  }
+
+
+  double
+  AdaptiveBakedWorld::interpolate(const std::vector<double> &values,
+                                  const size_t stride,
+                                  const size_t offset,
+                                  const LeafLocation &location) const
+  {
+    const std::array<double,3> &f = location.fraction;
+
+    double result = 0;
+    for (unsigned int n = 0; n < 8; ++n)
+      {
+        const double weight = ((n & 1) == 1 ? f[0] : 1.0 - f[0])
+                              * (((n >> 1) & 1) == 1 ? f[1] : 1.0 - f[1])
+                              * (((n >> 2) & 1) == 1 ? f[2] : 1.0 - f[2]);
+        result += weight * values[corner(location.leaf, n) * stride + offset];
+      }
+    return result;
+  }
+}
@@ -0,0 +1,411 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#include <world_builder/assert.h>
+#include <world_builder/baked_world.h>
+#include <world_builder/coordinate_systems/interface.h>
+#include <world_builder/utilities.h>
+#include <world_builder/world.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    /**
+     * The first bytes of a baked world file and the version of the format.
+     * The version has to be increased when the format changes.
+     */
+    const char baked_world_magic[8] = {'W','B','B','A','K','E','D','\0'};
+    const std::uint32_t baked_world_version = 1;
+
+    template<typename T>
+    void
+    write(std::ofstream &file, const T &value)
+    {
+      file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void
+    write(std::ofstream &file, const std::vector<T> &values)
+    {
+      write(file, static_cast<std::uint64_t>(values.size()));
+      file.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+
+    template<typename T>
+    void
+    read(std::ifstream &file, T &value)
+    {
+      file.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void
+    read(std::ifstream &file, std::vector<T> &values, const std::string &filename)
+    {
+      std::uint64_t size = 0;
+      read(file, size);
+      WBAssertThrow(file.good(), "Could not read the size of an array from the baked world file " << filename << ".");
+
+      // The size is only trusted when the array fits in the rest of the file.
+      const std::streampos position = file.tellg();
+      file.seekg(0, std::ios::end);
+      const std::streamoff remaining_bytes = file.tellg() - position;
+      file.seekg(position);
+      WBAssertThrow(file.good() && remaining_bytes >= 0 && size <= static_cast<std::uint64_t>(remaining_bytes) / sizeof(T),
+                    "The baked world file " << filename << " is corrupt.");
+      values.resize(static_cast<size_t>(size));
+      file.read(reinterpret_cast<char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    }
+  }
+
+
+  BakedWorld::BakedWorld(const World &world,
+                         const std::array<double,2> &min_surface_,
+                         const std::array<double,2> &max_surface_,
+                         const double min_depth_,
+                         const double max_depth_,
+                         const std::array<size_t,3> &n_points_,
+                         const double surface_depth_coordinate,
+                         const double gravity_norm_,
+                         const std::vector<unsigned int> &composition_numbers_,
+                         const unsigned int interface_band)
+    :
+    coordinate_system(world.parameters.coordinate_system->natural_coordinate_system()),
+    min_surface(min_surface_),
+    max_surface(max_surface_),
+    min_depth(min_depth_),
+    max_depth(max_depth_),
+    n_points(n_points_),
+    gravity_norm(gravity_norm_),
+    composition_numbers(composition_numbers_),
+    composition_interpolation(nearest),
+    fallback_world(nullptr)
+  {
+    WBAssertThrow(n_points[0] >= 2 && n_points[1] >= 2 && n_points[2] >= 2,
+                  "A baked world needs at least two grid points in every direction, but got "
+                  << n_points[0] << ", " << n_points[1] << " and " << n_points[2] << ".");
+    WBAssertThrow(max_surface[0] > min_surface[0] && max_surface[1] > min_surface[1] && max_depth > min_depth,
+                  "The region of a baked world may not be empty.");
+
+    spacing = {{(max_surface[0] - min_surface[0]) / static_cast<double>(n_points[0] - 1),
+                (max_surface[1] - min_surface[1]) / static_cast<double>(n_points[1] - 1),
+                (max_depth - min_depth) / static_cast<double>(n_points[2] - 1)
+               }
+              };
+
+    const size_t n_compositions = composition_numbers.size();
+    const size_t n_total_points = n_points[0] * n_points[1] * n_points[2];
+    temperatures.resize(n_total_points);
+    compositions.resize(n_total_points * n_compositions);
+
+    std::vector<double> depths(n_points[2]);
+    for (size_t k = 0; k < n_points[2]; ++k)
+      depths[k] = min_depth + static_cast<double>(k) * spacing[2];
+
+    // Every grid point with the same surface coordinates is in the same
+    // column, so the world only has to compute its surface work once for
+    // all the depths.
+    std::vector<WorldBuilder::properties> column;
+    for (size_t j = 0; j < n_points[1]; ++j)
+      for (size_t i = 0; i < n_points[0]; ++i)
+        {
+          const std::array<double,2> surface = {{min_surface[0] + static_cast<double>(i) * spacing[0],
+                                                 min_surface[1] + static_cast<double>(j) * spacing[1]
+                                                }
+                                               };
+          const std::array<double,3> natural_surface_point = Utilities::surface_to_natural_coordinates(surface, surface_depth_coordinate, coordinate_system);
+          const std::array<double,3> surface_point = world.parameters.coordinate_system->natural_to_cartesian_coordinates(natural_surface_point);
+
+          world.column(surface_point, depths, gravity_norm, composition_numbers, {}, 0, column);
+
+          for (size_t k = 0; k < n_points[2]; ++k)
+            {
+              const size_t index = point_index(i,j,k);
+              temperatures[index] = column[k].temperature;
+              for (size_t c = 0; c < n_compositions; ++c)
+                compositions[index * n_compositions + c] = column[k].compositions[c];
+            }
+        }
+
+    // Mark the cells in which a composition changes between its corners.
+    const std::array<size_t,3> n_cells = {{n_points[0] - 1, n_points[1] - 1, n_points[2] - 1}};
+    near_interface.assign(n_cells[0] * n_cells[1] * n_cells[2], 0);
+    for (size_t k = 0; k < n_cells[2]; ++k)
+      for (size_t j = 0; j < n_cells[1]; ++j)
+        for (size_t i = 0; i < n_cells[0]; ++i)
+          {
+            const size_t first_corner = point_index(i,j,k);
+            bool changes = false;
+            for (unsigned int corner = 1; corner < 8 && !changes; ++corner)
+              {
+                const size_t other_corner = point_index(i + (corner & 1), j + ((corner >> 1) & 1), k + ((corner >> 2) & 1));
+                for (size_t c = 0; c < n_compositions; ++c)
+                  if (std::fabs(compositions[other_corner * n_compositions + c] - compositions[first_corner * n_compositions + c]) > 0.)
+                    {
+                      changes = true;
+                      break;
+                    }
+              }
+            near_interface[cell_index({{i,j,k}})] = changes ? 1 : 0;
+          }
+
+    // Widen the marked cells by the interface band in every direction, one
+    // direction at a time.
+    for (unsigned int axis = 0; axis < 3; ++axis)
+      {
+        const std::vector<unsigned char> marked = near_interface;
+        for (size_t k = 0; k < n_cells[2]; ++k)
+          for (size_t j = 0; j < n_cells[1]; ++j)
+            for (size_t i = 0; i < n_cells[0]; ++i)
+              {
+                std::array<size_t,3> cell = {{i,j,k}};
+                const size_t center = cell[axis];
+                const size_t begin = center > interface_band ? center - interface_band : 0;
+                const size_t end = std::min(center + interface_band + 1, n_cells[axis]);
+                unsigned char value = 0;
+                for (size_t n = begin; n < end && value == 0; ++n)
+                  {
+                    cell[axis] = n;
+                    value = marked[cell_index(cell)];
+                  }
+                cell[axis] = center;
+                near_interface[cell_index(cell)] = value;
+              }
+      }
+  }
+
+
+  BakedWorld::BakedWorld(const std::string &filename)
+    :
+    composition_interpolation(nearest),
+    fallback_world(nullptr)
+  {
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    WBAssertThrow(file.good(), "Could not open the baked world file " << filename << ".");
+
+    char magic[sizeof(baked_world_magic)];
+    file.read(magic, sizeof(magic));
+    WBAssertThrow(file.good() && std::memcmp(magic, baked_world_magic, sizeof(magic)) == 0,
+                  "The file " << filename << " is not a baked world file.");
+
+    std::uint32_t version = 0;
+    read(file, version);
+    WBAssertThrow(version == baked_world_version, "The baked world file " << filename << " has version "
+                  << version << ", but this version of the World Builder can only read version "
+                  << baked_world_version << ".");
+
+    std::uint32_t coordinate_system_ = 0;
+    read(file, coordinate_system_);
+    coordinate_system = static_cast<CoordinateSystem>(coordinate_system_);
+
+    for (unsigned int i = 0; i < 3; ++i)
+      {
+        std::uint64_t n = 0;
+        read(file, n);
+        n_points[i] = static_cast<size_t>(n);
+      }
+    read(file, min_surface);
+    read(file, max_surface);
+    read(file, min_depth);
+    read(file, max_depth);
+    read(file, spacing);
+    read(file, gravity_norm);
+    read(file, composition_numbers, filename);
+    read(file, temperatures, filename);
+    read(file, compositions, filename);
+    read(file, near_interface, filename);
+
+    WBAssertThrow(file.good(), "Could not read the baked world file " << filename << ".");
+    WBAssertThrow(n_points[0] >= 2 && n_points[1] >= 2 && n_points[2] >= 2
+                  && temperatures.size() == n_points[0] * n_points[1] * n_points[2]
+                  && compositions.size() == temperatures.size() * composition_numbers.size()
+                  && near_interface.size() == (n_points[0] - 1) * (n_points[1] - 1) * (n_points[2] - 1),
+                  "The baked world file " << filename << " is corrupt.");
+  }
+
+
+  void
+  BakedWorld::save(const std::string &filename) const
+  {
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    WBAssertThrow(file.good(), "Could not open the baked world file " << filename << " for writing.");
+
+    file.write(baked_world_magic, sizeof(baked_world_magic));
+    write(file, baked_world_version);
+    write(file, static_cast<std::uint32_t>(coordinate_system));
+    for (unsigned int i = 0; i < 3; ++i)
+      write(file, static_cast<std::uint64_t>(n_points[i]));
+    write(file, min_surface);
+    write(file, max_surface);
+    write(file, min_depth);
+    write(file, max_depth);
+    write(file, spacing);
+    write(file, gravity_norm);
+    write(file, composition_numbers);
+    write(file, temperatures);
+    write(file, compositions);
+    write(file, near_interface);
+
+    WBAssertThrow(file.good(), "Could not write the baked world file " << filename << ".");
+  }
+
+
+  void
+  BakedWorld::set_fallback(const World *world)
+  {
+    fallback_world = world;
+  }
+
+
+  void
+  BakedWorld::set_composition_interpolation(const CompositionInterpolation composition_interpolation_)
+  {
+    composition_interpolation = composition_interpolation_;
+  }
+
+
+  double
+  BakedWorld::temperature(const std::array<double,3> &point,
+                          const double depth) const
+  {
+    GridLocation location;
+    if (!locate(point, depth, location) || (fallback_world != nullptr && near_interface[cell_index(location.cell)] != 0))
+      {
+        WBAssertThrow(fallback_world != nullptr, "The point " << point[0] << ":" << point[1] << ":" << point[2]
+                      << " at depth " << depth << " is outside of the baked world and there is no fallback world.");
+        return fallback_world->temperature(point, depth, gravity_norm);
+      }
+
+    return interpolate(temperatures, 1, 0, location);
+  }
+
+
+  double
+  BakedWorld::composition(const std::array<double,3> &point,
+                          const double depth,
+                          const unsigned int composition_number) const
+  {
+    GridLocation location;
+    if (!locate(point, depth, location) || (fallback_world != nullptr && near_interface[cell_index(location.cell)] != 0))
+      {
+        WBAssertThrow(fallback_world != nullptr, "The point " << point[0] << ":" << point[1] << ":" << point[2]
+                      << " at depth " << depth << " is outside of the baked world and there is no fallback world.");
+        return fallback_world->composition(point, depth, composition_number);
+      }
+
+    const std::vector<unsigned int>::const_iterator it = std::find(composition_numbers.begin(), composition_numbers.end(), composition_number);
+    WBAssertThrow(it != composition_numbers.end(), "The composition " << composition_number << " has not been baked.");
+    const size_t offset = static_cast<size_t>(it - composition_numbers.begin());
+
+    // The weights of the trilinear interpolation only sum to one up to round
+    // off, so the fraction is clamped to the range of a fraction.
+    if (composition_interpolation == fraction)
+      return std::min(std::max(interpolate(compositions, composition_numbers.size(), offset, location), 0.0), 1.0);
+
+    const size_t index = point_index(location.cell[0] + (location.fraction[0] < 0.5 ? 0 : 1),
+                                     location.cell[1] + (location.fraction[1] < 0.5 ? 0 : 1),
+                                     location.cell[2] + (location.fraction[2] < 0.5 ? 0 : 1));
+    return compositions[index * composition_numbers.size() + offset];
+  }
+
+
+  bool
+  BakedWorld::contains(const std::array<double,3> &point,
+                       const double depth) const
+  {
+    GridLocation location;
+    return locate(point, depth, location);
+  }
+
+
+  bool
+  BakedWorld::locate(const std::array<double,3> &point,
+                     const double depth,
+                     GridLocation &location) const
+  {
+    std::array<double,2> surface = Utilities::cartesian_to_natural_surface_coordinates(point, coordinate_system);
+
+    // The longitude may also be inside of the region when shifted by 2 pi.
+    if (coordinate_system == spherical && (surface[0] < min_surface[0] - spacing[0] || surface[0] > max_surface[0] + spacing[0]))
+      surface[0] += surface[0] < 0 ? 2.0 * Utilities::const_pi : -2.0 * Utilities::const_pi;
+
+    const std::array<double,3> coordinates = {{surface[0], surface[1], depth}};
+    const std::array<double,3> min_coordinates = {{min_surface[0], min_surface[1], min_depth}};
+    const std::array<double,3> max_coordinates = {{max_surface[0], max_surface[1], max_depth}};
+    for (unsigned int i = 0; i < 3; ++i)
+      {
+        // Allow for round off in the conversion to natural coordinates, so
+        // that points on the boundary of the region are inside of it.
+        const double tolerance = 1e-9 * spacing[i];
+        if (coordinates[i] < min_coordinates[i] - tolerance || coordinates[i] > max_coordinates[i] + tolerance)
+          return false;
+
+        const double grid_coordinate = std::max((coordinates[i] - min_coordinates[i]) / spacing[i], 0.0);
+        location.cell[i] = std::min(static_cast<size_t>(grid_coordinate), n_points[i] - 2);
+        location.fraction[i] = std::min(grid_coordinate - static_cast<double>(location.cell[i]), 1.0);
+      }
+    return true;
+  }
+
+
+  size_t
+  BakedWorld::point_index(const size_t i, const size_t j, const size_t k) const
+  {
+    return i + n_points[0] * (j + n_points[1] * k);
+  }
+
+
+  size_t
+  BakedWorld::cell_index(const std::array<size_t,3> &cell) const
+  {
+    return cell[0] + (n_points[0] - 1) * (cell[1] + (n_points[1] - 1) * cell[2]);
+  }
+
+
+  double
+  BakedWorld::interpolate(const std::vector<double> &values,
+                          const size_t stride,
+                          const size_t offset,
+                          const GridLocation &location) const
+  {
+    const std::array<size_t,3> &cell = location.cell;
+    const std::array<double,3> &f = location.fraction;
+
+    double result = 0;
+    for (unsigned int corner = 0; corner < 8; ++corner)
+      {
+        const size_t di = corner & 1;
+        const size_t dj = (corner >> 1) & 1;
+        const size_t dk = (corner >> 2) & 1;
+        const double weight = (di == 1 ? f[0] : 1.0 - f[0])
+                              * (dj == 1 ? f[1] : 1.0 - f[1])
+                              * (dk == 1 ? f[2] : 1.0 - f[2]);
+        result += weight * values[point_index(cell[0] + di, cell[1] + dj, cell[2] + dk) * stride + offset];
+      }
+    return result;
+  }
+}
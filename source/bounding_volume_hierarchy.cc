@@ -0,0 +1,228 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <world_builder/bounding_volume_hierarchy.h>
+#include <world_builder/assert.h>
+#include <world_builder/utilities.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    /**
+     * The maximum number of boxes stored in a leaf of the tree.
+     */
+    const size_t max_leaf_size = 4;
+
+    /**
+     * The maximum depth of the tree. Because the boxes are split at the
+     * median, the depth of the tree is the logarithm of the number of boxes,
+     * so this is never reached.
+     */
+    const size_t max_tree_depth = 64;
+
+    /**
+     * Returns a representative center of a box along one axis, which is
+     * also meaningful for boxes which are infinite on one or both sides.
+     */
+    double
+    center(const double min, const double max)
+    {
+      if (std::isfinite(min) && std::isfinite(max))
+        return 0.5 * (min + max);
+      if (std::isfinite(min))
+        return min;
+      if (std::isfinite(max))
+        return max;
+      return 0;
+    }
+  }
+
+  BoundingBox::BoundingBox()
+    :
+    min_surface({{-std::numeric_limits<double>::infinity(),-std::numeric_limits<double>::infinity()}}),
+    max_surface({{std::numeric_limits<double>::infinity(),std::numeric_limits<double>::infinity()}}),
+    min_depth(-std::numeric_limits<double>::infinity()),
+    max_depth(std::numeric_limits<double>::infinity())
+  {}
+
+
+  bool
+  BoundingBox::contains(const std::array<double,2> &surface_point,
+                        const double depth,
+                        const bool spherical) const
+  {
+    if (depth < min_depth || depth > max_depth)
+      return false;
+
+    if (surface_point[1] < min_surface[1] || surface_point[1] > max_surface[1])
+      return false;
+
+    if (surface_point[0] >= min_surface[0] && surface_point[0] <= max_surface[0])
+      return true;
+
+    if (spherical)
+      {
+        const double other_longitude = surface_point[0] + (surface_point[0] < 0 ? 2.0 * Utilities::const_pi : -2.0 * Utilities::const_pi);
+        return other_longitude >= min_surface[0] && other_longitude <= max_surface[0];
+      }
+
+    return false;
+  }
+
+
+  void
+  BoundingBox::extend(const BoundingBox &other)
+  {
+    for (unsigned int i = 0; i < 2; ++i)
+      {
+        min_surface[i] = std::min(min_surface[i], other.min_surface[i]);
+        max_surface[i] = std::max(max_surface[i], other.max_surface[i]);
+      }
+    min_depth = std::min(min_depth, other.min_depth);
+    max_depth = std::max(max_depth, other.max_depth);
+  }
+
+
+  BoundingVolumeHierarchy::BoundingVolumeHierarchy()
+    :
+    spherical(false)
+  {}
+
+
+  void
+  BoundingVolumeHierarchy::build(const std::vector<BoundingBox> &boxes_,
+                                 const bool spherical_)
+  {
+    boxes = boxes_;
+    spherical = spherical_;
+    nodes.clear();
+    indices.resize(boxes.size());
+
+    if (boxes.size() == 0)
+      return;
+
+    std::vector<std::array<double,2> > centers(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i)
+      {
+        indices[i] = i;
+        centers[i] = {{center(boxes[i].min_surface[0], boxes[i].max_surface[0]),
+                       center(boxes[i].min_surface[1], boxes[i].max_surface[1])
+                      }
+                     };
+      }
+
+    nodes.resize(1);
+    build_node(0, 0, boxes.size(), centers);
+  }
+
+
+  void
+  BoundingVolumeHierarchy::build_node(const size_t node_index,
+                                      const size_t begin,
+                                      const size_t end,
+                                      const std::vector<std::array<double,2> > &centers)
+  {
+    // An empty box which is extended by all the boxes in this node.
+    BoundingBox box;
+    box.min_surface = {{std::numeric_limits<double>::infinity(),std::numeric_limits<double>::infinity()}};
+    box.max_surface = {{-std::numeric_limits<double>::infinity(),-std::numeric_limits<double>::infinity()}};
+    box.min_depth = std::numeric_limits<double>::infinity();
+    box.max_depth = -std::numeric_limits<double>::infinity();
+
+    std::array<double,2> min_center = {{std::numeric_limits<double>::infinity(),std::numeric_limits<double>::infinity()}};
+    std::array<double,2> max_center = {{-std::numeric_limits<double>::infinity(),-std::numeric_limits<double>::infinity()}};
+    for (size_t i = begin; i < end; ++i)
+      {
+        box.extend(boxes[indices[i]]);
+        for (unsigned int axis = 0; axis < 2; ++axis)
+          {
+            min_center[axis] = std::min(min_center[axis], centers[indices[i]][axis]);
+            max_center[axis] = std::max(max_center[axis], centers[indices[i]][axis]);
+          }
+      }
+
+    nodes[node_index].box = box;
+    nodes[node_index].first = begin;
+    nodes[node_index].count = end - begin;
+
+    // Split along the surface axis in which the centers are the most spread out.
+    const unsigned int axis = max_center[0] - min_center[0] >= max_center[1] - min_center[1] ? 0 : 1;
+    if (end - begin <= max_leaf_size || !(max_center[axis] > min_center[axis]))
+      return;
+
+    const size_t middle = begin + (end - begin) / 2;
+    std::nth_element(indices.begin() + static_cast<std::ptrdiff_t>(begin),
+                     indices.begin() + static_cast<std::ptrdiff_t>(middle),
+                     indices.begin() + static_cast<std::ptrdiff_t>(end),
+                     [&](const size_t a, const size_t b)
+    {
+      return centers[a][axis] < centers[b][axis];
+    });
+
+    const size_t first_child = nodes.size();
+    nodes.resize(nodes.size() + 2);
+    nodes[node_index].first = first_child;
+    nodes[node_index].count = 0;
+
+    build_node(first_child, begin, middle, centers);
+    build_node(first_child + 1, middle, end, centers);
+  }
+
+
+  void
+  BoundingVolumeHierarchy::query(const std::array<double,2> &surface_point,
+                                 const double depth,
+                                 std::vector<size_t> &candidates) const
+  {
+    candidates.clear();
+    if (nodes.size() == 0)
+      return;
+
+    std::array<size_t,max_tree_depth> stack;
+    size_t stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0)
+      {
+        const Node &node = nodes[stack[--stack_size]];
+        if (!node.box.contains(surface_point, depth, spherical))
+          continue;
+
+        if (node.count > 0)
+          {
+            for (size_t i = node.first; i < node.first + node.count; ++i)
+              if (boxes[indices[i]].contains(surface_point, depth, spherical))
+                candidates.push_back(indices[i]);
+          }
+        else
+          {
+            WBAssert(stack_size + 2 <= max_tree_depth, "Internal error: the bounding volume hierarchy is too deep.");
+            stack[stack_size++] = node.first + 1;
+            stack[stack_size++] = node.first;
+          }
+      }
+
+    // The features have to be applied in their original order.
+    std::sort(candidates.begin(), candidates.end());
+  }
+}
@@ -129,7 +129,7 @@ namespace WorldBuilder
                                    double temperature_,
                                    const double ,
                                    const double ,
-                                   const std::map<std::string,double> &) const
+                                   const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &) const
         {
 
           if (depth <= max_depth && depth >= min_depth)
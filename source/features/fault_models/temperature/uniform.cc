@@ -88,10 +88,10 @@ namespace WorldBuilder
                                  double temperature_,
                                  const double ,
                                  const double ,
-                                 const std::map<std::string,double> &distance_from_plane) const
+                                 const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_plane) const
         {
 
-          if (std::fabs(distance_from_plane.at("distanceFromPlane")) <= max_depth && std::fabs(distance_from_plane.at("distanceFromPlane")) >= min_depth)
+          if (std::fabs(distance_from_plane.distance_from_plane) <= max_depth && std::fabs(distance_from_plane.distance_from_plane) >= min_depth)
             {
               return Utilities::apply_operation(operation,temperature_,temperature);
             }
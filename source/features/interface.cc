@@ -18,6 +18,8 @@
 */
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 #include <world_builder/features/interface.h>
 #include <world_builder/features/continental_plate.h>
@@ -42,6 +44,8 @@ namespace WorldBuilder
   namespace Features
   {
     Interface::Interface()
+      :
+      bounding_box_spherical(false)
     {}
 
     Interface::~Interface ()
@@ -166,6 +170,157 @@ namespace WorldBuilder
     }
 
 
+    double
+    Interface::temperature(const Point<3> &position,
+                           const double depth,
+                           const double gravity_norm,
+                           double temperature) const
+    {
+      return this->temperature(position,
+                               NaturalCoordinate(position, *(world->parameters.coordinate_system)),
+                               depth,
+                               gravity_norm,
+                               temperature);
+    }
+
+
+    double
+    Interface::composition(const Point<3> &position,
+                           const double depth,
+                           const unsigned int composition_number,
+                           double value) const
+    {
+      return this->composition(position,
+                               NaturalCoordinate(position, *(world->parameters.coordinate_system)),
+                               depth,
+                               composition_number,
+                               value);
+    }
+
+
+    WorldBuilder::grains
+    Interface::grains(const Point<3> &position,
+                      const double depth,
+                      const unsigned int composition_number,
+                      WorldBuilder::grains value) const
+    {
+      return this->grains(position,
+                          NaturalCoordinate(position, *(world->parameters.coordinate_system)),
+                          depth,
+                          composition_number,
+                          value);
+    }
+
+
+    void
+    Interface::properties(const Point<3> &position,
+                          const double depth,
+                          const double gravity_norm,
+                          const std::vector<unsigned int> &composition_numbers,
+                          const std::vector<unsigned int> &grains_composition_numbers,
+                          WorldBuilder::properties &properties) const
+    {
+      this->properties(position,
+                       NaturalCoordinate(position, *(world->parameters.coordinate_system)),
+                       depth,
+                       gravity_norm,
+                       composition_numbers,
+                       grains_composition_numbers,
+                       properties);
+    }
+
+
+    void
+    Interface::properties(const Point<3> &position,
+                          const NaturalCoordinate &natural_coordinate,
+                          const double depth,
+                          const double gravity_norm,
+                          const std::vector<unsigned int> &composition_numbers,
+                          const std::vector<unsigned int> &grains_composition_numbers,
+                          WorldBuilder::properties &properties) const
+    {
+      properties.temperature = this->temperature(position, natural_coordinate, depth, gravity_norm, properties.temperature);
+
+      for (size_t i = 0; i < composition_numbers.size(); ++i)
+        properties.compositions[i] = this->composition(position, natural_coordinate, depth, composition_numbers[i], properties.compositions[i]);
+
+      for (size_t i = 0; i < grains_composition_numbers.size(); ++i)
+        properties.grains[i] = this->grains(position, natural_coordinate, depth, grains_composition_numbers[i], properties.grains[i]);
+    }
+
+
+    void
+    Interface::properties_column(const std::vector<Point<3> > &positions,
+                                 const std::vector<NaturalCoordinate> &natural_coordinates,
+                                 const std::vector<double> &depths,
+                                 const double gravity_norm,
+                                 const std::vector<unsigned int> &composition_numbers,
+                                 const std::vector<unsigned int> &grains_composition_numbers,
+                                 std::vector<WorldBuilder::properties> &properties) const
+    {
+      for (size_t i = 0; i < positions.size(); ++i)
+        if (bounding_box_contains(natural_coordinates[i].get_surface_coordinates(), depths[i]))
+          this->properties(positions[i],
+                           natural_coordinates[i],
+                           depths[i],
+                           gravity_norm,
+                           composition_numbers,
+                           grains_composition_numbers,
+                           properties[i]);
+    }
+
+    void
+    Interface::set_bounding_box(const double min_depth,
+                                const double max_depth,
+                                const double surface_margin)
+    {
+      bounding_box = BoundingBox();
+      bounding_box.min_depth = min_depth;
+      bounding_box.max_depth = max_depth;
+      bounding_box_spherical = world->parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::spherical;
+
+      if (!std::isfinite(surface_margin) || coordinates.size() == 0)
+        return;
+
+      bounding_box.min_surface = {{std::numeric_limits<double>::infinity(),std::numeric_limits<double>::infinity()}};
+      bounding_box.max_surface = {{-std::numeric_limits<double>::infinity(),-std::numeric_limits<double>::infinity()}};
+      for (auto &coordinate : coordinates)
+        {
+          for (unsigned int i = 0; i < 2; ++i)
+            {
+              bounding_box.min_surface[i] = std::min(bounding_box.min_surface[i], coordinate[i]);
+              bounding_box.max_surface[i] = std::max(bounding_box.max_surface[i], coordinate[i]);
+            }
+        }
+
+      // Enlarge the box by the margin and a small tolerance, so that points
+      // which are on the boundary of a feature up to round off are never
+      // rejected by the bounding box.
+      for (unsigned int i = 0; i < 2; ++i)
+        {
+          const double tolerance = 1e-12 * std::max(1.0, std::max(std::fabs(bounding_box.min_surface[i]),
+                                                                  std::fabs(bounding_box.max_surface[i])));
+          bounding_box.min_surface[i] -= surface_margin + tolerance;
+          bounding_box.max_surface[i] += surface_margin + tolerance;
+        }
+    }
+
+
+    bool
+    Interface::bounding_box_contains(const std::array<double,2> &surface_point,
+                                     const double depth) const
+    {
+      return bounding_box.contains(surface_point, depth, bounding_box_spherical);
+    }
+
+
+    const BoundingBox &
+    Interface::get_bounding_box() const
+    {
+      return bounding_box;
+    }
+
+
     void
     Interface::registerType(const std::string &name,
                             void ( *declare_entries)(Parameters &, const std::string &,const std::vector<std::string> &),
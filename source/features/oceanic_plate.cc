@@ -132,22 +132,25 @@ namespace WorldBuilder
           }
       }
       prm.leave_subsection();
+
+      // The feature only influences points inside the polygon and between
+      // the min and max depth.
+      set_bounding_box(min_depth, max_depth, 0.0);
+
+      polygon = WorldBuilder::Utilities::Polygon(coordinates, coordinate_system);
     }
 
 
     double
     OceanicPlate::temperature(const Point<3> &position,
+                              const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                               const double depth,
                               const double gravity_norm,
                               double temperature) const
     {
-      WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
-                                                                      *(world->parameters.coordinate_system));
-
 
       if (depth <= max_depth && depth >= min_depth &&
-          WorldBuilder::Utilities::polygon_contains_point(coordinates, Point<2>(natural_coordinate.get_surface_coordinates(),
-                                                                                world->parameters.coordinate_system->natural_coordinate_system())))
+          polygon.contains(natural_coordinate.get_surface_coordinates()))
         {
           for (auto &temperature_model: temperature_models)
             {
@@ -171,16 +174,13 @@ namespace WorldBuilder
 
     double
     OceanicPlate::composition(const Point<3> &position,
+                              const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                               const double depth,
                               const unsigned int composition_number,
                               double composition) const
     {
-      WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
-                                                                      *(world->parameters.coordinate_system));
-
       if (depth <= max_depth && depth >= min_depth &&
-          WorldBuilder::Utilities::polygon_contains_point(coordinates, Point<2>(natural_coordinate.get_surface_coordinates(),
-                                                                                world->parameters.coordinate_system->natural_coordinate_system())))
+          polygon.contains(natural_coordinate.get_surface_coordinates()))
         {
           for (auto &composition_model: composition_models)
             {
@@ -204,16 +204,13 @@ namespace WorldBuilder
 
     WorldBuilder::grains
     OceanicPlate::grains(const Point<3> &position,
+                         const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                          const double depth,
                          const unsigned int composition_number,
                          WorldBuilder::grains grains) const
     {
-      WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
-                                                                      *(world->parameters.coordinate_system));
-
       if (depth <= max_depth && depth >= min_depth &&
-          WorldBuilder::Utilities::polygon_contains_point(coordinates, Point<2>(natural_coordinate.get_surface_coordinates(),
-                                                                                world->parameters.coordinate_system->natural_coordinate_system())))
+          polygon.contains(natural_coordinate.get_surface_coordinates()))
         {
           for (auto &grains_model: grains_models)
             {
@@ -235,6 +232,115 @@ namespace WorldBuilder
       return grains;
     }
 
+    void
+    OceanicPlate::properties(const Point<3> &position,
+                             const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                             const double depth,
+                             const double gravity_norm,
+                             const std::vector<unsigned int> &composition_numbers,
+                             const std::vector<unsigned int> &grains_composition_numbers,
+                             WorldBuilder::properties &properties) const
+    {
+      if (depth <= max_depth && depth >= min_depth &&
+          polygon.contains(natural_coordinate.get_surface_coordinates()))
+        properties_inside(position, depth, gravity_norm, true, composition_numbers, grains_composition_numbers, properties);
+    }
+
+
+    void
+    OceanicPlate::properties_column(const std::vector<Point<3> > &positions,
+                                    const std::vector<WorldBuilder::Utilities::NaturalCoordinate> &natural_coordinates,
+                                    const std::vector<double> &depths,
+                                    const double gravity_norm,
+                                    const std::vector<unsigned int> &composition_numbers,
+                                    const std::vector<unsigned int> &grains_composition_numbers,
+                                    std::vector<WorldBuilder::properties> &properties) const
+    {
+      // All the points in the column have the same surface coordinates, so the
+      // polygon only has to be checked once.
+      if (positions.size() == 0 || !polygon.contains(natural_coordinates[0].get_surface_coordinates()))
+        return;
+
+      // The temperature models get the whole column, so that they can compute
+      // what only depends on the surface position once.
+      for (auto &temperature_model: temperature_models)
+        {
+          temperature_model->get_temperatures(positions,
+                                              natural_coordinates,
+                                              depths,
+                                              gravity_norm,
+                                              min_depth,
+                                              max_depth,
+                                              properties);
+
+          for (size_t i = 0; i < positions.size(); ++i)
+            {
+              WBAssert(!std::isnan(properties[i].temperature), "Temparture is not a number: " << properties[i].temperature
+                       << ", based on a temperature model with the name " << temperature_model->get_name());
+              WBAssert(std::isfinite(properties[i].temperature), "Temparture is not a finite: " << properties[i].temperature
+                       << ", based on a temperature model with the name " << temperature_model->get_name());
+            }
+        }
+
+      for (size_t i = 0; i < positions.size(); ++i)
+        if (depths[i] <= max_depth && depths[i] >= min_depth)
+          properties_inside(positions[i], depths[i], gravity_norm, false, composition_numbers, grains_composition_numbers, properties[i]);
+    }
+
+
+    void
+    OceanicPlate::properties_inside(const Point<3> &position,
+                                    const double depth,
+                                    const double gravity_norm,
+                                    const bool compute_temperature,
+                                    const std::vector<unsigned int> &composition_numbers,
+                                    const std::vector<unsigned int> &grains_composition_numbers,
+                                    WorldBuilder::properties &properties) const
+    {
+      if (compute_temperature)
+        for (auto &temperature_model: temperature_models)
+          {
+            properties.temperature = temperature_model->get_temperature(position,
+                                                                        depth,
+                                                                        gravity_norm,
+                                                                        properties.temperature,
+                                                                        min_depth,
+                                                                        max_depth);
+
+            WBAssert(!std::isnan(properties.temperature), "Temparture is not a number: " << properties.temperature
+                     << ", based on a temperature model with the name " << temperature_model->get_name());
+            WBAssert(std::isfinite(properties.temperature), "Temparture is not a finite: " << properties.temperature
+                     << ", based on a temperature model with the name " << temperature_model->get_name());
+          }
+
+      for (size_t i = 0; i < composition_numbers.size(); ++i)
+        for (auto &composition_model: composition_models)
+          {
+            properties.compositions[i] = composition_model->get_composition(position,
+                                                                            depth,
+                                                                            composition_numbers[i],
+                                                                            properties.compositions[i],
+                                                                            min_depth,
+                                                                            max_depth);
+
+            WBAssert(!std::isnan(properties.compositions[i]), "Composition is not a number: " << properties.compositions[i]
+                     << ", based on a composition model with the name " << composition_model->get_name());
+            WBAssert(std::isfinite(properties.compositions[i]), "Composition is not a finite: " << properties.compositions[i]
+                     << ", based on a composition model with the name " << composition_model->get_name());
+          }
+
+      for (size_t i = 0; i < grains_composition_numbers.size(); ++i)
+        for (auto &grains_model: grains_models)
+          {
+            properties.grains[i] = grains_model->get_grains(position,
+                                                            depth,
+                                                            grains_composition_numbers[i],
+                                                            properties.grains[i],
+                                                            min_depth,
+                                                            max_depth);
+          }
+    }
+
     /**
      * Register plugin
      */
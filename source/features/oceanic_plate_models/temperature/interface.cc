@@ -63,6 +63,26 @@ namespace WorldBuilder
         }
 
 
+        void
+        Interface::get_temperatures(const std::vector<Point<3> > &positions,
+                                    const std::vector<WorldBuilder::Utilities::NaturalCoordinate> &,
+                                    const std::vector<double> &depths,
+                                    const double gravity,
+                                    const double feature_min_depth,
+                                    const double feature_max_depth,
+                                    std::vector<WorldBuilder::properties> &properties) const
+        {
+          for (size_t i = 0; i < positions.size(); ++i)
+            if (depths[i] <= feature_max_depth && depths[i] >= feature_min_depth)
+              properties[i].temperature = get_temperature(positions[i],
+                                                          depths[i],
+                                                          gravity,
+                                                          properties[i].temperature,
+                                                          feature_min_depth,
+                                                          feature_max_depth);
+        }
+
+
         void
         Interface::registerType(const std::string &name,
                                 void ( *declare_entries)(Parameters &, const std::string &),
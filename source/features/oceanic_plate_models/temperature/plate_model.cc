@@ -117,91 +117,147 @@ namespace WorldBuilder
               WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
                                                                               *(world->parameters.coordinate_system));
 
+              const double distance_ridge = distance_to_ridge(natural_coordinate.get_surface_coordinates(),
+                                                              natural_coordinate.get_depth_coordinate());
 
-              double bottom_temperature_local = bottom_temperature;
+              return Utilities::apply_operation(operation,temperature_,plate_temperature(depth, gravity_norm, distance_ridge));
 
-              if (bottom_temperature_local < 0)
-                {
-                  bottom_temperature_local =  this->world->potential_mantle_temperature *
-                                              std::exp(((this->world->thermal_expansion_coefficient* gravity_norm) /
-                                                        this->world->specific_heat) * depth);
-                }
+            }
+          return temperature_;
+        }
 
-              const int sommation_number = 100;
-              double distance_ridge = std::numeric_limits<double>::max();
 
-              const CoordinateSystem coordinate_system = world->parameters.coordinate_system->natural_coordinate_system();
+        void
+        PlateModel::get_temperatures(const std::vector<Point<3> > &positions,
+                                     const std::vector<WorldBuilder::Utilities::NaturalCoordinate> &natural_coordinates,
+                                     const std::vector<double> &depths,
+                                     const double gravity_norm,
+                                     const double feature_min_depth,
+                                     const double feature_max_depth,
+                                     std::vector<WorldBuilder::properties> &properties) const
+        {
+          if (positions.size() == 0)
+            return;
+
+          // All points share the same surface coordinates. In a cartesian
+          // coordinate system the distance to the ridge does not depend on
+          // depth at all, and in a spherical one it is an angle which only has
+          // to be scaled by the radius of each point.
+          const bool is_spherical = world->parameters.coordinate_system->natural_coordinate_system() == spherical;
+          const double column_distance = distance_to_ridge(natural_coordinates[0].get_surface_coordinates(),
+                                                           is_spherical ? 1.0 : natural_coordinates[0].get_depth_coordinate());
+
+          for (size_t i = 0; i < positions.size(); ++i)
+            if (depths[i] <= max_depth && depths[i] >= min_depth
+                && depths[i] <= feature_max_depth && depths[i] >= feature_min_depth)
+              {
+                const double distance_ridge = is_spherical
+                                              ? natural_coordinates[i].get_depth_coordinate() * column_distance
+                                              : column_distance;
+
+                properties[i].temperature = Utilities::apply_operation(operation,
+                                                                       properties[i].temperature,
+                                                                       plate_temperature(depths[i], gravity_norm, distance_ridge));
+              }
+        }
+
+
+        double
+        PlateModel::distance_to_ridge(const std::array<double,2> &surface_coordinates,
+                                      const double depth_coordinate) const
+        {
+          const CoordinateSystem coordinate_system = world->parameters.coordinate_system->natural_coordinate_system();
+          const Point<2> check_point(surface_coordinates,coordinate_system);
+          const Point<3> position = coordinate_system == cartesian
+                                    ? Point<3>(surface_coordinates[0],surface_coordinates[1],depth_coordinate,coordinate_system)
+                                    : Point<3>(depth_coordinate,surface_coordinates[0],surface_coordinates[1],coordinate_system);
+
+          double distance_ridge = std::numeric_limits<double>::max();
 
-              for (unsigned int i_ridge = 0; i_ridge < ridge_coordinates.size()-1; i_ridge++)
-                {
-                  const Point<2> segment_point0 = ridge_coordinates[i_ridge];
-                  const Point<2> segment_point1 = ridge_coordinates[i_ridge+1];
+          for (unsigned int i_ridge = 0; i_ridge < ridge_coordinates.size()-1; i_ridge++)
+            {
+              const Point<2> segment_point0 = ridge_coordinates[i_ridge];
+              const Point<2> segment_point1 = ridge_coordinates[i_ridge+1];
 
-                  const Point<2> check_point(natural_coordinate.get_surface_coordinates(),natural_coordinate.get_coordinate_system());
-                  // based on http://geomalgorithms.com/a02-_lines.html
-                  const Point<2> v = segment_point1 - segment_point0;
-                  const Point<2> w = check_point - segment_point0;
+              // based on http://geomalgorithms.com/a02-_lines.html
+              const Point<2> v = segment_point1 - segment_point0;
+              const Point<2> w = check_point - segment_point0;
 
-                  const double c1 = (w[0] * v[0] + w[1] * v[1]);
-                  const double c2 = (v[0] * v[0] + v[1] * v[1]);
+              const double c1 = (w[0] * v[0] + w[1] * v[1]);
+              const double c2 = (v[0] * v[0] + v[1] * v[1]);
 
-                  Point<2> Pb(coordinate_system);
-                  // This part is needed when we want to consider segments instead of lines
-                  // If you want to have infinite lines, use only the else statement.
+              Point<2> Pb(coordinate_system);
+              // This part is needed when we want to consider segments instead of lines
+              // If you want to have infinite lines, use only the else statement.
 
-                  if (c1 <= 0)
-                    Pb=segment_point0;
-                  else if (c2 <= c1)
-                    Pb=segment_point1;
-                  else
-                    Pb = segment_point0 + (c1 / c2) * v;
+              if (c1 <= 0)
+                Pb=segment_point0;
+              else if (c2 <= c1)
+                Pb=segment_point1;
+              else
+                Pb = segment_point0 + (c1 / c2) * v;
 
-                  Point<3> compare_point(coordinate_system);
+              Point<3> compare_point(coordinate_system);
 
-                  compare_point[0] = coordinate_system == cartesian ? Pb[0] :  natural_coordinate.get_depth_coordinate();
-                  compare_point[1] = coordinate_system == cartesian ? Pb[1] : Pb[0];
-                  compare_point[2] = coordinate_system == cartesian ? natural_coordinate.get_depth_coordinate() : Pb[1];
+              compare_point[0] = coordinate_system == cartesian ? Pb[0] :  depth_coordinate;
+              compare_point[1] = coordinate_system == cartesian ? Pb[1] : Pb[0];
+              compare_point[2] = coordinate_system == cartesian ? depth_coordinate : Pb[1];
 
-                  distance_ridge = std::min(distance_ridge,this->world->parameters.coordinate_system->distance_between_points_at_same_depth(Point<3>(natural_coordinate.get_coordinates(),natural_coordinate.get_coordinate_system()),compare_point));
+              distance_ridge = std::min(distance_ridge,this->world->parameters.coordinate_system->distance_between_points_at_same_depth(position,compare_point));
 
-                }
+            }
+          return distance_ridge;
+        }
 
-              // some aliases
-              //const double top_temperature = top_temperature;
-              //const double spreading_velocity = spreading_velocity;
-              const double thermal_diffusivity = this->world->thermal_diffusivity;
-              const double age = distance_ridge / spreading_velocity;
-              double temperature = top_temperature + (bottom_temperature_local - top_temperature) * (depth / max_depth);
 
-              for (int i = 1; i<sommation_number+1; ++i)
-                {
-                  temperature = temperature + (bottom_temperature_local - top_temperature) *
-                                ((2 / (double(i) * const_pi)) * std::sin((double(i) * const_pi * depth) / max_depth) *
-                                 std::exp((((spreading_velocity * max_depth)/(2 * thermal_diffusivity)) -
-                                           std::sqrt(((spreading_velocity*spreading_velocity*max_depth*max_depth) /
-                                                      (4*thermal_diffusivity*thermal_diffusivity)) + double(i) * double(i) * const_pi * const_pi)) *
-                                          ((spreading_velocity * age) / max_depth)));
+        double
+        PlateModel::plate_temperature(const double depth,
+                                      const double gravity_norm,
+                                      const double distance_ridge) const
+        {
+          double bottom_temperature_local = bottom_temperature;
 
-                }
+          if (bottom_temperature_local < 0)
+            {
+              bottom_temperature_local =  this->world->potential_mantle_temperature *
+                                          std::exp(((this->world->thermal_expansion_coefficient* gravity_norm) /
+                                                    this->world->specific_heat) * depth);
+            }
 
-              WBAssert(!std::isnan(temperature), "Temparture inside plate model is not a number: " << temperature
-                       << ". Relevant variables: bottom_temperature_local = " << bottom_temperature_local
-                       << ", top_temperature = " << top_temperature
-                       << ", max_depth = " << max_depth
-                       << ", spreading_velocity = " << spreading_velocity
-                       << ", thermal_diffusivity = " << thermal_diffusivity
-                       << ", age = " << age << ".");
-              WBAssert(std::isfinite(temperature), "Temparture inside plate model is not a finite: " << temperature                           << ". Relevant variables: bottom_temperature_local = " << bottom_temperature_local
-                       << ", top_temperature = " << top_temperature
-                       << ", spreading_velocity = " << spreading_velocity
-                       << ", thermal_diffusivity = " << thermal_diffusivity
-                       << ", age = " << age << ".");
+          const int sommation_number = 100;
 
+          // some aliases
+          //const double top_temperature = top_temperature;
+          //const double spreading_velocity = spreading_velocity;
+          const double thermal_diffusivity = this->world->thermal_diffusivity;
+          const double age = distance_ridge / spreading_velocity;
+          double temperature = top_temperature + (bottom_temperature_local - top_temperature) * (depth / max_depth);
 
-              return Utilities::apply_operation(operation,temperature_,temperature);
+          for (int i = 1; i<sommation_number+1; ++i)
+            {
+              temperature = temperature + (bottom_temperature_local - top_temperature) *
+                            ((2 / (double(i) * const_pi)) * std::sin((double(i) * const_pi * depth) / max_depth) *
+                             std::exp((((spreading_velocity * max_depth)/(2 * thermal_diffusivity)) -
+                                       std::sqrt(((spreading_velocity*spreading_velocity*max_depth*max_depth) /
+                                                  (4*thermal_diffusivity*thermal_diffusivity)) + double(i) * double(i) * const_pi * const_pi)) *
+                                      ((spreading_velocity * age) / max_depth)));
 
             }
-          return temperature_;
+
+          WBAssert(!std::isnan(temperature), "Temparture inside plate model is not a number: " << temperature
+                   << ". Relevant variables: bottom_temperature_local = " << bottom_temperature_local
+                   << ", top_temperature = " << top_temperature
+                   << ", max_depth = " << max_depth
+                   << ", spreading_velocity = " << spreading_velocity
+                   << ", thermal_diffusivity = " << thermal_diffusivity
+                   << ", age = " << age << ".");
+          WBAssert(std::isfinite(temperature), "Temparture inside plate model is not a finite: " << temperature                           << ". Relevant variables: bottom_temperature_local = " << bottom_temperature_local
+                   << ", top_temperature = " << top_temperature
+                   << ", spreading_velocity = " << spreading_velocity
+                   << ", thermal_diffusivity = " << thermal_diffusivity
+                   << ", age = " << age << ".");
+
+          return temperature;
         }
 
         WB_REGISTER_FEATURE_OCEANIC_PLATE_TEMPERATURE_MODEL(PlateModel, plate model)
@@ -209,4 +265,3 @@ namespace WorldBuilder
     }
   }
 }
-
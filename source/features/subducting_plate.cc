@@ -340,18 +340,97 @@ namespace WorldBuilder
           total_slab_length[i] = local_total_slab_length;
           maximum_total_slab_length = std::max(maximum_total_slab_length, local_total_slab_length);
         }
+
+      curved_planes_geometry = WorldBuilder::Utilities::CurvedPlanesGeometry(reference_point,
+                                                                             coordinates,
+                                                                             slab_segment_lengths,
+                                                                             slab_segment_angles,
+                                                                             this->world->parameters.coordinate_system,
+                                                                             one_dimensional_coordinates);
+
+      // A point can only be in the slab when it is at most the total slab length
+      // along the plane plus the thickness away from the plane, so this also
+      // bounds the horizontal distance to the coordinates. In a spherical model
+      // this distance is not easily converted to an angle, so only the depth is
+      // bounded there.
+      double maximum_distance_from_plane = 0;
+      for (unsigned int i = 0; i < slab_segment_thickness.size(); ++i)
+        for (unsigned int j = 0; j < slab_segment_thickness[i].size(); ++j)
+          maximum_distance_from_plane = std::max(maximum_distance_from_plane,
+                                                 std::max(std::max(std::fabs(slab_segment_thickness[i][j][0]),
+                                                                   std::fabs(slab_segment_thickness[i][j][1])),
+                                                          std::max(std::fabs(slab_segment_top_truncation[i][j][0]),
+                                                                   std::fabs(slab_segment_top_truncation[i][j][1]))));
+
+      const bool spherical = world->parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::spherical;
+      set_bounding_box(starting_depth,
+                       std::min(maximum_depth, maximum_total_slab_length + maximum_slab_thickness),
+                       spherical ? std::numeric_limits<double>::infinity() : maximum_total_slab_length + maximum_distance_from_plane);
     }
 
 
     double
     SubductingPlate::temperature(const Point<3> &position,
+                                 const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
                                  const double depth,
                                  const double gravity_norm,
                                  double temperature) const
     {
-      WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
-                                                                      *(world->parameters.coordinate_system));
+      properties_at_point(position, natural_coordinate, depth, gravity_norm, &temperature, 0, nullptr, nullptr, 0, nullptr, nullptr);
+      return temperature;
+    }
+
+    double
+    SubductingPlate::composition(const Point<3> &position,
+                                 const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                                 const double depth,
+                                 const unsigned int composition_number,
+                                 double composition) const
+    {
+      properties_at_point(position, natural_coordinate, depth, 0., nullptr, 1, &composition_number, &composition, 0, nullptr, nullptr);
+      return composition;
+    }
+
+
+    WorldBuilder::grains
+    SubductingPlate::grains(const Point<3> &position,
+                            const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                            const double depth,
+                            const unsigned int composition_number,
+                            WorldBuilder::grains grains) const
+    {
+      properties_at_point(position, natural_coordinate, depth, 0., nullptr, 0, nullptr, nullptr, 1, &composition_number, &grains);
+      return grains;
+    }
+
+    void
+    SubductingPlate::properties(const Point<3> &position,
+                                const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                                const double depth,
+                                const double gravity_norm,
+                                const std::vector<unsigned int> &composition_numbers,
+                                const std::vector<unsigned int> &grains_composition_numbers,
+                                WorldBuilder::properties &properties) const
+    {
+      properties_at_point(position, natural_coordinate, depth, gravity_norm, &properties.temperature,
+                          composition_numbers.size(), composition_numbers.data(), properties.compositions.data(),
+                          grains_composition_numbers.size(), grains_composition_numbers.data(), properties.grains.data());
+    }
+
 
+    void
+    SubductingPlate::properties_at_point(const Point<3> &position,
+                                         const WorldBuilder::Utilities::NaturalCoordinate &natural_coordinate,
+                                         const double depth,
+                                         const double gravity_norm,
+                                         double *temperature,
+                                         const size_t n_compositions,
+                                         const unsigned int *composition_numbers,
+                                         double *compositions,
+                                         const size_t n_grains,
+                                         const unsigned int *grains_composition_numbers,
+                                         WorldBuilder::grains *grains) const
+    {
       // The depth variable is the distance from the surface to the position, the depth
       // coordinate is the distance from the bottom of the model to the position and
       // the starting radius is the distance from the bottom of the model to the surface.
@@ -364,87 +443,151 @@ namespace WorldBuilder
                << ", starting_depth " << starting_depth
               );
 
-      // todo: explain and check -starting_depth
       if (depth <= maximum_depth && depth >= starting_depth && depth <= maximum_total_slab_length + maximum_slab_thickness)
         {
-          /*WBAssert(coordinates.size() == slab_segment_lengths.size(),
-                   "Internal error: The size of coordinates (" << coordinates.size()
-                   << ") and slab_segment_lengths (" << slab_segment_lengths.size() << ") are different.");
-          WBAssert(coordinates.size() == slab_segment_angles.size(),
-                   "Internal error: The size of coordinates (" << coordinates.size()
-                   << ") and slab_segment_angles (" << slab_segment_angles.size() << ") are different.");
-          WBAssert(coordinates.size() == slab_segment_angles.size(),
-                   "Internal error: The size of coordinates (" << coordinates.size()
-                   << ") and one_dimensional_coordinates (" << one_dimensional_coordinates.size() << ") are different.");*/
-          // todo: explain
-          std::map<std::string,double> distance_from_planes =
+          // Compute the distance to the slab once and use it for all the properties.
+          WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance_from_planes =
             WorldBuilder::Utilities::distance_point_from_curved_planes(position,
-                                                                       reference_point,
-                                                                       coordinates,
-                                                                       slab_segment_lengths,
-                                                                       slab_segment_angles,
+                                                                       natural_coordinate,
+                                                                       curved_planes_geometry,
                                                                        starting_radius,
-                                                                       this->world->parameters.coordinate_system,
-                                                                       false,
-                                                                       one_dimensional_coordinates);
-
-          const double distance_from_plane = distance_from_planes["distanceFromPlane"];
-          const double distance_along_plane = distance_from_planes["distanceAlongPlane"];
-          const double section_fraction = distance_from_planes["sectionFraction"];
-          const size_t current_section = static_cast<size_t>(std::floor(one_dimensional_coordinates[static_cast<size_t>(distance_from_planes["section"])]));
-          const size_t next_section = current_section + 1;
-          const size_t current_segment = static_cast<size_t>(distance_from_planes["segment"]); // the original value was a unsigned in, converting it back.
-          //const size_t next_segment = current_segment + 1;
-          const double segment_fraction = distance_from_planes["segmentFraction"];
-
-          if (abs(distance_from_plane) < INFINITY || (distance_along_plane) < INFINITY)
+                                                                       false);
+
+          properties_from_distance(position, depth, gravity_norm, distance_from_planes, temperature,
+                                   n_compositions, composition_numbers, compositions, n_grains, grains_composition_numbers, grains);
+        }
+    }
+
+
+    void
+    SubductingPlate::properties_column(const std::vector<Point<3> > &positions,
+                                       const std::vector<WorldBuilder::Utilities::NaturalCoordinate> &natural_coordinates,
+                                       const std::vector<double> &depths,
+                                       const double gravity_norm,
+                                       const std::vector<unsigned int> &composition_numbers,
+                                       const std::vector<unsigned int> &grains_composition_numbers,
+                                       std::vector<WorldBuilder::properties> &properties) const
+    {
+      bool in_depth_range = false;
+      for (size_t i = 0; i < positions.size(); ++i)
+        if (depths[i] <= maximum_depth && depths[i] >= starting_depth && depths[i] <= maximum_total_slab_length + maximum_slab_thickness)
+          {
+            in_depth_range = true;
+            break;
+          }
+
+      if (!in_depth_range)
+        return;
+
+      // The starting radius and the part of the distance to the curved planes
+      // which only depends on the surface coordinates are the same for all
+      // the points in the column, so compute them once.
+      const double starting_radius = natural_coordinates[0].get_depth_coordinate() + depths[0] - starting_depth;
+
+      WBAssert(std::abs(starting_radius) > std::numeric_limits<double>::epsilon(), "World Builder error: starting_radius can not be zero. "
+               << "Position = " << positions[0][0] << ":" << positions[0][1] << ":" << positions[0][2]
+               << ", natural_coordinate.get_depth_coordinate() = " << natural_coordinates[0].get_depth_coordinate()
+               << ", depth = " << depths[0]
+               << ", starting_depth " << starting_depth
+              );
+
+      const WorldBuilder::Utilities::CurvedPlanesColumn column(natural_coordinates[0],
+                                                               curved_planes_geometry,
+                                                               starting_radius);
+
+      for (size_t i = 0; i < positions.size(); ++i)
+        if (depths[i] <= maximum_depth && depths[i] >= starting_depth && depths[i] <= maximum_total_slab_length + maximum_slab_thickness)
+          properties_from_distance(positions[i],
+                                   depths[i],
+                                   gravity_norm,
+                                   WorldBuilder::Utilities::distance_point_from_curved_planes(positions[i],
+                                                                                              column,
+                                                                                              curved_planes_geometry,
+                                                                                              false),
+                                   &properties[i].temperature,
+                                   composition_numbers.size(),
+                                   composition_numbers.data(),
+                                   properties[i].compositions.data(),
+                                   grains_composition_numbers.size(),
+                                   grains_composition_numbers.data(),
+                                   properties[i].grains.data());
+    }
+
+
+    void
+    SubductingPlate::properties_from_distance(const Point<3> &position,
+                                              const double depth,
+                                              const double gravity_norm,
+                                              WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance_from_planes,
+                                              double *temperature,
+                                              const size_t n_compositions,
+                                              const unsigned int *composition_numbers,
+                                              double *compositions,
+                                              const size_t n_grains,
+                                              const unsigned int *grains_composition_numbers,
+                                              WorldBuilder::grains *grains) const
+    {
+      const double distance_from_plane = distance_from_planes.distance_from_plane;
+      const double distance_along_plane = distance_from_planes.distance_along_plane;
+      const double section_fraction = distance_from_planes.fraction_of_section;
+      const size_t current_section = static_cast<size_t>(std::floor(one_dimensional_coordinates[distance_from_planes.section]));
+      const size_t next_section = current_section + 1;
+      const size_t current_segment = distance_from_planes.segment;
+      const double segment_fraction = distance_from_planes.fraction_of_segment;
+
+      if (abs(distance_from_plane) < INFINITY || (distance_along_plane) < INFINITY)
+        {
+          // We want to do both section (horizontal) and segment (vertical) interpolation.
+          // first for thickness
+          const double thickness_up = slab_segment_thickness[current_section][current_segment][0]
+                                      + section_fraction
+                                      * (slab_segment_thickness[next_section][current_segment][0]
+                                         - slab_segment_thickness[current_section][current_segment][0]);
+          const double thickness_down = slab_segment_thickness[current_section][current_segment][1]
+                                        + section_fraction
+                                        * (slab_segment_thickness[next_section][current_segment][1]
+                                           - slab_segment_thickness[current_section][current_segment][1]);
+          const double thickness_local = thickness_up + segment_fraction * (thickness_down - thickness_up);
+          distance_from_planes.local_thickness = thickness_local;
+
+          // secondly for top truncation
+          const double top_truncation_up = slab_segment_top_truncation[current_section][current_segment][0]
+                                           + section_fraction
+                                           * (slab_segment_top_truncation[next_section][current_segment][0]
+                                              - slab_segment_top_truncation[current_section][current_segment][0]);
+          const double top_truncation_down = slab_segment_top_truncation[current_section][current_segment][1]
+                                             + section_fraction
+                                             * (slab_segment_top_truncation[next_section][current_segment][1]
+                                                - slab_segment_top_truncation[current_section][current_segment][1]);
+          const double top_truncation_local = top_truncation_up + segment_fraction * (top_truncation_down - top_truncation_up);
+
+          // if the thickness is zero, we don't need to compute anything, so return.
+          if (std::fabs(thickness_local) < 2.0 * std::numeric_limits<double>::epsilon())
+            return;
+
+          // if the thickness is smaller than what is truncated off at the top, we don't need to compute anything, so return.
+          if (thickness_local < top_truncation_local)
+            return;
+
+          const double max_slab_length = total_slab_length[current_section] +
+                                         section_fraction *
+                                         (total_slab_length[next_section] - total_slab_length[current_section]);
+
+          if (distance_from_plane >= top_truncation_local &&
+              distance_from_plane <= thickness_local &&
+              distance_along_plane >= 0 &&
+              distance_along_plane <= max_slab_length)
             {
-              // We want to do both section (horizontal) and segment (vertical) interpolation.
-              // first for thickness
-              const double thickness_up = slab_segment_thickness[current_section][current_segment][0]
-                                          + section_fraction
-                                          * (slab_segment_thickness[next_section][current_segment][0]
-                                             - slab_segment_thickness[current_section][current_segment][0]);
-              const double thickness_down = slab_segment_thickness[current_section][current_segment][1]
-                                            + section_fraction
-                                            * (slab_segment_thickness[next_section][current_segment][1]
-                                               - slab_segment_thickness[current_section][current_segment][1]);
-              const double thickness_local = thickness_up + segment_fraction * (thickness_down - thickness_up);
-              distance_from_planes["thicknessLocal"] = thickness_local;
-
-              // secondly for top truncation
-              const double top_truncation_up = slab_segment_top_truncation[current_section][current_segment][0]
-                                               + section_fraction
-                                               * (slab_segment_top_truncation[next_section][current_segment][0]
-                                                  - slab_segment_top_truncation[current_section][current_segment][0]);
-              const double top_truncation_down = slab_segment_top_truncation[current_section][current_segment][1]
-                                                 + section_fraction
-                                                 * (slab_segment_top_truncation[next_section][current_segment][1]
-                                                    - slab_segment_top_truncation[current_section][current_segment][1]);
-              const double top_truncation_local = top_truncation_up + segment_fraction * (top_truncation_down - top_truncation_up);
-
-              // if the thickness is zero, we don't need to compute anything, so return.
-              if (std::fabs(thickness_local) < 2.0 * std::numeric_limits<double>::epsilon())
-                return temperature;
-
-              // if the thickness is smaller than what is truncated off at the top, we don't need to compute anything, so return.
-              if (thickness_local < top_truncation_local)
-                return temperature;
-
-              const double max_slab_length = total_slab_length[current_section] +
-                                             section_fraction *
-                                             (total_slab_length[next_section] - total_slab_length[current_section]);
-
-              if (distance_from_plane >= top_truncation_local &&
-                  distance_from_plane <= thickness_local &&
-                  distance_along_plane >= 0 &&
-                  distance_along_plane <= max_slab_length)
+              // Inside the slab!
+              const auto &current_segment_models = segment_vector[current_section][current_segment];
+              const auto &next_segment_models = segment_vector[next_section][current_segment];
+
+              if (temperature != nullptr)
                 {
-                  // Inside the slab!
-                  double temperature_current_section = temperature;
-                  double temperature_next_section = temperature;
+                  double temperature_current_section = *temperature;
+                  double temperature_next_section = *temperature;
 
-                  for (auto &temperature_model: segment_vector[current_section][current_segment].temperature_systems)
+                  for (auto &temperature_model: current_segment_models.temperature_systems)
                     {
                       temperature_current_section = temperature_model->get_temperature(position,
                                                                                        depth,
@@ -458,10 +601,9 @@ namespace WorldBuilder
                                << ", based on a temperature model with the name " << temperature_model->get_name());
                       WBAssert(std::isfinite(temperature_current_section), "Temparture is not a finite: " << temperature_current_section
                                << ", based on a temperature model with the name " << temperature_model->get_name());
-
                     }
 
-                  for (auto &temperature_model: segment_vector[next_section][current_segment].temperature_systems)
+                  for (auto &temperature_model: next_segment_models.temperature_systems)
                     {
                       temperature_next_section = temperature_model->get_temperature(position,
                                                                                     depth,
@@ -475,291 +617,100 @@ namespace WorldBuilder
                                << ", based on a temperature model with the name " << temperature_model->get_name());
                       WBAssert(std::isfinite(temperature_next_section), "Temparture is not a finite: " << temperature_next_section
                                << ", based on a temperature model with the name " << temperature_model->get_name());
-
                     }
 
                   // linear interpolation between current and next section temperatures
-                  temperature = temperature_current_section + section_fraction * (temperature_next_section - temperature_current_section);
+                  *temperature = temperature_current_section + section_fraction * (temperature_next_section - temperature_current_section);
                 }
-            }
-        }
-      return temperature;
-    }
-
-    double
-    SubductingPlate::composition(const Point<3> &position,
-                                 const double depth,
-                                 const unsigned int composition_number,
-                                 double composition) const
-    {
 
-      WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
-                                                                      *(world->parameters.coordinate_system));
-      // todo: explain
-      const double starting_radius = natural_coordinate.get_depth_coordinate() + depth - starting_depth;
-
-      // todo: explain and check -starting_depth
-      if (depth <= maximum_depth && depth >= starting_depth && depth <= maximum_total_slab_length + maximum_slab_thickness)
-        {
-          // todo: explain
-          std::map<std::string,double> distance_from_planes =
-            WorldBuilder::Utilities::distance_point_from_curved_planes(position,
-                                                                       reference_point,
-                                                                       coordinates,
-                                                                       slab_segment_lengths,
-                                                                       slab_segment_angles,
-                                                                       starting_radius,
-                                                                       this->world->parameters.coordinate_system,
-                                                                       false,
-                                                                       one_dimensional_coordinates);
-
-          const double distance_from_plane = distance_from_planes["distanceFromPlane"];
-          const double distance_along_plane = distance_from_planes["distanceAlongPlane"];
-          const double section_fraction = distance_from_planes["sectionFraction"];
-          const size_t current_section = static_cast<size_t>(std::floor(one_dimensional_coordinates[static_cast<size_t>(distance_from_planes["section"])]));
-          const size_t next_section = current_section + 1;
-          const size_t current_segment = static_cast<size_t>(distance_from_planes["segment"]); // the original value was a unsigned in, converting it back.
-          //const size_t next_segment = current_segment + 1;
-          const double segment_fraction = distance_from_planes["segmentFraction"];
-
-          if (abs(distance_from_plane) < INFINITY || (distance_along_plane) < INFINITY)
-            {
-              // We want to do both section (horizontal) and segment (vertical) interpolation.
-
-              // We want to do both section (horizontal) and segment (vertical) interpolation.
-              // first for thickness
-              const double thickness_up = slab_segment_thickness[current_section][current_segment][0]
-                                          + section_fraction
-                                          * (slab_segment_thickness[next_section][current_segment][0]
-                                             - slab_segment_thickness[current_section][current_segment][0]);
-              const double thickness_down = slab_segment_thickness[current_section][current_segment][1]
-                                            + section_fraction
-                                            * (slab_segment_thickness[next_section][current_segment][1]
-                                               - slab_segment_thickness[current_section][current_segment][1]);
-              const double thickness_local = thickness_up + segment_fraction * (thickness_down - thickness_up);
-              distance_from_planes["thicknessLocal"] = thickness_local;
-
-              // secondly for top truncation
-              const double top_truncation_up = slab_segment_top_truncation[current_section][current_segment][0]
-                                               + section_fraction
-                                               * (slab_segment_top_truncation[next_section][current_segment][0]
-                                                  - slab_segment_top_truncation[current_section][current_segment][0]);
-              const double top_truncation_down = slab_segment_top_truncation[current_section][current_segment][1]
-                                                 + section_fraction
-                                                 * (slab_segment_top_truncation[next_section][current_segment][1]
-                                                    - slab_segment_top_truncation[current_section][current_segment][1]);
-              const double top_truncation_local = top_truncation_up + segment_fraction * (top_truncation_down - top_truncation_up);
-
-              // if the thickness is zero, we don't need to compute anything, so return.
-              if (std::fabs(thickness_local) < 2.0 * std::numeric_limits<double>::epsilon())
-                return composition;
-
-              // if the thickness is smaller than what is truncated off at the top, we don't need to compute anything, so return.
-              if (thickness_local < top_truncation_local)
-                return composition;
-
-              const double max_slab_length = total_slab_length[current_section] +
-                                             section_fraction *
-                                             (total_slab_length[next_section] - total_slab_length[current_section]);
-
-              if (distance_from_plane >= top_truncation_local &&
-                  distance_from_plane <= thickness_local &&
-                  distance_along_plane >= 0 &&
-                  distance_along_plane <= max_slab_length)
+              for (size_t i = 0; i < n_compositions; ++i)
                 {
-                  // Inside the slab!
-
-                  double composition_current_section = composition;
-                  double composition_next_section = composition;
+                  double composition_current_section = compositions[i];
+                  double composition_next_section = compositions[i];
 
-                  for (auto &composition_model: segment_vector[current_section][current_segment].composition_systems)
+                  for (auto &composition_model: current_segment_models.composition_systems)
                     {
                       composition_current_section = composition_model->get_composition(position,
                                                                                        depth,
-                                                                                       composition_number,
+                                                                                       composition_numbers[i],
                                                                                        composition_current_section,
                                                                                        starting_depth,
                                                                                        maximum_depth,
                                                                                        distance_from_planes);
 
                       WBAssert(!std::isnan(composition_current_section), "Composition_current_section is not a number: " << composition_current_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
+                               << ", based on a composition model with the name " << composition_model->get_name());
                       WBAssert(std::isfinite(composition_current_section), "Composition_current_section is not a finite: " << composition_current_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
-
+                               << ", based on a composition model with the name " << composition_model->get_name());
                     }
 
-                  for (auto &composition_model: segment_vector[next_section][current_segment].composition_systems)
+                  for (auto &composition_model: next_segment_models.composition_systems)
                     {
                       composition_next_section = composition_model->get_composition(position,
                                                                                     depth,
-                                                                                    composition_number,
+                                                                                    composition_numbers[i],
                                                                                     composition_next_section,
                                                                                     starting_depth,
                                                                                     maximum_depth,
                                                                                     distance_from_planes);
 
                       WBAssert(!std::isnan(composition_next_section), "Composition_next_section is not a number: " << composition_next_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
+                               << ", based on a composition model with the name " << composition_model->get_name());
                       WBAssert(std::isfinite(composition_next_section), "Composition_next_section is not a finite: " << composition_next_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
-
+                               << ", based on a composition model with the name " << composition_model->get_name());
                     }
 
-                  // linear interpolation between current and next section temperatures
-                  composition = composition_current_section + section_fraction * (composition_next_section - composition_current_section);
-
-
+                  // linear interpolation between current and next section compositions
+                  compositions[i] = composition_current_section + section_fraction * (composition_next_section - composition_current_section);
                 }
-            }
-        }
-
-      return composition;
-    }
-
-
-    WorldBuilder::grains
-    SubductingPlate::grains(const Point<3> &position,
-                            const double depth,
-                            const unsigned int composition_number,
-                            WorldBuilder::grains grains) const
-    {
-
-      WorldBuilder::Utilities::NaturalCoordinate natural_coordinate = WorldBuilder::Utilities::NaturalCoordinate(position,
-                                                                      *(world->parameters.coordinate_system));
-      // todo: explain
-      const double starting_radius = natural_coordinate.get_depth_coordinate() + depth - starting_depth;
 
-      // todo: explain and check -starting_depth
-      if (depth <= maximum_depth && depth >= starting_depth && depth <= maximum_total_slab_length + maximum_slab_thickness)
-        {
-          // todo: explain
-          std::map<std::string,double> distance_from_planes =
-            WorldBuilder::Utilities::distance_point_from_curved_planes(position,
-                                                                       reference_point,
-                                                                       coordinates,
-                                                                       slab_segment_lengths,
-                                                                       slab_segment_angles,
-                                                                       starting_radius,
-                                                                       this->world->parameters.coordinate_system,
-                                                                       false,
-                                                                       one_dimensional_coordinates);
-
-          const double distance_from_plane = distance_from_planes["distanceFromPlane"];
-          const double distance_along_plane = distance_from_planes["distanceAlongPlane"];
-          const double section_fraction = distance_from_planes["sectionFraction"];
-          const size_t current_section = static_cast<size_t>(std::floor(one_dimensional_coordinates[static_cast<size_t>(distance_from_planes["section"])]));
-          const size_t next_section = current_section + 1;
-          const size_t current_segment = static_cast<size_t>(distance_from_planes["segment"]); // the original value was a unsigned in, converting it back.
-          //const size_t next_segment = current_segment + 1;
-          const double segment_fraction = distance_from_planes["segmentFraction"];
-
-          if (abs(distance_from_plane) < INFINITY || (distance_along_plane) < INFINITY)
-            {
-              // We want to do both section (horizontal) and segment (vertical) interpolation.
-
-              // We want to do both section (horizontal) and segment (vertical) interpolation.
-              // first for thickness
-              const double thickness_up = slab_segment_thickness[current_section][current_segment][0]
-                                          + section_fraction
-                                          * (slab_segment_thickness[next_section][current_segment][0]
-                                             - slab_segment_thickness[current_section][current_segment][0]);
-              const double thickness_down = slab_segment_thickness[current_section][current_segment][1]
-                                            + section_fraction
-                                            * (slab_segment_thickness[next_section][current_segment][1]
-                                               - slab_segment_thickness[current_section][current_segment][1]);
-              const double thickness_local = thickness_up + segment_fraction * (thickness_down - thickness_up);
-              distance_from_planes["thicknessLocal"] = thickness_local;
-
-              // secondly for top truncation
-              const double top_truncation_up = slab_segment_top_truncation[current_section][current_segment][0]
-                                               + section_fraction
-                                               * (slab_segment_top_truncation[next_section][current_segment][0]
-                                                  - slab_segment_top_truncation[current_section][current_segment][0]);
-              const double top_truncation_down = slab_segment_top_truncation[current_section][current_segment][1]
-                                                 + section_fraction
-                                                 * (slab_segment_top_truncation[next_section][current_segment][1]
-                                                    - slab_segment_top_truncation[current_section][current_segment][1]);
-              const double top_truncation_local = top_truncation_up + segment_fraction * (top_truncation_down - top_truncation_up);
-
-              // if the thickness is zero, we don't need to compute anything, so return.
-              if (std::fabs(thickness_local) < 2.0 * std::numeric_limits<double>::epsilon())
-                return grains;
-
-              // if the thickness is smaller than what is truncated off at the top, we don't need to compute anything, so return.
-              if (thickness_local < top_truncation_local)
-                return grains;
-
-              const double max_slab_length = total_slab_length[current_section] +
-                                             section_fraction *
-                                             (total_slab_length[next_section] - total_slab_length[current_section]);
-
-              if (distance_from_plane >= top_truncation_local &&
-                  distance_from_plane <= thickness_local &&
-                  distance_along_plane >= 0 &&
-                  distance_along_plane <= max_slab_length)
+              for (size_t i = 0; i < n_grains; ++i)
                 {
-                  // Inside the slab!
-                  WorldBuilder::grains  grains_current_section = grains;
-                  WorldBuilder::grains  grains_next_section = grains;
+                  WorldBuilder::grains &point_grains = grains[i];
+                  WorldBuilder::grains grains_current_section = point_grains;
+                  WorldBuilder::grains grains_next_section = point_grains;
 
-                  for (auto &grains_model: segment_vector[current_section][current_segment].grains_systems)
+                  for (auto &grains_model: current_segment_models.grains_systems)
                     {
                       grains_current_section = grains_model->get_grains(position,
                                                                         depth,
-                                                                        composition_number,
+                                                                        grains_composition_numbers[i],
                                                                         grains_current_section,
                                                                         starting_depth,
                                                                         maximum_depth,
                                                                         distance_from_planes);
-
-                      /*WBAssert(!std::isnan(composition_current_section), "Composition_current_section is not a number: " << composition_current_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
-                      WBAssert(std::isfinite(composition_current_section), "Composition_current_section is not a finite: " << composition_current_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());*/
-
                     }
 
-                  for (auto &grains_model: segment_vector[next_section][current_segment].grains_systems)
+                  for (auto &grains_model: next_segment_models.grains_systems)
                     {
                       grains_next_section = grains_model->get_grains(position,
                                                                      depth,
-                                                                     composition_number,
+                                                                     grains_composition_numbers[i],
                                                                      grains_next_section,
                                                                      starting_depth,
                                                                      maximum_depth,
                                                                      distance_from_planes);
-
-                      /*WBAssert(!std::isnan(composition_next_section), "Composition_next_section is not a number: " << composition_next_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());
-                      WBAssert(std::isfinite(composition_next_section), "Composition_next_section is not a finite: " << composition_next_section
-                               << ", based on a temperature model with the name " << composition_model->get_name());*/
-
                     }
 
-                  // linear interpolation between current and next section temperatures
-                  for (size_t i = 0; i < grains.sizes.size(); i++)
+                  // linear interpolation between current and next section grain sizes
+                  for (size_t j = 0; j < point_grains.sizes.size(); j++)
                     {
-                      grains.sizes[i] = grains_current_section.sizes[i] + section_fraction * (grains_next_section.sizes[i] - grains_current_section.sizes[i]);
+                      point_grains.sizes[j] = grains_current_section.sizes[j] + section_fraction * (grains_next_section.sizes[j] - grains_current_section.sizes[j]);
                     }
 
                   // average two rotations matrices throu quaternions.
-                  for (size_t i = 0; i < grains_current_section.rotation_matrices.size(); i++)
+                  for (size_t j = 0; j < grains_current_section.rotation_matrices.size(); j++)
                     {
-                      glm::quaternion::quat quat_current = glm::quaternion::quat_cast(grains_current_section.rotation_matrices[i]);
-                      glm::quaternion::quat quat_next = glm::quaternion::quat_cast(grains_next_section.rotation_matrices[i]);
+                      glm::quaternion::quat quat_current = glm::quaternion::quat_cast(grains_current_section.rotation_matrices[j]);
+                      glm::quaternion::quat quat_next = glm::quaternion::quat_cast(grains_next_section.rotation_matrices[j]);
 
                       glm::quaternion::quat quat_average = glm::quaternion::slerp(quat_current,quat_next,section_fraction);
 
-                      grains.rotation_matrices[i] = glm::quaternion::mat3_cast(quat_average);
+                      point_grains.rotation_matrices[j] = glm::quaternion::mat3_cast(quat_average);
                     }
-
-
                 }
             }
         }
-
-      return grains;
     }
 
     /**
@@ -21,6 +21,7 @@
 #include <world_builder/assert.h>
 #include <world_builder/nan.h>
 #include <world_builder/parameters.h>
+#include <world_builder/random_number_generator.h>
 
 #include <world_builder/types/array.h>
 #include <world_builder/types/bool.h>
@@ -46,7 +47,8 @@ namespace WorldBuilder
           :
           min_depth(NaN::DSNAN),
           max_depth(NaN::DSNAN),
-          operation("")
+          operation(""),
+          random_number_stream(0)
         {
           this->world = world_;
           this->name = "random uniform distribution";
@@ -96,6 +98,7 @@ namespace WorldBuilder
           operation = prm.get<std::string>("orientation operation");
           grain_sizes = prm.get_vector<double>("grain sizes");
           normalize_grain_sizes = prm.get_vector<bool>("normalize grain sizes");
+          random_number_stream = CounterBasedRandomNumberGenerator::get_stream(prm.get_full_json_path());
 
 
           WBAssertThrow(compositions.size() == grain_sizes.size(),
@@ -108,22 +111,27 @@ namespace WorldBuilder
 
 
         WorldBuilder::grains
-        RandomUniformDistribution::get_grains(const Point<3> &,
+        RandomUniformDistribution::get_grains(const Point<3> &position,
                                               const double,
                                               const unsigned int composition_number,
                                               WorldBuilder::grains grains_,
                                               const double,
                                               const double,
-                                              const std::map<std::string,double> &distance_from_planes) const
+                                              const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const
         {
           WorldBuilder::grains  grains_local = grains_;
-          if (distance_from_planes.at("distanceFromPlane") <= max_depth && distance_from_planes.at("distanceFromPlane") >= min_depth)
+          if (distance_from_planes.distance_from_plane <= max_depth && distance_from_planes.distance_from_plane >= min_depth)
             {
               for (unsigned int i =0; i < compositions.size(); ++i)
                 {
                   if (compositions[i] == composition_number)
                     {
-                      std::uniform_real_distribution<> dist(0.0,1.0);
+                      // The random numbers only depend on the seed, the position, the composition
+                      // number and this model, so the result does not depend on the order of the queries.
+                      CounterBasedRandomNumberGenerator random_number_generator(world->get_random_number_seed(),
+                                                                                position,
+                                                                                composition_number,
+                                                                                random_number_stream);
                       for (auto &&it_rotation_matrices : grains_local.rotation_matrices)
                         {
                           // set a uniform random a_cosine_matrix per grain
@@ -141,9 +149,9 @@ namespace WorldBuilder
                           // the public domain, and is yours to study, modify, and use."
 
                           // first generate three random numbers between 0 and 1 and multiply them with 2 PI or 2 for z. Note that these are not the same as phi_1, theta and phi_2.
-                          double one = dist(world->get_random_number_engine());
-                          double two = dist(world->get_random_number_engine());
-                          double three = dist(world->get_random_number_engine());
+                          double one = random_number_generator.uniform();
+                          double two = random_number_generator.uniform();
+                          double three = random_number_generator.uniform();
 
                           double theta = 2.0 * const_pi * one; // Rotation about the pole (Z)
                           double phi = 2.0 * const_pi * two; // For direction of pole deflection.
@@ -188,7 +196,7 @@ namespace WorldBuilder
                       double total_size = 0;
                       for (auto &&it_sizes : grains_local.sizes)
                         {
-                          it_sizes = grain_sizes[i] < 0 ? dist(world->get_random_number_engine()) : grain_sizes[i];
+                          it_sizes = grain_sizes[i] < 0 ? random_number_generator.uniform() : grain_sizes[i];
                           total_size += it_sizes;
                         }
 
@@ -146,12 +146,12 @@ namespace WorldBuilder
                                     double temperature_,
                                     const double,
                                     const double,
-                                    const std::map<std::string,double> &distance_from_planes) const
+                                    const WorldBuilder::Utilities::PointDistanceFromCurvedPlanes &distance_from_planes) const
         {
-          const double thickness_local = std::min(distance_from_planes.at("thicknessLocal"), max_depth);
-          const double distance_from_plane = distance_from_planes.at("distanceFromPlane");
-          const double distance_along_plane = distance_from_planes.at("distanceAlongPlane");
-          const double average_angle = distance_from_planes.at("averageAngle");
+          const double thickness_local = std::min(distance_from_planes.local_thickness, max_depth);
+          const double distance_from_plane = distance_from_planes.distance_from_plane;
+          const double distance_along_plane = distance_from_planes.distance_along_plane;
+          const double average_angle = distance_from_planes.average_angle;
 
           if (distance_from_plane <= max_depth && distance_from_plane >= min_depth)
             {
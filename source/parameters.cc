@@ -16,21 +16,30 @@
    You should have received a copy of the GNU Lesser General Public License
    along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <tuple>
 
-#include <rapidjson/istreamwrapper.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "rapidjson/pointer.h"
 #include "rapidjson/prettywriter.h"
-#include "rapidjson/latexwriter.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/error/en.h"
 
 #include <world_builder/assert.h>
 #include <world_builder/config.h>
 #include <world_builder/parameters.h>
+#include <world_builder/schema_declarations.h>
 #include <world_builder/utilities.h>
 
 #include <world_builder/types/object.h>
@@ -68,88 +77,496 @@ using namespace rapidjson;
 
 namespace WorldBuilder
 {
+  namespace
+  {
+    /**
+     * The first bytes of a compiled world file and the version of its format.
+     * The version has to be increased when the format changes.
+     */
+    const char compiled_world_magic[8] = {'W','B','W','O','R','L','D','\0'};
+    const std::uint32_t compiled_world_format_version = 1;
+
+    /**
+     * The types of the values in a compiled world file.
+     */
+    enum CompiledValueType : unsigned char
+    {
+      compiled_null,
+      compiled_false,
+      compiled_true,
+      compiled_int,
+      compiled_uint,
+      compiled_double,
+      compiled_string,
+      compiled_array,
+      compiled_object
+    };
+
+    /**
+     * Returns a json array with the values of the vector.
+     */
+    template<class T>
+    Value
+    vector_to_value(const std::vector<T> &vector, Document::AllocatorType &allocator)
+    {
+      Value array(kArrayType);
+      for (size_t i = 0; i < vector.size(); ++i)
+        array.PushBack(Value(vector[i]), allocator);
+      return array;
+    }
+
+    template<class T>
+    void
+    write_binary(std::string &buffer, const T value)
+    {
+      buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    void
+    write_binary(std::string &buffer, const char *string, const std::uint32_t length)
+    {
+      write_binary(buffer, length);
+      buffer.append(string, length);
+    }
+
+    /**
+     * Appends a compact binary representation of a json value to the buffer.
+     * Integers and doubles are stored separately, so that the value can be
+     * retrieved in the same way as from the parsed json file.
+     */
+    void
+    write_value(std::string &buffer, const Value &value)
+    {
+      switch (value.GetType())
+        {
+          case kNullType:
+            write_binary(buffer, compiled_null);
+            break;
+          case kFalseType:
+            write_binary(buffer, compiled_false);
+            break;
+          case kTrueType:
+            write_binary(buffer, compiled_true);
+            break;
+          case kNumberType:
+            if (value.IsDouble())
+              {
+                write_binary(buffer, compiled_double);
+                write_binary(buffer, value.GetDouble());
+              }
+            else if (value.IsUint64())
+              {
+                write_binary(buffer, compiled_uint);
+                write_binary(buffer, value.GetUint64());
+              }
+            else
+              {
+                write_binary(buffer, compiled_int);
+                write_binary(buffer, value.GetInt64());
+              }
+            break;
+          case kStringType:
+            write_binary(buffer, compiled_string);
+            write_binary(buffer, value.GetString(), value.GetStringLength());
+            break;
+          case kArrayType:
+            write_binary(buffer, compiled_array);
+            write_binary(buffer, static_cast<std::uint32_t>(value.Size()));
+            for (auto &element : value.GetArray())
+              write_value(buffer, element);
+            break;
+          case kObjectType:
+            write_binary(buffer, compiled_object);
+            write_binary(buffer, static_cast<std::uint32_t>(value.MemberCount()));
+            for (auto &member : value.GetObject())
+              {
+                write_binary(buffer, member.name.GetString(), member.name.GetStringLength());
+                write_value(buffer, member.value);
+              }
+            break;
+          default:
+            WBAssertThrow(false, "Unknown json value type: " << value.GetType() << ".");
+        }
+    }
+
+    /**
+     * Reads binary data from a buffer, checking that the buffer is long
+     * enough.
+     */
+    class BinaryReader
+    {
+      public:
+        BinaryReader(const char *begin_, const char *end_)
+          :
+          current(begin_),
+          end(end_)
+        {}
+
+        template<class T>
+        T read()
+        {
+          T value;
+          std::memcpy(&value, read_bytes(sizeof(T)), sizeof(T));
+          return value;
+        }
+
+        const char *read_bytes(const size_t n_bytes)
+        {
+          WBAssertThrow(static_cast<size_t>(end - current) >= n_bytes, "The compiled world file is truncated.");
+          const char *bytes = current;
+          current += n_bytes;
+          return bytes;
+        }
+
+        /**
+         * Reads a value and its children. The sizes of the arrays and
+         * objects are checked against the bytes which are left before
+         * anything is allocated, and the nesting depth is limited, so that
+         * a corrupt compiled world can not exhaust the memory or the stack.
+         */
+        void read_value(Value &value, Document::AllocatorType &allocator, const unsigned int depth = 0)
+        {
+          WBAssertThrow(depth <= max_depth, "The compiled world file is nested more than " << max_depth << " levels deep.");
+          const unsigned char type = read<unsigned char>();
+          switch (type)
+            {
+              case compiled_null:
+                value.SetNull();
+                break;
+              case compiled_false:
+                value.SetBool(false);
+                break;
+              case compiled_true:
+                value.SetBool(true);
+                break;
+              case compiled_int:
+                value.SetInt64(read<std::int64_t>());
+                break;
+              case compiled_uint:
+                value.SetUint64(read<std::uint64_t>());
+                break;
+              case compiled_double:
+                value.SetDouble(read<double>());
+                break;
+              case compiled_string:
+              {
+                const std::uint32_t length = read<std::uint32_t>();
+                value.SetString(read_bytes(length), length, allocator);
+                break;
+              }
+              case compiled_array:
+              {
+                // Every element takes at least the byte of its type.
+                const std::uint32_t size = read<std::uint32_t>();
+                WBAssertThrow(size <= remaining_bytes(), "The compiled world file is truncated.");
+                value.SetArray();
+                value.Reserve(size, allocator);
+                for (std::uint32_t i = 0; i < size; ++i)
+                  {
+                    Value element;
+                    read_value(element, allocator, depth + 1);
+                    value.PushBack(element, allocator);
+                  }
+                break;
+              }
+              case compiled_object:
+              {
+                // Every member takes at least the length of its name and
+                // the byte of its type.
+                const std::uint32_t size = read<std::uint32_t>();
+                WBAssertThrow(size <= remaining_bytes() / (sizeof(std::uint32_t) + 1), "The compiled world file is truncated.");
+                value.SetObject();
+                for (std::uint32_t i = 0; i < size; ++i)
+                  {
+                    const std::uint32_t length = read<std::uint32_t>();
+                    Value name(read_bytes(length), length, allocator);
+                    Value member;
+                    read_value(member, allocator, depth + 1);
+                    value.AddMember(name, member, allocator);
+                  }
+                break;
+              }
+              default:
+                WBAssertThrow(false, "The compiled world file contains an unknown value type: " << static_cast<unsigned int>(type) << ".");
+            }
+        }
+
+        bool at_end() const
+        {
+          return current == end;
+        }
+
+        size_t remaining_bytes() const
+        {
+          return static_cast<size_t>(end - current);
+        }
+
+      private:
+        /**
+         * The largest nesting depth of the values in a compiled world.
+         */
+        static const unsigned int max_depth = 256;
+
+        const char *current;
+        const char *end;
+    };
+
+    /**
+     * The full version of the World Builder. A compiled world can only be
+     * loaded by the same version which wrote it, because it contains the
+     * default values of that version.
+     */
+    std::string
+    full_version()
+    {
+      return Version::MAJOR + "." + Version::MINOR + "." + Version::PATCH + Version::LABEL;
+    }
+
+    /**
+     * Returns the member of an object or the element of an array with the
+     * given name, in the same way as a single token of a json pointer, or a
+     * null pointer if it does not exist.
+     */
+    template<class ValueType>
+    ValueType *
+    find_child(ValueType *value, const char *token, const size_t length)
+    {
+      if (value == nullptr)
+        return nullptr;
+
+      if (value->IsObject())
+        {
+          const auto member = value->FindMember(Value(StringRef(token, static_cast<SizeType>(length))));
+          return member != value->MemberEnd() ? &member->value : nullptr;
+        }
+
+      if (value->IsArray())
+        {
+          if (length == 0)
+            return nullptr;
+
+          size_t index = 0;
+          for (size_t i = 0; i < length; ++i)
+            {
+              if (token[i] < '0' || token[i] > '9' || index > value->Size())
+                return nullptr;
+              index = index * 10 + static_cast<size_t>(token[i] - '0');
+            }
+          return index < value->Size() ? &(*value)[static_cast<SizeType>(index)] : nullptr;
+        }
+
+      return nullptr;
+    }
+
+    template<class ValueType>
+    ValueType *
+    find_child(ValueType *value, const std::string &token)
+    {
+      return find_child(value, token.c_str(), token.size());
+    }
+
+    /**
+     * Returns the value at the given path relative to the given value, in
+     * which the levels are separated by a slash, or a null pointer if it
+     * does not exist.
+     */
+    template<class ValueType>
+    ValueType *
+    find_relative(ValueType *value, const std::string &relative_path)
+    {
+      if (relative_path.empty())
+        return value;
+
+      size_t begin = 0;
+      while (value != nullptr)
+        {
+          const size_t end = std::min(relative_path.find('/', begin), relative_path.size());
+          value = find_child(value, relative_path.c_str() + begin, end - begin);
+          if (end == relative_path.size())
+            break;
+          begin = end + 1;
+        }
+      return value;
+    }
+  }
+
+
   Parameters::Parameters(World &world_)
     :
-    world(world_)
+    world(world_),
+    shared_declarations(nullptr),
+    write_default_values(false),
+    value_cursor(1, &parameters)
   {
   }
 
   Parameters::~Parameters()
   {}
 
-  void Parameters::initialize(std::string &filename, bool has_output_dir, std::string output_dir)
+  /**
+   * The text of a world builder file which is parsed in-situ. The file is
+   * mapped into memory with a private copy-on-write mapping, so the parser
+   * can terminate and unescape the strings in place without changing the
+   * file. The strings of the parsed document point into this buffer, so it
+   * has to live as long as the document.
+   */
+  struct Parameters::InsituBuffer
   {
+    explicit InsituBuffer(const std::string &filename);
+    ~InsituBuffer();
+
+    /**
+     * The null terminated text of the file and its size without the null
+     * character.
+     */
+    char *data;
+    size_t size;
+
+    /**
+     * The memory mapping of the file, or a null pointer if the file has been
+     * copied into the copy.
+     */
+    void *mapping;
+    std::vector<char> copy;
+  };
+
+
+  Parameters::InsituBuffer::InsituBuffer(const std::string &filename)
+    :
+    data(nullptr),
+    size(0),
+    mapping(nullptr)
+  {
+#ifndef _WIN32
+    const int file = open(filename.c_str(), O_RDONLY);
+    WBAssertThrow(file >= 0, "Could not find the world builder file at the specified location: " + filename);
 
-    if (has_output_dir == true)
+    struct stat file_status;
+    if (fstat(file, &file_status) != 0)
       {
-        StringBuffer buffer;
-        std::ofstream file;
-        // write out declarations
-        file.open (output_dir + "world_buider_declarations.tex");
-
-        WBAssertThrow(file.is_open(), "Error: Could not open file '" + output_dir + "world_buider_declarations.tex' for string the tex declarations.");
-
-        LatexWriter<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteNanAndInfFlag> tex_writer(buffer);
-        declarations.Accept(tex_writer);
-        file << buffer.GetString();
-        file.close();
+        close(file);
+        WBAssertThrow(false, "Could not read the world builder file " << filename << ".");
+      }
+    size = static_cast<size_t>(file_status.st_size);
 
-        // write out json schema
-        buffer.Clear();
-        file.open (output_dir + "world_buider_declarations.schema.json");
-        WBAssertThrow(file.is_open(), "Error: Could not open file '" + output_dir + "world_buider_declarations.schema.json' for string the json declarations.");
-        PrettyWriter<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteNanAndInfFlag> json_writer(buffer);
-        declarations.Accept(json_writer);
-        file << buffer.GetString();
-        file.close();
+    // The bytes after the end of the file in the last page of a mapping are
+    // zero, which terminates the text for the parser. A file which exactly
+    // fills its pages is copied instead.
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    if (S_ISREG(file_status.st_mode) && size % page_size != 0)
+      {
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED)
+          mapping = nullptr;
       }
 
-    path_level =0;
-    // Now read in the world builder file into a file stream and
-    // put it into a the rapidjason document
-    std::ifstream json_input_stream(filename.c_str());
+    // The size of a pipe or another file which is not a regular file is not
+    // known, so the copy is read until the end of the file and grows as
+    // needed.
+    ssize_t result = 0;
+    if (mapping == nullptr)
+      {
+        copy.resize(S_ISREG(file_status.st_mode) ? size + 1 : 65536);
+        size_t n_read = 0;
+        while ((result = read(file, copy.data() + n_read, copy.size() - 1 - n_read)) > 0)
+          {
+            n_read += static_cast<size_t>(result);
+            if (n_read == copy.size() - 1)
+              copy.resize(2 * copy.size());
+          }
+        size = n_read;
+        copy[size] = '\0';
+      }
+    close(file);
+    WBAssertThrow(result >= 0, "Could not read the world builder file " << filename << ".");
 
-    // Get world builder file and check whether it exists
+    data = mapping != nullptr ? static_cast<char *>(mapping) : copy.data();
+#else
+    std::ifstream json_input_stream(filename.c_str(), std::ios::binary);
     WBAssertThrow(json_input_stream.good(),
                   "Could not find the world builder file at the specified location: " + filename);
 
-    WBAssert(json_input_stream, "Could not read the world builder file.");
+    copy.assign(std::istreambuf_iterator<char>(json_input_stream), std::istreambuf_iterator<char>());
+    WBAssertThrow(!json_input_stream.bad(), "Could not read the world builder file " << filename << ".");
+    size = copy.size();
+    copy.push_back('\0');
+    data = copy.data();
+#endif
+  }
 
-    rapidjson::IStreamWrapper isw(json_input_stream);
+
+  Parameters::InsituBuffer::~InsituBuffer()
+  {
+#ifndef _WIN32
+    if (mapping != nullptr)
+      munmap(mapping, size);
+#endif
+  }
+
+
+  void Parameters::initialize(std::string &filename)
+  {
+    path_level =0;
+
+    // The world builder file is parsed in place, so the strings in the
+    // document do not have to be copied. The buffer is kept until the
+    // document is released.
+    insitu_buffer.reset(new InsituBuffer(filename));
+
+    // A compiled world in a file which is not a regular file, such as a
+    // pipe, is only recognized once the file has been read.
+    if (is_compiled_world_buffer(insitu_buffer->data, insitu_buffer->size))
+      {
+        const std::unique_ptr<InsituBuffer> buffer(std::move(insitu_buffer));
+        read_compiled_world(buffer->data, buffer->size, "The compiled world file " + filename);
+        return;
+      }
 
     // relaxing sytax by allowing comments () for now, maybe also allow trailing commas and (kParseTrailingCommasFlag) and nan's, inf etc (kParseNanAndInfFlag)?
-    //WBAssertThrow(!parameters.ParseStream<kParseCommentsFlag>(isw).HasParseError(), "Parsing erros world builder file");
-
-    WBAssertThrowExc(!(parameters.ParseStream<kParseCommentsFlag | kParseNanAndInfFlag>(isw).HasParseError()), std::ifstream json_input_stream_error(filename.c_str()); ,
-                     "Parsing errors world builder file: Error(offset " << static_cast<unsigned>(parameters.GetErrorOffset())
-                     << "): " << GetParseError_En(parameters.GetParseError()) << std::endl << std::endl
-                     << " Showing 50 chars before and after: "
-                     << std::string((std::istreambuf_iterator<char>(json_input_stream_error.seekg(0, json_input_stream_error.beg))),
-                                    std::istreambuf_iterator<char>()).substr(static_cast<unsigned>(parameters.GetErrorOffset()) <= 50
-                                                                             ?
-                                                                             0
-                                                                             :
-                                                                             static_cast<unsigned>(parameters.GetErrorOffset()) - 50, 100
-                                                                            ) << std::endl << std::endl
-                     << " Showing 5 chars before and after: "
-                     << std::string((std::istreambuf_iterator<char>(json_input_stream_error.seekg(0, json_input_stream_error.beg))),
-                                    std::istreambuf_iterator<char>()).substr(static_cast<unsigned>(parameters.GetErrorOffset()) <= 5
-                                                                             ? 0
-                                                                             :
-                                                                             static_cast<unsigned>(parameters.GetErrorOffset())-5,
-                                                                             (static_cast<unsigned>(parameters.GetErrorOffset()) + 10 > json_input_stream_error.seekg(0,std::ios::end).tellg()
-                                                                              ?
-                                                                              static_cast<unsigned>(json_input_stream.tellg())-static_cast<unsigned>(parameters.GetErrorOffset())
-                                                                              :
-                                                                              10)
-                                                                            ));
+    parameters.ParseInsitu<kParseCommentsFlag | kParseNanAndInfFlag>(insitu_buffer->data);
+
+    validate_parsed_parameters(insitu_buffer->data, insitu_buffer->size);
+  }
+
+
+  void Parameters::initialize_from_buffer(const char *json_text, const size_t json_text_size)
+  {
+    path_level =0;
+    insitu_buffer.reset();
+
+    parameters.Parse<kParseCommentsFlag | kParseNanAndInfFlag>(json_text, json_text_size);
+
+    validate_parsed_parameters(json_text, json_text_size);
+  }
+
+
+  void Parameters::validate_parsed_parameters(const char *json_text, const size_t json_text_size)
+  {
+    WBAssertThrow(!parameters.HasParseError(),
+                  "Parsing errors world builder file: Error(offset " << static_cast<unsigned>(parameters.GetErrorOffset())
+                  << "): " << GetParseError_En(parameters.GetParseError()) << std::endl << std::endl
+                  << " Showing 50 chars before and after: "
+                  << std::string(json_text, json_text_size).substr(parameters.GetErrorOffset() <= 50
+                                                                   ?
+                                                                   0
+                                                                   :
+                                                                   parameters.GetErrorOffset() - 50, 100
+                                                                  ) << std::endl << std::endl
+                  << " Showing 5 chars before and after: "
+                  << std::string(json_text, json_text_size).substr(parameters.GetErrorOffset() <= 5
+                                                                   ?
+                                                                   0
+                                                                   :
+                                                                   parameters.GetErrorOffset() - 5, 10
+                                                                  ));
 
     WBAssertThrow(parameters.IsObject(), "World builder file is is not an object.");
-    json_input_stream.close();
 
 
-    SchemaDocument schema(declarations);
-    SchemaValidator validator(schema);
+    std::unique_ptr<SchemaDocument> own_schema;
+    if (shared_declarations == nullptr)
+      own_schema.reset(new SchemaDocument(declarations));
+    SchemaValidator validator(shared_declarations != nullptr ? shared_declarations->get_schema() : *own_schema);
 
     if (!parameters.Accept(validator))
       {
@@ -167,20 +584,163 @@ namespace WorldBuilder
         validator.GetError().Accept(writer);
         WBAssertThrow(false, string.str() << "Error document: " << std::endl << buffer.GetString());
       }
+
+    reset_cursors();
+  }
+
+  void
+  Parameters::set_shared_declarations(const SchemaDeclarations &shared_declarations_)
+  {
+    shared_declarations = &shared_declarations_;
+    declaration_cursor.clear();
+  }
+
+
+  void
+  Parameters::release_parameters()
+  {
+    Document().Swap(parameters);
+    insitu_buffer.reset();
+    reset_cursors();
+  }
+
+
+  const Document &
+  Parameters::get_declarations() const
+  {
+    return shared_declarations != nullptr ? shared_declarations->get_declarations() : declarations;
+  }
+
+
+  bool
+  Parameters::has_declarations() const
+  {
+    return get_declarations().IsObject();
+  }
+
+
+  bool
+  Parameters::is_compiled_world_file(const std::string &filename)
+  {
+#ifndef _WIN32
+    struct stat file_status;
+    if (stat(filename.c_str(), &file_status) == 0 && !S_ISREG(file_status.st_mode))
+      return false;
+#endif
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    char magic[sizeof(compiled_world_magic)];
+    file.read(magic, sizeof(magic));
+    return file.good() && std::memcmp(magic, compiled_world_magic, sizeof(magic)) == 0;
+  }
+
+
+  bool
+  Parameters::is_compiled_world_buffer(const char *buffer, const size_t buffer_size)
+  {
+    return buffer_size >= sizeof(compiled_world_magic) && std::memcmp(buffer, compiled_world_magic, sizeof(compiled_world_magic)) == 0;
+  }
+
+
+  void
+  Parameters::initialize_from_compiled_world(const std::string &filename)
+  {
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    WBAssertThrow(file.good(), "Could not find the compiled world file at the specified location: " + filename);
+    const std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    read_compiled_world(buffer.data(), buffer.size(), "The compiled world file " + filename);
+  }
+
+
+  void
+  Parameters::initialize_from_compiled_world_buffer(const char *buffer, const size_t buffer_size)
+  {
+    read_compiled_world(buffer, buffer_size, "The compiled world buffer");
+  }
+
+
+  void
+  Parameters::read_compiled_world(const char *buffer, const size_t buffer_size, const std::string &source)
+  {
+    path_level = 0;
+    insitu_buffer.reset();
+
+    BinaryReader reader(buffer, buffer + buffer_size);
+    WBAssertThrow(is_compiled_world_buffer(buffer, buffer_size), source << " is not a compiled world.");
+    reader.read_bytes(sizeof(compiled_world_magic));
+
+    const std::uint32_t format_version = reader.read<std::uint32_t>();
+    WBAssertThrow(format_version == compiled_world_format_version,
+                  source << " has format version " << format_version
+                  << ", but this World Builder can only read format version " << compiled_world_format_version
+                  << ". Compile the world builder file again.");
+
+    const std::uint32_t version_length = reader.read<std::uint32_t>();
+    const std::string version(reader.read_bytes(version_length), version_length);
+    WBAssertThrow(version == full_version(),
+                  source << " was written by World Builder version " << version
+                  << ", but this is version " << full_version() << ". Compile the world builder file again.");
+
+    reader.read_value(parameters, parameters.GetAllocator());
+    WBAssertThrow(reader.at_end(), source << " has trailing data.");
+    WBAssertThrow(parameters.IsObject(), source << " does not contain an object.");
+
+    reset_cursors();
+  }
+
+
+  void
+  Parameters::write_compiled_world(const std::string &filename) const
+  {
+    WBAssertThrow(parameters.IsObject(), "The parameters have already been released, so they can not be written "
+                  "to the compiled world file " << filename << ".");
+    std::string buffer(compiled_world_magic, sizeof(compiled_world_magic));
+    write_binary(buffer, compiled_world_format_version);
+    const std::string version = full_version();
+    write_binary(buffer, version.c_str(), static_cast<std::uint32_t>(version.size()));
+    write_value(buffer, parameters);
+
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    WBAssertThrow(file.good(), "Could not open the compiled world file " << filename << " for writing.");
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    WBAssertThrow(file.good(), "Could not write the compiled world file " << filename << ".");
+  }
+
+
+  void
+  Parameters::write_default_values_on_get()
+  {
+    write_default_values = true;
+  }
+
+
+  void
+  Parameters::set_default_value(const std::string &name, const Value &value)
+  {
+    if (!write_default_values)
+      return;
+
+    Value *current = get_value_at_depth(path.size());
+    if (current != NULL)
+      Pointer(("/" + name).c_str()).Set(*current, value, parameters.GetAllocator());
+    else
+      Pointer((get_full_json_path() + "/" + name).c_str()).Set(parameters, value);
   }
 
+
   void
   Parameters::declare_entry(const std::string name,
                             const Types::Interface &type,
                             const std::string documentation)
   {
     type.write_schema(*this,name,documentation);
+    declaration_cursor.clear();
   }
 
   bool
   Parameters::check_entry(const std::string &name) const
   {
-    return Pointer((this->get_full_json_path() + "/" + name).c_str()).Get(parameters) == NULL ? false : true;
+    return get_value(name) == NULL ? false : true;
   }
 
 
@@ -188,14 +748,14 @@ namespace WorldBuilder
   std::string
   Parameters::get(const std::string &name)
   {
-    const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_value(name);
 
 #ifdef debug
+    const std::string base = this->get_full_json_path();
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (Pointer((base + "/required").c_str()).Get(get_declarations()) != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : Pointer((base + "/required").c_str()).Get(get_declarations())->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -209,10 +769,11 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration(name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
-                      << base + "/" + name + "/default value");
+                      << get_full_json_path() + "/" + name + "/default value");
+        set_default_value(name, *value);
       }
 
     return value->GetString();
@@ -222,13 +783,13 @@ namespace WorldBuilder
   double
   Parameters::get(const std::string &name)
   {
-    const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_value(name);
 #ifdef debug
+    const std::string base = this->get_full_json_path();
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (Pointer((base + "/required").c_str()).Get(get_declarations()) != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : Pointer((base + "/required").c_str()).Get(get_declarations())->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -242,10 +803,11 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration(name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
-                      << get_full_json_schema_path() + "/" + name + "/default value, for value: " << base + "/" + name);
+                      << get_full_json_schema_path() + "/" + name + "/default value, for value: " << get_full_json_path() + "/" + name);
+        set_default_value(name, *value);
       }
 
     double return_value;
@@ -255,7 +817,7 @@ namespace WorldBuilder
       }
     catch (...)
       {
-        WBAssertThrow(false, "Could not convert values of " << base << " into doubles.");
+        WBAssertThrow(false, "Could not convert values of " << get_full_json_path() + "/" + name << " into doubles.");
       }
     return return_value;
   }
@@ -264,14 +826,14 @@ namespace WorldBuilder
   size_t
   Parameters::get(const std::string &name)
   {
-    const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_value(name);
 
 #ifdef debug
+    const std::string base = this->get_full_json_path();
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (Pointer((base + "/required").c_str()).Get(get_declarations()) != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : Pointer((base + "/required").c_str()).Get(get_declarations())->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -285,10 +847,11 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration(name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
-                      << base + "/" + name + "/default value");
+                      << get_full_json_path() + "/" + name + "/default value");
+        set_default_value(name, *value);
       }
 
     return value->GetUint();
@@ -298,14 +861,14 @@ namespace WorldBuilder
   unsigned int
   Parameters::get(const std::string &name)
   {
-    const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_value(name);
 
 #ifdef debug
+    const std::string base = this->get_full_json_path();
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (Pointer((base + "/required").c_str()).Get(get_declarations()) != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : Pointer((base + "/required").c_str()).Get(get_declarations())->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -319,10 +882,11 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration(name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
-                      << base + "/" + name + "/default value");
+                      << get_full_json_path() + "/" + name + "/default value");
+        set_default_value(name, *value);
       }
 
     return value->GetUint();
@@ -332,14 +896,14 @@ namespace WorldBuilder
   bool
   Parameters::get(const std::string &name)
   {
-    const std::string base = this->get_full_json_path();
-    const Value *value = Pointer((base + "/" + name).c_str()).Get(parameters);
+    const Value *value = get_value(name);
 
 #ifdef debug
+    const std::string base = this->get_full_json_path();
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
+    if (Pointer((base + "/required").c_str()).Get(get_declarations()) != NULL)
       {
-        for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : Pointer((base + "/required").c_str()).Get(get_declarations())->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -353,10 +917,11 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration(name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
-                      << base + "/" + name + "/default value");
+                      << get_full_json_path() + "/" + name + "/default value");
+        set_default_value(name, *value);
       }
 
     return value->GetBool();
@@ -368,14 +933,14 @@ namespace WorldBuilder
   Parameters::get(const std::string &name)
   {
 
-    const std::string strict_base = this->get_full_json_path();
-    const Value *array = Pointer((strict_base + "/" + name).c_str()).Get(parameters);
+    const Value *array = get_value(name);
 
 #ifdef debug
+    const std::string strict_base = this->get_full_json_path();
     bool required = false;
-    if (Pointer((strict_base + "/required").c_str()).Get(declarations) != NULL)
+    if (Pointer((strict_base + "/required").c_str()).Get(get_declarations()) != NULL)
       {
-        for (auto &v : Pointer((strict_base + "/required").c_str()).Get(declarations)->GetArray())
+        for (auto &v : Pointer((strict_base + "/required").c_str()).Get(get_declarations())->GetArray())
           {
             if (v.GetString() == name)
               {
@@ -389,23 +954,22 @@ namespace WorldBuilder
 #endif
     if (array != NULL)
       {
-        const std::string base = strict_base + "/" + name;
         //let's assume that the file is correct, because it has been checked with the json schema.
         // So there are exactly two values.
         double value1, value2;
 
         try
           {
-            value1 = Pointer((base + "/0").c_str()).Get(parameters)->GetDouble();
-            value2 = Pointer((base + "/1").c_str()).Get(parameters)->GetDouble();
+            value1 = (*array)[0u].GetDouble();
+            value2 = (*array)[1u].GetDouble();
           }
         catch (...)
           {
-            WBAssertThrow(false, "Could not convert values of " << base << " into Point<2>, because it could not convert the sub-elements into doubles.");
+            WBAssertThrow(false, "Could not convert values of " << get_full_json_path() + "/" + name << " into Point<2>, because it could not convert the sub-elements into doubles.");
           }
         return Point<2>(value1,value2,this->coordinate_system->natural_coordinate_system());
       }
-    WBAssertThrow(false, "default values not implemented in get<Point<2> >. Looked in: " + strict_base + "/" << name);
+    WBAssertThrow(false, "default values not implemented in get<Point<2> >. Looked in: " << get_full_json_path() + "/" << name);
 
     return Point<2>(invalid);;
   }
@@ -415,34 +979,32 @@ namespace WorldBuilder
   Parameters::get_vector(const std::string &name)
   {
     std::vector<bool> vector;
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
-            const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
-
-            vector.push_back(Pointer(base.c_str()).Get(parameters)->GetBool());
+            vector.push_back((*array)[i].GetBool());
           }
       }
     else
       {
-        const Value *value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/minItems").c_str()).Get(declarations);
+        const Value *value = get_declaration(name + "/minItems");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the minItems value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/minItems value");
 
         size_t min_size = value->GetUint();
 
-        bool default_value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/items/default value").c_str()).Get(declarations)->GetBool();
+        bool default_value = get_declaration(name + "/items/default value")->GetBool();
 
         // set to min size
         for (size_t i = 0; i < min_size; ++i)
           {
             vector.push_back(default_value);
           }
+        if (write_default_values)
+          set_default_value(name, vector_to_value(vector, parameters.GetAllocator()));
       }
     return vector;
   }
@@ -452,26 +1014,23 @@ namespace WorldBuilder
   Parameters::get_vector(const std::string &name)
   {
     std::vector<Point<2> > vector;
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
-            const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
             //let's assume that the file is correct, because it has been checked with the json schema.
             // So there are exactly two values.
             double value1, value2;
 
             try
               {
-                value1 = Pointer((base + "/0").c_str()).Get(parameters)->GetDouble();
-                value2 = Pointer((base + "/1").c_str()).Get(parameters)->GetDouble();
+                value1 = (*array)[i][0u].GetDouble();
+                value2 = (*array)[i][1u].GetDouble();
               }
             catch (...)
               {
-                WBAssertThrow(false, "Could not convert values of " << base << " into doubles.");
+                WBAssertThrow(false, "Could not convert values of " << get_full_json_path() + "/" + name + "/" + std::to_string(i) << " into doubles.");
               }
             vector.push_back(Point<2>(value1,value2,this->coordinate_system->natural_coordinate_system()));
           }
@@ -484,26 +1043,23 @@ namespace WorldBuilder
   Parameters::get_vector(const std::string &name)
   {
     std::vector<std::array<double,3> > vector;
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
-            const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
             //let's assume that the file is correct, because it has been checked with the json schema.
             // So there are exactly three values.
             try
               {
-                const double value1 = Pointer((base + "/0").c_str()).Get(parameters)->GetDouble();
-                const double value2 = Pointer((base + "/1").c_str()).Get(parameters)->GetDouble();
-                const double value3 = Pointer((base + "/2").c_str()).Get(parameters)->GetDouble();
+                const double value1 = (*array)[i][0u].GetDouble();
+                const double value2 = (*array)[i][1u].GetDouble();
+                const double value3 = (*array)[i][2u].GetDouble();
                 vector.push_back({{value1,value2,value3}});
               }
             catch (...)
               {
-                WBAssertThrow(false, "Could not convert values of " << base << " into doubles.");
+                WBAssertThrow(false, "Could not convert values of " << get_full_json_path() + "/" + name + "/" + std::to_string(i) << " into doubles.");
               }
           }
       }
@@ -516,15 +1072,12 @@ namespace WorldBuilder
   Parameters::get_vector(const std::string &name)
   {
     std::vector<std::array<std::array<double,3>,3>  > vector;
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array1 = get_value(name);
+    if (array1 != NULL)
       {
-        Value *array1 = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array1->Size(); ++i )
+        for (SizeType i = 0; i < array1->Size(); ++i )
           {
-            const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
-            Value *array2 = Pointer((base).c_str()).Get(parameters);
+            const Value *array2 = &(*array1)[i];
 
             // Not sure why cppcheck it is generating the warning
             // Filed a question at: https://sourceforge.net/p/cppcheck/discussion/general/thread/429759f85e/
@@ -532,24 +1085,24 @@ namespace WorldBuilder
             std::array<std::array<double,3>,3> array;
             WBAssertThrow(array2->Size() == 3, "Array " << i << " is supposed to be a 3x3 array, but the outer array dimensions is "
                           << array2->Size() << ".");
-            for (size_t j = 0; j < array2->Size(); ++j )
+            for (SizeType j = 0; j < array2->Size(); ++j )
               {
-                const std::string base_extended = base + "/" + std::to_string(j);
+                const Value &array3 = (*array2)[j];
 
-                WBAssertThrow(Pointer((base_extended).c_str()).Get(parameters)->Size() == 3,
+                WBAssertThrow(array3.Size() == 3,
                               "Array " << i << " is supposed to be a 3x3 array, but the inner array dimensions of "
-                              << j << " is " << Pointer((base_extended).c_str()).Get(parameters)->Size() << ".");
+                              << j << " is " << array3.Size() << ".");
                 double value1, value2, value3;
 
                 try
                   {
-                    value1 = Pointer((base_extended + "/0").c_str()).Get(parameters)->GetDouble();
-                    value2 = Pointer((base_extended + "/1").c_str()).Get(parameters)->GetDouble();
-                    value3 = Pointer((base_extended + "/2").c_str()).Get(parameters)->GetDouble();
+                    value1 = array3[0u].GetDouble();
+                    value2 = array3[1u].GetDouble();
+                    value3 = array3[2u].GetDouble();
                   }
                 catch (...)
                   {
-                    WBAssertThrow(false, "Could not convert values of " << base << " into doubles.");
+                    WBAssertThrow(false, "Could not convert values of " << get_full_json_path() + "/" + name + "/" + std::to_string(i) << " into doubles.");
                   }
                 array[j][0] = value1;
                 array[j][1] = value2;
@@ -574,72 +1127,70 @@ namespace WorldBuilder
     using namespace Features::SubductingPlateModels;
     std::vector<Objects::Segment<Temperature::Interface,Composition::Interface,Grains::Interface> > vector;
     this->enter_subsection(name);
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value_at_depth(path.size());
+    if (array != NULL)
       {
         // get the array of segments
-        Value *array = Pointer((strict_base).c_str()).Get(parameters);
-
         for (size_t i = 0; i < array->Size(); ++i )
           {
             this->enter_subsection(std::to_string(i));
-            const std::string base = this->get_full_json_path();
+            Value *segment = get_value_at_depth(path.size());
             // get one segment
             // length
-            double length = Pointer((base + "/length").c_str()).Get(parameters)->GetDouble();
+            double length = (*segment)["length"].GetDouble();
 
             // get thickness
-            Value *point_array = Pointer((base  + "/thickness").c_str()).Get(parameters);
+            const Value *point_array = find_child(segment, "thickness");
             Point<2> thickness(invalid);
             if (point_array != NULL) // is required, turn into assertthrow
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/thickness/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
                     thickness = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/thickness/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/thickness/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
+                    double local1 = (*point_array)[1u].GetDouble();
                     thickness = Point<2>(local0,local1,invalid);
                   }
               }
 
             // get top trunctation (default is 0,0)
-            point_array = Pointer((base  + "/top truncation").c_str()).Get(parameters);
+            point_array = find_child(segment, "top truncation");
             Point<2> top_trunctation(invalid);
             if (point_array != NULL)
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/top truncation/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
                     top_trunctation = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/top truncation/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/top truncation/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
+                    double local1 = (*point_array)[1u].GetDouble();
                     top_trunctation = Point<2>(local0,local1,invalid);
                   }
               }
             // get thickness
-            point_array = Pointer((base  + "/angle").c_str()).Get(parameters);
+            point_array = find_child(segment, "angle");
             Point<2> angle(invalid);
             if (point_array != NULL) // is required, turn into assertthrow
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/angle/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
                     angle = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/angle/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/angle/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
+                    double local1 = (*point_array)[1u].GetDouble();
                     angle = Point<2>(local0,local1,invalid);
                   }
               }
@@ -650,14 +1201,16 @@ namespace WorldBuilder
             //This is a value to look back in the path elements.
             size_t searchback = 0;
             if (this->get_shared_pointers<Temperature::Interface>("temperature models", temperature_models) == false ||
-                Pointer((base + "/temperature model default entry").c_str()).Get(parameters) != NULL)
+                find_child(segment, "temperature model default entry") != NULL)
               {
                 temperature_models = default_temperature_models;
 
                 // find the default value, which is the closest to the current path
+                Value *default_models = NULL;
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/temperature models").c_str()).Get(parameters) != NULL)
+                    default_models = find_child(get_value_at_depth(path.size()-searchback), "temperature models");
+                    if (default_models != NULL)
                       {
                         break;
                       }
@@ -666,34 +1219,29 @@ namespace WorldBuilder
                 // if we can not find default value for the temperture model, skip it
                 if (searchback < path.size())
                   {
+                    // copy the value and place it in the correct location.
+                    Value value;
+                    value.CopyFrom(*default_models, parameters.GetAllocator());
 
-                    // copy the value, this unfortunately removes it.
-                    Value value1 = Value(Pointer((this->get_full_json_path(path.size()-searchback) + "/temperature models").c_str()).Get(parameters)->GetArray());
-
-                    // now copy it
-                    Value value2;
-                    value2.CopyFrom(value1, parameters.GetAllocator());
-
-                    // now we should have 2x the same value, so put it back and place it in the correct location.
-                    Pointer((this->get_full_json_path(path.size()-searchback) + "/temperature models").c_str()).Set(parameters, value1);//.Get(parameters)->Set("temperature models", value1, parameters.GetAllocator());
-
-                    Pointer((base).c_str()).Get(parameters)->AddMember("temperature models", value2, parameters.GetAllocator());
-                    Pointer((base + "/temperature model default entry").c_str()).Set(parameters,true);
+                    segment->AddMember("temperature models", value, parameters.GetAllocator());
+                    Pointer("/temperature model default entry").Set(*segment, true, parameters.GetAllocator());
                   }
               }
 
             // now do the same for compositions
             std::vector<std::shared_ptr<Composition::Interface> > composition_models;
             if (this->get_shared_pointers<Composition::Interface>("composition models", composition_models) == false ||
-                Pointer((base + "/composition model default entry").c_str()).Get(parameters) != NULL)
+                find_child(segment, "composition model default entry") != NULL)
               {
                 composition_models = default_composition_models;
 
 
                 // find the default value, which is the closest to the current path
+                Value *default_models = NULL;
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/composition models").c_str()).Get(parameters) != NULL)
+                    default_models = find_child(get_value_at_depth(path.size()-searchback), "composition models");
+                    if (default_models != NULL)
                       {
                         break;
                       }
@@ -702,34 +1250,29 @@ namespace WorldBuilder
                 // if we can not find default value for the temperture model, skip it
                 if (searchback < path.size())
                   {
+                    // copy the value and place it in the correct location.
+                    Value value;
+                    value.CopyFrom(*default_models, parameters.GetAllocator());
 
-                    // copy the value, this unfortunately removes it.
-                    Value value1 = Value(Pointer((this->get_full_json_path(path.size()-searchback) + "/composition models").c_str()).Get(parameters)->GetArray());
-
-                    // now copy it
-                    Value value2;
-                    value2.CopyFrom(value1, parameters.GetAllocator());
-
-                    // now we should have 2x the same value, so put it back and place it in the correct location.
-                    Pointer((this->get_full_json_path(path.size()-searchback) + "/composition models").c_str()).Set(parameters, value1);//.Get(parameters)->Set("temperature models", value1, parameters.GetAllocator());
-
-                    Pointer((base).c_str()).Get(parameters)->AddMember("composition models", value2, parameters.GetAllocator());
-                    Pointer((base + "/composition model default entry").c_str()).Set(parameters,true);
+                    segment->AddMember("composition models", value, parameters.GetAllocator());
+                    Pointer("/composition model default entry").Set(*segment, true, parameters.GetAllocator());
                   }
               }
 
             // now do the same for grains
             std::vector<std::shared_ptr<Grains::Interface> > grains_models;
             if (this->get_shared_pointers<Grains::Interface>("grains models", grains_models) == false ||
-                Pointer((base + "/grains model default entry").c_str()).Get(parameters) != NULL)
+                find_child(segment, "grains model default entry") != NULL)
               {
                 grains_models = default_grains_models;
 
 
                 // find the default value, which is the closest to the current path
+                Value *default_models = NULL;
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/grains models").c_str()).Get(parameters) != NULL)
+                    default_models = find_child(get_value_at_depth(path.size()-searchback), "grains models");
+                    if (default_models != NULL)
                       {
                         break;
                       }
@@ -738,19 +1281,12 @@ namespace WorldBuilder
                 // if we can not find default value for the temperture model, skip it
                 if (searchback < path.size())
                   {
+                    // copy the value and place it in the correct location.
+                    Value value;
+                    value.CopyFrom(*default_models, parameters.GetAllocator());
 
-                    // copy the value, this unfortunately removes it.
-                    Value value1 = Value(Pointer((this->get_full_json_path(path.size()-searchback) + "/grains models").c_str()).Get(parameters)->GetArray());
-
-                    // now copy it
-                    Value value2;
-                    value2.CopyFrom(value1, parameters.GetAllocator());
-
-                    // now we should have 2x the same value, so put it back and place it in the correct location.
-                    Pointer((this->get_full_json_path(path.size()-searchback) + "/grains models").c_str()).Set(parameters, value1);//.Get(parameters)->Set("temperature models", value1, parameters.GetAllocator());
-
-                    Pointer((base).c_str()).Get(parameters)->AddMember("grains models", value2, parameters.GetAllocator());
-                    Pointer((base + "/grains model default entry").c_str()).Set(parameters,true);
+                    segment->AddMember("grains models", value, parameters.GetAllocator());
+                    Pointer("/grains model default entry").Set(*segment, true, parameters.GetAllocator());
                   }
               }
             vector.push_back(Objects::Segment<Temperature::Interface,Composition::Interface,Grains::Interface>(length, thickness, top_trunctation, angle, temperature_models, composition_models, grains_models));
@@ -773,72 +1309,70 @@ namespace WorldBuilder
     using namespace Features::FaultModels;
     std::vector<Objects::Segment<Temperature::Interface,Composition::Interface,Grains::Interface> > vector;
     this->enter_subsection(name);
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value_at_depth(path.size());
+    if (array != NULL)
       {
         // get the array of segments
-        Value *array = Pointer((strict_base).c_str()).Get(parameters);
-
         for (size_t i = 0; i < array->Size(); ++i )
           {
             this->enter_subsection(std::to_string(i));
-            const std::string base = this->get_full_json_path();
+            Value *segment = get_value_at_depth(path.size());
             // get one segment
             // length
-            double length = Pointer((base + "/length").c_str()).Get(parameters)->GetDouble();
+            double length = (*segment)["length"].GetDouble();
 
             // get thickness
-            Value *point_array = Pointer((base  + "/thickness").c_str()).Get(parameters);
+            const Value *point_array = find_child(segment, "thickness");
             Point<2> thickness(invalid);
             if (point_array != NULL) // is required, turn into assertthrow
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/thickness/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
                     thickness = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/thickness/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/thickness/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
+                    double local1 = (*point_array)[1u].GetDouble();
                     thickness = Point<2>(local0,local1,invalid);
                   }
               }
 
             // get top trunctation (default is 0,0)
-            point_array = Pointer((base  + "/top truncation").c_str()).Get(parameters);
+            point_array = find_child(segment, "top truncation");
             Point<2> top_trunctation(invalid);
             if (point_array != NULL)
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/top truncation/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
                     top_trunctation = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/top truncation/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/top truncation/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
+                    double local1 = (*point_array)[1u].GetDouble();
                     top_trunctation = Point<2>(local0,local1,invalid);
                   }
               }
             // get thickness
-            point_array = Pointer((base  + "/angle").c_str()).Get(parameters);
+            point_array = find_child(segment, "angle");
             Point<2> angle(invalid);
             if (point_array != NULL) // is required, turn into assertthrow
               {
                 if (point_array->Size() == 1)
                   {
                     // There is only one value, set it for both elements
-                    double local0 = Pointer((base + "/angle/0").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
                     angle = Point<2>(local0,local0,invalid);
                   }
                 else
                   {
-                    double local0 = Pointer((base + "/angle/0").c_str()).Get(parameters)->GetDouble();
-                    double local1 = Pointer((base + "/angle/1").c_str()).Get(parameters)->GetDouble();
+                    double local0 = (*point_array)[0u].GetDouble();
+                    double local1 = (*point_array)[1u].GetDouble();
                     angle = Point<2>(local0,local1,invalid);
                   }
               }
@@ -849,14 +1383,16 @@ namespace WorldBuilder
             //This is a value to look back in the path elements.
             size_t searchback = 0;
             if (this->get_shared_pointers<Temperature::Interface>("temperature models", temperature_models) == false ||
-                Pointer((base + "/temperature model default entry").c_str()).Get(parameters) != NULL)
+                find_child(segment, "temperature model default entry") != NULL)
               {
                 temperature_models = default_temperature_models;
 
                 // find the default value, which is the closest to the current path
+                Value *default_models = NULL;
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/temperature models").c_str()).Get(parameters) != NULL)
+                    default_models = find_child(get_value_at_depth(path.size()-searchback), "temperature models");
+                    if (default_models != NULL)
                       {
                         break;
                       }
@@ -865,34 +1401,29 @@ namespace WorldBuilder
                 // if we can not find default value for the temperture model, skip it
                 if (searchback < path.size())
                   {
+                    // copy the value and place it in the correct location.
+                    Value value;
+                    value.CopyFrom(*default_models, parameters.GetAllocator());
 
-                    // copy the value, this unfortunately removes it.
-                    Value value1 = Value(Pointer((this->get_full_json_path(path.size()-searchback) + "/temperature models").c_str()).Get(parameters)->GetArray());
-
-                    // now copy it
-                    Value value2;
-                    value2.CopyFrom(value1, parameters.GetAllocator());
-
-                    // now we should have 2x the same value, so put it back and place it in the correct location.
-                    Pointer((this->get_full_json_path(path.size()-searchback) + "/temperature models").c_str()).Set(parameters, value1);//.Get(parameters)->Set("temperature models", value1, parameters.GetAllocator());
-
-                    Pointer((base).c_str()).Get(parameters)->AddMember("temperature models", value2, parameters.GetAllocator());
-                    Pointer((base + "/temperature model default entry").c_str()).Set(parameters,true);
+                    segment->AddMember("temperature models", value, parameters.GetAllocator());
+                    Pointer("/temperature model default entry").Set(*segment, true, parameters.GetAllocator());
                   }
               }
 
             // now do the same for compositions
             std::vector<std::shared_ptr<Composition::Interface> > composition_models;
             if (this->get_shared_pointers<Composition::Interface>("composition models", composition_models) == false ||
-                Pointer((base + "/composition model default entry").c_str()).Get(parameters) != NULL)
+                find_child(segment, "composition model default entry") != NULL)
               {
                 composition_models = default_composition_models;
 
 
                 // find the default value, which is the closest to the current path
+                Value *default_models = NULL;
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/composition models").c_str()).Get(parameters) != NULL)
+                    default_models = find_child(get_value_at_depth(path.size()-searchback), "composition models");
+                    if (default_models != NULL)
                       {
                         break;
                       }
@@ -901,34 +1432,29 @@ namespace WorldBuilder
                 // if we can not find default value for the temperture model, skip it
                 if (searchback < path.size())
                   {
+                    // copy the value and place it in the correct location.
+                    Value value;
+                    value.CopyFrom(*default_models, parameters.GetAllocator());
 
-                    // copy the value, this unfortunately removes it.
-                    Value value1 = Value(Pointer((this->get_full_json_path(path.size()-searchback) + "/composition models").c_str()).Get(parameters)->GetArray());
-
-                    // now copy it
-                    Value value2;
-                    value2.CopyFrom(value1, parameters.GetAllocator());
-
-                    // now we should have 2x the same value, so put it back and place it in the correct location.
-                    Pointer((this->get_full_json_path(path.size()-searchback) + "/composition models").c_str()).Set(parameters, value1);//.Get(parameters)->Set("temperature models", value1, parameters.GetAllocator());
-
-                    Pointer((base).c_str()).Get(parameters)->AddMember("composition models", value2, parameters.GetAllocator());
-                    Pointer((base + "/composition model default entry").c_str()).Set(parameters,true);
+                    segment->AddMember("composition models", value, parameters.GetAllocator());
+                    Pointer("/composition model default entry").Set(*segment, true, parameters.GetAllocator());
                   }
               }
 
             // now do the same for grains
             std::vector<std::shared_ptr<Grains::Interface> > grains_models;
             if (this->get_shared_pointers<Grains::Interface>("grains models", grains_models) == false ||
-                Pointer((base + "/grains model default entry").c_str()).Get(parameters) != NULL)
+                find_child(segment, "grains model default entry") != NULL)
               {
                 grains_models = default_grains_models;
 
 
                 // find the default value, which is the closest to the current path
+                Value *default_models = NULL;
                 for (searchback = 0; searchback < path.size(); ++searchback)
                   {
-                    if (Pointer((this->get_full_json_path(path.size()-searchback) + "/grains models").c_str()).Get(parameters) != NULL)
+                    default_models = find_child(get_value_at_depth(path.size()-searchback), "grains models");
+                    if (default_models != NULL)
                       {
                         break;
                       }
@@ -937,19 +1463,12 @@ namespace WorldBuilder
                 // if we can not find default value for the temperture model, skip it
                 if (searchback < path.size())
                   {
+                    // copy the value and place it in the correct location.
+                    Value value;
+                    value.CopyFrom(*default_models, parameters.GetAllocator());
 
-                    // copy the value, this unfortunately removes it.
-                    Value value1 = Value(Pointer((this->get_full_json_path(path.size()-searchback) + "/grains models").c_str()).Get(parameters)->GetArray());
-
-                    // now copy it
-                    Value value2;
-                    value2.CopyFrom(value1, parameters.GetAllocator());
-
-                    // now we should have 2x the same value, so put it back and place it in the correct location.
-                    Pointer((this->get_full_json_path(path.size()-searchback) + "/grains models").c_str()).Set(parameters, value1);//.Get(parameters)->Set("temperature models", value1, parameters.GetAllocator());
-
-                    Pointer((base).c_str()).Get(parameters)->AddMember("grains models", value2, parameters.GetAllocator());
-                    Pointer((base + "/grains model default entry").c_str()).Set(parameters,true);
+                    segment->AddMember("grains models", value, parameters.GetAllocator());
+                    Pointer("/grains model default entry").Set(*segment, true, parameters.GetAllocator());
                   }
               }
             vector.push_back(Objects::Segment<Temperature::Interface,Composition::Interface,Grains::Interface>(length, thickness, top_trunctation, angle, temperature_models, composition_models, grains_models));
@@ -966,28 +1485,24 @@ namespace WorldBuilder
   Parameters::get_vector(const std::string &name)
   {
     std::vector<double> vector;
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
-            const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
-
-            vector.push_back(Pointer(base.c_str()).Get(parameters)->GetDouble());
+            vector.push_back((*array)[i].GetDouble());
           }
       }
     else
       {
-        const Value *value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/minItems").c_str()).Get(declarations);
+        const Value *value = get_declaration(name + "/minItems");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the minItems value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/minItems");
 
         size_t min_size = value->GetUint();
 
-        value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/items/default value").c_str()).Get(declarations);
+        value = get_declaration(name + "/items/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/default value");
@@ -999,6 +1514,8 @@ namespace WorldBuilder
           {
             vector.push_back(default_value);
           }
+        if (write_default_values)
+          set_default_value(name, vector_to_value(vector, parameters.GetAllocator()));
       }
     return vector;
   }
@@ -1008,28 +1525,24 @@ namespace WorldBuilder
   Parameters::get_vector(const std::string &name)
   {
     std::vector<size_t> vector;
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
-            const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
-
-            vector.push_back(Pointer(base.c_str()).Get(parameters)->GetUint());
+            vector.push_back((*array)[i].GetUint());
           }
       }
     else
       {
-        const Value *value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/minItems").c_str()).Get(declarations);
+        const Value *value = get_declaration(name + "/minItems");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the minItems value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/minItems");
 
         size_t min_size = value->GetUint();
 
-        value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/items/default value").c_str()).Get(declarations);
+        value = get_declaration(name + "/items/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/default value");
@@ -1041,6 +1554,8 @@ namespace WorldBuilder
           {
             vector.push_back(default_value);
           }
+        if (write_default_values)
+          set_default_value(name, vector_to_value(vector, parameters.GetAllocator()));
       }
     return vector;
   }
@@ -1050,34 +1565,32 @@ namespace WorldBuilder
   Parameters::get_vector(const std::string &name)
   {
     std::vector<unsigned int> vector;
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
-            const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
-
-            vector.push_back(Pointer(base.c_str()).Get(parameters)->GetUint());
+            vector.push_back((*array)[i].GetUint());
           }
       }
     else
       {
-        const Value *value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/minItems").c_str()).Get(declarations);
+        const Value *value = get_declaration(name + "/minItems");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the minItems value at: "
                       << this->get_full_json_schema_path() + "/" + name + "/minItems value");
 
         size_t min_size = value->GetUint();
 
-        unsigned int default_value = Pointer((this->get_full_json_schema_path()  + "/" + name + "/items/default value").c_str()).Get(declarations)->GetUint();
+        unsigned int default_value = get_declaration(name + "/items/default value")->GetUint();
 
         // set to min size
         for (size_t i = 0; i < min_size; ++i)
           {
             vector.push_back(default_value);
           }
+        if (write_default_values)
+          set_default_value(name, vector_to_value(vector, parameters.GetAllocator()));
       }
     return vector;
   }
@@ -1086,13 +1599,13 @@ namespace WorldBuilder
   std::unique_ptr<T>
   Parameters::get_unique_pointer(const std::string &name)
   {
-    const std::string base = this->get_full_json_path();
-    Value *value = Pointer((base + "/" + name + "/model").c_str()).Get(parameters);
+    const Value *value = get_value(name + "/model");
 
 #ifdef debug
+    const std::string base = this->get_full_json_path();
     bool required = false;
-    if (Pointer((base + "/required").c_str()).Get(declarations) != NULL)
-      for (auto &v : Pointer((base + "/required").c_str()).Get(declarations)->GetArray())
+    if (Pointer((base + "/required").c_str()).Get(get_declarations()) != NULL)
+      for (auto &v : Pointer((base + "/required").c_str()).Get(get_declarations())->GetArray())
         {
           if (v.GetString() == name)
             {
@@ -1105,10 +1618,11 @@ namespace WorldBuilder
 #endif
     if (value == NULL)
       {
-        value = Pointer((get_full_json_schema_path() + "/" + name + "/default value").c_str()).Get(declarations);
+        value = get_declaration(name + "/default value");
         WBAssertThrow(value != NULL,
                       "internal error: could not retrieve the default value at: "
-                      << base + "/" + name + "/default value. Make sure the value has been declared.");
+                      << get_full_json_path() + "/" + name + "/default value. Make sure the value has been declared.");
+        set_default_value(name + "/model", *value);
       }
 
     return T::create(value->GetString(),&world);
@@ -1119,16 +1633,12 @@ namespace WorldBuilder
   Parameters::get_unique_pointers(const std::string &name, std::vector<std::unique_ptr<T> > &vector)
   {
     vector.resize(0);
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
-            const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
-
-            std::string value = Pointer((base + "/model").c_str()).Get(parameters)->GetString();
+            std::string value = (*array)[i]["model"].GetString();
 
             vector.push_back(std::move(T::create(value, &world)));
           }
@@ -1146,12 +1656,10 @@ namespace WorldBuilder
   Parameters::get_unique_pointers(const std::string &name, std::vector<std::unique_ptr<Features::SubductingPlate> > &vector)
   {
     vector.resize(0);
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
             vector.push_back(std::unique_ptr<Features::SubductingPlate>(new Features::SubductingPlate(&world)));
           }
@@ -1169,12 +1677,10 @@ namespace WorldBuilder
   Parameters::get_unique_pointers(const std::string &name, std::vector<std::unique_ptr<Features::Fault> > &vector)
   {
     vector.resize(0);
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
             vector.push_back(std::unique_ptr<Features::Fault>(new Features::Fault(&world)));
           }
@@ -1194,16 +1700,12 @@ namespace WorldBuilder
   Parameters::get_shared_pointers(const std::string &name, std::vector<std::shared_ptr<T> > &vector)
   {
     vector.resize(0);
-    const std::string strict_base = this->get_full_json_path();
-    if (Pointer((strict_base + "/" + name).c_str()).Get(parameters) != NULL)
+    const Value *array = get_value(name);
+    if (array != NULL)
       {
-        Value *array = Pointer((strict_base  + "/" + name).c_str()).Get(parameters);
-
-        for (size_t i = 0; i < array->Size(); ++i )
+        for (SizeType i = 0; i < array->Size(); ++i )
           {
-            const std::string base = strict_base + "/" + name + "/" + std::to_string(i);
-
-            std::string value = Pointer((base + "/model").c_str()).Get(parameters)->GetString();
+            std::string value = (*array)[i]["model"].GetString();
 
             vector.push_back(std::move(T::create(value, &world)));
           }
@@ -1219,6 +1721,7 @@ namespace WorldBuilder
   void
   Parameters::enter_subsection(const std::string name)
   {
+    value_cursor.push_back(find_child(get_value_at_depth(path.size()), name));
     path.push_back(name);
     //TODO: WBAssert(is path valid?)
   }
@@ -1227,6 +1730,130 @@ namespace WorldBuilder
   Parameters::leave_subsection()
   {
     path.pop_back();
+    value_cursor.pop_back();
+
+    while (declaration_cursor.size() > 0 && declaration_cursor.back().first > path.size())
+      declaration_cursor.pop_back();
+  }
+
+
+  void
+  Parameters::reset_cursors()
+  {
+    value_cursor.assign(1, &parameters);
+    for (size_t i = 0; i < path.size(); ++i)
+      value_cursor.push_back(find_child(value_cursor.back(), path[i]));
+
+    declaration_cursor.clear();
+  }
+
+
+  Value *
+  Parameters::get_value_at_depth(const size_t depth) const
+  {
+    WBAssert(depth < value_cursor.size(), "Internal error: the depth " << depth << " is larger than the depth of the path.");
+
+    // Values which did not exist when the subsection was entered may have
+    // been added since, so look them up from the closest existing parent.
+    size_t level = depth;
+    while (value_cursor[level] == NULL)
+      --level;
+
+    Value *value = value_cursor[level];
+    for (; level < depth && value != NULL; ++level)
+      value = find_child(value, path[level]);
+
+    return value;
+  }
+
+
+  Value *
+  Parameters::get_value(const std::string &name) const
+  {
+    return find_relative(get_value_at_depth(path.size()), name);
+  }
+
+
+  const Value *
+  Parameters::get_current_declaration() const
+  {
+    // This follows the same steps as get_full_json_schema_path(), but
+    // continues from the last node which has been found before.
+    if (declaration_cursor.size() == 0)
+      declaration_cursor.push_back(std::make_pair(0, find_child(static_cast<const Value *>(&get_declarations()), "properties")));
+
+    while (declaration_cursor.back().first < path.size())
+      {
+        const size_t i = declaration_cursor.back().first;
+        const Value *collapse = declaration_cursor.back().second;
+
+        WBAssertThrow(get_declarations().IsObject(), "internal error: the declarations are needed to look up a value in "
+                      << get_full_json_path() << ", but they are not available. This can happen when a compiled "
+                      "world is used which misses a value.");
+
+        if (collapse == NULL)
+          {
+            declaration_cursor.push_back(std::make_pair(path.size(), collapse));
+            break;
+          }
+
+        const Value *member = find_child(collapse, path[i]);
+        const Value *base = member != NULL && find_child(member, "type") != NULL ? member : collapse;
+        const Value *type = find_child(base, "type");
+        WBAssertThrow(type != NULL && type->IsString(),
+                      "Internal error: could not find the type of " << get_full_json_path(i+1) << " in the declarations.");
+
+        if (std::strcmp(type->GetString(), "array") == 0)
+          {
+            // the type is an array. Arrays always have an items, but can also
+            // have a oneOf. If it has a oneOf, the model in the parameters of
+            // the next entry of the path determines which of them is needed.
+            const Value *one_of = find_relative(base, "items/oneOf");
+            if (one_of != NULL)
+              {
+                WBAssertThrow(i + 1 < path.size(), "Internal error: could not find which of the possible values of "
+                              << get_full_json_path(i+1) << " is needed.");
+
+                const Value *model = find_child(get_value_at_depth(i+2), "model");
+                WBAssertThrow(model != NULL, "Could not find model in: " << get_full_json_path(i+2) + "/model");
+
+                SizeType index = 0;
+                for (; index < one_of->Size(); ++index)
+                  {
+                    const Value *declarations_model = find_relative(&(*one_of)[index], "properties/model/enum/0");
+                    if (declarations_model != NULL && std::strcmp(declarations_model->GetString(), model->GetString()) == 0)
+                      break;
+                  }
+
+                WBAssertThrow(index < one_of->Size(),
+                              "Internal error: This is an array with several possible values, "
+                              "but could not find the correct value " << get_full_json_path(i+1) + "/items/oneOf");
+
+                declaration_cursor.push_back(std::make_pair(i + 2, find_relative(member, "items/oneOf/" + std::to_string(index) + "/properties")));
+              }
+            else
+              {
+                declaration_cursor.push_back(std::make_pair(i + 1, find_child(base, "items")));
+              }
+          }
+        else if (std::strcmp(type->GetString(), "object") == 0)
+          {
+            declaration_cursor.push_back(std::make_pair(i + 1, find_child(collapse, "properties")));
+          }
+        else
+          {
+            declaration_cursor.push_back(std::make_pair(i + 1, member));
+          }
+      }
+
+    return declaration_cursor.back().second;
+  }
+
+
+  const Value *
+  Parameters::get_declaration(const std::string &name) const
+  {
+    return find_relative(get_current_declaration(), name);
   }
 
 
@@ -1296,26 +1923,30 @@ namespace WorldBuilder
     for (size_t i = 0; i < path.size(); i++)
       {
         // first get the type
-        //WBAssert(Pointer((collapse + "/" + path[i] + "/type").c_str()).Get(declarations) != NULL, "Internal error: could not find " << collapse + "/" + path[i] + "/type");
+        //WBAssert(Pointer((collapse + "/" + path[i] + "/type").c_str()).Get(get_declarations()) != NULL, "Internal error: could not find " << collapse + "/" + path[i] + "/type");
+
+        WBAssertThrow(get_declarations().IsObject(), "internal error: the declarations are needed to look up a value in "
+                      << get_full_json_path() << ", but they are not available. This can happen when a compiled "
+                      "world is used which misses a value.");
 
-        std::string base_path = Pointer((collapse + "/" + path[i] + "/type").c_str()).Get(declarations) != NULL
+        std::string base_path = Pointer((collapse + "/" + path[i] + "/type").c_str()).Get(get_declarations()) != NULL
                                 ?
                                 collapse + "/" + path[i]
                                 :
                                 collapse;
-        std::string type = Pointer((base_path + "/type").c_str()).Get(declarations)->GetString();
+        std::string type = Pointer((base_path + "/type").c_str()).Get(get_declarations())->GetString();
 
         if (type == "array")
           {
             // the type is an array. Arrays always have an items, but can also
             // have a oneOf (todo: or anyOf ...). Find out whether this is the case
             //collapse += path[i] + "/items";
-            if (Pointer((base_path + "/items/oneOf").c_str()).Get(declarations) != NULL)
+            if (Pointer((base_path + "/items/oneOf").c_str()).Get(get_declarations()) != NULL)
               {
                 // it has a structure with oneOf. Find out which of the entries is needed.
                 // This means we have to take a sneak peak to figure out how to get to the
                 // next value.
-                size_t size = Pointer((base_path + "/items/oneOf").c_str()).Get(declarations)->Size();
+                size_t size = Pointer((base_path + "/items/oneOf").c_str()).Get(get_declarations())->Size();
 #ifdef debug
                 bool found = false;
 #endif
@@ -1323,7 +1954,7 @@ namespace WorldBuilder
                 for (; index < size; ++index)
                   {
                     std::string declarations_string = Pointer((base_path + "/items/oneOf/" + std::to_string(index)
-                                                               + "/properties/model/enum/0").c_str()).Get(declarations)->GetString();
+                                                               + "/properties/model/enum/0").c_str()).Get(get_declarations())->GetString();
 
                     // we need to get the json path relevant for the current declaration string
                     // we are interested in, which requires an offset of 2.
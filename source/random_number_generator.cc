@@ -0,0 +1,132 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstring>
+
+#include <world_builder/random_number_generator.h>
+
+namespace WorldBuilder
+{
+  namespace
+  {
+    // The multipliers and key increments of the Philox4x32 algorithm.
+    const std::uint32_t philox_m0 = 0xD2511F53;
+    const std::uint32_t philox_m1 = 0xCD9E8D57;
+    const std::uint32_t philox_w0 = 0x9E3779B9;
+    const std::uint32_t philox_w1 = 0xBB67AE85;
+
+    /**
+     * The finalizer of the SplitMix64 generator, which mixes the bits of a
+     * 64 bit integer, so that nearby positions give unrelated counters.
+     */
+    std::uint64_t
+    mix(std::uint64_t z)
+    {
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+    }
+
+    /**
+     * Returns the bits of a double as an integer.
+     */
+    std::uint64_t
+    bits(const double value)
+    {
+      std::uint64_t result;
+      std::memcpy(&result, &value, sizeof(result));
+      return result;
+    }
+  }
+
+  CounterBasedRandomNumberGenerator::CounterBasedRandomNumberGenerator(const unsigned long seed,
+                                                                       const Point<3> &position,
+                                                                       const unsigned int composition_number,
+                                                                       const std::uint64_t stream)
+    :
+    key({{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(static_cast<std::uint64_t>(seed) >> 32)}}),
+    block({{0,0,0,0}}),
+    n_used(2)
+  {
+    const std::uint64_t position_hash = mix(mix(mix(mix(stream) ^ bits(position[0])) ^ bits(position[1])) ^ bits(position[2]));
+    counter = {{0,
+                composition_number,
+                static_cast<std::uint32_t>(position_hash),
+                static_cast<std::uint32_t>(position_hash >> 32)
+               }
+              };
+  }
+
+
+  std::uint64_t
+  CounterBasedRandomNumberGenerator::get_stream(const std::string &path)
+  {
+    // The 64 bit FNV-1a hash of the path.
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const char character : path)
+      {
+        hash ^= static_cast<unsigned char>(character);
+        hash *= 0x100000001B3ULL;
+      }
+    return hash;
+  }
+
+
+  void
+  CounterBasedRandomNumberGenerator::generate_block()
+  {
+    std::array<std::uint32_t,4> x = counter;
+    std::array<std::uint32_t,2> k = key;
+    for (unsigned int round = 0; round < 10; ++round)
+      {
+        const std::uint64_t product_0 = static_cast<std::uint64_t>(philox_m0) * x[0];
+        const std::uint64_t product_1 = static_cast<std::uint64_t>(philox_m1) * x[2];
+        x = {{static_cast<std::uint32_t>(product_1 >> 32) ^ x[1] ^ k[0],
+              static_cast<std::uint32_t>(product_1),
+              static_cast<std::uint32_t>(product_0 >> 32) ^ x[3] ^ k[1],
+              static_cast<std::uint32_t>(product_0)
+             }
+            };
+        k[0] += philox_w0;
+        k[1] += philox_w1;
+      }
+    block = x;
+
+    // Only the first word of the counter counts the blocks. A single query
+    // never draws 2^32 blocks, so it can not overflow.
+    ++counter[0];
+  }
+
+
+  double
+  CounterBasedRandomNumberGenerator::uniform()
+  {
+    if (n_used == 2)
+      {
+        generate_block();
+        n_used = 0;
+      }
+
+    const std::uint64_t value = (static_cast<std::uint64_t>(block[2 * n_used]) << 32) | block[2 * n_used + 1];
+    ++n_used;
+
+    // Use the upper 53 bits to fill the mantissa of a double in [0,1).
+    return static_cast<double>(value >> 11) * (1.0 / 9007199254740992.0);
+  }
+}
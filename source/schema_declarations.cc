@@ -0,0 +1,94 @@
+/*
+  Copyright (C) 2018 - 2020 by the authors of the World Builder code.
+
+  This file is part of the World Builder.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU Lesser General Public License as published
+   by the Free Software Foundation, either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <fstream>
+
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/latexwriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <world_builder/assert.h>
+#include <world_builder/parameters.h>
+#include <world_builder/schema_declarations.h>
+#include <world_builder/world.h>
+
+using namespace rapidjson;
+
+namespace WorldBuilder
+{
+  SchemaDeclarations::SchemaDeclarations(World &world)
+  {
+    Parameters prm(world);
+    World::declare_entries(prm);
+    declarations.Swap(prm.declarations);
+
+    // The schema keeps pointers into the declarations, so it can only be
+    // build once the declarations are at their final location.
+    schema.reset(new SchemaDocument(declarations));
+  }
+
+
+  const SchemaDeclarations &
+  SchemaDeclarations::get(World &world)
+  {
+    // The initialization of a function local static variable is thread safe.
+    static const SchemaDeclarations schema_declarations(world);
+    return schema_declarations;
+  }
+
+
+  const Document &
+  SchemaDeclarations::get_declarations() const
+  {
+    return declarations;
+  }
+
+
+  const SchemaDocument &
+  SchemaDeclarations::get_schema() const
+  {
+    return *schema;
+  }
+
+
+  void
+  SchemaDeclarations::write(const std::string &output_dir) const
+  {
+    StringBuffer buffer;
+    std::ofstream file;
+    // write out declarations
+    file.open (output_dir + "world_buider_declarations.tex");
+
+    WBAssertThrow(file.is_open(), "Error: Could not open file '" + output_dir + "world_buider_declarations.tex' for string the tex declarations.");
+
+    LatexWriter<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteNanAndInfFlag> tex_writer(buffer);
+    declarations.Accept(tex_writer);
+    file << buffer.GetString();
+    file.close();
+
+    // write out json schema
+    buffer.Clear();
+    file.open (output_dir + "world_buider_declarations.schema.json");
+    WBAssertThrow(file.is_open(), "Error: Could not open file '" + output_dir + "world_buider_declarations.schema.json' for string the json declarations.");
+    PrettyWriter<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteNanAndInfFlag> json_writer(buffer);
+    declarations.Accept(json_writer);
+    file << buffer.GetString();
+    file.close();
+  }
+}
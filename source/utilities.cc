@@ -148,6 +148,231 @@ namespace WorldBuilder
       return (wn != 0);
     }
 
+    Polygon::Polygon()
+      :
+      min_point({{std::numeric_limits<double>::infinity(),std::numeric_limits<double>::infinity()}}),
+      max_point({{-std::numeric_limits<double>::infinity(),-std::numeric_limits<double>::infinity()}}),
+      spherical(false),
+      n_cells({{0,0}}),
+      cell_size({{0,0}})
+    {}
+
+
+    Polygon::Polygon(const std::vector<Point<2> > &point_list,
+                     const CoordinateSystem coordinate_system,
+                     const bool use_raster)
+      :
+      Polygon()
+    {
+      spherical = coordinate_system == CoordinateSystem::spherical;
+
+      const size_t n_points = point_list.size();
+      start_x.reserve(n_points);
+      start_y.reserve(n_points);
+      end_y.reserve(n_points);
+      edge_x.reserve(n_points);
+      edge_y.reserve(n_points);
+      edge_squared_length.reserve(n_points);
+
+      // The edge i goes from point j = i-1 to point i, in the same way as in
+      // polygon_contains_point_implementation.
+      for (size_t i = 0, j = n_points-1; i < n_points; j = i++)
+        {
+          for (unsigned int d = 0; d < 2; ++d)
+            {
+              min_point[d] = std::min(min_point[d], point_list[i][d]);
+              max_point[d] = std::max(max_point[d], point_list[i][d]);
+            }
+
+          // An edge between two equal points, for example when the first point
+          // is repeated at the end, does not change the winding number. It is
+          // skipped, because polygon_contains_point_implementation would find
+          // every point on the horizontal line through it on the boundary.
+          const double squared_length = (point_list[i] - point_list[j]).norm_square();
+          if (!(squared_length > 0))
+            continue;
+
+          start_x.push_back(point_list[j][0]);
+          start_y.push_back(point_list[j][1]);
+          end_y.push_back(point_list[i][1]);
+          edge_x.push_back(point_list[i][0] - point_list[j][0]);
+          edge_y.push_back(point_list[i][1] - point_list[j][1]);
+          edge_squared_length.push_back(squared_length);
+        }
+
+      if (use_raster)
+        build_raster();
+    }
+
+
+    void
+    Polygon::build_raster()
+    {
+      // Use more cells for polygons with more edges, so that the number of
+      // cells crossed by the boundary stays a small fraction of all cells.
+      const size_t n_edges = start_x.size();
+      const size_t n_cells_per_direction = std::min(static_cast<size_t>(256),
+                                                    std::max(static_cast<size_t>(4),
+                                                             2 * static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(n_edges))))));
+
+      for (unsigned int d = 0; d < 2; ++d)
+        {
+          // A polygon without area does not need a raster.
+          if (!(max_point[d] - min_point[d] > 0) || !std::isfinite(max_point[d] - min_point[d]))
+            return;
+          n_cells[d] = n_cells_per_direction;
+          cell_size[d] = (max_point[d] - min_point[d]) / static_cast<double>(n_cells[d]);
+        }
+
+      // First mark all the cells which an edge comes close to. The cells are
+      // enlarged by a small margin, so that a point which is rounded into a
+      // neighboring cell is still classified correctly.
+      cells.assign(n_cells[0] * n_cells[1], cell_outside);
+      const std::array<double,2> margin = {{1e-6 * cell_size[0], 1e-6 * cell_size[1]}};
+      for (size_t edge = 0; edge < n_edges; ++edge)
+        {
+          const double end_x = start_x[edge] + edge_x[edge];
+          std::array<size_t,2> first_cell;
+          std::array<size_t,2> last_cell;
+          const std::array<double,2> edge_min = {{std::min(start_x[edge], end_x), std::min(start_y[edge], end_y[edge])}};
+          const std::array<double,2> edge_max = {{std::max(start_x[edge], end_x), std::max(start_y[edge], end_y[edge])}};
+          for (unsigned int d = 0; d < 2; ++d)
+            {
+              const double first = std::floor((edge_min[d] - margin[d] - min_point[d]) / cell_size[d]);
+              const double last = std::floor((edge_max[d] + margin[d] - min_point[d]) / cell_size[d]);
+              first_cell[d] = static_cast<size_t>(std::max(0.0, first));
+              last_cell[d] = std::min(n_cells[d] - 1, static_cast<size_t>(std::max(0.0, last)));
+            }
+
+          for (size_t j = first_cell[1]; j <= last_cell[1]; ++j)
+            for (size_t i = first_cell[0]; i <= last_cell[0]; ++i)
+              {
+                // The edge misses the cell if all the corners of the cell lie
+                // on the same side of the line through the edge.
+                const double cell_min_x = min_point[0] + static_cast<double>(i) * cell_size[0] - margin[0];
+                const double cell_min_y = min_point[1] + static_cast<double>(j) * cell_size[1] - margin[1];
+                const double cell_max_x = cell_min_x + cell_size[0] + 2.0 * margin[0];
+                const double cell_max_y = cell_min_y + cell_size[1] + 2.0 * margin[1];
+                unsigned int n_left = 0;
+                unsigned int n_right = 0;
+                for (const double corner_x : {cell_min_x, cell_max_x})
+                  for (const double corner_y : {cell_min_y, cell_max_y})
+                    {
+                      const double is_left = edge_x[edge] * (corner_y - start_y[edge]) - (corner_x - start_x[edge]) * edge_y[edge];
+                      n_left += is_left > 0 ? 1 : 0;
+                      n_right += is_left < 0 ? 1 : 0;
+                    }
+                if (n_left < 4 && n_right < 4)
+                  cells[j * n_cells[0] + i] = cell_boundary;
+              }
+        }
+
+      // All the other cells are completely inside or outside the polygon. Within
+      // a row, this only changes after a cell which is crossed by the boundary,
+      // so the edges only have to be tested for the first cell after one.
+      for (size_t j = 0; j < n_cells[1]; ++j)
+        {
+          bool previous_is_boundary = true;
+          CellType previous_type = cell_outside;
+          for (size_t i = 0; i < n_cells[0]; ++i)
+            {
+              CellType &cell = cells[j * n_cells[0] + i];
+              if (cell == cell_boundary)
+                {
+                  previous_is_boundary = true;
+                  continue;
+                }
+
+              if (previous_is_boundary)
+                previous_type = contains_implementation(min_point[0] + (static_cast<double>(i) + 0.5) * cell_size[0],
+                                                        min_point[1] + (static_cast<double>(j) + 0.5) * cell_size[1])
+                                ? cell_inside : cell_outside;
+              cell = previous_type;
+              previous_is_boundary = false;
+            }
+        }
+    }
+
+
+    bool
+    Polygon::contains(const std::array<double,2> &point) const
+    {
+      if (point[1] < min_point[1] || point[1] > max_point[1])
+        return false;
+
+      if (point[0] >= min_point[0] && point[0] <= max_point[0]
+          && raster_contains(point[0], point[1]))
+        return true;
+
+      if (spherical)
+        {
+          const double other_point_x = point[0] + (point[0] < 0 ? 2.0 * const_pi : -2.0 * const_pi);
+          return other_point_x >= min_point[0] && other_point_x <= max_point[0]
+                 && raster_contains(other_point_x, point[1]);
+        }
+
+      return false;
+    }
+
+
+    bool
+    Polygon::raster_contains(const double point_x,
+                             const double point_y) const
+    {
+      if (cells.size() == 0)
+        return contains_implementation(point_x, point_y);
+
+      // The point lies within the bounding box, so only the cells on the
+      // maximum side have to be clamped.
+      const size_t i = std::min(n_cells[0] - 1, static_cast<size_t>((point_x - min_point[0]) / cell_size[0]));
+      const size_t j = std::min(n_cells[1] - 1, static_cast<size_t>((point_y - min_point[1]) / cell_size[1]));
+      switch (cells[j * n_cells[0] + i])
+        {
+          case cell_inside:
+            return true;
+          case cell_outside:
+            return false;
+          default:
+            return contains_implementation(point_x, point_y);
+        }
+    }
+
+
+    bool
+    Polygon::contains_implementation(const double point_x,
+                                     const double point_y) const
+    {
+      // This is the same winding number algorithm as in
+      // polygon_contains_point_implementation, but the branches are replaced
+      // by masks, so that the loop over the edges can be vectorized. Instead
+      // of returning as soon as the point is found on an edge, it is recorded
+      // and returned after the loop.
+      const size_t n_edges = start_x.size();
+      int winding_number = 0;
+      int on_boundary = 0;
+      for (size_t i = 0; i < n_edges; ++i)
+        {
+          const double relative_x = point_x - start_x[i];
+          const double relative_y = point_y - start_y[i];
+          const double is_left = edge_x[i] * relative_y - relative_x * edge_y[i];
+
+          const int upward = (start_y[i] <= point_y) & (end_y[i] >= point_y);
+          const int downward = (start_y[i] > point_y) & (end_y[i] <= point_y);
+          const int up_crossing = upward & (is_left > 0) & (end_y[i] > point_y);
+          const int down_crossing = downward & (is_left < 0);
+
+          const double dot_product = relative_x * edge_x[i] + relative_y * edge_y[i];
+          const int on_line = (upward | downward) & (std::fabs(is_left) < std::numeric_limits<double>::epsilon());
+          const int on_segment = (dot_product >= 0) & (dot_product <= edge_squared_length[i]);
+
+          winding_number += up_crossing - down_crossing;
+          on_boundary |= on_line & (1 - up_crossing) & (1 - down_crossing) & on_segment;
+        }
+
+      return on_boundary != 0 || winding_number != 0;
+    }
+
+
     double
     signed_distance_to_polygon(const std::vector<Point<2> > &point_list,
                                const Point<2> &point)
@@ -227,7 +452,7 @@ namespace WorldBuilder
       coordinates = coordinate_system_.cartesian_to_natural_coordinates(position.get_array());
     }
 
-    const std::array<double,3> &NaturalCoordinate::get_coordinates()
+    const std::array<double,3> &NaturalCoordinate::get_coordinates() const
     {
       return coordinates;
     }
@@ -306,6 +531,24 @@ namespace WorldBuilder
     }
 
 
+    void NaturalCoordinate::set_depth_coordinate(const double depth_coordinate)
+    {
+      switch (coordinate_system)
+        {
+          case CoordinateSystem::cartesian:
+            coordinates[2] = depth_coordinate;
+            break;
+
+          case CoordinateSystem::spherical:
+            coordinates[0] = depth_coordinate;
+            break;
+
+          default:
+            WBAssert (false, "Coordinate system not implemented.");
+        }
+    }
+
+
     std::array<double,3>
     cartesian_to_spherical_coordinates(const Point<3> &position)
     {
@@ -338,6 +581,30 @@ namespace WorldBuilder
     }
 
 
+    std::array<double,2>
+    cartesian_to_natural_surface_coordinates(const std::array<double,3> &position,
+                                             const CoordinateSystem coordinate_system)
+    {
+      if (coordinate_system == spherical)
+        {
+          const std::array<double,3> scoord = cartesian_to_spherical_coordinates(Point<3>(position,cartesian));
+          return {{scoord[1],scoord[2]}};
+        }
+      return {{position[0],position[1]}};
+    }
+
+
+    std::array<double,3>
+    surface_to_natural_coordinates(const std::array<double,2> &surface_coordinates,
+                                   const double depth_coordinate,
+                                   const CoordinateSystem coordinate_system)
+    {
+      if (coordinate_system == spherical)
+        return {{depth_coordinate,surface_coordinates[0],surface_coordinates[1]}};
+      return {{surface_coordinates[0],surface_coordinates[1],depth_coordinate}};
+    }
+
+
 
     CoordinateSystem
     string_to_coordinate_system(const std::string &coordinate_system)
@@ -433,27 +700,37 @@ namespace WorldBuilder
       return Point<3>(x,y,z,a.get_coordinate_system());
     }
 
-    std::map<std::string,double>
-    distance_point_from_curved_planes(const Point<3> &check_point, // cartesian point in spherical system
-                                      const Point<2> &reference_point, // in (rad) spherical coordinates in spherical system
-                                      const std::vector<Point<2> > &point_list, // in  (rad) spherical coordinates in spherical system
-                                      const std::vector<std::vector<double> > &plane_segment_lengths,
-                                      const std::vector<std::vector<Point<2> > > &plane_segment_angles,
-                                      const double start_radius,
-                                      const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
-                                      const bool only_positive,
-                                      std::vector<double> global_x_list)
+    CurvedPlanesGeometry::Section::Section(const Point<2> &P1_, const Point<2> &P2)
+      :
+      P1(P1_),
+      P1P2(P2 - P1_),
+      unit_P1P2(P1P2 / P1P2.norm()),
+      P1P2_squared_norm(P1P2 * P1P2),
+      P1P2_norm(P1P2.norm()),
+      reference_on_side_of_line(0),
+      original_current_section(0),
+      global_x_fraction(0),
+      global_x_length(0)
+    {}
+
+
+    CurvedPlanesGeometry::CurvedPlanesGeometry()
+      :
+      natural_coordinate_system(invalid),
+      depth_method(DepthMethod::none)
+    {}
+
+
+    CurvedPlanesGeometry::CurvedPlanesGeometry(const Point<2> &reference_point,
+                                               const std::vector<Point<2> > &point_list,
+                                               const std::vector<std::vector<double> > &plane_segment_lengths,
+                                               const std::vector<std::vector<Point<2> > > &plane_segment_angles,
+                                               const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                               std::vector<double> global_x_list)
+      :
+      natural_coordinate_system(coordinate_system->natural_coordinate_system()),
+      depth_method(coordinate_system->depth_method())
     {
-      // TODO: Assert that point_list, plane_segment_angles and plane_segment_lenghts have the same size.
-      /*WBAssert(point_list.size() == plane_segment_lengths.size(),
-               "Internal error: The size of point_list (" << point_list.size()
-               << ") and plane_segment_lengths (" << plane_segment_lengths.size() << ") are different.");
-      WBAssert(point_list.size() == plane_segment_angles.size(),
-               "Internal error: The size of point_list (" << point_list.size()
-               << ") and plane_segment_angles (" << plane_segment_angles.size() << ") are different.");
-      WBAssert(point_list.size() == plane_segment_angles.size(),
-               "Internal error: The size of point_list (" << point_list.size()
-               << ") and global_x_list (" << global_x_list.size() << ") are different.");*/
       if (global_x_list.size() == 0)
         {
           // fill it
@@ -464,540 +741,837 @@ namespace WorldBuilder
       WBAssertThrow(global_x_list.size() == point_list.size(), "The given global_x_list doesn't have "
                     "the same size as the point list. This is required.");
 
-      double distance = INFINITY;
-      double new_distance = INFINITY;
-      double along_plane_distance = INFINITY;
-      double new_along_plane_distance  = INFINITY;
-
-      const CoordinateSystem natural_coordinate_system = coordinate_system->natural_coordinate_system();
-      const bool bool_cartesian = natural_coordinate_system == cartesian;
-
-      const Point<3> check_point_natural(coordinate_system->cartesian_to_natural_coordinates(check_point.get_array()),natural_coordinate_system);
-      const Point<3> check_point_surface(bool_cartesian ? check_point_natural[0] : start_radius,
-                                         check_point_natural[1],
-                                         bool_cartesian ? start_radius           : check_point_natural[2],
-                                         natural_coordinate_system);
-      const Point<2> check_point_surface_2d(bool_cartesian ? check_point_natural[0] : check_point_natural[1],
-                                            bool_cartesian ? check_point_natural[1] : check_point_natural[2],
-                                            natural_coordinate_system);
-
-      // The section which is checked.
-      size_t section = 0;
-
-      // The 'horizontal' fraction between the points at the surface.
-      double section_fraction = 0.0;
-
-      // What segment the point on the line is in.
-      unsigned int segment = 0;
-
-      // The 'vertical' fraction, indicates how far in the current segment the
-      // point on the line is.
-      double segment_fraction = 0.0;
-      double total_average_angle = 0.0;
-
-      const DepthMethod depth_method = coordinate_system->depth_method();
       WBAssertThrow(depth_method == DepthMethod::none
                     || depth_method == DepthMethod::angle_at_starting_point_with_surface
                     || depth_method == DepthMethod::angle_at_begin_segment_with_surface,
                     "Only the depth methods none, angle_at_starting_point_with_surface and "
                     "angle_at_begin_segment_with_surface are implemented");
 
-      // loop over all the planes to find out which one is closest to the point.
-
-      for (size_t i_section=0; i_section < point_list.size()-1; ++i_section)
+      for (size_t i_section = 0; i_section + 1 < point_list.size(); ++i_section)
         {
           const size_t current_section = i_section;
           const size_t next_section = i_section+1;
-          // translate to orignal coordinates current and next section
-          const size_t original_current_section = static_cast<size_t>(std::floor(global_x_list[i_section]));
-          const size_t original_next_section = original_current_section + 1;
-          // see on what side the line P1P2 reference point is. This is based on the determinant
-          const double reference_on_side_of_line = (point_list[next_section][0] - point_list[current_section][0])
-                                                   * (reference_point[1] - point_list[current_section][1])
-                                                   - (point_list[next_section][1] - point_list[current_section][1])
-                                                   * (reference_point[0] - point_list[current_section][0])
-                                                   < 0 ? 1 : -1;
 
+          Section section(point_list[current_section], point_list[next_section]);
 
+          // see on what side the line P1P2 reference point is. This is based on the determinant
+          section.reference_on_side_of_line = (point_list[next_section][0] - point_list[current_section][0])
+                                              * (reference_point[1] - point_list[current_section][1])
+                                              - (point_list[next_section][1] - point_list[current_section][1])
+                                              * (reference_point[0] - point_list[current_section][0])
+                                              < 0 ? 1 : -1;
 
-          const Point<2> P1(point_list[current_section]);
-
-          const Point<2> P2(point_list[next_section]);
-
-          const Point<2> P1P2 = P2 - P1;
-          const Point<2> P1PC = check_point_surface_2d - P1;
-
-
-          // Compute the closest point on the line P1 to P2 from the check
-          // point at the surface. We do this in natural coordinates on
-          // purpose, because in spherical coordinates it is more accurate.
-          Point<2> closest_point_on_line_2d = P1 + ((P1PC * P1P2) / (P1P2 * P1P2)) * P1P2;
+          // translate to orignal coordinates current and next section
+          section.original_current_section = static_cast<size_t>(std::floor(global_x_list[i_section]));
+          section.global_x_fraction = global_x_list[i_section] - static_cast<int>(global_x_list[i_section]);
+          section.global_x_length = global_x_list[i_section+1]-global_x_list[i_section];
 
+          sections.push_back(section);
+        }
 
-          // compute what fraction of the distance between P1 and P2 the
-          // closest point lies.
-          const Point<2> P1CPL = closest_point_on_line_2d - P1;
+      // The segments are stored for every original section, together with the
+      // change to the same segment of the next original section.
+      const size_t n_original_sections = sections.size() == 0 ? 0 : sections.back().original_current_section + 1;
+      segments.resize(n_original_sections);
+      for (size_t original_current_section = 0; original_current_section < n_original_sections; ++original_current_section)
+        {
+          const size_t original_next_section = original_current_section + 1;
 
-          // This determines where the check point is between the coordinates
-          // in the coordinate list.
-          const double fraction_CPL_P1P2_strict = (P1CPL * P1P2 <= 0 ? -1.0 : 1.0)
-                                                  * (1 - (P1P2.norm() - P1CPL.norm()) / P1P2.norm());
+          WBAssert(plane_segment_angles.size() > original_next_section,
+                   "Error: original_next_section = " << original_next_section
+                   << ", and plane_segment_angles.size() = " << plane_segment_angles.size());
 
-          // If the point on the line does not lay between point P1 and P2
-          // then ignore it. Otherwise continue.
-          if (fraction_CPL_P1P2_strict >= 0 && fraction_CPL_P1P2_strict <= 1.0)
+          segments[original_current_section].resize(plane_segment_lengths[original_current_section].size());
+          for (size_t current_segment = 0; current_segment < plane_segment_lengths[original_current_section].size(); ++current_segment)
             {
-              // now figure out where the point is in relation with the user
-              // defined coordinates
-              const double fraction_CPL_P1P2 = global_x_list[i_section] - static_cast<int>(global_x_list[i_section])
-                                               + (global_x_list[i_section+1]-global_x_list[i_section]) * fraction_CPL_P1P2_strict;
-
-              const Point<2> unit_normal_to_plane_spherical = P1P2 / P1P2.norm();
-              const Point<2> closest_point_on_line_plus_normal_to_plane_spherical = closest_point_on_line_2d + 1e-8 * (closest_point_on_line_2d.norm() > 1.0 ? closest_point_on_line_2d.norm() : 1.0) * unit_normal_to_plane_spherical;
-
-              WBAssert(std::fabs(closest_point_on_line_plus_normal_to_plane_spherical.norm()) > std::numeric_limits<double>::epsilon(),
-                       "Internal error: The norm of variable 'closest_point_on_line_plus_normal_to_plane_spherical' "
-                       "is  zero, while this may not happen.");
-
-              // We now need 3d points from this point on, so make them.
-              // The order of a Cartesian coordinate is x,y,z and the order of
-              // a spherical coordinate it radius, long, lat (in rad).
-              const Point<3> closest_point_on_line_surface(bool_cartesian ? closest_point_on_line_2d[0] : start_radius,
-                                                           bool_cartesian ? closest_point_on_line_2d[1] : closest_point_on_line_2d[0],
-                                                           bool_cartesian ? start_radius : closest_point_on_line_2d[1],
-                                                           natural_coordinate_system);
-
-              Point<3> closest_point_on_line_bottom = closest_point_on_line_surface;
-              closest_point_on_line_bottom[bool_cartesian ? 2 : 0] = 0;
-
-              const Point<3> closest_point_on_line_plus_normal_to_plane_surface_spherical(bool_cartesian ? closest_point_on_line_plus_normal_to_plane_spherical[0] : start_radius,
-                                                                                          bool_cartesian ? closest_point_on_line_plus_normal_to_plane_spherical[1] : closest_point_on_line_plus_normal_to_plane_spherical[0],
-                                                                                          bool_cartesian ? start_radius : closest_point_on_line_plus_normal_to_plane_spherical[1],
-                                                                                          natural_coordinate_system);
-
-              // Now that we have both the check point and the
-              // closest_point_on_line, we need to push them to cartesian.
-              const Point<3> check_point_cartesian(check_point);
-              const Point<3> check_point_surface_cartesian(coordinate_system->natural_to_cartesian_coordinates(check_point_surface.get_array()),cartesian);
-              const Point<3> closest_point_on_line_cartesian(coordinate_system->natural_to_cartesian_coordinates(closest_point_on_line_surface.get_array()),cartesian);
-              const Point<3> closest_point_on_line_bottom_cartesian(coordinate_system->natural_to_cartesian_coordinates(closest_point_on_line_bottom.get_array()),cartesian);
-              const Point<3> closest_point_on_line_plus_normal_to_plane_cartesian(coordinate_system->natural_to_cartesian_coordinates(closest_point_on_line_plus_normal_to_plane_surface_spherical.get_array()),cartesian);
-
-
-              // if the two points are the same, we don't need to search any further
-              if (std::fabs((check_point_cartesian - closest_point_on_line_cartesian).norm()) < 2e-14)
-                {
-                  distance = 0.0;
-                  along_plane_distance = 0.0;
-                  section = current_section;
-                  section_fraction = fraction_CPL_P1P2;
-                  segment = 0;
-                  segment_fraction = 0.0;
-                  total_average_angle = plane_segment_angles[original_current_section][0][0]
-                                        + fraction_CPL_P1P2 * (plane_segment_angles[original_next_section][0][0]
-                                                               - plane_segment_angles[original_current_section][0][0]);
-                  break;
-                }
-
-              Point<3> normal_to_plane = closest_point_on_line_plus_normal_to_plane_cartesian - closest_point_on_line_cartesian;
-              normal_to_plane = normal_to_plane / normal_to_plane.norm();
-
-              // The y-axis is from the bottom/center to the closest_point_on_line,
-              // the x-axis is 90 degrees rotated from that, so we rotate around
-              // the line P1P2.
-              // Todo: Assert that the norm of the axis are not equal to zero.
-              Point<3> y_axis = closest_point_on_line_cartesian - closest_point_on_line_bottom_cartesian;
-
-              WBAssert(std::abs(y_axis.norm()) > std::numeric_limits<double>::epsilon(),
-                       "World Builder error: Cannot detemine the up direction in the model. This is most likely due to the provided start radius being zero."
-                       << " Techical details: The y_axis.norm() is zero. Y_axis is " << y_axis[0] << ":" << y_axis[1] << ":" << y_axis[2]
-                       << ". closest_point_on_line_cartesian = " << closest_point_on_line_cartesian[0] << ":" << closest_point_on_line_cartesian[1] << ":" << closest_point_on_line_cartesian[2]
-                       << ", closest_point_on_line_bottom_cartesian = " << closest_point_on_line_bottom_cartesian[0] << ":" << closest_point_on_line_bottom_cartesian[1] << ":" << closest_point_on_line_bottom_cartesian[2]);
-
-              WBAssert(!std::isnan(y_axis[0]),
-                       "Internal error: The y_axis variable is not a number: " << y_axis[0]);
-              WBAssert(!std::isnan(y_axis[1]),
-                       "Internal error: The y_axis variable is not a number: " << y_axis[1]);
-              WBAssert(!std::isnan(y_axis[2]),
-                       "Internal error: The y_axis variable is not a number: " << y_axis[2]);
-
-
-              y_axis = y_axis / y_axis.norm();
-
-
-              WBAssert(!std::isnan(y_axis[0]),
-                       "Internal error: The y_axis variable is not a number: " << y_axis[0]);
-              WBAssert(!std::isnan(y_axis[1]),
-                       "Internal error: The y_axis variable is not a number: " << y_axis[1]);
-              WBAssert(!std::isnan(y_axis[2]),
-                       "Internal error: The y_axis variable is not a number: " << y_axis[2]);
-
-
-              // shorthand notation for computing the x_axis
-              double vx = y_axis[0];
-              double vy = y_axis[1];
-              double vz = y_axis[2];
-              double ux = normal_to_plane[0];
-              double uy = normal_to_plane[1];
-              double uz = normal_to_plane[2];
-
-              Point<3> x_axis(ux*ux*vx + ux*uy*vy - uz*vy + uy*uz*vz + uy*vz,
-                              uy*ux*vx + uz*vx + uy*uy*vy + uy*uz*vz - ux*vz,
-                              uz*ux*vx - uy*vx + uz*uy*vy + ux*vy + uz*uz*vz,
-                              cartesian);
-
-              WBAssert(!std::isnan(x_axis[0]),
-                       "Internal error: The x_axis variable is not a number: " << x_axis[0]);
-              WBAssert(!std::isnan(x_axis[1]),
-                       "Internal error: The x_axis variable is not a number: " << x_axis[1]);
-              WBAssert(!std::isnan(x_axis[2]),
-                       "Internal error: The x_axis variable is not a number: " << x_axis[2]);
-
-              x_axis = x_axis *(reference_on_side_of_line / x_axis.norm());
-
-
-              WBAssert(!std::isnan(x_axis[0]),
-                       "Internal error: The x_axis variable is not a number: " << x_axis[0]);
-              WBAssert(!std::isnan(x_axis[1]),
-                       "Internal error: The x_axis variable is not a number: " << x_axis[1]);
-              WBAssert(!std::isnan(x_axis[2]),
-                       "Internal error: The x_axis variable is not a number: " << x_axis[2]);
-
-              Point<2> check_point_2d(x_axis * (check_point_cartesian - closest_point_on_line_bottom_cartesian),
-                                      y_axis * (check_point_cartesian - closest_point_on_line_bottom_cartesian),
-                                      cartesian);
-
-
-              Point<2> begin_segment(x_axis * (closest_point_on_line_cartesian - closest_point_on_line_bottom_cartesian),
-                                     y_axis * (closest_point_on_line_cartesian - closest_point_on_line_bottom_cartesian),
-                                     cartesian);
-
-
-              WBAssert(!std::isnan(check_point_2d[0]),
-                       "Internal error: The check_point_2d variable is not a number: " << check_point_2d[0]);
-              WBAssert(!std::isnan(check_point_2d[1]),
-                       "Internal error: The check_point_2d variable is not a number: " << check_point_2d[1]);
-
-
-              WBAssert(!std::isnan(begin_segment[0]),
-                       "Internal error: The begin_segment variable is not a number: " << begin_segment[0]);
-              WBAssert(!std::isnan(begin_segment[1]),
-                       "Internal error: The begin_segment variable is not a number: " << begin_segment[1]);
-
-              Point<2> end_segment = begin_segment;
-
-
-              double total_length = 0.0;
-              double add_angle = 0.0;
-              double average_angle = 0.0;
-              for (unsigned int i_segment = 0; i_segment < plane_segment_lengths[original_current_section].size(); i_segment++)
-                {
-                  const unsigned int current_segment = i_segment;
-
-                  // compute the angle between the the previous begin and end if
-                  // the depth method is angle_at_begin_segment_with_surface.
-                  if (i_segment != 0 && depth_method == DepthMethod::angle_at_begin_segment_with_surface)
-                    {
-                      const double add_angle_inner = (begin_segment * end_segment) / (begin_segment.norm() * end_segment.norm());
-
-                      WBAssert(!std::isnan(add_angle_inner),
-                               "Internal error: The add_angle_inner variable is not a number: " << add_angle_inner
-                               << ". Variables: begin_segment = " << begin_segment[0] << ":" << begin_segment[1]
-                               << ", end_segment = " << end_segment[0] << ":" << end_segment[1]
-                               << ", begin_segment * end_segment / (begin_segment.norm() * end_segment.norm()) = "
-                               << std::setprecision(32) << begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())
-                               << ".");
-
-                      // there could be round of error problems here is the inner part is close to one
-                      WBAssert(add_angle_inner >= 0 && add_angle_inner <= 1,
-                               "Internal error: The variable add_angle_inner is smaller than zero or larger then one,"
-                               "which causes the std::acos to return nan. If it is only a little bit larger then one, "
-                               "this is probably caused by that begin and end segment are the same and round off error. "
-                               "The value of add_angle_inner = " << add_angle_inner);
-
-                      add_angle += std::acos(add_angle_inner);
-
-                      WBAssert(!std::isnan(add_angle),
-                               "Internal error: The add_angle variable is not a number: " << add_angle
-                               << ". Variables: begin_segment = " << begin_segment[0] << ":" << begin_segment[1]
-                               << ", end_segment = " << end_segment[0] << ":" << end_segment[1]
-                               << ", begin_segment * end_segment / (begin_segment.norm() * end_segment.norm()) = "
-                               << std::setprecision(32) << begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())
-                               << ", std::acos(begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())) = "
-                               << std::acos(begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())));
-                    }
-
-
-
-
-                  begin_segment = end_segment;
-
-                  WBAssert(!std::isnan(begin_segment[0]),
-                           "Internal error: The begin_segment variable is not a number: " << begin_segment[0]);
-                  WBAssert(!std::isnan(begin_segment[1]),
-                           "Internal error: The begin_segment variable is not a number: " << begin_segment[1]);
+              WBAssert(plane_segment_angles[original_next_section].size() > current_segment,
+                       "Error: current_segment = "  << current_segment
+                       << ", and current_segment.size() = " << plane_segment_angles[original_next_section].size());
+
+              Segment &segment = segments[original_current_section][current_segment];
+              segment.angle_top = plane_segment_angles[original_current_section][current_segment][0];
+              segment.angle_top_change = plane_segment_angles[original_next_section][current_segment][0]
+                                         - plane_segment_angles[original_current_section][current_segment][0];
+              segment.angle_bottom = plane_segment_angles[original_current_section][current_segment][1];
+              segment.angle_bottom_change = plane_segment_angles[original_next_section][current_segment][1]
+                                            - plane_segment_angles[original_current_section][current_segment][1];
+              segment.length = plane_segment_lengths[original_current_section][current_segment];
+              segment.length_change = plane_segment_lengths[original_next_section][current_segment]
+                                      - plane_segment_lengths[original_current_section][current_segment];
+            }
+        }
+    }
 
 
-                  // This interpolates different properties between P1 and P2 (the
-                  // points of the plane at the surface)
-                  const double degree_90_to_rad = 0.5 * const_pi;
+    PointDistanceFromCurvedPlanes
+    distance_point_from_curved_planes(const Point<3> &check_point, // cartesian point in spherical system
+                                      const Point<2> &reference_point, // in (rad) spherical coordinates in spherical system
+                                      const std::vector<Point<2> > &point_list, // in  (rad) spherical coordinates in spherical system
+                                      const std::vector<std::vector<double> > &plane_segment_lengths,
+                                      const std::vector<std::vector<Point<2> > > &plane_segment_angles,
+                                      const double start_radius,
+                                      const std::unique_ptr<CoordinateSystems::Interface> &coordinate_system,
+                                      const bool only_positive,
+                                      std::vector<double> global_x_list)
+    {
+      // TODO: Assert that point_list, plane_segment_angles and plane_segment_lenghts have the same size.
+      const CurvedPlanesGeometry geometry(reference_point,
+                                          point_list,
+                                          plane_segment_lengths,
+                                          plane_segment_angles,
+                                          coordinate_system,
+                                          global_x_list);
+
+      return distance_point_from_curved_planes(check_point,
+                                               NaturalCoordinate(check_point, *coordinate_system),
+                                               geometry,
+                                               start_radius,
+                                               only_positive);
+    }
 
-                  WBAssert(plane_segment_angles.size() > original_next_section,
-                           "Error: original_next_section = " << original_next_section
-                           << ", and plane_segment_angles.size() = " << plane_segment_angles.size());
 
+    namespace
+    {
+      /**
+       * Converts natural coordinates to Cartesian coordinates for a coordinate
+       * system which is known at compile time.
+       */
+      template <CoordinateSystem natural_coordinate_system>
+      struct NaturalCoordinateConversions;
+
+      template <>
+      struct NaturalCoordinateConversions<cartesian>
+      {
+        static
+        std::array<double,3>
+        natural_to_cartesian_coordinates(const std::array<double,3> &position)
+        {
+          return position;
+        }
+      };
+
+      template <>
+      struct NaturalCoordinateConversions<spherical>
+      {
+        static
+        std::array<double,3>
+        natural_to_cartesian_coordinates(const std::array<double,3> &position)
+        {
+          return spherical_to_cartesian_coordinates(position).get_array();
+        }
+      };
 
-                  WBAssert(plane_segment_angles[original_next_section].size() > current_segment,
-                           "Error: current_segment = "  << current_segment
-                           << ", and current_segment.size() = " << plane_segment_angles[original_next_section].size());
 
-                  const double interpolated_angle_top    = plane_segment_angles[original_current_section][current_segment][0]
-                                                           + fraction_CPL_P1P2 * (plane_segment_angles[original_next_section][current_segment][0]
-                                                                                  - plane_segment_angles[original_current_section][current_segment][0])
-                                                           + add_angle;
+      /**
+       * The state of the search for the closest point on the curved planes,
+       * which is updated for every section and segment.
+       */
+      struct CurvedPlanesSearchState
+      {
+        CurvedPlanesSearchState()
+          :
+          distance(INFINITY),
+          new_distance(INFINITY),
+          along_plane_distance(INFINITY),
+          new_along_plane_distance(INFINITY),
+          section(0),
+          section_fraction(0.0),
+          segment(0),
+          segment_fraction(0.0),
+          total_average_angle(0.0)
+        {}
+
+        double distance;
+        double new_distance;
+        double along_plane_distance;
+        double new_along_plane_distance;
+
+        // The section which is checked.
+        size_t section;
+
+        // The 'horizontal' fraction between the points at the surface.
+        double section_fraction;
+
+        // What segment the point on the line is in.
+        unsigned int segment;
+
+        // The 'vertical' fraction, indicates how far in the current segment the
+        // point on the line is.
+        double segment_fraction;
+        double total_average_angle;
+      };
 
-                  const double interpolated_angle_bottom = plane_segment_angles[original_current_section][current_segment][1]
-                                                           + fraction_CPL_P1P2 * (plane_segment_angles[original_next_section][current_segment][1]
-                                                                                  - plane_segment_angles[original_current_section][current_segment][1])
-                                                           + add_angle;
 
+      /**
+       * Returns the surface part of the natural coordinates of a point in the
+       * same order as the coordinates of the curved planes.
+       */
+      template <CoordinateSystem natural_coordinate_system>
+      Point<2>
+      surface_point_2d(const NaturalCoordinate &natural_coordinate)
+      {
+        const bool bool_cartesian = natural_coordinate_system == cartesian;
+        const std::array<double,3> &check_point_natural = natural_coordinate.get_coordinates();
+        return Point<2>(bool_cartesian ? check_point_natural[0] : check_point_natural[1],
+                        bool_cartesian ? check_point_natural[1] : check_point_natural[2],
+                        natural_coordinate_system);
+      }
 
-                  double interpolated_segment_length     = plane_segment_lengths[original_current_section][current_segment]
-                                                           + fraction_CPL_P1P2 * (plane_segment_lengths[original_next_section][current_segment]
-                                                                                  - plane_segment_lengths[original_current_section][current_segment]);
-                  WBAssert(!std::isnan(interpolated_angle_top),
-                           "Internal error: The interpolated_angle_top variable is not a number: " << interpolated_angle_top);
 
-                  // We want to know where the end point of this segment is (and
-                  // the start of the next segment). There are two cases which we
-                  // will deal with separately. The first one is if the angle is
-                  // constant. The second one is if the angle changes.
-                  const double difference_in_angle_along_segment = interpolated_angle_top - interpolated_angle_bottom;
+      /**
+       * Computes the part of a section of the curved planes which only
+       * depends on the surface position of the check point. Returns false if
+       * the check point does not lie next to the section.
+       */
+      template <CoordinateSystem natural_coordinate_system>
+      bool
+      compute_column_section(const Point<2> &check_point_surface_2d,
+                             const CurvedPlanesGeometry &geometry,
+                             const size_t i_section,
+                             const double start_radius,
+                             CurvedPlanesColumn::Section &column_section)
+      {
+        const bool bool_cartesian = natural_coordinate_system == cartesian;
+
+        const CurvedPlanesGeometry::Section &section_geometry = geometry.sections[i_section];
+        const size_t current_section = i_section;
+        // translate to orignal coordinates current section
+        const size_t original_current_section = section_geometry.original_current_section;
+        // see on what side the line P1P2 reference point is.
+        const double reference_on_side_of_line = section_geometry.reference_on_side_of_line;
+
+        const Point<2> &P1 = section_geometry.P1;
+        const Point<2> &P1P2 = section_geometry.P1P2;
+        const Point<2> P1PC = check_point_surface_2d - P1;
+
+
+        // Compute the closest point on the line P1 to P2 from the check
+        // point at the surface. We do this in natural coordinates on
+        // purpose, because in spherical coordinates it is more accurate.
+        Point<2> closest_point_on_line_2d = P1 + ((P1PC * P1P2) / section_geometry.P1P2_squared_norm) * P1P2;
+
+
+        // compute what fraction of the distance between P1 and P2 the
+        // closest point lies.
+        const Point<2> P1CPL = closest_point_on_line_2d - P1;
+
+        // This determines where the check point is between the coordinates
+        // in the coordinate list.
+        const double fraction_CPL_P1P2_strict = (P1CPL * P1P2 <= 0 ? -1.0 : 1.0)
+                                                * (1 - (section_geometry.P1P2_norm - P1CPL.norm()) / section_geometry.P1P2_norm);
+
+        // If the point on the line does not lay between point P1 and P2
+        // then ignore it. Otherwise continue.
+        if (!(fraction_CPL_P1P2_strict >= 0 && fraction_CPL_P1P2_strict <= 1.0))
+          return false;
+
+        // now figure out where the point is in relation with the user
+        // defined coordinates
+        const double fraction_CPL_P1P2 = section_geometry.global_x_fraction
+                                         + section_geometry.global_x_length * fraction_CPL_P1P2_strict;
+
+        const Point<2> &unit_normal_to_plane_spherical = section_geometry.unit_P1P2;
+        const Point<2> closest_point_on_line_plus_normal_to_plane_spherical = closest_point_on_line_2d + 1e-8 * (closest_point_on_line_2d.norm() > 1.0 ? closest_point_on_line_2d.norm() : 1.0) * unit_normal_to_plane_spherical;
+
+        WBAssert(std::fabs(closest_point_on_line_plus_normal_to_plane_spherical.norm()) > std::numeric_limits<double>::epsilon(),
+                 "Internal error: The norm of variable 'closest_point_on_line_plus_normal_to_plane_spherical' "
+                 "is  zero, while this may not happen.");
+
+        // We now need 3d points from this point on, so make them.
+        // The order of a Cartesian coordinate is x,y,z and the order of
+        // a spherical coordinate it radius, long, lat (in rad).
+        const Point<3> closest_point_on_line_surface(bool_cartesian ? closest_point_on_line_2d[0] : start_radius,
+                                                     bool_cartesian ? closest_point_on_line_2d[1] : closest_point_on_line_2d[0],
+                                                     bool_cartesian ? start_radius : closest_point_on_line_2d[1],
+                                                     natural_coordinate_system);
+
+        Point<3> closest_point_on_line_bottom = closest_point_on_line_surface;
+        closest_point_on_line_bottom[bool_cartesian ? 2 : 0] = 0;
+
+        const Point<3> closest_point_on_line_plus_normal_to_plane_surface_spherical(bool_cartesian ? closest_point_on_line_plus_normal_to_plane_spherical[0] : start_radius,
+                                                                                    bool_cartesian ? closest_point_on_line_plus_normal_to_plane_spherical[1] : closest_point_on_line_plus_normal_to_plane_spherical[0],
+                                                                                    bool_cartesian ? start_radius : closest_point_on_line_plus_normal_to_plane_spherical[1],
+                                                                                    natural_coordinate_system);
+
+        // Now that we have the closest_point_on_line, we need to push
+        // it to cartesian.
+        const Point<3> closest_point_on_line_cartesian(NaturalCoordinateConversions<natural_coordinate_system>::natural_to_cartesian_coordinates(closest_point_on_line_surface.get_array()),cartesian);
+        const Point<3> closest_point_on_line_bottom_cartesian(NaturalCoordinateConversions<natural_coordinate_system>::natural_to_cartesian_coordinates(closest_point_on_line_bottom.get_array()),cartesian);
+        const Point<3> closest_point_on_line_plus_normal_to_plane_cartesian(NaturalCoordinateConversions<natural_coordinate_system>::natural_to_cartesian_coordinates(closest_point_on_line_plus_normal_to_plane_surface_spherical.get_array()),cartesian);
+
+        Point<3> normal_to_plane = closest_point_on_line_plus_normal_to_plane_cartesian - closest_point_on_line_cartesian;
+        normal_to_plane = normal_to_plane / normal_to_plane.norm();
+
+        // The y-axis is from the bottom/center to the closest_point_on_line,
+        // the x-axis is 90 degrees rotated from that, so we rotate around
+        // the line P1P2.
+        // Todo: Assert that the norm of the axis are not equal to zero.
+        Point<3> y_axis = closest_point_on_line_cartesian - closest_point_on_line_bottom_cartesian;
+
+        WBAssert(std::abs(y_axis.norm()) > std::numeric_limits<double>::epsilon(),
+                 "World Builder error: Cannot detemine the up direction in the model. This is most likely due to the provided start radius being zero."
+                 << " Techical details: The y_axis.norm() is zero. Y_axis is " << y_axis[0] << ":" << y_axis[1] << ":" << y_axis[2]
+                 << ". closest_point_on_line_cartesian = " << closest_point_on_line_cartesian[0] << ":" << closest_point_on_line_cartesian[1] << ":" << closest_point_on_line_cartesian[2]
+                 << ", closest_point_on_line_bottom_cartesian = " << closest_point_on_line_bottom_cartesian[0] << ":" << closest_point_on_line_bottom_cartesian[1] << ":" << closest_point_on_line_bottom_cartesian[2]);
+
+        WBAssert(!std::isnan(y_axis[0]),
+                 "Internal error: The y_axis variable is not a number: " << y_axis[0]);
+        WBAssert(!std::isnan(y_axis[1]),
+                 "Internal error: The y_axis variable is not a number: " << y_axis[1]);
+        WBAssert(!std::isnan(y_axis[2]),
+                 "Internal error: The y_axis variable is not a number: " << y_axis[2]);
+
+
+        y_axis = y_axis / y_axis.norm();
+
+
+        WBAssert(!std::isnan(y_axis[0]),
+                 "Internal error: The y_axis variable is not a number: " << y_axis[0]);
+        WBAssert(!std::isnan(y_axis[1]),
+                 "Internal error: The y_axis variable is not a number: " << y_axis[1]);
+        WBAssert(!std::isnan(y_axis[2]),
+                 "Internal error: The y_axis variable is not a number: " << y_axis[2]);
+
+
+        // shorthand notation for computing the x_axis
+        double vx = y_axis[0];
+        double vy = y_axis[1];
+        double vz = y_axis[2];
+        double ux = normal_to_plane[0];
+        double uy = normal_to_plane[1];
+        double uz = normal_to_plane[2];
+
+        Point<3> x_axis(ux*ux*vx + ux*uy*vy - uz*vy + uy*uz*vz + uy*vz,
+                        uy*ux*vx + uz*vx + uy*uy*vy + uy*uz*vz - ux*vz,
+                        uz*ux*vx - uy*vx + uz*uy*vy + ux*vy + uz*uz*vz,
+                        cartesian);
+
+        WBAssert(!std::isnan(x_axis[0]),
+                 "Internal error: The x_axis variable is not a number: " << x_axis[0]);
+        WBAssert(!std::isnan(x_axis[1]),
+                 "Internal error: The x_axis variable is not a number: " << x_axis[1]);
+        WBAssert(!std::isnan(x_axis[2]),
+                 "Internal error: The x_axis variable is not a number: " << x_axis[2]);
+
+        x_axis = x_axis *(reference_on_side_of_line / x_axis.norm());
+
+
+        WBAssert(!std::isnan(x_axis[0]),
+                 "Internal error: The x_axis variable is not a number: " << x_axis[0]);
+        WBAssert(!std::isnan(x_axis[1]),
+                 "Internal error: The x_axis variable is not a number: " << x_axis[1]);
+        WBAssert(!std::isnan(x_axis[2]),
+                 "Internal error: The x_axis variable is not a number: " << x_axis[2]);
+
+        const Point<2> begin_segment(x_axis * (closest_point_on_line_cartesian - closest_point_on_line_bottom_cartesian),
+                               y_axis * (closest_point_on_line_cartesian - closest_point_on_line_bottom_cartesian),
+                               cartesian);
+
+        column_section.section = current_section;
+        column_section.original_section = original_current_section;
+        column_section.fraction = fraction_CPL_P1P2;
+        column_section.closest_point_on_line = closest_point_on_line_cartesian;
+        column_section.closest_point_on_line_bottom = closest_point_on_line_bottom_cartesian;
+        column_section.x_axis = x_axis;
+        column_section.y_axis = y_axis;
+        column_section.begin_segment = begin_segment;
+        return true;
+      }
 
-                  if (std::fabs(difference_in_angle_along_segment) < 1e-8)
-                    {
-                      // The angle is constant. It is easy find find the end of
-                      // this segment and the distance.
-                      if (std::fabs(interpolated_segment_length) > std::numeric_limits<double>::epsilon())
-                        {
-                          end_segment[0] += interpolated_segment_length * std::sin(degree_90_to_rad - interpolated_angle_top);
-                          end_segment[1] -= interpolated_segment_length * std::cos(degree_90_to_rad - interpolated_angle_top);
-
-                          Point<2> begin_end_segment = end_segment - begin_segment;
-                          Point<2> normal_2d_plane(-begin_end_segment[0],begin_end_segment[1], cartesian);
-                          WBAssert(std::fabs(normal_2d_plane.norm()) > std::numeric_limits<double>::epsilon(), "Internal Error: normal_2d_plane.norm() is zero, which should not happen. "
-                                   << "Extra info: begin_end_segment[0] = " << begin_end_segment[0]
-                                   << ", begin_end_segment[1] = " << begin_end_segment[1]
-                                   << ", end_segment: [" << end_segment[0] << "," << end_segment[1] << "]"
-                                   << ", begin_segment: [" << begin_segment[0] << "," << begin_segment[1] << "]"
-                                  );
-                          normal_2d_plane /= normal_2d_plane.norm();
-
-                          // Now find the distance of a point to this line.
-                          // Based on http://geomalgorithms.com/a02-_lines.html.
-                          const Point<2> BSP_ESP = end_segment - begin_segment;
-                          const Point<2> BSP_CP = check_point_2d - begin_segment;
-
-                          const double c1 = BSP_ESP * BSP_CP;
-                          const double c2 = BSP_ESP * BSP_ESP;
-
-                          if (c1 < 0 || c2 < c1)
-                            {
-                              new_distance = INFINITY;
-                              new_along_plane_distance = INFINITY;
-                            }
-                          else
-                            {
-                              const Point<2> Pb = begin_segment + (c1/c2) * BSP_ESP;
-                              const double side_of_line =  (begin_segment[0] - end_segment[0]) * (check_point_2d[1] - begin_segment[1])
-                                                           - (begin_segment[1] - end_segment[1]) * (check_point_2d[0] - begin_segment[0])
-                                                           < 0 ? -1.0 : 1.0;
 
-                              new_distance = side_of_line * (check_point_2d - Pb).norm();
-                              new_along_plane_distance = (begin_segment - Pb).norm();
-                            }
+      /**
+       * Computes the distance of the check point to the curved planes of one
+       * section and updates the state when it is closer than the sections
+       * before. Returns true when the check point lies on the curved planes,
+       * in which case no further sections have to be checked.
+       */
+      bool
+      update_distance_from_column_section(const Point<3> &check_point_cartesian,
+                                          const CurvedPlanesGeometry &geometry,
+                                          const CurvedPlanesColumn::Section &column_section,
+                                          const bool only_positive,
+                                          CurvedPlanesSearchState &state)
+      {
+        const size_t current_section = column_section.section;
+        const size_t original_current_section = column_section.original_section;
+        const double fraction_CPL_P1P2 = column_section.fraction;
+        const Point<3> &closest_point_on_line_cartesian = column_section.closest_point_on_line;
+        const Point<3> &closest_point_on_line_bottom_cartesian = column_section.closest_point_on_line_bottom;
+        const Point<3> &x_axis = column_section.x_axis;
+        const Point<3> &y_axis = column_section.y_axis;
+        const DepthMethod depth_method = geometry.depth_method;
+
+        double &distance = state.distance;
+        double &new_distance = state.new_distance;
+        double &along_plane_distance = state.along_plane_distance;
+        double &new_along_plane_distance = state.new_along_plane_distance;
+        size_t &section = state.section;
+        double &section_fraction = state.section_fraction;
+        unsigned int &segment = state.segment;
+        double &segment_fraction = state.segment_fraction;
+        double &total_average_angle = state.total_average_angle;
+
+        // if the two points are the same, we don't need to search any further
+        if (std::fabs((check_point_cartesian - closest_point_on_line_cartesian).norm()) < 2e-14)
+          {
+            distance = 0.0;
+            along_plane_distance = 0.0;
+            section = current_section;
+            section_fraction = fraction_CPL_P1P2;
+            segment = 0;
+            segment_fraction = 0.0;
+            total_average_angle = geometry.segments[original_current_section][0].angle_top
+                                  + fraction_CPL_P1P2 * geometry.segments[original_current_section][0].angle_top_change;
+            return true;
+          }
+
+        Point<2> check_point_2d(x_axis * (check_point_cartesian - closest_point_on_line_bottom_cartesian),
+                                y_axis * (check_point_cartesian - closest_point_on_line_bottom_cartesian),
+                                cartesian);
+
+        Point<2> begin_segment = column_section.begin_segment;
+
+        WBAssert(!std::isnan(check_point_2d[0]),
+                 "Internal error: The check_point_2d variable is not a number: " << check_point_2d[0]);
+        WBAssert(!std::isnan(check_point_2d[1]),
+                 "Internal error: The check_point_2d variable is not a number: " << check_point_2d[1]);
+
+
+        WBAssert(!std::isnan(begin_segment[0]),
+                 "Internal error: The begin_segment variable is not a number: " << begin_segment[0]);
+        WBAssert(!std::isnan(begin_segment[1]),
+                 "Internal error: The begin_segment variable is not a number: " << begin_segment[1]);
+
+        Point<2> end_segment = begin_segment;
+
+
+        double total_length = 0.0;
+        double add_angle = 0.0;
+        double average_angle = 0.0;
+        for (unsigned int i_segment = 0; i_segment < geometry.segments[original_current_section].size(); i_segment++)
+          {
+            const CurvedPlanesGeometry::Segment &segment_geometry = geometry.segments[original_current_section][i_segment];
+
+            // compute the angle between the the previous begin and end if
+            // the depth method is angle_at_begin_segment_with_surface.
+            if (i_segment != 0 && depth_method == DepthMethod::angle_at_begin_segment_with_surface)
+              {
+                const double add_angle_inner = (begin_segment * end_segment) / (begin_segment.norm() * end_segment.norm());
+
+                WBAssert(!std::isnan(add_angle_inner),
+                         "Internal error: The add_angle_inner variable is not a number: " << add_angle_inner
+                         << ". Variables: begin_segment = " << begin_segment[0] << ":" << begin_segment[1]
+                         << ", end_segment = " << end_segment[0] << ":" << end_segment[1]
+                         << ", begin_segment * end_segment / (begin_segment.norm() * end_segment.norm()) = "
+                         << std::setprecision(32) << begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())
+                         << ".");
+
+                // there could be round of error problems here is the inner part is close to one
+                WBAssert(add_angle_inner >= 0 && add_angle_inner <= 1,
+                         "Internal error: The variable add_angle_inner is smaller than zero or larger then one,"
+                         "which causes the std::acos to return nan. If it is only a little bit larger then one, "
+                         "this is probably caused by that begin and end segment are the same and round off error. "
+                         "The value of add_angle_inner = " << add_angle_inner);
+
+                add_angle += std::acos(add_angle_inner);
+
+                WBAssert(!std::isnan(add_angle),
+                         "Internal error: The add_angle variable is not a number: " << add_angle
+                         << ". Variables: begin_segment = " << begin_segment[0] << ":" << begin_segment[1]
+                         << ", end_segment = " << end_segment[0] << ":" << end_segment[1]
+                         << ", begin_segment * end_segment / (begin_segment.norm() * end_segment.norm()) = "
+                         << std::setprecision(32) << begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())
+                         << ", std::acos(begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())) = "
+                         << std::acos(begin_segment * end_segment / (begin_segment.norm() * end_segment.norm())));
+              }
+
+
+
+
+            begin_segment = end_segment;
+
+            WBAssert(!std::isnan(begin_segment[0]),
+                     "Internal error: The begin_segment variable is not a number: " << begin_segment[0]);
+            WBAssert(!std::isnan(begin_segment[1]),
+                     "Internal error: The begin_segment variable is not a number: " << begin_segment[1]);
+
+
+            // This interpolates different properties between P1 and P2 (the
+            // points of the plane at the surface)
+            const double degree_90_to_rad = 0.5 * const_pi;
+
+            const double interpolated_angle_top    = segment_geometry.angle_top
+                                                     + fraction_CPL_P1P2 * segment_geometry.angle_top_change
+                                                     + add_angle;
+
+            const double interpolated_angle_bottom = segment_geometry.angle_bottom
+                                                     + fraction_CPL_P1P2 * segment_geometry.angle_bottom_change
+                                                     + add_angle;
+
+
+            double interpolated_segment_length     = segment_geometry.length
+                                                     + fraction_CPL_P1P2 * segment_geometry.length_change;
+            WBAssert(!std::isnan(interpolated_angle_top),
+                     "Internal error: The interpolated_angle_top variable is not a number: " << interpolated_angle_top);
+
+            // We want to know where the end point of this segment is (and
+            // the start of the next segment). There are two cases which we
+            // will deal with separately. The first one is if the angle is
+            // constant. The second one is if the angle changes.
+            const double difference_in_angle_along_segment = interpolated_angle_top - interpolated_angle_bottom;
+
+            if (std::fabs(difference_in_angle_along_segment) < 1e-8)
+              {
+                // The angle is constant. It is easy find find the end of
+                // this segment and the distance.
+                if (std::fabs(interpolated_segment_length) > std::numeric_limits<double>::epsilon())
+                  {
+                    end_segment[0] += interpolated_segment_length * std::sin(degree_90_to_rad - interpolated_angle_top);
+                    end_segment[1] -= interpolated_segment_length * std::cos(degree_90_to_rad - interpolated_angle_top);
+
+                    Point<2> begin_end_segment = end_segment - begin_segment;
+                    Point<2> normal_2d_plane(-begin_end_segment[0],begin_end_segment[1], cartesian);
+                    WBAssert(std::fabs(normal_2d_plane.norm()) > std::numeric_limits<double>::epsilon(), "Internal Error: normal_2d_plane.norm() is zero, which should not happen. "
+                             << "Extra info: begin_end_segment[0] = " << begin_end_segment[0]
+                             << ", begin_end_segment[1] = " << begin_end_segment[1]
+                             << ", end_segment: [" << end_segment[0] << "," << end_segment[1] << "]"
+                             << ", begin_segment: [" << begin_segment[0] << "," << begin_segment[1] << "]"
+                            );
+                    normal_2d_plane /= normal_2d_plane.norm();
+
+                    // Now find the distance of a point to this line.
+                    // Based on http://geomalgorithms.com/a02-_lines.html.
+                    const Point<2> BSP_ESP = end_segment - begin_segment;
+                    const Point<2> BSP_CP = check_point_2d - begin_segment;
+
+                    const double c1 = BSP_ESP * BSP_CP;
+                    const double c2 = BSP_ESP * BSP_ESP;
+
+                    if (c1 < 0 || c2 < c1)
+                      {
+                        new_distance = INFINITY;
+                        new_along_plane_distance = INFINITY;
+                      }
+                    else
+                      {
+                        const Point<2> Pb = begin_segment + (c1/c2) * BSP_ESP;
+                        const double side_of_line =  (begin_segment[0] - end_segment[0]) * (check_point_2d[1] - begin_segment[1])
+                                                     - (begin_segment[1] - end_segment[1]) * (check_point_2d[0] - begin_segment[0])
+                                                     < 0 ? -1.0 : 1.0;
+
+                        new_distance = side_of_line * (check_point_2d - Pb).norm();
+                        new_along_plane_distance = (begin_segment - Pb).norm();
+                      }
+
+                  }
+              }
+            else
+              {
+                // The angle is not constant. This means that we need to
+                // define a circle. First find the center of the circle.
+                const double radius_angle_circle = std::fabs(interpolated_segment_length/difference_in_angle_along_segment);
+
+                WBAssert(!std::isnan(radius_angle_circle),
+                         "Internal error: The radius_angle_circle variable is not a number: " << radius_angle_circle
+                         << ". interpolated_segment_length = " << interpolated_segment_length
+                         << ", difference_in_angle_along_segment = " << difference_in_angle_along_segment);
+
+                const double cos_angle_top = std::cos(interpolated_angle_top);
+
+                WBAssert(!std::isnan(cos_angle_top),
+                         "Internal error: The radius_angle_circle variable is not a number: " << cos_angle_top
+                         << ". interpolated_angle_top = " << interpolated_angle_top);
+
+                Point<2> center_circle(cartesian);
+                if (std::fabs(interpolated_angle_top - 0.5 * const_pi) < 1e-8)
+                  {
+                    // if interpolated_angle_top is 90 degrees, the tan function
+                    // is undefined (1/0). What we really want in this case is
+                    // set the center to the correct location which is x = the x
+                    //begin point + radius and y = the y begin point.
+                    center_circle[0] = difference_in_angle_along_segment > 0 ? begin_segment[0] + radius_angle_circle : begin_segment[0] - radius_angle_circle;
+                    center_circle[1] = begin_segment[1];
+                  }
+                else if (std::fabs(interpolated_angle_top - 1.5 * const_pi) < 1e-8)
+                  {
+                    // if interpolated_angle_top is 270 degrees, the tan function
+                    // is undefined (-1/0). What we really want in this case is
+                    // set the center to the correct location which is x = the x
+                    //begin point - radius and y = the y begin point.
+                    center_circle[0] = difference_in_angle_along_segment > 0 ? begin_segment[0] - radius_angle_circle : begin_segment[0] + radius_angle_circle;
+                    center_circle[1] = begin_segment[1];
+                  }
+                else
+                  {
+                    double tan_angle_top = std::tan(interpolated_angle_top);
+
+                    WBAssert(!std::isnan(tan_angle_top),
+                             "Internal error: The tan_angle_top variable is not a number: " << tan_angle_top);
+                    const double center_circle_y = difference_in_angle_along_segment < 0 ?
+                                                   begin_segment[1] - radius_angle_circle * cos_angle_top
+                                                   : begin_segment[1] + radius_angle_circle * cos_angle_top;
+
+                    WBAssert(!std::isnan(center_circle_y),
+                             "Internal error: The center_circle_y variable is not a number: " << center_circle_y
+                             << ". begin_segment[1] = " << begin_segment[1]
+                             << ", radius_angle_circle = " << radius_angle_circle
+                             << ", cos_angle_top = " << cos_angle_top);
+
+                    // to prevent round off errors becomming dominant, we check
+                    // whether center_circle_y - begin_segment[1] should be zero.
+                    // TODO: improve this to some kind of relative difference.
+                    const double CCYBS = center_circle_y - begin_segment[1];
+
+                    WBAssert(!std::isnan(CCYBS),
+                             "Internal error: The CCYBS variable is not a number: " << CCYBS);
+
+
+
+                    center_circle[0] = begin_segment[0] + tan_angle_top * (CCYBS);
+                    center_circle[1] = center_circle_y;
+                  }
+
+                WBAssert(!std::isnan(center_circle[0]) || !std::isnan(center_circle[1]),
+                         "Internal error: The center variable contains not a number: " << center_circle[0] << ":" << center_circle[0]);
+                WBAssert(std::fabs((begin_segment-center_circle).norm() - std::fabs(radius_angle_circle))
+                         < 1e-8 * std::fabs((begin_segment-center_circle).norm() + std::fabs(radius_angle_circle)),
+                         "Internal error: The center of the circle is not a radius away from the begin point. " << std::endl
+                         << "The center is located at " << center_circle[0] << ":" << center_circle[1] << std::endl
+                         << "The begin point is located at " << begin_segment[0] << ":" << begin_segment[1] << std::endl
+                         << "The computed radius is " << std::fabs((begin_segment-center_circle).norm())
+                         << ", and it should be " << radius_angle_circle << ".");
+
+
+                // Now compute the location of the end of the segment by
+                // rotating P1 around the center_circle
+                Point<2> BSPC = begin_segment - center_circle;
+                const double sin_angle_diff = sin(difference_in_angle_along_segment);
+                const double cos_angle_diff = cos(difference_in_angle_along_segment);
+                end_segment[0] = cos_angle_diff * BSPC[0] - sin_angle_diff * BSPC[1] + center_circle[0];
+                end_segment[1] = sin_angle_diff * BSPC[0] + cos_angle_diff * BSPC[1] + center_circle[1];
+
+
+
+                WBAssert(std::fabs((end_segment-center_circle).norm() - std::fabs(radius_angle_circle))
+                         < 1e-8 * std::fabs((end_segment-center_circle).norm() + std::fabs(radius_angle_circle)) ,
+                         "Internal error: The center of the circle is not a radius away from the end point. " << std::endl
+                         << "The center is located at " << center_circle[0] << ":" << center_circle[1] << std::endl
+                         << "The end point is located at " << end_segment[0] << ":" << end_segment[1] << std::endl
+                         << "The computed radius is " << std::fabs((end_segment-center_circle).norm())
+                         << ", and it should be " << radius_angle_circle << ".");
+
+                // Now check if the angle of the check point in this circle
+                // is larger then the angle of P1 and smaller then P1 + angle
+                // difference. If that is the case then the distance from the
+                // plane is radius - (center - check_point).norm(). Otherwise
+                // it is infinity.
+                // The angle of the check point is computed with the help of
+                // dot product. But before that we need to adjust the check
+                // point 2d.
+                const Point<2> CPCR = check_point_2d - center_circle;
+                const double CPCR_norm = CPCR.norm();
+
+                const double dot_product = CPCR * Point<2>(0, radius_angle_circle, cartesian);
+                // If the x of the check point is larger then the x of center
+                // the circle, the angle is more than 180 degree, but the dot
+                // product will decrease instead of increase from 180 degrees.
+                // To fix this we make a special case for this.
+                // Furthermore, when the check point is at the same location as
+                // the center of the circle, we count that point as belonging
+                // to the top of the top segment (0 degree).
+                double check_point_angle = std::fabs(CPCR_norm) < std::numeric_limits<double>::epsilon() ? 2.0 * const_pi : (check_point_2d[0] <= center_circle[0]
+                                           ? std::acos(dot_product/(CPCR_norm * radius_angle_circle))
+                                           : 2.0 * const_pi - std::acos(dot_product/(CPCR_norm * radius_angle_circle)));
+                check_point_angle = difference_in_angle_along_segment >= 0 ? const_pi - check_point_angle : 2.0 * const_pi - check_point_angle;
+
+                // In the case that it is exactly 2 * pi, bring it back to zero
+                check_point_angle = (std::fabs(check_point_angle - 2 * const_pi) < 1e-14 ? 0 : check_point_angle);
+
+                if ((difference_in_angle_along_segment > 0 && (check_point_angle <= interpolated_angle_top || std::fabs(check_point_angle - interpolated_angle_top) < 1e-12)
+                     && (check_point_angle >= interpolated_angle_bottom || std::fabs(check_point_angle - interpolated_angle_bottom) < 1e-12))
+                    || (difference_in_angle_along_segment < 0 && (check_point_angle >= interpolated_angle_top || std::fabs(check_point_angle - interpolated_angle_top) < 1e-12)
+                        && (check_point_angle <= interpolated_angle_bottom || std::fabs(check_point_angle - interpolated_angle_bottom) < 1e-12)))
+                  {
+                    new_distance = (radius_angle_circle - CPCR_norm) * (difference_in_angle_along_segment < 0 ? 1 : -1);
+                    new_along_plane_distance = (radius_angle_circle * check_point_angle - radius_angle_circle * interpolated_angle_top) * (difference_in_angle_along_segment < 0 ? 1 : -1);
+                  }
+
+              }
+
+            // Now we need to see whether we need to update the information
+            // based on whether this segment is the closest one to the point
+            // up to now. To do this we first look whether the point falls
+            // within the bound of the segment and if it is actually closer.
+            // TODO: find out whether the fabs() are needed.
+            if (new_along_plane_distance >= -1e-10 &&
+                new_along_plane_distance <= std::fabs(interpolated_segment_length) &&
+                std::fabs(new_distance) < std::fabs(distance))
+              {
+                // There are two specific cases we are concerned with. The
+                // first case is that we want to have both the positive and
+                // negative distances (above and below the line). The second
+                // case is that we only want positive distances.
+                distance = only_positive ? std::fabs(new_distance) : new_distance;
+                along_plane_distance = new_along_plane_distance + total_length;
+                section = current_section;
+                section_fraction = fraction_CPL_P1P2;
+                segment = i_segment;
+                segment_fraction = new_along_plane_distance / interpolated_segment_length;
+                total_average_angle = (average_angle * total_length
+                                       + 0.5 * (interpolated_angle_top + interpolated_angle_bottom  - 2 * add_angle) * new_along_plane_distance);
+                total_average_angle = (std::fabs(total_average_angle) < std::numeric_limits<double>::epsilon() ? 0 : total_average_angle /
+                                       (total_length + new_along_plane_distance));
+              }
+
+            // increase average angle
+            average_angle = (average_angle * total_length +
+                             0.5 * (interpolated_angle_top + interpolated_angle_bottom  - 2 * add_angle) * interpolated_segment_length);
+            average_angle = (std::fabs(average_angle) < std::numeric_limits<double>::epsilon() ? 0 : average_angle /
+                             (total_length + interpolated_segment_length));
+            // increase the total length for the next segment.
+            total_length += interpolated_segment_length;
+          }
+        return false;
+      }
 
-                        }
-                    }
-                  else
-                    {
-                      // The angle is not constant. This means that we need to
-                      // define a circle. First find the center of the circle.
-                      const double radius_angle_circle = std::fabs(interpolated_segment_length/difference_in_angle_along_segment);
 
-                      WBAssert(!std::isnan(radius_angle_circle),
-                               "Internal error: The radius_angle_circle variable is not a number: " << radius_angle_circle
-                               << ". interpolated_segment_length = " << interpolated_segment_length
-                               << ", difference_in_angle_along_segment = " << difference_in_angle_along_segment);
+      /**
+       * Converts the state of the search to the return values of
+       * distance_point_from_curved_planes.
+       */
+      PointDistanceFromCurvedPlanes
+      get_return_values(const CurvedPlanesSearchState &state)
+      {
+        PointDistanceFromCurvedPlanes return_values;
+        return_values.distance_from_plane = state.distance;
+        return_values.distance_along_plane = state.along_plane_distance;
+        return_values.fraction_of_section = state.section_fraction;
+        return_values.fraction_of_segment = state.segment_fraction;
+        return_values.section = state.section;
+        return_values.segment = state.segment;
+        return_values.average_angle = state.total_average_angle;
+        return_values.local_thickness = NaN::DQNAN;
+        return return_values;
+      }
 
-                      const double cos_angle_top = std::cos(interpolated_angle_top);
 
-                      WBAssert(!std::isnan(cos_angle_top),
-                               "Internal error: The radius_angle_circle variable is not a number: " << cos_angle_top
-                               << ". interpolated_angle_top = " << interpolated_angle_top);
+      /**
+       * The implementation of distance_point_from_curved_planes for a given
+       * natural coordinate system. Because the coordinate system is known at
+       * compile time, the checks on the coordinate system are resolved by the
+       * compiler and the conversions to Cartesian coordinates are inlined.
+       */
+      template <CoordinateSystem natural_coordinate_system>
+      PointDistanceFromCurvedPlanes
+      distance_point_from_curved_planes_implementation(const Point<3> &check_point, // cartesian point in spherical system
+                                                       const NaturalCoordinate &natural_coordinate,
+                                                       const CurvedPlanesGeometry &geometry,
+                                                       const double start_radius,
+                                                       const bool only_positive)
+      {
+        const Point<2> check_point_surface_2d = surface_point_2d<natural_coordinate_system>(natural_coordinate);
+
+        // loop over all the planes to find out which one is closest to the point.
+        CurvedPlanesSearchState state;
+        CurvedPlanesColumn::Section column_section;
+        for (size_t i_section=0; i_section < geometry.sections.size(); ++i_section)
+          if (compute_column_section<natural_coordinate_system>(check_point_surface_2d, geometry, i_section, start_radius, column_section)
+              && update_distance_from_column_section(check_point, geometry, column_section, only_positive, state))
+            break;
 
-                      Point<2> center_circle(cartesian);
-                      if (std::fabs(interpolated_angle_top - 0.5 * const_pi) < 1e-8)
-                        {
-                          // if interpolated_angle_top is 90 degrees, the tan function
-                          // is undefined (1/0). What we really want in this case is
-                          // set the center to the correct location which is x = the x
-                          //begin point + radius and y = the y begin point.
-                          center_circle[0] = difference_in_angle_along_segment > 0 ? begin_segment[0] + radius_angle_circle : begin_segment[0] - radius_angle_circle;
-                          center_circle[1] = begin_segment[1];
-                        }
-                      else if (std::fabs(interpolated_angle_top - 1.5 * const_pi) < 1e-8)
-                        {
-                          // if interpolated_angle_top is 270 degrees, the tan function
-                          // is undefined (-1/0). What we really want in this case is
-                          // set the center to the correct location which is x = the x
-                          //begin point - radius and y = the y begin point.
-                          center_circle[0] = difference_in_angle_along_segment > 0 ? begin_segment[0] - radius_angle_circle : begin_segment[0] + radius_angle_circle;
-                          center_circle[1] = begin_segment[1];
-                        }
-                      else
-                        {
-                          double tan_angle_top = std::tan(interpolated_angle_top);
+        return get_return_values(state);
+      }
 
-                          WBAssert(!std::isnan(tan_angle_top),
-                                   "Internal error: The tan_angle_top variable is not a number: " << tan_angle_top);
-                          const double center_circle_y = difference_in_angle_along_segment < 0 ?
-                                                         begin_segment[1] - radius_angle_circle * cos_angle_top
-                                                         : begin_segment[1] + radius_angle_circle * cos_angle_top;
 
-                          WBAssert(!std::isnan(center_circle_y),
-                                   "Internal error: The center_circle_y variable is not a number: " << center_circle_y
-                                   << ". begin_segment[1] = " << begin_segment[1]
-                                   << ", radius_angle_circle = " << radius_angle_circle
-                                   << ", cos_angle_top = " << cos_angle_top);
+      /**
+       * Computes the sections of a column for a given natural coordinate
+       * system.
+       */
+      template <CoordinateSystem natural_coordinate_system>
+      void
+      compute_column_sections(const NaturalCoordinate &natural_coordinate,
+                              const CurvedPlanesGeometry &geometry,
+                              const double start_radius,
+                              std::vector<CurvedPlanesColumn::Section> &sections)
+      {
+        const Point<2> check_point_surface_2d = surface_point_2d<natural_coordinate_system>(natural_coordinate);
+
+        CurvedPlanesColumn::Section column_section;
+        for (size_t i_section=0; i_section < geometry.sections.size(); ++i_section)
+          if (compute_column_section<natural_coordinate_system>(check_point_surface_2d, geometry, i_section, start_radius, column_section))
+            sections.push_back(column_section);
+      }
+    }
 
-                          // to prevent round off errors becomming dominant, we check
-                          // whether center_circle_y - begin_segment[1] should be zero.
-                          // TODO: improve this to some kind of relative difference.
-                          const double CCYBS = center_circle_y - begin_segment[1];
 
-                          WBAssert(!std::isnan(CCYBS),
-                                   "Internal error: The CCYBS variable is not a number: " << CCYBS);
+    PointDistanceFromCurvedPlanes
+    distance_point_from_curved_planes(const Point<3> &check_point, // cartesian point in spherical system
+                                      const NaturalCoordinate &natural_coordinate,
+                                      const CurvedPlanesGeometry &geometry,
+                                      const double start_radius,
+                                      const bool only_positive)
+    {
+      // The coordinate system was fixed when the geometry was created, so
+      // this only selects the right implementation.
+      switch (geometry.natural_coordinate_system)
+        {
+          case cartesian:
+            return distance_point_from_curved_planes_implementation<cartesian>(check_point, natural_coordinate, geometry, start_radius, only_positive);
+          case spherical:
+            return distance_point_from_curved_planes_implementation<spherical>(check_point, natural_coordinate, geometry, start_radius, only_positive);
+          default:
+            WBAssertThrow(false, "Only the cartesian and spherical coordinate systems are implemented.");
+        }
+      return PointDistanceFromCurvedPlanes();
+    }
 
 
+    CurvedPlanesColumn::Section::Section()
+      :
+      section(0),
+      original_section(0),
+      fraction(0),
+      closest_point_on_line(cartesian),
+      closest_point_on_line_bottom(cartesian),
+      x_axis(cartesian),
+      y_axis(cartesian),
+      begin_segment(cartesian)
+    {}
 
-                          center_circle[0] = begin_segment[0] + tan_angle_top * (CCYBS);
-                          center_circle[1] = center_circle_y;
-                        }
 
-                      WBAssert(!std::isnan(center_circle[0]) || !std::isnan(center_circle[1]),
-                               "Internal error: The center variable contains not a number: " << center_circle[0] << ":" << center_circle[0]);
-                      WBAssert(std::fabs((begin_segment-center_circle).norm() - std::fabs(radius_angle_circle))
-                               < 1e-8 * std::fabs((begin_segment-center_circle).norm() + std::fabs(radius_angle_circle)),
-                               "Internal error: The center of the circle is not a radius away from the begin point. " << std::endl
-                               << "The center is located at " << center_circle[0] << ":" << center_circle[1] << std::endl
-                               << "The begin point is located at " << begin_segment[0] << ":" << begin_segment[1] << std::endl
-                               << "The computed radius is " << std::fabs((begin_segment-center_circle).norm())
-                               << ", and it should be " << radius_angle_circle << ".");
-
-
-                      // Now compute the location of the end of the segment by
-                      // rotating P1 around the center_circle
-                      Point<2> BSPC = begin_segment - center_circle;
-                      const double sin_angle_diff = sin(difference_in_angle_along_segment);
-                      const double cos_angle_diff = cos(difference_in_angle_along_segment);
-                      end_segment[0] = cos_angle_diff * BSPC[0] - sin_angle_diff * BSPC[1] + center_circle[0];
-                      end_segment[1] = sin_angle_diff * BSPC[0] + cos_angle_diff * BSPC[1] + center_circle[1];
-
-
-
-                      WBAssert(std::fabs((end_segment-center_circle).norm() - std::fabs(radius_angle_circle))
-                               < 1e-8 * std::fabs((end_segment-center_circle).norm() + std::fabs(radius_angle_circle)) ,
-                               "Internal error: The center of the circle is not a radius away from the end point. " << std::endl
-                               << "The center is located at " << center_circle[0] << ":" << center_circle[1] << std::endl
-                               << "The end point is located at " << end_segment[0] << ":" << end_segment[1] << std::endl
-                               << "The computed radius is " << std::fabs((end_segment-center_circle).norm())
-                               << ", and it should be " << radius_angle_circle << ".");
-
-                      // Now check if the angle of the check point in this circle
-                      // is larger then the angle of P1 and smaller then P1 + angle
-                      // difference. If that is the case then the distance from the
-                      // plane is radius - (center - check_point).norm(). Otherwise
-                      // it is infinity.
-                      // The angle of the check point is computed with the help of
-                      // dot product. But before that we need to adjust the check
-                      // point 2d.
-                      const Point<2> CPCR = check_point_2d - center_circle;
-                      const double CPCR_norm = CPCR.norm();
-
-                      const double dot_product = CPCR * Point<2>(0, radius_angle_circle, cartesian);
-                      // If the x of the check point is larger then the x of center
-                      // the circle, the angle is more than 180 degree, but the dot
-                      // product will decrease instead of increase from 180 degrees.
-                      // To fix this we make a special case for this.
-                      // Furthermore, when the check point is at the same location as
-                      // the center of the circle, we count that point as belonging
-                      // to the top of the top segment (0 degree).
-                      double check_point_angle = std::fabs(CPCR_norm) < std::numeric_limits<double>::epsilon() ? 2.0 * const_pi : (check_point_2d[0] <= center_circle[0]
-                                                 ? std::acos(dot_product/(CPCR_norm * radius_angle_circle))
-                                                 : 2.0 * const_pi - std::acos(dot_product/(CPCR_norm * radius_angle_circle)));
-                      check_point_angle = difference_in_angle_along_segment >= 0 ? const_pi - check_point_angle : 2.0 * const_pi - check_point_angle;
-
-                      // In the case that it is exactly 2 * pi, bring it back to zero
-                      check_point_angle = (std::fabs(check_point_angle - 2 * const_pi) < 1e-14 ? 0 : check_point_angle);
-
-                      if ((difference_in_angle_along_segment > 0 && (check_point_angle <= interpolated_angle_top || std::fabs(check_point_angle - interpolated_angle_top) < 1e-12)
-                           && (check_point_angle >= interpolated_angle_bottom || std::fabs(check_point_angle - interpolated_angle_bottom) < 1e-12))
-                          || (difference_in_angle_along_segment < 0 && (check_point_angle >= interpolated_angle_top || std::fabs(check_point_angle - interpolated_angle_top) < 1e-12)
-                              && (check_point_angle <= interpolated_angle_bottom || std::fabs(check_point_angle - interpolated_angle_bottom) < 1e-12)))
-                        {
-                          new_distance = (radius_angle_circle - CPCR_norm) * (difference_in_angle_along_segment < 0 ? 1 : -1);
-                          new_along_plane_distance = (radius_angle_circle * check_point_angle - radius_angle_circle * interpolated_angle_top) * (difference_in_angle_along_segment < 0 ? 1 : -1);
-                        }
+    CurvedPlanesColumn::CurvedPlanesColumn(const NaturalCoordinate &natural_coordinate,
+                                           const CurvedPlanesGeometry &geometry,
+                                           const double start_radius)
+    {
+      switch (geometry.natural_coordinate_system)
+        {
+          case cartesian:
+            compute_column_sections<cartesian>(natural_coordinate, geometry, start_radius, sections);
+            break;
+          case spherical:
+            compute_column_sections<spherical>(natural_coordinate, geometry, start_radius, sections);
+            break;
+          default:
+            WBAssertThrow(false, "Only the cartesian and spherical coordinate systems are implemented.");
+        }
+    }
 
-                    }
 
-                  // Now we need to see whether we need to update the information
-                  // based on whether this segment is the closest one to the point
-                  // up to now. To do this we first look whether the point falls
-                  // within the bound of the segment and if it is actually closer.
-                  // TODO: find out whether the fabs() are needed.
-                  if (new_along_plane_distance >= -1e-10 &&
-                      new_along_plane_distance <= std::fabs(interpolated_segment_length) &&
-                      std::fabs(new_distance) < std::fabs(distance))
-                    {
-                      // There are two specific cases we are concerned with. The
-                      // first case is that we want to have both the positive and
-                      // negative distances (above and below the line). The second
-                      // case is that we only want positive distances.
-                      distance = only_positive ? std::fabs(new_distance) : new_distance;
-                      along_plane_distance = new_along_plane_distance + total_length;
-                      section = current_section;
-                      section_fraction = fraction_CPL_P1P2;
-                      segment = i_segment;
-                      segment_fraction = new_along_plane_distance / interpolated_segment_length;
-                      total_average_angle = (average_angle * total_length
-                                             + 0.5 * (interpolated_angle_top + interpolated_angle_bottom  - 2 * add_angle) * new_along_plane_distance);
-                      total_average_angle = (std::fabs(total_average_angle) < std::numeric_limits<double>::epsilon() ? 0 : total_average_angle /
-                                             (total_length + new_along_plane_distance));
-                    }
+    PointDistanceFromCurvedPlanes
+    distance_point_from_curved_planes(const Point<3> &check_point,
+                                      const CurvedPlanesColumn &column,
+                                      const CurvedPlanesGeometry &geometry,
+                                      const bool only_positive)
+    {
+      CurvedPlanesSearchState state;
+      for (auto &column_section : column.sections)
+        if (update_distance_from_column_section(check_point, geometry, column_section, only_positive, state))
+          break;
 
-                  // increase average angle
-                  average_angle = (average_angle * total_length +
-                                   0.5 * (interpolated_angle_top + interpolated_angle_bottom  - 2 * add_angle) * interpolated_segment_length);
-                  average_angle = (std::fabs(average_angle) < std::numeric_limits<double>::epsilon() ? 0 : average_angle /
-                                   (total_length + interpolated_segment_length));
-                  // increase the total length for the next segment.
-                  total_length += interpolated_segment_length;
-                }
-            }
-        }
-      std::map<std::string, double> return_values;
-      return_values["distanceFromPlane"] = distance;
-      return_values["distanceAlongPlane"] = along_plane_distance;
-      return_values["sectionFraction"] = section_fraction;
-      return_values["segmentFraction"] = segment_fraction;
-      return_values["section"] = static_cast<double>(section);
-      return_values["segment"] = segment;
-      return_values["averageAngle"] = total_average_angle;
-      return return_values;
+      return get_return_values(state);
     }
 
+
     void interpolation::set_points(const std::vector<double> &x,
                                    const std::vector<double> &y,
                                    bool monotone_spline)
@@ -28,6 +28,7 @@
 #include <world_builder/point.h>
 #include <world_builder/nan.h>
 #include <world_builder/parameters.h>
+#include <world_builder/schema_declarations.h>
 #include <world_builder/coordinate_systems/interface.h>
 #include <world_builder/types/interface.h>
 
@@ -47,18 +48,74 @@ namespace WorldBuilder
 
   using namespace Utilities;
 
-  World::World(std::string filename, bool has_output_dir, std::string output_dir, unsigned long random_number_seed)
+  World::World(std::string filename, bool has_output_dir, std::string output_dir, unsigned long random_number_seed_)
+    :
+    World(filename, has_output_dir, output_dir, random_number_seed_, false)
+  {}
+
+  World::World(const std::string &filename, bool has_output_dir, const std::string &output_dir, unsigned long random_number_seed_, const bool compiling)
     :
     parameters(*this),
     surface_coord_conversions(invalid),
     dim(NaN::ISNAN),
-    random_number_engine(random_number_seed)
+    random_number_engine(random_number_seed_),
+    random_number_seed(random_number_seed_)
   {
-    this->declare_entries(parameters);
+    // A compiled world already contains all the values which are needed, so
+    // the declarations do not have to be build and the file does not have
+    // to be validated.
+    if (Parameters::is_compiled_world_file(filename))
+      {
+        parameters.initialize_from_compiled_world(filename);
+      }
+    else
+      {
+        // The declarations are the same for every world, so they are only
+        // build once and shared.
+        const SchemaDeclarations &schema_declarations = SchemaDeclarations::get(*this);
+        parameters.set_shared_declarations(schema_declarations);
+
+        if (has_output_dir)
+          schema_declarations.write(output_dir);
+
+        std::string world_builder_file = filename;
+        parameters.initialize(world_builder_file);
+      }
+
+    // Only a world which is compiled needs the default values in the
+    // parameters, because it writes them to the compiled world file.
+    if (compiling)
+      parameters.write_default_values_on_get();
+
+    this->parse_entries(parameters);
 
-    parameters.initialize(filename, has_output_dir, output_dir);
+    // All the values have been stored in the world and the features, so the
+    // document, which can be large, is not needed anymore, unless the world
+    // is compiled.
+    if (!compiling)
+      parameters.release_parameters();
+  }
+
+  World::World(const char *buffer, const size_t buffer_size, unsigned long random_number_seed_)
+    :
+    parameters(*this),
+    surface_coord_conversions(invalid),
+    dim(NaN::ISNAN),
+    random_number_engine(random_number_seed_),
+    random_number_seed(random_number_seed_)
+  {
+    if (Parameters::is_compiled_world_buffer(buffer, buffer_size))
+      {
+        parameters.initialize_from_compiled_world_buffer(buffer, buffer_size);
+      }
+    else
+      {
+        parameters.set_shared_declarations(SchemaDeclarations::get(*this));
+        parameters.initialize_from_buffer(buffer, buffer_size);
+      }
 
     this->parse_entries(parameters);
+    parameters.release_parameters();
   }
 
   World::~World()
@@ -204,14 +261,28 @@ namespace WorldBuilder
         }
     }
     prm.leave_subsection();
+
+    /**
+     * Build the bounding volume hierarchy over the bounding boxes of the
+     * features, so that only the features which can influence a point
+     * have to be asked for it.
+     */
+    std::vector<BoundingBox> feature_bounding_boxes;
+    for (auto &&feature : prm.features)
+      feature_bounding_boxes.push_back(feature->get_bounding_box());
+    feature_hierarchy.build(feature_bounding_boxes, coordinate_system == spherical);
   }
 
-  double
-  World::temperature(const std::array<double,2> &point,
-                     const double depth,
-                     const double gravity_norm) const
+  void
+  World::compile(const std::string &world_builder_file, const std::string &compiled_world_file)
+  {
+    const World world(world_builder_file, false, "", 1, true);
+    world.parameters.write_compiled_world(compiled_world_file);
+  }
+
+  std::array<double,3>
+  World::cross_section_to_cartesian(const std::array<double,2> &point) const
   {
-    // turn it into a 3d coordinate and call the 3d temperature function
     WBAssertThrow(dim == 2, "This function can only be called when the cross section "
                   "variable in the world builder file has been set. Dim is "
                   << dim << ".");
@@ -239,8 +310,16 @@ namespace WorldBuilder
         coord_3d[2] = point_natural[1];
       }
 
+    return this->parameters.coordinate_system->natural_to_cartesian_coordinates(coord_3d.get_array());
+  }
 
-    std::array<double, 3> point_3d_cartesian = this->parameters.coordinate_system->natural_to_cartesian_coordinates(coord_3d.get_array());
+  double
+  World::temperature(const std::array<double,2> &point,
+                     const double depth,
+                     const double gravity_norm) const
+  {
+    // turn it into a 3d coordinate and call the 3d function
+    const std::array<double, 3> point_3d_cartesian = cross_section_to_cartesian(point);
 
     return temperature(point_3d_cartesian, depth, gravity_norm);
   }
@@ -261,9 +340,17 @@ namespace WorldBuilder
                                    specific_heat) * depth);
 
 
-    for (auto &&it : parameters.features)
+    const Utilities::NaturalCoordinate natural_coordinate(point,*parameters.coordinate_system);
+
+    // The candidate buffer is reused by all the queries of a thread, so a
+    // query does not have to allocate memory.
+    thread_local std::vector<size_t> candidates;
+    feature_hierarchy.query(natural_coordinate.get_surface_coordinates(), depth, candidates);
+
+    for (const size_t feature_index : candidates)
       {
-        temperature = it->temperature(point,depth,gravity_norm,temperature);
+        const std::unique_ptr<Features::Interface> &it = parameters.features[feature_index];
+        temperature = it->temperature(point,natural_coordinate,depth,gravity_norm,temperature);
 
         WBAssert(!std::isnan(temperature), "Temparture is not a number: " << temperature
                  << ", based on a feature with the name " << it->get_name());
@@ -282,35 +369,8 @@ namespace WorldBuilder
                      const double depth,
                      const unsigned int composition_number) const
   {
-    // turn it into a 3d coordinate and call the 3d temperature function
-    WBAssertThrow(dim == 2, "This function can only be called when the cross section "
-                  "variable in the world builder file has been set. Dim is "
-                  << dim << ".");
-
-    const CoordinateSystem coordinate_system = this->parameters.coordinate_system->natural_coordinate_system();
-
-    Point<2> point_natural(point[0], point[1],coordinate_system);
-    if (coordinate_system == spherical)
-      {
-        point_natural[1] = std::sqrt(point[0]*point[0]+point[1]*point[1]);
-        point_natural[0] = std::atan2(point[1],point[0]);
-      }
-
-    Point<3> coord_3d(coordinate_system);
-    if (coordinate_system == spherical)
-      {
-        coord_3d[0] = point_natural[1];
-        coord_3d[1] = cross_section[0][0] + point_natural[0] * surface_coord_conversions[0];
-        coord_3d[2] = cross_section[0][1] + point_natural[0] * surface_coord_conversions[1];
-      }
-    else
-      {
-        coord_3d[0] = cross_section[0][0] + point_natural[0] * surface_coord_conversions[0];
-        coord_3d[1] = cross_section[0][1] + point_natural[0] * surface_coord_conversions[1];
-        coord_3d[2] = point_natural[1];
-      }
-
-    std::array<double, 3> point_3d_cartesian = this->parameters.coordinate_system->natural_to_cartesian_coordinates(coord_3d.get_array());
+    // turn it into a 3d coordinate and call the 3d function
+    const std::array<double, 3> point_3d_cartesian = cross_section_to_cartesian(point);
 
     return composition(point_3d_cartesian, depth, composition_number);
   }
@@ -322,10 +382,16 @@ namespace WorldBuilder
   {
     // We receive the cartesian points from the user.
     Point<3> point(point_,cartesian);
+    const Utilities::NaturalCoordinate natural_coordinate(point,*parameters.coordinate_system);
+
     double composition = 0;
-    for (auto &&it : parameters.features)
+    thread_local std::vector<size_t> candidates;
+    feature_hierarchy.query(natural_coordinate.get_surface_coordinates(), depth, candidates);
+
+    for (const size_t feature_index : candidates)
       {
-        composition = it->composition(point,depth,composition_number, composition);
+        const std::unique_ptr<Features::Interface> &it = parameters.features[feature_index];
+        composition = it->composition(point,natural_coordinate,depth,composition_number, composition);
 
         WBAssert(!std::isnan(composition), "Composition is not a number: " << composition
                  << ", based on a feature with the name " << it->get_name());
@@ -348,35 +414,8 @@ namespace WorldBuilder
                 const unsigned int composition_number,
                 size_t number_of_grains) const
   {
-    // turn it into a 3d coordinate and call the 3d temperature function
-    WBAssertThrow(dim == 2, "This function can only be called when the cross section "
-                  "variable in the world builder file has been set. Dim is "
-                  << dim << ".");
-
-    const CoordinateSystem coordinate_system = this->parameters.coordinate_system->natural_coordinate_system();
-
-    Point<2> point_natural(point[0], point[1],coordinate_system);
-    if (coordinate_system == spherical)
-      {
-        point_natural[1] = std::sqrt(point[0]*point[0]+point[1]*point[1]);
-        point_natural[0] = std::atan2(point[1],point[0]);
-      }
-
-    Point<3> coord_3d(coordinate_system);
-    if (coordinate_system == spherical)
-      {
-        coord_3d[0] = point_natural[1];
-        coord_3d[1] = cross_section[0][0] + point_natural[0] * surface_coord_conversions[0];
-        coord_3d[2] = cross_section[0][1] + point_natural[0] * surface_coord_conversions[1];
-      }
-    else
-      {
-        coord_3d[0] = cross_section[0][0] + point_natural[0] * surface_coord_conversions[0];
-        coord_3d[1] = cross_section[0][1] + point_natural[0] * surface_coord_conversions[1];
-        coord_3d[2] = point_natural[1];
-      }
-
-    std::array<double, 3> point_3d_cartesian = this->parameters.coordinate_system->natural_to_cartesian_coordinates(coord_3d.get_array());
+    // turn it into a 3d coordinate and call the 3d function
+    const std::array<double, 3> point_3d_cartesian = cross_section_to_cartesian(point);
 
     return grains(point_3d_cartesian, depth, composition_number,number_of_grains);
   }
@@ -392,9 +431,14 @@ namespace WorldBuilder
     WorldBuilder::grains grains;
     grains.sizes.resize(number_of_grains,0);
     grains.rotation_matrices.resize(number_of_grains);
-    for (std::vector<std::unique_ptr<Features::Interface> >::const_iterator it = parameters.features.begin(); it != parameters.features.end(); ++it)
+    const Utilities::NaturalCoordinate natural_coordinate(point,*parameters.coordinate_system);
+
+    thread_local std::vector<size_t> candidates;
+    feature_hierarchy.query(natural_coordinate.get_surface_coordinates(), depth, candidates);
+
+    for (const size_t feature_index : candidates)
       {
-        grains = (*it)->grains(point,depth,composition_number, grains);
+        grains = parameters.features[feature_index]->grains(point,natural_coordinate,depth,composition_number, grains);
 
         /*WBAssert(!std::isnan(composition), "Composition is not a number: " << composition
                  << ", based on a feature with the name " << (*it)->get_name());
@@ -409,11 +453,353 @@ namespace WorldBuilder
     return grains;
   }
 
+  void
+  World::properties(const std::array<double,2> &point,
+                    const double depth,
+                    const double gravity_norm,
+                    const std::vector<unsigned int> &composition_numbers,
+                    const std::vector<unsigned int> &grains_composition_numbers,
+                    const size_t number_of_grains,
+                    WorldBuilder::properties &properties) const
+  {
+    // turn it into a 3d coordinate and call the 3d function
+    const std::array<double, 3> point_3d_cartesian = cross_section_to_cartesian(point);
+
+    this->properties(point_3d_cartesian, depth, gravity_norm, composition_numbers,
+                     grains_composition_numbers, number_of_grains, properties);
+  }
+
+  void
+  World::properties(const std::array<double,3> &point_,
+                    const double depth,
+                    const double gravity_norm,
+                    const std::vector<unsigned int> &composition_numbers,
+                    const std::vector<unsigned int> &grains_composition_numbers,
+                    const size_t number_of_grains,
+                    WorldBuilder::properties &properties) const
+  {
+    // We receive the cartesian points from the user.
+    Point<3> point(point_,cartesian);
+
+    const bool at_surface = std::fabs(depth) < 2.0 * std::numeric_limits<double>::epsilon() && force_surface_temperature == true;
+
+    properties.temperature = potential_mantle_temperature *
+                             std::exp(((thermal_expansion_coefficient * gravity_norm) /
+                                       specific_heat) * depth);
+
+    properties.compositions.assign(composition_numbers.size(), 0.);
+
+    properties.grains.resize(grains_composition_numbers.size());
+    for (auto &grains : properties.grains)
+      {
+        grains.sizes.assign(number_of_grains, 0);
+        grains.rotation_matrices.assign(number_of_grains, std::array<std::array<double,3>,3>());
+      }
+
+    const Utilities::NaturalCoordinate natural_coordinate(point,*parameters.coordinate_system);
+
+    thread_local std::vector<size_t> candidates;
+    feature_hierarchy.query(natural_coordinate.get_surface_coordinates(), depth, candidates);
+
+    for (const size_t feature_index : candidates)
+      {
+        const std::unique_ptr<Features::Interface> &it = parameters.features[feature_index];
+        it->properties(point, natural_coordinate, depth, gravity_norm, composition_numbers, grains_composition_numbers, properties);
+
+        WBAssert(!std::isnan(properties.temperature), "Temparture is not a number: " << properties.temperature
+                 << ", based on a feature with the name " << it->get_name());
+        WBAssert(std::isfinite(properties.temperature), "Temparture is not a finite: " << properties.temperature
+                 << ", based on a feature with the name " << it->get_name());
+      }
+
+    // When the surface temperature is forced, the temperature of the features is not used.
+    if (at_surface)
+      properties.temperature = this->surface_temperature;
+  }
+
+  void
+  World::column(const std::array<double,2> &surface_point,
+                const std::vector<double> &depths,
+                const double gravity_norm,
+                const std::vector<unsigned int> &composition_numbers,
+                const std::vector<unsigned int> &grains_composition_numbers,
+                const size_t number_of_grains,
+                std::vector<WorldBuilder::properties> &properties) const
+  {
+    // turn it into a 3d coordinate and call the 3d function
+    const std::array<double, 3> point_3d_cartesian = cross_section_to_cartesian(surface_point);
+
+    this->column(point_3d_cartesian, depths, gravity_norm, composition_numbers,
+                 grains_composition_numbers, number_of_grains, properties);
+  }
+
+  void
+  World::column(const std::array<double,3> &surface_point,
+                const std::vector<double> &depths,
+                const double gravity_norm,
+                const std::vector<unsigned int> &composition_numbers,
+                const std::vector<unsigned int> &grains_composition_numbers,
+                const size_t number_of_grains,
+                std::vector<WorldBuilder::properties> &properties) const
+  {
+    const size_t n_points = depths.size();
+    properties.resize(n_points);
+    if (n_points == 0)
+      return;
+
+    // The surface point is at depth zero, so the points of the column are
+    // found by moving the depth coordinate of its natural coordinates down.
+    const Utilities::NaturalCoordinate surface_coordinate(Point<3>(surface_point,cartesian),*parameters.coordinate_system);
+    const double surface_depth_coordinate = surface_coordinate.get_depth_coordinate();
+
+    std::vector<Point<3> > positions(n_points, Point<3>(cartesian));
+    std::vector<Utilities::NaturalCoordinate> natural_coordinates(n_points, surface_coordinate);
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        natural_coordinates[i].set_depth_coordinate(surface_depth_coordinate - depths[i]);
+        positions[i] = Point<3>(parameters.coordinate_system->natural_to_cartesian_coordinates(natural_coordinates[i].get_coordinates()),cartesian);
+
+        properties[i].temperature = potential_mantle_temperature *
+                                    std::exp(((thermal_expansion_coefficient * gravity_norm) /
+                                              specific_heat) * depths[i]);
+
+        properties[i].compositions.assign(composition_numbers.size(), 0.);
+
+        properties[i].grains.resize(grains_composition_numbers.size());
+        for (auto &grains : properties[i].grains)
+          {
+            grains.sizes.assign(number_of_grains, 0);
+            grains.rotation_matrices.assign(number_of_grains, std::array<std::array<double,3>,3>());
+          }
+      }
+
+    // All the points share the same surface coordinates, so a feature is a
+    // candidate for the column when it is a candidate for any of its depths.
+    std::vector<char> is_candidate(parameters.features.size(), 0);
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        feature_hierarchy.query(surface_coordinate.get_surface_coordinates(), depths[i], candidates);
+        for (const size_t feature_index : candidates)
+          is_candidate[feature_index] = 1;
+      }
+
+    for (size_t feature_index = 0; feature_index < parameters.features.size(); ++feature_index)
+      {
+        if (is_candidate[feature_index] == 0)
+          continue;
+
+        const std::unique_ptr<Features::Interface> &it = parameters.features[feature_index];
+        it->properties_column(positions, natural_coordinates, depths, gravity_norm, composition_numbers, grains_composition_numbers, properties);
+      }
+
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        WBAssert(std::isfinite(properties[i].temperature), "Temparture is not a finite: " << properties[i].temperature
+                 << ", at depth " << depths[i]);
+
+        // When the surface temperature is forced, the temperature of the features is not used.
+        if (std::fabs(depths[i]) < 2.0 * std::numeric_limits<double>::epsilon() && force_surface_temperature == true)
+          properties[i].temperature = this->surface_temperature;
+      }
+  }
+
+  void
+  World::temperature(const size_t n_points,
+                     const double x[],
+                     const double z[],
+                     const double depth[],
+                     const double gravity_norm[],
+                     double temperatures[]) const
+  {
+    std::vector<double> x_3d(n_points), y_3d(n_points), z_3d(n_points);
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        const std::array<double,3> point_3d = cross_section_to_cartesian({{x[i],z[i]}});
+        x_3d[i] = point_3d[0];
+        y_3d[i] = point_3d[1];
+        z_3d[i] = point_3d[2];
+      }
+
+    temperature(n_points, x_3d.data(), y_3d.data(), z_3d.data(), depth, gravity_norm, temperatures);
+  }
+
+  void
+  World::temperature(const size_t n_points,
+                     const double x[],
+                     const double y[],
+                     const double z[],
+                     const double depth[],
+                     const double gravity_norm[],
+                     double temperatures[]) const
+  {
+    // Set up the points and the starting temperatures once, and then let
+    // every feature sweep over all the points. Each point still sees the
+    // features in the same order as in the single point function, so the
+    // results are identical.
+    std::vector<Point<3> > points;
+    points.reserve(n_points);
+    std::vector<Utilities::NaturalCoordinate> natural_coordinates;
+    natural_coordinates.reserve(n_points);
+    // The candidates of all the points are stored after each other, with
+    // the candidates of point i starting at candidate_offsets[i].
+    std::vector<size_t> candidates;
+    std::vector<size_t> candidate_offsets(n_points + 1, 0);
+    std::vector<size_t> point_candidates;
+    std::vector<char> at_surface(n_points, false);
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        points.emplace_back(x[i],y[i],z[i],cartesian);
+        natural_coordinates.emplace_back(points[i],*parameters.coordinate_system);
+        feature_hierarchy.query(natural_coordinates[i].get_surface_coordinates(), depth[i], point_candidates);
+        candidates.insert(candidates.end(), point_candidates.begin(), point_candidates.end());
+        candidate_offsets[i + 1] = candidates.size();
+
+        if (std::fabs(depth[i]) < 2.0 * std::numeric_limits<double>::epsilon() && force_surface_temperature == true)
+          {
+            at_surface[i] = true;
+            temperatures[i] = this->surface_temperature;
+            continue;
+          }
+
+        temperatures[i] = potential_mantle_temperature *
+                          std::exp(((thermal_expansion_coefficient * gravity_norm[i]) /
+                                    specific_heat) * depth[i]);
+      }
+
+    std::vector<size_t> next_candidate(candidate_offsets.begin(), candidate_offsets.end() - 1);
+
+    for (size_t feature_index = 0; feature_index < parameters.features.size(); ++feature_index)
+      {
+        const std::unique_ptr<Features::Interface> &it = parameters.features[feature_index];
+        for (size_t i = 0; i < n_points; ++i)
+          {
+            // The candidates of every point are sorted, so only the next one
+            // has to be compared with the current feature.
+            if (next_candidate[i] >= candidate_offsets[i + 1] || candidates[next_candidate[i]] != feature_index)
+              continue;
+            ++next_candidate[i];
+
+            if (at_surface[i])
+              continue;
+
+            temperatures[i] = it->temperature(points[i],natural_coordinates[i],depth[i],gravity_norm[i],temperatures[i]);
+
+            WBAssert(!std::isnan(temperatures[i]), "Temparture is not a number: " << temperatures[i]
+                     << ", based on a feature with the name " << it->get_name());
+            WBAssert(std::isfinite(temperatures[i]), "Temparture is not a finite: " << temperatures[i]
+                     << ", based on a feature with the name " << it->get_name());
+          }
+      }
+  }
+
+  void
+  World::composition(const size_t n_points,
+                     const double x[],
+                     const double z[],
+                     const double depth[],
+                     const unsigned int composition_number,
+                     double compositions[]) const
+  {
+    std::vector<double> x_3d(n_points), y_3d(n_points), z_3d(n_points);
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        const std::array<double,3> point_3d = cross_section_to_cartesian({{x[i],z[i]}});
+        x_3d[i] = point_3d[0];
+        y_3d[i] = point_3d[1];
+        z_3d[i] = point_3d[2];
+      }
+
+    composition(n_points, x_3d.data(), y_3d.data(), z_3d.data(), depth, composition_number, compositions);
+  }
+
+  void
+  World::composition(const size_t n_points,
+                     const double x[],
+                     const double y[],
+                     const double z[],
+                     const double depth[],
+                     const unsigned int composition_number,
+                     double compositions[]) const
+  {
+    std::vector<Point<3> > points;
+    points.reserve(n_points);
+    std::vector<Utilities::NaturalCoordinate> natural_coordinates;
+    natural_coordinates.reserve(n_points);
+    std::vector<size_t> candidates;
+    std::vector<size_t> candidate_offsets(n_points + 1, 0);
+    std::vector<size_t> point_candidates;
+    for (size_t i = 0; i < n_points; ++i)
+      {
+        points.emplace_back(x[i],y[i],z[i],cartesian);
+        natural_coordinates.emplace_back(points[i],*parameters.coordinate_system);
+        feature_hierarchy.query(natural_coordinates[i].get_surface_coordinates(), depth[i], point_candidates);
+        candidates.insert(candidates.end(), point_candidates.begin(), point_candidates.end());
+        candidate_offsets[i + 1] = candidates.size();
+        compositions[i] = 0;
+      }
+
+    std::vector<size_t> next_candidate(candidate_offsets.begin(), candidate_offsets.end() - 1);
+
+    for (size_t feature_index = 0; feature_index < parameters.features.size(); ++feature_index)
+      {
+        const std::unique_ptr<Features::Interface> &it = parameters.features[feature_index];
+        for (size_t i = 0; i < n_points; ++i)
+          {
+            // The candidates of every point are sorted, so only the next one
+            // has to be compared with the current feature.
+            if (next_candidate[i] >= candidate_offsets[i + 1] || candidates[next_candidate[i]] != feature_index)
+              continue;
+            ++next_candidate[i];
+
+            compositions[i] = it->composition(points[i],natural_coordinates[i],depth[i],composition_number, compositions[i]);
+
+            WBAssert(!std::isnan(compositions[i]), "Composition is not a number: " << compositions[i]
+                     << ", based on a feature with the name " << it->get_name());
+            WBAssert(std::isfinite(compositions[i]), "Composition is not a finite: " << compositions[i]
+                     << ", based on a feature with the name " << it->get_name());
+          }
+      }
+  }
+
+  void
+  World::grains(const size_t n_points,
+                const double x[],
+                const double z[],
+                const double depth[],
+                const unsigned int composition_number,
+                const size_t number_of_grains,
+                WorldBuilder::grains grains_out[]) const
+  {
+    for (size_t i = 0; i < n_points; ++i)
+      grains_out[i] = grains(cross_section_to_cartesian({{x[i],z[i]}}), depth[i], composition_number, number_of_grains);
+  }
+
+  void
+  World::grains(const size_t n_points,
+                const double x[],
+                const double y[],
+                const double z[],
+                const double depth[],
+                const unsigned int composition_number,
+                const size_t number_of_grains,
+                WorldBuilder::grains grains_out[]) const
+  {
+    for (size_t i = 0; i < n_points; ++i)
+      grains_out[i] = grains(std::array<double,3> {{x[i],y[i],z[i]}}, depth[i], composition_number, number_of_grains);
+  }
+
   std::mt19937 &
   World::get_random_number_engine()
   {
     return random_number_engine;
   }
 
+  unsigned long
+  World::get_random_number_seed() const
+  {
+    return random_number_seed;
+  }
+
 }
 
@@ -47,6 +47,18 @@ extern "C" {
     *ptr_ptr_world = reinterpret_cast<void *>(a);
   }
 
+  /**
+   * This function creates an object of the world builder from the contents of a
+   * world builder file or a compiled world file in memory, and returns a pointer
+   * to it. When done call the release world function to destroy the object.
+   */
+  void create_world_from_buffer(void **ptr_ptr_world, const char *buffer, const size_t buffer_size, const unsigned long random_number_seed)
+  {
+    WorldBuilder::World *a = new WorldBuilder::World(buffer, buffer_size, random_number_seed);
+
+    *ptr_ptr_world = reinterpret_cast<void *>(a);
+  }
+
   /**
    * This function return the temperature at a specific location given x, z, depth and
    * gravity.
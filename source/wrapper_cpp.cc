@@ -32,6 +32,14 @@ namespace wrapper_cpp
   }
 
 
+  WorldBuilderWrapper::WorldBuilderWrapper(const char *buffer, const size_t buffer_size, const unsigned long random_number_seed)
+    : ptr_ptr_world(NULL)
+  {
+    WorldBuilder::World *a = new WorldBuilder::World(buffer, buffer_size, random_number_seed);
+    ptr_ptr_world = reinterpret_cast<void *>(a);
+  }
+
+
   WorldBuilderWrapper::~WorldBuilderWrapper()
   {
     WorldBuilder::World *a = reinterpret_cast<WorldBuilder::World *>(ptr_ptr_world);
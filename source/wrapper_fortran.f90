@@ -40,6 +40,22 @@ USE, INTRINSIC :: ISO_C_BINDING!, ONLY: C_PTR
       INTEGER(C_LONG), intent(in), value ::random_number_seed
     END SUBROUTINE create_world
 
+  !> Create an interface with the create world from buffer C function.
+  !! This function creates an object of the world builder from the contents of a
+  !! world builder file or a compiled world file in memory, for example after the
+  !! file has been read by one MPI process and broadcasted to the other ones. The
+  !! buffer does not need to be null terminated. When done call the release world
+  !! function to destroy the object.
+   SUBROUTINE create_world_from_buffer(cworld, buffer, buffer_size, random_number_seed) BIND(C, NAME='create_world_from_buffer')
+      USE, INTRINSIC :: ISO_C_BINDING, ONLY: C_PTR, C_CHAR, C_SIZE_T, C_LONG
+      IMPLICIT NONE
+      ! This argument is a pointer passed by reference.
+      TYPE(C_PTR), INTENT(OUT) :: cworld
+      character(KIND=C_CHAR,len=1),  intent(in)  :: buffer(*)
+      INTEGER(C_SIZE_T), intent(in), value :: buffer_size
+      INTEGER(C_LONG), intent(in), value ::random_number_seed
+    END SUBROUTINE create_world_from_buffer
+
     !> Create an interface with the 2d tempearture C function of the World builder.
     !! This function return the temperature at a specific location given x, z, depth and
     !! gravity.
@@ -20,10 +20,22 @@ file(MAKE_DIRECTORY ${CMAKE_BINARY_DIR}/app/${TEST_NAME})
 
 set(EXECUTE_COMMAND ${TEST_PROGRAM} ${TEST_ARGS})
 
+# the test program reads its standard input from TEST_INPUT if it is given
+if( TEST_INPUT )
+  set(TEST_INPUT_FILE INPUT_FILE ${TEST_INPUT})
+endif( TEST_INPUT )
+
+# the directories of the files which the test program writes have to exist
+foreach(OUTPUT_FILE ${TEST_OUTPUT_FILES})
+  get_filename_component(OUTPUT_FILE_DIR ${OUTPUT_FILE} DIRECTORY)
+  file(MAKE_DIRECTORY ${OUTPUT_FILE_DIR})
+endforeach(OUTPUT_FILE)
+
 # run the test program, capture the stdout/stderr and the result var ${TEST_ARGS}
 execute_process(
   COMMAND ${TEST_PROGRAM} ${TEST_ARGS} 
   WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/app/ 
+  ${TEST_INPUT_FILE}
   OUTPUT_FILE ${TEST_OUTPUT}
   ERROR_VARIABLE TEST_ERROR_VAR
   RESULT_VARIABLE TEST_RESULT_VAR
@@ -34,37 +46,54 @@ execute_process(
 if( TEST_RESULT_VAR )
 	message( FATAL_ERROR "Failed: Test program ${TEST_PROGRAM} exited != 0.\n${TEST_ERROR_VAR}" )
 endif( TEST_RESULT_VAR )
-file(TO_NATIVE_PATH "${TEST_OUTPUT}" TEST_NATIVE_OUTPUT)
-file(TO_NATIVE_PATH "${TEST_REFERENCE}" TEST_NATIVE_REFERENCE)
+# compares an output of the test program with its reference output
+function(compare_output OUTPUT REFERENCE)
+  file(TO_NATIVE_PATH "${OUTPUT}" TEST_NATIVE_OUTPUT)
+  file(TO_NATIVE_PATH "${REFERENCE}" TEST_NATIVE_REFERENCE)
 
 
-IF("${TEST_DIFF}" MATCHES ".*exe")
-  # windows
-  FIND_PROGRAM(DOS2UNIX_EXECUTABLE
-	     NAMES dos2unix
-	     HINTS ${DIFF_DIR}
-	     PATH_SUFFIXES bin
-	     )
-     IF(NOT DOS2UNIX_EXECUTABLE MATCHES "-NOTFOUND")
-	     SET(TEST_D2U ${DOS2UNIX_EXECUTABLE})
-     ELSE()
-	     MESSAGE(FATAL_ERROR
-		     "Could not find dos2unix. This is required for running the testsuite in windows.\n"
-		     "Please specify TEST_D2U by hand."
-		     )
-     ENDIF()
-     execute_process(COMMAND ${TEST_D2U} ${TEST_NATIVE_OUTPUT})
-     execute_process(COMMAND ${TEST_D2U} ${TEST_NATIVE_REFERENCE})
-ENDIF()
+  IF("${TEST_DIFF}" MATCHES ".*exe")
+    # windows
+    FIND_PROGRAM(DOS2UNIX_EXECUTABLE
+  	     NAMES dos2unix
+  	     HINTS ${DIFF_DIR}
+  	     PATH_SUFFIXES bin
+  	     )
+       IF(NOT DOS2UNIX_EXECUTABLE MATCHES "-NOTFOUND")
+  	     SET(TEST_D2U ${DOS2UNIX_EXECUTABLE})
+       ELSE()
+  	     MESSAGE(FATAL_ERROR
+  		     "Could not find dos2unix. This is required for running the testsuite in windows.\n"
+  		     "Please specify TEST_D2U by hand."
+  		     )
+       ENDIF()
+       execute_process(COMMAND ${TEST_D2U} ${TEST_NATIVE_OUTPUT})
+       execute_process(COMMAND ${TEST_D2U} ${TEST_NATIVE_REFERENCE})
+  ENDIF()
 
-# now compare the output with the reference
-execute_process(
-	COMMAND ${CMAKE_COMMAND} -E compare_files ${TEST_NATIVE_OUTPUT} ${TEST_NATIVE_REFERENCE}
-  RESULT_VARIABLE TEST_RESULT
-  )
+  # now compare the output with the reference
+  execute_process(
+  	COMMAND ${CMAKE_COMMAND} -E compare_files ${TEST_NATIVE_OUTPUT} ${TEST_NATIVE_REFERENCE}
+    RESULT_VARIABLE TEST_RESULT
+    )
+
+  # again, if return value is !=0 scream and shout
+  if( TEST_RESULT )
+  	execute_process(COMMAND ${TEST_DIFF} ${TEST_NATIVE_OUTPUT} ${TEST_NATIVE_REFERENCE})
+  	message( FATAL_ERROR "Failed: The output of ${TEST_NAME} stored in ${TEST_NATIVE_OUTPUT} did not match the reference output stored in ${TEST_NATIVE_REFERENCE}")
+  endif( TEST_RESULT )
+endfunction(compare_output)
+
+compare_output(${TEST_OUTPUT} ${TEST_REFERENCE})
 
-# again, if return value is !=0 scream and shout
-if( TEST_RESULT )
-	execute_process(COMMAND ${TEST_DIFF} ${TEST_NATIVE_OUTPUT} ${TEST_NATIVE_REFERENCE})
-	message( FATAL_ERROR "Failed: The output of ${TEST_NAME} stored in ${TEST_NATIVE_OUTPUT} did not match the reference output stored in ${TEST_NATIVE_REFERENCE}")
-endif( TEST_RESULT )
+# the files which the test program writes besides its screen output are
+# compared with the references in TEST_OUTPUT_REFERENCES in the same order
+if( TEST_OUTPUT_FILES )
+  list(LENGTH TEST_OUTPUT_FILES N_OUTPUT_FILES)
+  math(EXPR LAST_OUTPUT_FILE "${N_OUTPUT_FILES} - 1")
+  foreach(I RANGE ${LAST_OUTPUT_FILE})
+    list(GET TEST_OUTPUT_FILES ${I} OUTPUT_FILE)
+    list(GET TEST_OUTPUT_REFERENCES ${I} OUTPUT_REFERENCE)
+    compare_output(${OUTPUT_FILE} ${OUTPUT_REFERENCE})
+  endforeach()
+endif( TEST_OUTPUT_FILES )
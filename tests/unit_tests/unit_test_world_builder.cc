@@ -19,11 +19,25 @@
 
 #define CATCH_CONFIG_MAIN
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <thread>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include <catch2.h>
 
+#include <world_builder/adaptive_baked_world.h>
+#include <world_builder/baked_world.h>
+#include <world_builder/bounding_volume_hierarchy.h>
 #include <world_builder/config.h>
 #include <world_builder/coordinate_systems/interface.h>
 
@@ -34,6 +48,8 @@
 #include <world_builder/features/fault_models/composition/uniform.h>
 
 #include <world_builder/point.h>
+#include <world_builder/random_number_generator.h>
+#include <world_builder/schema_declarations.h>
 
 #include <world_builder/types/array.h>
 #include <world_builder/types/bool.h>
@@ -122,6 +138,95 @@ inline void compare_vectors_array3_array3_approx(
     }
 }
 
+/**
+ * Compare the given two grains with an epsilon (using Catch::Approx)
+ */
+inline void check_grains_approx(
+  const WorldBuilder::grains &computed,
+  const WorldBuilder::grains &expected,
+  const double epsilon)
+{
+  REQUIRE(computed.sizes.size() == expected.sizes.size());
+  REQUIRE(computed.rotation_matrices.size() == expected.rotation_matrices.size());
+  for (unsigned int i=0; i< computed.sizes.size(); ++i)
+    {
+      INFO("grain index i=" << i << ": ");
+      CHECK(computed.sizes[i] == Approx(expected.sizes[i]).epsilon(epsilon));
+      for (unsigned int j=0; j< 3; ++j)
+        for (unsigned int k=0; k< 3; ++k)
+          {
+            INFO("rotation matrix index j:k = " << j << ":" << k << ": ");
+            CHECK(computed.rotation_matrices[i][j][k] == Approx(expected.rotation_matrices[i][j][k]).epsilon(epsilon));
+          }
+    }
+}
+
+/**
+ * Check that the given two grains are exactly the same
+ */
+inline void check_grains_identical(
+  const WorldBuilder::grains &computed,
+  const WorldBuilder::grains &expected)
+{
+  check_grains_approx(computed, expected, 0.);
+}
+
+/**
+ * Compare the temperature, compositions and grains of the given two
+ * properties with an epsilon (using Catch::Approx)
+ */
+inline void check_properties_approx(
+  const WorldBuilder::properties &computed,
+  const WorldBuilder::properties &expected,
+  const double epsilon)
+{
+  CHECK(computed.temperature == Approx(expected.temperature).epsilon(epsilon));
+  REQUIRE(computed.compositions.size() == expected.compositions.size());
+  for (unsigned int i=0; i< computed.compositions.size(); ++i)
+    {
+      INFO("composition index i=" << i << ": ");
+      CHECK(computed.compositions[i] == Approx(expected.compositions[i]).epsilon(epsilon));
+    }
+  REQUIRE(computed.grains.size() == expected.grains.size());
+  for (unsigned int i=0; i< computed.grains.size(); ++i)
+    {
+      INFO("grains index i=" << i << ": ");
+      check_grains_approx(computed.grains[i], expected.grains[i], epsilon);
+    }
+}
+
+/**
+ * Check that the given two properties are exactly the same
+ */
+inline void check_properties_identical(
+  const WorldBuilder::properties &computed,
+  const WorldBuilder::properties &expected)
+{
+  check_properties_approx(computed, expected, 0.);
+}
+
+/**
+ * Returns the positions and depths of a grid of points through the test
+ * worlds. The Cartesian grid spans 2250 by 2250 km from the origin, with the
+ * surface at 800 km. The spherical grid spans the whole sphere. Both reach
+ * to a depth of 200 km.
+ */
+inline std::vector<std::pair<std::array<double,3>,double> > test_grid(const bool spherical)
+{
+  std::vector<std::pair<std::array<double,3>,double> > grid;
+  for (unsigned int i = 0; i < 10; ++i)
+    for (unsigned int j = 0; j < 10; ++j)
+      for (unsigned int k = 0; k < 6; ++k)
+        {
+          const double depth = k * 40e3;
+          const std::array<double,3> position = spherical
+                                                ? Utilities::spherical_to_cartesian_coordinates({{6371e3 - depth, (i * 36.0 - 180.0) * Utilities::const_pi / 180.0, (j * 18.0 - 85.0) * Utilities::const_pi / 180.0}}).get_array()
+                                                : std::array<double,3> {{i * 250e3, j * 250e3, 800e3 - depth}};
+          grid.emplace_back(position, depth);
+        }
+  return grid;
+}
+
 /**
  * Compare two rotation matrices
  */
@@ -249,6 +354,12 @@ TEST_CASE("WorldBuilder Point: Testing initialize and operators")
   CHECK_THROWS_WITH(Point<2>(1,2,3,cartesian),Contains("Can't use the 3d constructor in 2d."));
   CHECK_THROWS_WITH(Point<3>(1,2,cartesian),Contains("Can't use the 2d constructor in 3d."));
 
+  // The points are defined in the header and can be copied as plain memory.
+  CHECK(std::is_trivially_copyable<Point<2> >::value);
+  CHECK(std::is_trivially_copyable<Point<3> >::value);
+  constexpr Point<3> constexpr_point(std::array<double,3> {{1,2,3}},cartesian);
+  CHECK(constexpr_point.get_array()[2] == Approx(3.0));
+
 
 
 }
@@ -522,6 +633,8 @@ TEST_CASE("WorldBuilder Utilities: Point in polygon")
       INFO("checking point " << i << " = (" << check_points[i][0] << ":" << check_points[i][1] << ")");
       CHECK(Utilities::polygon_contains_point(point_list_4_elements,check_points[i]) == awnsers[i][0]);
       CHECK(Utilities::polygon_contains_point(point_list_3_elements,check_points[i]) == awnsers[i][1]);
+      CHECK(Utilities::Polygon(point_list_4_elements,cartesian).contains(check_points[i].get_array()) == awnsers[i][0]);
+      CHECK(Utilities::Polygon(point_list_3_elements,cartesian).contains(check_points[i].get_array()) == awnsers[i][1]);
       CHECK(Utilities::signed_distance_to_polygon(point_list_4_elements,check_points[i]) == Approx(awnsers_signed_distance[i][0]));
       CHECK(Utilities::signed_distance_to_polygon(point_list_3_elements,check_points[i]) == Approx(awnsers_signed_distance[i][1]));
     }
@@ -539,6 +652,93 @@ TEST_CASE("WorldBuilder Utilities: Point in polygon")
                     Contains("Not enough polygon points were specified."));
 }
 
+TEST_CASE("WorldBuilder Utilities: prepared polygon")
+{
+  // A concave polygon in spherical coordinates which crosses the -pi longitude.
+  std::vector<Point<2> > point_list(5, Point<2>(spherical));
+  point_list[0] = Point<2>(-3.5,-0.5,spherical);
+  point_list[1] = Point<2>(-2.5,-0.5,spherical);
+  point_list[2] = Point<2>(-2.5,0.5,spherical);
+  point_list[3] = Point<2>(-3.0,0.0,spherical);
+  point_list[4] = Point<2>(-3.5,0.5,spherical);
+
+  const Utilities::Polygon spherical_polygon(point_list,spherical);
+  std::vector<Point<2> > cartesian_point_list;
+  for (auto &point : point_list)
+    cartesian_point_list.emplace_back(point.get_array(),cartesian);
+  const Utilities::Polygon cartesian_polygon(cartesian_point_list,cartesian);
+
+  // The prepared polygon should give the same answers as polygon_contains_point,
+  // also for points on the edges and vertices.
+  unsigned int n_inside = 0;
+  for (int i = -40; i <= 40; ++i)
+    for (int j = -12; j <= 12; ++j)
+      {
+        const Point<2> spherical_point(i * 0.1, j * 0.05, spherical);
+        const Point<2> cartesian_point(spherical_point.get_array(), cartesian);
+        INFO("checking point (" << spherical_point[0] << ":" << spherical_point[1] << ")");
+        const bool inside = Utilities::polygon_contains_point(point_list,spherical_point);
+        CHECK(spherical_polygon.contains(spherical_point.get_array()) == inside);
+        CHECK(cartesian_polygon.contains(cartesian_point.get_array()) == Utilities::polygon_contains_point(cartesian_point_list,cartesian_point));
+        n_inside += inside ? 1 : 0;
+      }
+  CHECK(n_inside > 0);
+
+  // A point shifted by 2 pi is only inside in spherical coordinates.
+  const std::array<double,2> shifted_point = {{-3.0 + 2.0 * Utilities::const_pi,-0.25}};
+  CHECK(spherical_polygon.contains(shifted_point));
+  CHECK(!cartesian_polygon.contains(shifted_point));
+
+  // An empty polygon contains nothing.
+  CHECK(!Utilities::Polygon().contains(shifted_point));
+
+  // Repeating the first point at the end does not change the polygon.
+  point_list.push_back(point_list[0]);
+  const Utilities::Polygon closed_polygon(point_list,spherical);
+  CHECK(closed_polygon.contains({{-3.25,-0.5}}));
+  CHECK(closed_polygon.contains({{-3.25,-0.25}}));
+  CHECK(!closed_polygon.contains({{-3.75,-0.5}}));
+}
+
+TEST_CASE("WorldBuilder Utilities: polygon raster")
+{
+  // A star shaped polygon with many edges, so that the raster has cells which
+  // are inside, outside and crossed by the boundary.
+  std::vector<Point<2> > point_list;
+  const unsigned int n_points = 400;
+  for (unsigned int i = 0; i < n_points; ++i)
+    {
+      const double angle = 2.0 * Utilities::const_pi * i / n_points;
+      const double radius = i % 2 == 0 ? 1.0 : 0.6 + 0.3 * std::sin(7.0 * angle);
+      point_list.emplace_back(0.5 + radius * std::cos(angle), radius * std::sin(angle), cartesian);
+    }
+
+  for (auto coordinate_system : {cartesian, spherical})
+    {
+      std::vector<Point<2> > system_point_list;
+      for (auto &point : point_list)
+        system_point_list.emplace_back(point.get_array(), coordinate_system);
+
+      const Utilities::Polygon polygon_with_raster(system_point_list, coordinate_system, true);
+      const Utilities::Polygon polygon_without_raster(system_point_list, coordinate_system, false);
+
+      unsigned int n_inside = 0;
+      for (int i = -130; i <= 130; ++i)
+        for (int j = -110; j <= 110; ++j)
+          {
+            const std::array<double,2> point = {{0.5 + i * 0.01, j * 0.01}};
+            const bool inside = polygon_without_raster.contains(point);
+            CHECK(polygon_with_raster.contains(point) == inside);
+            n_inside += inside ? 1 : 0;
+          }
+      CHECK(n_inside > 10000);
+
+      // The vertices lie on the boundary and are therefore inside.
+      for (auto &point : point_list)
+        CHECK(polygon_with_raster.contains(point.get_array()));
+    }
+}
+
 
 TEST_CASE("WorldBuilder Utilities: Natural Coordinate")
 {
@@ -819,6 +1019,865 @@ TEST_CASE("WorldBuilder World random")
   CHECK(world3.get_random_number_engine()() == 4282876139);
   CHECK(dist(world3.get_random_number_engine()) == Approx(1.9325573614));
   CHECK(dist(world3.get_random_number_engine()) == Approx(1.1281244478));
+
+  // The grains plugins use a counter based random number generator, so the random
+  // numbers only depend on the seed, the position, the composition number and the
+  // stream of the model.
+  const Point<3> position(1e3, 2e3, 3e3, cartesian);
+  const std::uint64_t stream = CounterBasedRandomNumberGenerator::get_stream("/features/0/grains models/0");
+  CHECK(stream == CounterBasedRandomNumberGenerator::get_stream("/features/0/grains models/0"));
+  CHECK(stream != CounterBasedRandomNumberGenerator::get_stream("/features/0/grains models/1"));
+  CHECK(stream != CounterBasedRandomNumberGenerator::get_stream("/features/1/grains models/0"));
+  CounterBasedRandomNumberGenerator generator_1(1, position, 0, stream);
+  CounterBasedRandomNumberGenerator generator_2(1, position, 0, stream);
+  CounterBasedRandomNumberGenerator generator_3(2, position, 0, stream);
+  CounterBasedRandomNumberGenerator generator_4(1, position, 1, stream);
+  CounterBasedRandomNumberGenerator generator_5(1, Point<3>(1e3, 2e3, 3e3 + 1e-9, cartesian), 0, stream);
+  CounterBasedRandomNumberGenerator generator_6(1, position, 0, stream + 1);
+  for (unsigned int i = 0; i < 10; ++i)
+    {
+      const double value = generator_1.uniform();
+      CHECK(value >= 0.0);
+      CHECK(value < 1.0);
+      CHECK(generator_2.uniform() == Approx(value).epsilon(0.));
+      CHECK(generator_3.uniform() != Approx(value).epsilon(0.));
+      CHECK(generator_4.uniform() != Approx(value).epsilon(0.));
+      CHECK(generator_5.uniform() != Approx(value).epsilon(0.));
+      CHECK(generator_6.uniform() != Approx(value).epsilon(0.));
+    }
+
+  // Two random grains models at the same point should not draw the same grains,
+  // both when they are in different features and in the same feature.
+  const std::string two_features = R"({"version":"0.4", "coordinate system":{"model":"cartesian"}, "features":[
+    {"model":"continental plate", "name":"first", "max depth":100e3, "coordinates":[[0,0],[1e3,0],[1e3,1e3],[0,1e3]],
+     "grains models":[{"model":"random uniform distribution", "max depth":50e3, "compositions":[0], "grain sizes":[-1], "normalize grain sizes":[false]}]},
+    {"model":"continental plate", "name":"second", "max depth":100e3, "coordinates":[[0,0],[1e3,0],[1e3,1e3],[0,1e3]],
+     "grains models":[{"model":"random uniform distribution", "min depth":50e3, "compositions":[0], "grain sizes":[-1], "normalize grain sizes":[false]}]}]})";
+  const std::string one_feature = R"({"version":"0.4", "coordinate system":{"model":"cartesian"}, "features":[
+    {"model":"continental plate", "name":"first", "max depth":100e3, "coordinates":[[0,0],[1e3,0],[1e3,1e3],[0,1e3]],
+     "grains models":[{"model":"random uniform distribution", "max depth":50e3, "compositions":[0], "grain sizes":[-1], "normalize grain sizes":[false]},
+                      {"model":"random uniform distribution", "min depth":50e3, "compositions":[0], "grain sizes":[-1], "normalize grain sizes":[false]}]}]})";
+  WorldBuilder::World world6(two_features.data(), two_features.size(), 1);
+  WorldBuilder::World world7(one_feature.data(), one_feature.size(), 1);
+  for (auto world : {&world6, &world7})
+    {
+      // Just above 50 km depth only the first model applies. At 50 km depth
+      // the second model applies as well and replaces the grains of the
+      // first one, at the same position.
+      const WorldBuilder::grains first = world->grains(std::array<double,3> {{500,500,-50e3}}, 50e3 - 1e-9, 0, 3);
+      const WorldBuilder::grains second = world->grains(std::array<double,3> {{500,500,-50e3}}, 50e3, 0, 3);
+      for (unsigned int i = 0; i < 3; ++i)
+        {
+          CHECK(first.sizes[i] > 0.);
+          CHECK(first.sizes[i] != Approx(second.sizes[i]).epsilon(0.));
+          CHECK(first.rotation_matrices[i][0][0] != Approx(second.rotation_matrices[i][0][0]).epsilon(0.));
+        }
+    }
+
+  // The grains of a point should not depend on the queries which were done before.
+  file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb";
+  WorldBuilder::World world4(file_name, false, "", 1);
+  WorldBuilder::World world5(file_name, false, "", 1);
+  const std::array<double,3> grains_position = {{250e3,500e3,800e3}};
+  world5.grains(std::array<double,3> {{250e3,501e3,800e3}}, 0, 0, 2);
+  world5.grains(std::array<double,3> {{250e3,502e3,800e3}}, 0, 1, 2);
+  const WorldBuilder::grains grains_4 = world4.grains(grains_position, 0, 0, 2);
+  const WorldBuilder::grains grains_5 = world5.grains(grains_position, 0, 0, 2);
+  compare_vectors_approx(grains_4.sizes, grains_5.sizes);
+  compare_vectors_array3_array3_approx(grains_4.rotation_matrices, grains_5.rotation_matrices);
+}
+
+TEST_CASE("WorldBuilder World batched queries")
+{
+  // The batched functions should give exactly the same result as the single point functions.
+  std::vector<std::string> file_names = {"subducting_plate_different_angles_cartesian.wb",
+                                         "subducting_plate_different_angles_spherical.wb",
+                                         "fault_constant_angles_cartesian_force_temp.wb",
+                                         "oceanic_plate_spherical.wb",
+                                         "continental_plate.wb"
+                                        };
+  for (auto &file_name : file_names)
+    {
+      INFO("file: " << file_name);
+      WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file_name);
+
+      std::vector<double> x, y, z, depth, gravity;
+      for (auto &point : test_grid(world.parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::spherical))
+        {
+          x.push_back(point.first[0]);
+          y.push_back(point.first[1]);
+          z.push_back(point.first[2]);
+          depth.push_back(point.second);
+          gravity.push_back(10);
+        }
+      const size_t n_points = x.size();
+
+      std::vector<double> temperatures(n_points);
+      world.temperature(n_points, x.data(), y.data(), z.data(), depth.data(), gravity.data(), temperatures.data());
+      for (size_t i = 0; i < n_points; ++i)
+        CHECK(temperatures[i] == Approx(world.temperature({{x[i],y[i],z[i]}}, depth[i], gravity[i])).epsilon(0.));
+
+      std::vector<double> compositions(n_points);
+      for (unsigned int composition_number = 0; composition_number < 4; ++composition_number)
+        {
+          world.composition(n_points, x.data(), y.data(), z.data(), depth.data(), composition_number, compositions.data());
+          for (size_t i = 0; i < n_points; ++i)
+            CHECK(compositions[i] == Approx(world.composition({{x[i],y[i],z[i]}}, depth[i], composition_number)).epsilon(0.));
+        }
+
+      std::vector<WorldBuilder::grains> grains(n_points);
+      world.grains(n_points, x.data(), y.data(), z.data(), depth.data(), 0, 3, grains.data());
+      for (size_t i = 0; i < n_points; ++i)
+        check_grains_identical(grains[i], world.grains({{x[i],y[i],z[i]}}, depth[i], 0, 3));
+    }
+
+  // Now a world builder file with a cross section
+  WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/simple_wb1.json");
+  std::vector<double> x = {1, 550e3, 120e3, 750e3}, z = {2, 0, 0, 10e3}, depth = {0, 0, 10e3, 5e3}, gravity = {10, 10, 10, 10};
+  std::vector<double> temperatures(x.size()), compositions(x.size());
+  world.temperature(x.size(), x.data(), z.data(), depth.data(), gravity.data(), temperatures.data());
+  world.composition(x.size(), x.data(), z.data(), depth.data(), 3, compositions.data());
+  for (size_t i = 0; i < x.size(); ++i)
+    {
+      CHECK(temperatures[i] == Approx(world.temperature(std::array<double,2> {{x[i],z[i]}}, depth[i], gravity[i])).epsilon(0.));
+      CHECK(compositions[i] == Approx(world.composition(std::array<double,2> {{x[i],z[i]}}, depth[i], 3)).epsilon(0.));
+    }
+}
+
+TEST_CASE("WorldBuilder World properties")
+{
+  // The fused properties function should give exactly the same result as the separate functions.
+  std::vector<std::string> file_names = {"subducting_plate_different_angles_cartesian.wb",
+                                         "subducting_plate_constant_angles_cartesian.wb",
+                                         "fault_constant_angles_cartesian_2.wb",
+                                         "fault_constant_angles_cartesian_force_temp.wb",
+                                         "mantle_layer_cartesian.wb",
+                                         "continental_plate.wb"
+                                        };
+  const std::vector<unsigned int> composition_numbers = {0,1,2,3,4};
+  const std::vector<unsigned int> grains_composition_numbers = {0,1};
+  for (auto &file_name : file_names)
+    {
+      INFO("file: " << file_name);
+      WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file_name);
+      WorldBuilder::World world_reference(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file_name);
+
+      WorldBuilder::properties properties;
+      WorldBuilder::properties expected;
+      for (auto &point : test_grid(false))
+        {
+          world.properties(point.first, point.second, 10, composition_numbers, grains_composition_numbers, 3, properties);
+
+          expected.temperature = world_reference.temperature(point.first, point.second, 10);
+          expected.compositions.clear();
+          for (auto composition_number : composition_numbers)
+            expected.compositions.push_back(world_reference.composition(point.first, point.second, composition_number));
+          expected.grains.clear();
+          for (auto composition_number : grains_composition_numbers)
+            expected.grains.push_back(world_reference.grains(point.first, point.second, composition_number, 3));
+
+          check_properties_identical(properties, expected);
+        }
+    }
+
+  // Now a world builder file with a cross section
+  WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/simple_wb1.json");
+  WorldBuilder::properties properties;
+  const std::array<double,2> position = {{550e3, 0}};
+  world.properties(position, 0, 10, composition_numbers, {}, 0, properties);
+  CHECK(properties.temperature == Approx(150));
+  CHECK(properties.compositions[3] == Approx(1.0));
+  CHECK(properties.grains.size() == 0);
+}
+
+TEST_CASE("WorldBuilder World column")
+{
+  // In a Cartesian world the points of a column are computed by subtracting
+  // the depth from the height of the surface, in the same way as the separate
+  // points below, so the column should give exactly the same result as the
+  // properties function.
+  std::vector<std::string> file_names = {"subducting_plate_different_angles_cartesian.wb",
+                                         "subducting_plate_constant_angles_cartesian.wb",
+                                         "fault_constant_angles_cartesian_2.wb",
+                                         "fault_constant_angles_cartesian_force_temp.wb",
+                                         "mantle_layer_cartesian.wb",
+                                         "oceanic_plate_cartesian.wb",
+                                         "continental_plate.wb"
+                                        };
+  const std::vector<unsigned int> composition_numbers = {0,1,2,3,4};
+  const std::vector<unsigned int> grains_composition_numbers = {0,1};
+  std::vector<double> depths;
+  for (unsigned int k = 0; k < 20; ++k)
+    depths.push_back(k * 20e3);
+
+  for (auto &file_name : file_names)
+    {
+      INFO("file: " << file_name);
+      WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file_name);
+
+      std::vector<WorldBuilder::properties> column;
+      WorldBuilder::properties properties;
+      for (unsigned int i = 0; i < 8; ++i)
+        for (unsigned int j = 0; j < 8; ++j)
+          {
+            world.column({{i * 250e3, j * 250e3, 800e3}}, depths, 10, composition_numbers, grains_composition_numbers, 3, column);
+            REQUIRE(column.size() == depths.size());
+            for (size_t k = 0; k < depths.size(); ++k)
+              {
+                world.properties({{i * 250e3, j * 250e3, 800e3 - depths[k]}}, depths[k], 10, composition_numbers, grains_composition_numbers, 3, properties);
+                check_properties_identical(column[k], properties);
+              }
+          }
+    }
+
+  // In a spherical world the points of the column are computed from the
+  // natural coordinates of the surface point, so they may differ from the
+  // separate points by round off.
+  file_names = {"subducting_plate_different_angles_spherical.wb",
+                "oceanic_plate_spherical.wb"
+               };
+  for (auto &file_name : file_names)
+    {
+      INFO("file: " << file_name);
+      WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file_name);
+
+      std::vector<WorldBuilder::properties> column;
+      WorldBuilder::properties properties;
+      for (unsigned int i = 0; i < 20; ++i)
+        for (unsigned int j = 0; j < 20; ++j)
+          {
+            const double longitude = (i * 18.0 - 180.0) * Utilities::const_pi / 180.0;
+            const double latitude = (j * 9.0 - 85.0) * Utilities::const_pi / 180.0;
+            world.column(Utilities::spherical_to_cartesian_coordinates({{6371e3, longitude, latitude}}).get_array(),
+                         depths, 10, composition_numbers, {}, 0, column);
+            REQUIRE(column.size() == depths.size());
+            for (size_t k = 0; k < depths.size(); ++k)
+              {
+                world.properties(Utilities::spherical_to_cartesian_coordinates({{6371e3 - depths[k], longitude, latitude}}).get_array(),
+                                 depths[k], 10, composition_numbers, {}, 0, properties);
+                check_properties_approx(column[k], properties, 1e-10);
+              }
+          }
+    }
+
+  // Now a world builder file with a cross section
+  WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/simple_wb1.json");
+  std::vector<WorldBuilder::properties> column;
+  const std::array<double,2> surface_point = {{550e3, 0}};
+  world.column(surface_point, {0, 10e3}, 10, composition_numbers, {}, 0, column);
+  REQUIRE(column.size() == 2);
+  CHECK(column[0].temperature == Approx(150));
+  CHECK(column[0].compositions[3] == Approx(1.0));
+  CHECK(column[1].grains.size() == 0);
+}
+
+TEST_CASE("WorldBuilder World compiled")
+{
+  // A world loaded from a compiled world file should give exactly the same
+  // results as the world from which it was compiled. The first file uses
+  // every feature, temperature, composition and grains model, and leaves
+  // many of their values at the default.
+  std::vector<std::string> file_names = {"all_plugins_cartesian.wb",
+                                         "subducting_plate_different_angles_spherical.wb",
+                                         "oceanic_plate_spherical.wb",
+                                         "simple_wb1.json"
+                                        };
+  const std::vector<unsigned int> composition_numbers = {0,1,2,3,4,5,6,7,8,9};
+  const std::vector<unsigned int> grains_composition_numbers = {0,1};
+  for (auto &file_name : file_names)
+    {
+      INFO("file: " << file_name);
+      WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file_name);
+      WorldBuilder::World::compile(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file_name, "compiled_world_unit_test.wbc");
+      CHECK(Parameters::is_compiled_world_file("compiled_world_unit_test.wbc"));
+      CHECK(!Parameters::is_compiled_world_file(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file_name));
+
+      // Every value is read from the compiled world file. Without any
+      // declarations, a lookup of a default value would throw while the
+      // compiled world is parsed.
+      WorldBuilder::World compiled_world("compiled_world_unit_test.wbc");
+      std::remove("compiled_world_unit_test.wbc");
+      CHECK(world.parameters.has_declarations());
+      CHECK(!compiled_world.parameters.has_declarations());
+      CHECK(compiled_world.parameters.declarations.IsNull());
+      REQUIRE(compiled_world.parameters.features.size() == world.parameters.features.size());
+
+      WorldBuilder::properties properties;
+      WorldBuilder::properties compiled_properties;
+      for (auto &point : test_grid(world.parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::spherical))
+        {
+          world.properties(point.first, point.second, 10, composition_numbers, grains_composition_numbers, 3, properties);
+          compiled_world.properties(point.first, point.second, 10, composition_numbers, grains_composition_numbers, 3, compiled_properties);
+          check_properties_identical(compiled_properties, properties);
+        }
+
+      if (file_name == "simple_wb1.json")
+        {
+          const std::array<double,2> position = {{550e3, 0}};
+          CHECK(compiled_world.temperature(position, 0, 10) == Approx(world.temperature(position, 0, 10)).epsilon(0.));
+        }
+    }
+
+  // A truncated compiled world file can not be read.
+  WorldBuilder::World::compile(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb", "compiled_world_unit_test.wbc");
+  std::string contents;
+  {
+    std::ifstream file("compiled_world_unit_test.wbc", std::ios::binary);
+    contents.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream file("compiled_world_unit_test.wbc", std::ios::binary);
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size() / 2));
+  }
+  CHECK_THROWS_WITH(WorldBuilder::World("compiled_world_unit_test.wbc"), Contains("The compiled world file is truncated."));
+
+  // A compiled world file with a different format version can not be read.
+  contents[8] = static_cast<char>(contents[8] + 1);
+  {
+    std::ofstream file("compiled_world_unit_test.wbc", std::ios::binary);
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  }
+  CHECK_THROWS_WITH(WorldBuilder::World("compiled_world_unit_test.wbc"), Contains("Compile the world builder file again."));
+  std::remove("compiled_world_unit_test.wbc");
+}
+
+TEST_CASE("WorldBuilder World from buffer")
+{
+  // A world which is read from a buffer should be the same as a world which
+  // is read from the file.
+  const std::string file = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/simple_wb1.json";
+  std::string contents;
+  {
+    std::ifstream input(file.c_str(), std::ios::binary);
+    contents.assign((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+  }
+
+  // The buffer does not have to be null terminated.
+  const std::string padded_contents = contents + "}}";
+  WorldBuilder::World world(padded_contents.data(), contents.size(), 1);
+  const std::array<double,2> position_2d = {{550e3, 0}};
+  const std::array<double,3> position_3d = {{120e3, 500e3, 0}};
+  CHECK(world.temperature(position_2d, 0, 10) == Approx(150));
+  CHECK(world.temperature(position_3d, 0, 10) == Approx(150));
+  CHECK(world.composition(position_2d, 0, 3) == Approx(1.0));
+
+  void *ptr_world = NULL;
+  create_world_from_buffer(&ptr_world, contents.data(), contents.size(), 1);
+  double temperature = 0;
+  temperature_2d(ptr_world, 550e3, 0, 0, 10, &temperature);
+  CHECK(temperature == Approx(150));
+  double composition = 0;
+  composition_3d(ptr_world, 120e3, 500e3, 0, 0, 3, &composition);
+  CHECK(composition == Approx(1.0));
+  release_world(ptr_world);
+
+  wrapper_cpp::WorldBuilderWrapper wrapper_world(contents.data(), contents.size(), 1);
+  CHECK(wrapper_world.temperature_2d(550e3, 0, 0, 10) == Approx(150));
+  CHECK(wrapper_world.composition_3d(120e3, 500e3, 0, 0, 3) == Approx(1.0));
+
+  // A compiled world can also be read from a buffer.
+  WorldBuilder::World::compile(file, "compiled_world_buffer_unit_test.wbc");
+  std::string compiled_contents;
+  {
+    std::ifstream input("compiled_world_buffer_unit_test.wbc", std::ios::binary);
+    compiled_contents.assign((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+  }
+  std::remove("compiled_world_buffer_unit_test.wbc");
+  CHECK(Parameters::is_compiled_world_buffer(compiled_contents.data(), compiled_contents.size()));
+  CHECK(!Parameters::is_compiled_world_buffer(contents.data(), contents.size()));
+  CHECK(!Parameters::is_compiled_world_buffer(compiled_contents.data(), 4));
+
+  WorldBuilder::World compiled_world(compiled_contents.data(), compiled_contents.size(), 1);
+  CHECK(compiled_world.parameters.declarations.IsNull());
+  CHECK(compiled_world.temperature(position_2d, 0, 10) == Approx(world.temperature(position_2d, 0, 10)).epsilon(0.));
+  CHECK(compiled_world.composition(position_3d, 0, 3) == Approx(world.composition(position_3d, 0, 3)).epsilon(0.));
+
+  CHECK_THROWS_WITH(WorldBuilder::World(compiled_contents.data(), compiled_contents.size() / 2, 1),
+                    Contains("The compiled world file is truncated."));
+
+  // The size of an array is checked before it is allocated, and the nesting
+  // depth of the values is limited. The values start after the magic string,
+  // the format version and the version string.
+  std::uint32_t version_length = 0;
+  std::memcpy(&version_length, compiled_contents.data() + 12, sizeof(version_length));
+  const std::string compiled_header = compiled_contents.substr(0, 16 + version_length);
+  const char array_type = 7;
+  const std::uint32_t huge_size = std::numeric_limits<std::uint32_t>::max();
+  std::string huge_array = compiled_header + array_type;
+  huge_array.append(reinterpret_cast<const char *>(&huge_size), sizeof(huge_size));
+  CHECK_THROWS_WITH(WorldBuilder::World(huge_array.data(), huge_array.size(), 1),
+                    Contains("The compiled world file is truncated."));
+
+  const std::uint32_t one = 1;
+  std::string nested_arrays = compiled_header;
+  for (unsigned int i = 0; i < 1000; ++i)
+    {
+      nested_arrays += array_type;
+      nested_arrays.append(reinterpret_cast<const char *>(&one), sizeof(one));
+    }
+  nested_arrays += '\0';
+  CHECK_THROWS_WITH(WorldBuilder::World(nested_arrays.data(), nested_arrays.size(), 1),
+                    Contains("The compiled world file is nested more than 256 levels deep."));
+  CHECK_THROWS_WITH(WorldBuilder::World(contents.data(), contents.size() / 2, 1),
+                    Contains("Parsing errors world builder file"));
+}
+
+TEST_CASE("WorldBuilder World releases parameters")
+{
+  // The world builder file is parsed in place, and the parameters are
+  // released once they have been parsed.
+  const std::string file = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/simple_wb1.json";
+  WorldBuilder::World world(file);
+  CHECK(world.parameters.parameters.IsNull());
+  CHECK_THROWS_WITH(world.parameters.write_compiled_world("released_world_unit_test.wbc"),
+                    Contains("The parameters have already been released"));
+  const std::array<double,2> position = {{550e3, 0}};
+  CHECK(world.temperature(position, 0, 10) == Approx(150));
+
+  // A file which exactly fills its memory pages has no null character after
+  // it in the mapping, so it is parsed from a copy.
+  std::string contents;
+  {
+    std::ifstream input(file.c_str(), std::ios::binary);
+    contents.assign((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+  }
+#ifndef _WIN32
+  const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  const size_t page_size = 4096;
+#endif
+  REQUIRE(contents.size() < page_size);
+  contents.append(page_size - contents.size(), ' ');
+  {
+    std::ofstream output("page_sized_unit_test.wb", std::ios::binary);
+    output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  }
+  WorldBuilder::World page_sized_world("page_sized_unit_test.wb");
+  std::remove("page_sized_unit_test.wb");
+  CHECK(page_sized_world.temperature(position, 0, 10) == Approx(150));
+
+#ifndef _WIN32
+  // The size of a pipe is not known, so it is read until its end. A world
+  // builder file and a compiled world are both recognized after they have
+  // been read from the pipe.
+  WorldBuilder::World::compile(file, "piped_world_unit_test.wbc");
+  std::string compiled_contents;
+  {
+    std::ifstream input("piped_world_unit_test.wbc", std::ios::binary);
+    compiled_contents.assign((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+  }
+  std::remove("piped_world_unit_test.wbc");
+  for (const std::string &piped_contents : {contents + std::string(200000, ' '), compiled_contents})
+    {
+      std::remove("piped_world_unit_test.fifo");
+      REQUIRE(mkfifo("piped_world_unit_test.fifo", 0600) == 0);
+      std::thread writer([&piped_contents]()
+      {
+        std::ofstream output("piped_world_unit_test.fifo", std::ios::binary);
+        output.write(piped_contents.data(), static_cast<std::streamsize>(piped_contents.size()));
+      });
+      CHECK(!Parameters::is_compiled_world_file("piped_world_unit_test.fifo"));
+      std::unique_ptr<WorldBuilder::World> piped_world;
+      CHECK_NOTHROW(piped_world.reset(new WorldBuilder::World("piped_world_unit_test.fifo")));
+      writer.join();
+      std::remove("piped_world_unit_test.fifo");
+      REQUIRE(piped_world != nullptr);
+      CHECK(piped_world->temperature(position, 0, 10) == Approx(150));
+    }
+#endif
+
+  CHECK_THROWS_WITH(WorldBuilder::World("non_existing_unit_test.wb"),
+                    Contains("Could not find the world builder file at the specified location: non_existing_unit_test.wb"));
+}
+
+TEST_CASE("WorldBuilder SchemaDeclarations")
+{
+  // The declarations are only build once and shared by all the worlds.
+  WorldBuilder::World world1(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb");
+  WorldBuilder::World world2(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_spherical.wb");
+  const SchemaDeclarations &schema_declarations = SchemaDeclarations::get(world1);
+  CHECK(&SchemaDeclarations::get(world2) == &schema_declarations);
+  CHECK(schema_declarations.get_declarations().IsObject());
+
+  // The worlds do not build their own declarations anymore.
+  CHECK(world1.parameters.declarations.IsNull());
+  CHECK(world2.parameters.declarations.IsNull());
+
+  // The declarations are only written when this is requested.
+  std::remove("world_buider_declarations.tex");
+  std::remove("world_buider_declarations.schema.json");
+  WorldBuilder::World world3(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb");
+  CHECK(!std::ifstream("world_buider_declarations.tex").good());
+  CHECK(!std::ifstream("world_buider_declarations.schema.json").good());
+
+  WorldBuilder::World world4(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/continental_plate.wb", true, "./");
+  CHECK(std::ifstream("world_buider_declarations.tex").good());
+  CHECK(std::ifstream("world_buider_declarations.schema.json").good());
+  std::remove("world_buider_declarations.tex");
+  std::remove("world_buider_declarations.schema.json");
+}
+
+TEST_CASE("WorldBuilder Parameters cursor")
+{
+  // The values and the default values are looked up relative to the current
+  // subsection, also after leaving and entering other subsections.
+  std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_cartesian.wb";
+  WorldBuilder::World world(file_name);
+
+  // By default, the default values are not written into the parameters.
+  {
+    Parameters prm(world);
+    prm.set_shared_declarations(SchemaDeclarations::get(world));
+    prm.initialize(file_name);
+    prm.enter_subsection("features");
+    prm.enter_subsection("0");
+    CHECK(prm.get<double>("min depth") == Approx(0.0));
+    CHECK(!prm.check_entry("min depth"));
+    prm.leave_subsection();
+    prm.leave_subsection();
+  }
+
+  Parameters prm(world);
+  prm.set_shared_declarations(SchemaDeclarations::get(world));
+  prm.initialize(file_name);
+  prm.write_default_values_on_get();
+
+  prm.enter_subsection("features");
+  {
+    prm.enter_subsection("0");
+    {
+      CHECK(prm.get<std::string>("model") == "subducting plate");
+      CHECK(prm.check_entry("segments"));
+      CHECK(!prm.check_entry("min depth"));
+      CHECK(prm.get<double>("min depth") == Approx(0.0));
+      CHECK(prm.check_entry("min depth"));
+
+      prm.enter_subsection("segments");
+      {
+        prm.enter_subsection("1");
+        {
+          CHECK(prm.get<double>("length") == Approx(200e3));
+          CHECK(prm.get_vector<double>("angle").size() == 2);
+        }
+        prm.leave_subsection();
+      }
+      prm.leave_subsection();
+
+      prm.enter_subsection("temperature models");
+      {
+        prm.enter_subsection("0");
+        {
+          CHECK(prm.get<double>("plate velocity") == Approx(0.01));
+          CHECK(!prm.check_entry("thermal conductivity"));
+          CHECK(prm.get<double>("thermal conductivity") == Approx(2.0));
+          CHECK(prm.check_entry("thermal conductivity"));
+          CHECK(prm.get<bool>("adiabatic heating") == true);
+        }
+        prm.leave_subsection();
+      }
+      prm.leave_subsection();
+
+      prm.enter_subsection("composition models");
+      {
+        prm.enter_subsection("0");
+        {
+          CHECK(prm.get<std::string>("model") == "uniform");
+          CHECK(prm.get_vector<unsigned int>("compositions")[0] == 0);
+          CHECK(prm.get<double>("min distance slab top") == Approx(0.0));
+        }
+        prm.leave_subsection();
+      }
+      prm.leave_subsection();
+    }
+    prm.leave_subsection();
+  }
+  prm.leave_subsection();
+
+  CHECK(prm.get<std::string>("version") == "0.4");
+  CHECK(prm.get<double>("surface temperature") == Approx(293.15));
+}
+
+TEST_CASE("WorldBuilder BakedWorld")
+{
+  const std::string file_name = WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_cartesian.wb";
+  WorldBuilder::World world(file_name);
+  const std::vector<unsigned int> composition_numbers = {0,1,2,3};
+
+  BakedWorld baked_world(world, {{0,0}}, {{2000e3,2000e3}}, 0, 400e3, {{21,21,11}}, 800e3, 10, composition_numbers);
+
+  // At the grid points the baked world is exactly the world.
+  for (unsigned int i = 0; i < 21; ++i)
+    for (unsigned int j = 0; j < 21; ++j)
+      for (unsigned int k = 0; k < 11; ++k)
+        {
+          const std::array<double,3> position = {{i * 100e3, j * 100e3, 800e3 - k * 40e3}};
+          const double depth = k * 40e3;
+          CHECK(baked_world.temperature(position, depth) == Approx(world.temperature(position, depth, 10)).epsilon(0.));
+          for (auto composition_number : composition_numbers)
+            CHECK(baked_world.composition(position, depth, composition_number) == Approx(world.composition(position, depth, composition_number)).epsilon(0.));
+        }
+
+  // The temperature is interpolated linearly along the edges of the cells.
+  {
+    const std::array<double,3> position = {{1050e3, 1000e3, 800e3 - 120e3}};
+    const double expected = 0.5 * (world.temperature({{1000e3, 1000e3, 800e3 - 120e3}}, 120e3, 10)
+                                   + world.temperature({{1100e3, 1000e3, 800e3 - 120e3}}, 120e3, 10));
+    CHECK(baked_world.temperature(position, 120e3) == Approx(expected));
+  }
+
+  // A saved and loaded baked world gives the same results.
+  baked_world.save("baked_world_unit_test.bin");
+  BakedWorld loaded_world("baked_world_unit_test.bin");
+  std::remove("baked_world_unit_test.bin");
+
+  std::mt19937 random_number_engine(3);
+  std::uniform_real_distribution<double> surface_distribution(0, 2000e3);
+  std::uniform_real_distribution<double> depth_distribution(0, 400e3);
+  unsigned int n_wrong_without_fallback = 0;
+  unsigned int n_wrong_with_fallback = 0;
+  for (unsigned int n = 0; n < 2000; ++n)
+    {
+      const double depth = depth_distribution(random_number_engine);
+      const std::array<double,3> position = {{surface_distribution(random_number_engine), surface_distribution(random_number_engine), 800e3 - depth}};
+      CHECK(loaded_world.temperature(position, depth) == Approx(baked_world.temperature(position, depth)).epsilon(0.));
+
+      baked_world.set_composition_interpolation(BakedWorld::fraction);
+      const double fraction = baked_world.composition(position, depth, 0);
+      CHECK(fraction >= 0.);
+      CHECK(fraction <= 1.);
+      baked_world.set_composition_interpolation(BakedWorld::nearest);
+
+      const double exact = world.composition(position, depth, 0);
+      const double nearest = baked_world.composition(position, depth, 0);
+      CHECK(loaded_world.composition(position, depth, 0) == Approx(nearest).epsilon(0.));
+      if (std::fabs(nearest - exact) > 0.)
+        ++n_wrong_without_fallback;
+
+      // Near a change in composition the fallback world is used.
+      loaded_world.set_fallback(&world);
+      if (std::fabs(loaded_world.composition(position, depth, 0) - exact) > 0.)
+        ++n_wrong_with_fallback;
+      loaded_world.set_fallback(nullptr);
+    }
+  CHECK(n_wrong_without_fallback > 0);
+  CHECK(n_wrong_with_fallback < n_wrong_without_fallback);
+
+  // Outside of the region the fallback world is required.
+  const std::array<double,3> outside = {{3000e3, 1000e3, 800e3 - 100e3}};
+  CHECK(!baked_world.contains(outside, 100e3));
+  CHECK_THROWS_WITH(baked_world.temperature(outside, 100e3), Contains("is outside of the baked world"));
+  CHECK_THROWS_WITH(baked_world.composition({{1000e3, 1000e3, 800e3 - 100e3}}, 100e3, 5), Contains("has not been baked"));
+  baked_world.set_fallback(&world);
+  CHECK(baked_world.temperature(outside, 100e3) == Approx(world.temperature(outside, 100e3, 10)).epsilon(0.));
+
+  CHECK_THROWS_WITH(BakedWorld(file_name), Contains("is not a baked world file"));
+
+  // An array which is longer than the rest of the file is not allocated.
+  baked_world.save("baked_world_unit_test.bin");
+  {
+    std::fstream file("baked_world_unit_test.bin", std::ios::in | std::ios::out | std::ios::binary);
+    const std::uint64_t huge_size = std::numeric_limits<std::uint64_t>::max() / 16;
+    file.seekp(8 + 2 * 4 + 3 * 8 + 4 * 8 + 2 * 8 + 3 * 8 + 8);
+    file.write(reinterpret_cast<const char *>(&huge_size), sizeof(huge_size));
+  }
+  CHECK_THROWS_WITH(BakedWorld("baked_world_unit_test.bin"), Contains("is corrupt"));
+  std::remove("baked_world_unit_test.bin");
+
+  // A spherical world is baked in longitude, latitude and depth.
+  WorldBuilder::World spherical_world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/oceanic_plate_spherical.wb");
+  const double degree = Utilities::const_pi / 180.0;
+  BakedWorld spherical_baked_world(spherical_world, {{-20 * degree, -20 * degree}}, {{20 * degree, 20 * degree}},
+                                   0, 200e3, {{9,9,5}}, 6371e3, 10, composition_numbers);
+  for (unsigned int i = 0; i < 9; ++i)
+    for (unsigned int j = 0; j < 9; ++j)
+      for (unsigned int k = 0; k < 5; ++k)
+        {
+          const double depth = k * 50e3;
+          const std::array<double,3> position = Utilities::spherical_to_cartesian_coordinates({{6371e3 - depth, (i * 5.0 - 20.0) * degree, (j * 5.0 - 20.0) * degree}}).get_array();
+          CHECK(spherical_baked_world.temperature(position, depth) == Approx(spherical_world.temperature(position, depth, 10)));
+          for (auto composition_number : composition_numbers)
+            CHECK(spherical_baked_world.composition(position, depth, composition_number) == Approx(spherical_world.composition(position, depth, composition_number)));
+        }
+}
+
+TEST_CASE("WorldBuilder AdaptiveBakedWorld")
+{
+  WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/subducting_plate_different_angles_cartesian.wb");
+  const std::vector<unsigned int> composition_numbers = {0,1,2,3};
+
+  const double temperature_tolerance = 5;
+  AdaptiveBakedWorld adaptive_world(world, {{0,0}}, {{2000e3,2000e3}}, 0, 400e3, 800e3, 10, composition_numbers,
+                                    temperature_tolerance, 0.5, 2, 6);
+
+  // The octree should be much smaller than a uniform grid at the maximum level.
+  CHECK(adaptive_world.n_leaves() > 64);
+  CHECK(adaptive_world.n_leaves() < 64 * 64 * 64 / 10);
+  CHECK(adaptive_world.n_vertices() < 65 * 65 * 65 / 10);
+
+  // The corners of the cells at the minimum level are always vertices, so
+  // the octree is exact there.
+  for (unsigned int i = 0; i <= 4; ++i)
+    for (unsigned int j = 0; j <= 4; ++j)
+      for (unsigned int k = 0; k <= 4; ++k)
+        {
+          const double depth = k * 100e3;
+          const std::array<double,3> position = {{i * 500e3, j * 500e3, 800e3 - depth}};
+          CHECK(adaptive_world.temperature(position, depth) == Approx(world.temperature(position, depth, 10)).epsilon(0.));
+          for (auto composition_number : composition_numbers)
+            CHECK(adaptive_world.composition(position, depth, composition_number) == Approx(world.composition(position, depth, composition_number)).epsilon(0.));
+        }
+
+  // Away from the points which were checked the error is not bounded, but
+  // it should be small for most points.
+  std::mt19937 random_number_engine(3);
+  std::uniform_real_distribution<double> surface_distribution(0, 2000e3);
+  std::uniform_real_distribution<double> depth_distribution(0, 400e3);
+  unsigned int n_large_temperature_errors = 0;
+  unsigned int n_wrong_compositions = 0;
+  const unsigned int n_points = 2000;
+  for (unsigned int n = 0; n < n_points; ++n)
+    {
+      const double depth = depth_distribution(random_number_engine);
+      const std::array<double,3> position = {{surface_distribution(random_number_engine), surface_distribution(random_number_engine), 800e3 - depth}};
+      if (std::fabs(adaptive_world.temperature(position, depth) - world.temperature(position, depth, 10)) > 4 * temperature_tolerance)
+        ++n_large_temperature_errors;
+      if (std::fabs(adaptive_world.composition(position, depth, 0) - world.composition(position, depth, 0)) > 0.)
+        ++n_wrong_compositions;
+
+      adaptive_world.set_composition_interpolation(BakedWorld::fraction);
+      const double fraction = adaptive_world.composition(position, depth, 0);
+      CHECK(fraction >= 0.);
+      CHECK(fraction <= 1.);
+      adaptive_world.set_composition_interpolation(BakedWorld::nearest);
+    }
+  CHECK(n_large_temperature_errors < n_points / 50);
+  CHECK(n_wrong_compositions < n_points / 50);
+
+  // The faces of all the leaves lie on the planes between the cells at the
+  // maximum level. The temperature should be continuous across them, also
+  // where a coarse leaf touches finer leaves.
+  const std::array<double,3> cell_size = {{2000e3 / 64, 2000e3 / 64, 400e3 / 64}};
+  std::uniform_int_distribution<unsigned int> plane_distribution(1, 63);
+  for (unsigned int n = 0; n < n_points; ++n)
+    for (unsigned int i = 0; i < 3; ++i)
+      {
+        std::array<double,3> coordinates = {{surface_distribution(random_number_engine),
+                                             surface_distribution(random_number_engine),
+                                             depth_distribution(random_number_engine)
+                                            }
+                                           };
+        coordinates[i] = plane_distribution(random_number_engine) * cell_size[i];
+        std::array<double,3> below = {{coordinates[0], coordinates[1], 800e3 - coordinates[2]}};
+        std::array<double,3> above = below;
+        below[i] -= 1e-3;
+        above[i] += 1e-3;
+        const double depth_below = i == 2 ? coordinates[2] + 1e-3 : coordinates[2];
+        const double depth_above = i == 2 ? coordinates[2] - 1e-3 : coordinates[2];
+        INFO("point " << below[0] << ":" << below[1] << ":" << below[2] << " in direction " << i);
+        CHECK(adaptive_world.temperature(below, depth_below) == Approx(adaptive_world.temperature(above, depth_above)).epsilon(1e-6));
+      }
+
+  const std::array<double,3> outside = {{1000e3, 1000e3, 800e3 - 500e3}};
+  CHECK(!adaptive_world.contains(outside, 500e3));
+  CHECK_THROWS_WITH(adaptive_world.temperature(outside, 500e3), Contains("is outside of the adaptive baked world"));
+  CHECK_THROWS_WITH(AdaptiveBakedWorld(world, {{0,0}}, {{2000e3,2000e3}}, 0, 400e3, 800e3, 10, composition_numbers, 1, 0.5, 2, 21),
+                    Contains("can not be larger than 20"));
+}
+
+TEST_CASE("WorldBuilder Features: bounding box")
+{
+  // A feature may not change anything for points outside of its bounding box.
+  std::vector<std::string> file_names = {"subducting_plate_different_angles_cartesian.wb",
+                                         "subducting_plate_constant_angles_cartesian.wb",
+                                         "subducting_plate_different_angles_spherical.wb",
+                                         "fault_constant_angles_cartesian.wb",
+                                         "fault_different_angles_cartesian.wb",
+                                         "mantle_layer_cartesian.wb",
+                                         "oceanic_plate_spherical.wb",
+                                         "continental_plate.wb"
+                                        };
+  for (auto &file_name : file_names)
+    {
+      INFO("file: " << file_name);
+      WorldBuilder::World world(WorldBuilder::Data::WORLD_BUILDER_SOURCE_DIR + "/tests/data/" + file_name);
+      const bool spherical = world.parameters.coordinate_system->natural_coordinate_system() == CoordinateSystem::spherical;
+
+      unsigned int n_rejected = 0;
+      for (unsigned int i = 0; i < 20; ++i)
+        for (unsigned int j = 0; j < 20; ++j)
+          for (unsigned int k = 0; k < 10; ++k)
+            {
+              const double depth = k * 150e3;
+              const Point<3> position = spherical
+                                        ? Point<3>(Utilities::spherical_to_cartesian_coordinates({{6371e3 - depth, (i * 18.0 - 180.0) * Utilities::const_pi / 180.0, (j * 9.0 - 90.0) * Utilities::const_pi / 180.0}}).get_array(), cartesian)
+                                        : Point<3>(i * 100e3, j * 100e3, 800e3 - depth, cartesian);
+              const std::array<double,2> surface_point = Utilities::NaturalCoordinate(position, *world.parameters.coordinate_system).get_surface_coordinates();
+
+              for (auto &&feature : world.parameters.features)
+                {
+                  if (feature->bounding_box_contains(surface_point, depth))
+                    continue;
+
+                  ++n_rejected;
+                  CHECK(feature->temperature(position, depth, 10, -1.0) == Approx(-1.0).epsilon(0.));
+                  for (unsigned int c = 0; c < 8; ++c)
+                    CHECK(feature->composition(position, depth, c, -1.0) == Approx(-1.0).epsilon(0.));
+                }
+            }
+      CHECK(n_rejected > 0);
+    }
+}
+
+TEST_CASE("WorldBuilder bounding volume hierarchy")
+{
+  // The hierarchy should return exactly the boxes which contain the point, in increasing order.
+  for (unsigned int spherical = 0; spherical < 2; ++spherical)
+    {
+      std::mt19937 random_number_engine(42);
+      std::uniform_real_distribution<double> distribution(-4.0, 4.0);
+
+      std::vector<BoundingBox> boxes(100);
+      for (size_t i = 0; i < boxes.size(); ++i)
+        {
+          const double x = distribution(random_number_engine);
+          const double y = distribution(random_number_engine);
+          const double depth = std::fabs(distribution(random_number_engine));
+          boxes[i].min_surface = {{x, y}};
+          boxes[i].max_surface = {{x + 0.5 * std::fabs(distribution(random_number_engine)), y + 0.5 * std::fabs(distribution(random_number_engine))}};
+          boxes[i].min_depth = depth;
+          boxes[i].max_depth = depth + std::fabs(distribution(random_number_engine));
+        }
+      // Some boxes which are only bounded in depth.
+      boxes[10] = BoundingBox();
+      boxes[10].max_depth = 1;
+      boxes[50] = BoundingBox();
+      boxes[50].min_depth = 2;
+
+      BoundingVolumeHierarchy hierarchy;
+      hierarchy.build(boxes, spherical == 1);
+
+      std::vector<size_t> candidates;
+      for (unsigned int i = 0; i < 1000; ++i)
+        {
+          const std::array<double,2> surface_point = {{distribution(random_number_engine), distribution(random_number_engine)}};
+          const double depth = std::fabs(distribution(random_number_engine));
+
+          std::vector<size_t> expected;
+          for (size_t j = 0; j < boxes.size(); ++j)
+            if (boxes[j].contains(surface_point, depth, spherical == 1))
+              expected.push_back(j);
+
+          hierarchy.query(surface_point, depth, candidates);
+          CHECK(candidates == expected);
+        }
+    }
+
+  // An empty hierarchy returns no candidates.
+  BoundingVolumeHierarchy hierarchy;
+  hierarchy.build({}, false);
+  std::vector<size_t> candidates(1,0);
+  hierarchy.query({{0,0}}, 0, candidates);
+  CHECK(candidates.size() == 0);
 }
 
 TEST_CASE("WorldBuilder Coordinate Systems: Interface")
@@ -1101,28 +2160,28 @@ TEST_CASE("WorldBuilder Features: Continental Plate")
     WorldBuilder::grains grains = world1.grains(position, 0, 0, 2);
     compare_vectors_approx(grains.sizes, {0.5,0.5}); // was 0.2, but is normalized
     // these are random numbers, but they should stay the same.
-    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.9582241838,-0.07911030008,-0.2748599171}},{{-0.1099528091,-0.7852541367,0.6093326847}},{{-0.2640393784,0.6140989344,0.7437511045}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{-0.2124629855,0.07025627985,0.9746402079}},{{0.06298075396,-0.9943536315,0.08540655858}},{{0.9751373772,0.07952930755,0.2068385477}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{0.7433794227,-0.3876129772,0.5451084423}},{{0.06424681694,0.8525797307,0.518632962}},{{-0.6657772754,-0.3505195896,0.658693128}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{0.7873785667,0.5116841803,0.3438230538}},{{0.0964602998,-0.653120207,0.751085485}},{{0.6088763448,-0.5582233378,-0.5636100619}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
 
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
     grains = world1.grains(position, 0, 1, 2);
-    std::array<std::array<double, 3>, 3> array_3 = {{{{-0.8434546455,-0.3219802991,-0.4300150555}},{{-0.23850553,0.9417033479,-0.2372971063}},{{0.4813516106,-0.09758837799,-0.8710781454}}}};
-    std::array<std::array<double, 3>, 3> array_4 = {{{{-0.3695282689,-0.1240881435,0.9208968407}},{{-0.9061330384,-0.1714186601,-0.3867021588}},{{0.2058440555,-0.9773524316,-0.04909632573}}}};
+    std::array<std::array<double, 3>, 3> array_3 = {{{{0.9829850974,0.1000120304,0.1540710615}},{{-0.05795353954,-0.6270745544,0.7768004187}},{{0.1743034293,-0.7725121986,-0.6106088908}}}};
+    std::array<std::array<double, 3>, 3> array_4 = {{{{-0.4659283669,-0.6797695227,-0.5664134117}},{{0.882235945,-0.3079949891,-0.356088225}},{{0.0676054302,-0.6656218767,0.7432207095}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_2 = {array_3,array_4};
 
-    compare_vectors_approx(grains.sizes, {0.4434528938,0.2295772202});
+    compare_vectors_approx(grains.sizes, {0.7587629902,0.117201416});
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_2);
   }
 
   // check grains layer 2
   {
     WorldBuilder::grains grains = world1.grains(position, 150e3, 0, 2);
-    compare_vectors_approx(grains.sizes, {0.471427737,0.528572263});
+    compare_vectors_approx(grains.sizes, {0.7144507511,0.2855492489});
     CHECK(grains.sizes[0] + grains.sizes[1] == Approx(1.0));
     // these are random numbers, but they should stay the same.
-    std::array<std::array<double, 3>, 3> array_1 = {{{{0.6535959261,0.5566812833,-0.5127556087}},{{0.3237701162,0.4067148135,0.8542575562}},{{0.6840944944,-0.7243542016,0.08559038145}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{0.937444582,0.1583937415,-0.3100146421}},{{0.3453462197,-0.5355813035,0.7706417169}},{{-0.04397322126,-0.8294962869,-0.5567784711}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{0.8161324909,0.2336868007,-0.5285056635}},{{0.5644105887,-0.1261513714,0.815798087}},{{0.1239695307,-0.9640935176,-0.2348515378}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{0.5978124169,-0.8015006844,-0.01472980081}},{{0.7123687458,0.5395791036,-0.4487595803}},{{0.3676290035,0.2577809996,0.8935311254}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
 
@@ -1347,28 +2406,28 @@ TEST_CASE("WorldBuilder Features: Mantle layer")
     WorldBuilder::grains grains = world1.grains(position, 0+300e3, 0, 2);
     compare_vectors_approx(grains.sizes, {0.5,0.5}); // was 0.2, but is normalized
     // these are random numbers, but they should stay the same.
-    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.9582241838,-0.07911030008,-0.2748599171}},{{-0.1099528091,-0.7852541367,0.6093326847}},{{-0.2640393784,0.6140989344,0.7437511045}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{-0.2124629855,0.07025627985,0.9746402079}},{{0.06298075396,-0.9943536315,0.08540655858}},{{0.9751373772,0.07952930755,0.2068385477}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{0.7433794227,-0.3876129772,0.5451084423}},{{0.06424681694,0.8525797307,0.518632962}},{{-0.6657772754,-0.3505195896,0.658693128}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{0.7873785667,0.5116841803,0.3438230538}},{{0.0964602998,-0.653120207,0.751085485}},{{0.6088763448,-0.5582233378,-0.5636100619}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
 
     grains = world1.grains(position, 0+300e3, 1, 2);
-    std::array<std::array<double, 3>, 3> array_3 = {{{{-0.8434546455,-0.3219802991,-0.4300150555}},{{-0.23850553,0.9417033479,-0.2372971063}},{{0.4813516106,-0.09758837799,-0.8710781454}}}};
-    std::array<std::array<double, 3>, 3> array_4 = {{{{-0.3695282689,-0.1240881435,0.9208968407}},{{-0.9061330384,-0.1714186601,-0.3867021588}},{{0.2058440555,-0.9773524316,-0.04909632573}}}};
+    std::array<std::array<double, 3>, 3> array_3 = {{{{0.9829850974,0.1000120304,0.1540710615}},{{-0.05795353954,-0.6270745544,0.7768004187}},{{0.1743034293,-0.7725121986,-0.6106088908}}}};
+    std::array<std::array<double, 3>, 3> array_4 = {{{{-0.4659283669,-0.6797695227,-0.5664134117}},{{0.882235945,-0.3079949891,-0.356088225}},{{0.0676054302,-0.6656218767,0.7432207095}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_2 = {array_3,array_4};
 
-    compare_vectors_approx(grains.sizes, {0.4434528938,0.2295772202});
+    compare_vectors_approx(grains.sizes, {0.7587629902,0.117201416});
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_2);
   }
 
   // check grains layer 2
   {
     WorldBuilder::grains grains = world1.grains(position, 150e3+300e3, 0, 2);
-    compare_vectors_approx(grains.sizes, {0.471427737,0.528572263});
+    compare_vectors_approx(grains.sizes, {0.7144507511,0.2855492489});
     CHECK(grains.sizes[0] + grains.sizes[1] == Approx(1.0));
     // these are random numbers, but they should stay the same.
-    std::array<std::array<double, 3>, 3> array_1 = {{{{0.6535959261,0.5566812833,-0.5127556087}},{{0.3237701162,0.4067148135,0.8542575562}},{{0.6840944944,-0.7243542016,0.08559038145}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{0.937444582,0.1583937415,-0.3100146421}},{{0.3453462197,-0.5355813035,0.7706417169}},{{-0.04397322126,-0.8294962869,-0.5567784711}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{0.8161324909,0.2336868007,-0.5285056635}},{{0.5644105887,-0.1261513714,0.815798087}},{{0.1239695307,-0.9640935176,-0.2348515378}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{0.5978124169,-0.8015006844,-0.01472980081}},{{0.7123687458,0.5395791036,-0.4487595803}},{{0.3676290035,0.2577809996,0.8935311254}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
 
@@ -1778,28 +2837,28 @@ TEST_CASE("WorldBuilder Features: Oceanic Plate")
     WorldBuilder::grains grains = world2.grains(position, 0, 0, 2);
     compare_vectors_approx(grains.sizes, {0.5,0.5}); // was 0.2, but is normalized
     // these are random numbers, but they should stay the same.
-    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.9582241838,-0.07911030008,-0.2748599171}},{{-0.1099528091,-0.7852541367,0.6093326847}},{{-0.2640393784,0.6140989344,0.7437511045}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{-0.2124629855,0.07025627985,0.9746402079}},{{0.06298075396,-0.9943536315,0.08540655858}},{{0.9751373772,0.07952930755,0.2068385477}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.6224549564,-0.2437039597,0.7437460637}},{{-0.7580132853,0.424298465,-0.4953651904}},{{-0.1948478548,-0.8721119152,-0.4488375217}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{-0.9551071871,-0.2823423067,-0.08973897104}},{{0.2529411294,-0.6194383748,-0.7431802506}},{{0.1542434639,-0.7325154753,0.6630460257}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
 
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
     grains = world2.grains(position, 0, 1, 2);
-    std::array<std::array<double, 3>, 3> array_3 = {{{{-0.8434546455,-0.3219802991,-0.4300150555}},{{-0.23850553,0.9417033479,-0.2372971063}},{{0.4813516106,-0.09758837799,-0.8710781454}}}};
-    std::array<std::array<double, 3>, 3> array_4 = {{{{-0.3695282689,-0.1240881435,0.9208968407}},{{-0.9061330384,-0.1714186601,-0.3867021588}},{{0.2058440555,-0.9773524316,-0.04909632573}}}};
+    std::array<std::array<double, 3>, 3> array_3 = {{{{-0.638613513,0.746962627,-0.1849854452}},{{-0.5256013092,-0.5989742334,-0.6041300617}},{{-0.5620640932,-0.2885770289,0.7751175741}}}};
+    std::array<std::array<double, 3>, 3> array_4 = {{{{0.4758289464,-0.8326312867,-0.2833936383}},{{-0.1440603636,-0.391636117,0.9087726688}},{{-0.8676597406,-0.3915945509,-0.3063009668}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_2 = {array_3,array_4};
 
-    compare_vectors_approx(grains.sizes, {0.4434528938,0.2295772202});
+    compare_vectors_approx(grains.sizes, {0.4677010059,0.8183294148});
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_2);
   }
 
   // check grains layer 2
   {
     WorldBuilder::grains grains = world2.grains(position, 150e3, 0, 2);
-    compare_vectors_approx(grains.sizes, {0.471427737,0.528572263});
+    compare_vectors_approx(grains.sizes, {0.47821419,0.52178581});
     CHECK(grains.sizes[0] + grains.sizes[1] == Approx(1.0));
     // these are random numbers, but they should stay the same.
-    std::array<std::array<double, 3>, 3> array_1 = {{{{0.6535959261,0.5566812833,-0.5127556087}},{{0.3237701162,0.4067148135,0.8542575562}},{{0.6840944944,-0.7243542016,0.08559038145}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{0.937444582,0.1583937415,-0.3100146421}},{{0.3453462197,-0.5355813035,0.7706417169}},{{-0.04397322126,-0.8294962869,-0.5567784711}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.4703501317,-0.1359525941,0.8719447493}},{{0.6177667744,0.654858278,0.4353445166}},{{-0.6301864534,0.7434228459,-0.2240256818}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{0.3263632162,0.7831769176,0.5292645528}},{{-0.9143052774,0.4036388111,-0.03348984723}},{{-0.2398601902,-0.4729795195,0.8477956495}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
 
@@ -1923,18 +2982,18 @@ TEST_CASE("WorldBuilder Features: Subducting Plate")
     // note that the values are different from for example the continental plate since
     // this performs a interpolation between segments of the slab.
 
-    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.8841073844,-0.1312960784,-0.4484589977}},{{-0.4639013434,0.3618800113,0.8086027461}},{{0.05612197756,0.9229323904,-0.3808492174}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{-0.2568202195,-0.0592025578,0.9646441997}},{{-0.5750059457,-0.7928848317,-0.2017468859}},{{0.7767956856,-0.6064888299,0.1695870338}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{0.32667525,-0.7175154016,0.6151869061}},{{-0.3476920095,0.5140201301,0.7841514984}},{{-0.8788592308,-0.4700584584,-0.08155671734}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{0.382847329,-0.9036020563,0.1921750412}},{{0.8195545604,0.4282122008,0.3807422143}},{{-0.426331145,0.01173179159,0.9044910833}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
 
     grains = world1.grains(position, std::sqrt(2) * 33e3 - 1, 1, 2);
 
-    std::array<std::array<double, 3>, 3> array_3 = {{{{0.6521279994,0.6032912374,0.459095584}},{{-0.5017626042,0.7974338311,-0.3351620115}},{{-0.5682986551,-0.01178846375,0.8227379113}}}};
-    std::array<std::array<double, 3>, 3> array_4 = {{{{-0.7358966282,0.4557371955,-0.5007591849}},{{0.6726233448,0.4071992867,-0.6178726219}},{{-0.07767875296,-0.791512697,-0.6061960589}}}};
+    std::array<std::array<double, 3>, 3> array_3 = {{{{-0.7398545787,-0.03389873973,0.6719122546}},{{0.5460225289,-0.6137171672,0.5702724232}},{{0.393032569,0.7887978918,0.4725709318}}}};
+    std::array<std::array<double, 3>, 3> array_4 = {{{{-0.7816669943,-0.6093174936,-0.1331499231}},{{0.1627201297,0.006858833616,-0.9866484256}},{{0.6020953989,-0.7928966821,0.0937868977}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_2 = {array_3,array_4};
 
-    compare_vectors_approx(grains.sizes, {0.8843655798,0.5257196065});
+    compare_vectors_approx(grains.sizes, {0.1717008062,0.2837387449});
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_2);
   }
 
@@ -1942,11 +3001,11 @@ TEST_CASE("WorldBuilder Features: Subducting Plate")
   {
     WorldBuilder::grains grains = world1.grains(position, std::sqrt(2) * 66e3 - 1, 0, 2);
 
-    compare_vectors_approx(grains.sizes, {0.6692173347,0.3307826653});
+    compare_vectors_approx(grains.sizes, {0.4053776826,0.5946223174});
     CHECK(grains.sizes[0] + grains.sizes[1] == Approx(1.0));
     // these are random numbers, but they should stay the same.
-    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.5791315939,0.7367092885,-0.3490931411}},{{-0.1853986251,-0.5360105647,-0.8236018603}},{{-0.7938727522,-0.4122524697,0.4470055419}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{0.6418405971,0.7328740545,-0.2256906471}},{{-0.6739597786,0.3987178861,-0.6219342924}},{{-0.3658126088,0.5512890961,0.7498409616}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.6338373933,0.696925371,-0.3354775493}},{{0.6711871926,0.7111467417,0.2092320824}},{{0.3843929128,-0.09254911674,-0.9185187802}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{-0.2493467557,0.9639440455,-0.09294123163}},{{-0.9253421984,-0.2088529038,0.3164210493}},{{0.2856011402,0.1649010057,0.9440548962}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
 
@@ -2826,18 +3885,18 @@ TEST_CASE("WorldBuilder Features: Fault")
     // note that the values are different from for example the continental plate since
     // this performs a interpolation between segments of the slab.
 
-    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.8841073844,-0.1312960784,-0.4484589977}},{{-0.4639013434,0.3618800113,0.8086027461}},{{0.05612197756,0.9229323904,-0.3808492174}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{-0.2568202195,-0.0592025578,0.9646441997}},{{-0.5750059457,-0.7928848317,-0.2017468859}},{{0.7767956856,-0.6064888299,0.1695870338}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.7127499494,-0.698948264,-0.05881185211}},{{-0.1839030697,0.1053022264,0.977287625}},{{-0.67688047,0.7073773854,-0.2035928878}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{-0.8603444627,0.3641227198,-0.3566820019}},{{0.485877693,0.7973480525,-0.3579929476}},{{0.1540463338,-0.4813010784,-0.8629130889}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
 
     grains = world3.grains(position, 95e3, 1, 2);
 
-    std::array<std::array<double, 3>, 3> array_3 = {{{{0.6521279994,0.6032912374,0.459095584}},{{-0.5017626042,0.7974338311,-0.3351620115}},{{-0.5682986551,-0.01178846375,0.8227379113}}}};
-    std::array<std::array<double, 3>, 3> array_4 = {{{{-0.7358966282,0.4557371955,-0.5007591849}},{{0.6726233448,0.4071992867,-0.6178726219}},{{-0.07767875296,-0.791512697,-0.6061960589}}}};
+    std::array<std::array<double, 3>, 3> array_3 = {{{{-0.8280445481,0.3006005218,-0.4732668938}},{{0.489196403,-0.02503145066,-0.8718143758}},{{-0.2739144132,-0.9534216028,-0.1263255378}}}};
+    std::array<std::array<double, 3>, 3> array_4 = {{{{0.001545235019,0.9999861947,0.005022214124}},{{0.04763945139,0.004942904553,-0.9988523667}},{{-0.9988634015,0.001782717182,-0.04763115577}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_2 = {array_3,array_4};
 
-    compare_vectors_approx(grains.sizes, {0.8843655798,0.5257196065});
+    compare_vectors_approx(grains.sizes, {0.2364511303,0.5180872432});
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_2);
   }
 
@@ -2845,11 +3904,11 @@ TEST_CASE("WorldBuilder Features: Fault")
   {
     WorldBuilder::grains grains = world3.grains(position, 150e3, 0, 2);
 
-    compare_vectors_approx(grains.sizes, {0.6692173347,0.3307826653});
+    compare_vectors_approx(grains.sizes, {0.8194424691,0.1805575309});
     CHECK(grains.sizes[0] + grains.sizes[1] == Approx(1.0));
     // these are random numbers, but they should stay the same.
-    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.5791315939,0.7367092885,-0.3490931411}},{{-0.1853986251,-0.5360105647,-0.8236018603}},{{-0.7938727522,-0.4122524697,0.4470055419}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{0.6418405971,0.7328740545,-0.2256906471}},{{-0.6739597786,0.3987178861,-0.6219342924}},{{-0.3658126088,0.5512890961,0.7498409616}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{0.03402270119,-0.4059509533,0.9132613423}},{{0.07859371991,0.9120472491,0.4024833446}},{{-0.9963259923,0.05808303557,0.06293550655}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{0.7578674168,-0.4673456418,0.4552197598}},{{-0.5709862305,-0.1375866722,0.8093482762}},{{-0.3156132177,-0.873302902,-0.3711203822}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
 
@@ -2859,12 +3918,12 @@ TEST_CASE("WorldBuilder Features: Fault")
   {
     WorldBuilder::grains grains = world3.grains(position, 35e3, 0, 2);
 
-    compare_vectors_approx(grains.sizes, {0.3070168208,0.6929831792});
+    compare_vectors_approx(grains.sizes, {0.8194424691,0.1805575309});
     CHECK(grains.sizes[0] + grains.sizes[1] == Approx(1.0));
     // these are random numbers, but they should stay the same.
 
-    std::array<std::array<double, 3>, 3> array_1 = {{{{-0.6634752307,-0.3450403529,0.663888374}},{{-0.2770374165,-0.7109563284,-0.646367828}},{{0.6950186243,-0.6127709638,0.376112826}}}};
-    std::array<std::array<double, 3>, 3> array_2 = {{{{0.6976381754,-0.134849869,0.7036451443}},{{-0.1367834457,-0.9891309921,-0.05394598614}},{{0.7032718288,-0.05861222805,-0.7085007703}}}};
+    std::array<std::array<double, 3>, 3> array_1 = {{{{0.03402270119,-0.4059509533,0.9132613423}},{{0.07859371991,0.9120472491,0.4024833446}},{{-0.9963259923,0.05808303557,0.06293550655}}}};
+    std::array<std::array<double, 3>, 3> array_2 = {{{{0.7578674168,-0.4673456418,0.4552197598}},{{-0.5709862305,-0.1375866722,0.8093482762}},{{-0.3156132177,-0.873302902,-0.3711203822}}}};
     std::vector<std::array<std::array<double, 3>, 3> > vector_1 = {array_1,array_2};
     compare_vectors_array3_array3_approx(grains.rotation_matrices, vector_1);
 
@@ -4515,7 +5574,7 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
 
   double starting_radius = 10;
 
-  std::map<std::string,double> distance_from_planes =
+  WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance_from_planes =
     Utilities::distance_point_from_curved_planes(position,
                                                  reference_point,
                                                  coordinates,
@@ -4525,12 +5584,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_along_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
   // center square test 2
@@ -4546,12 +5605,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_from_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.fraction_of_segment) < 1e-14); // practically zero
 
   // center square test 3
   position[1] = 20;
@@ -4566,12 +5625,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_along_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // center square test 4
   reference_point[1] = 0;
@@ -4586,12 +5645,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_from_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.fraction_of_segment) < 1e-14); // practically zero
 
   // center square test 5
   position[1] = -10;
@@ -4607,12 +5666,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(sqrt(20*20+20*20))); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0707106781)); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(sqrt(20*20+20*20))); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0707106781)); // practically zero
 
   // begin section square test 6
   position[0] = 0;
@@ -4627,12 +5686,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(sqrt(20*20+20*20))); // practically zero
-  CHECK(std::fabs(distance_from_planes["sectionFraction"]) < 1e-14);
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0707106781)); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(sqrt(20*20+20*20))); // practically zero
+  CHECK(std::fabs(distance_from_planes.fraction_of_section) < 1e-14);
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0707106781)); // practically zero
 
 
   // end section square test 7
@@ -4648,12 +5707,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(sqrt(20*20+20*20))); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0707106781)); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(sqrt(20*20+20*20))); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0707106781)); // practically zero
 
   // before begin section square test 8
   position[0] = -10;
@@ -4668,12 +5727,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.fraction_of_segment) < 1e-14); // practically zero
 
   // beyond end section square test 9
   position[0] = 25;
@@ -4688,12 +5747,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.fraction_of_segment) < 1e-14); // practically zero
 
 
   // beyond end section square test 10
@@ -4711,12 +5770,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-3.5355339059));
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10.6066017178));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.75));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-3.5355339059));
+  CHECK(distance_from_planes.distance_along_plane == Approx(10.6066017178));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.75));
 
   // beyond end section square test 10 (only positive version)
   position[0] = 10;
@@ -4733,12 +5792,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  true);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(3.5355339059));
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10.6066017178));
-  CHECK(distance_from_planes["sectionFraction"] ==  Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.75));
+  CHECK(distance_from_planes.distance_from_plane == Approx(3.5355339059));
+  CHECK(distance_from_planes.distance_along_plane == Approx(10.6066017178));
+  CHECK(distance_from_planes.fraction_of_section ==  Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.75));
 
 
   // beyond end section square test 11
@@ -4756,12 +5815,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(3.5355339059));
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(17.6776695297));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0176776695));
+  CHECK(distance_from_planes.distance_from_plane == Approx(3.5355339059));
+  CHECK(distance_from_planes.distance_along_plane == Approx(17.6776695297));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0176776695));
 
 
   // beyond end section square test 11 (only positve version)
@@ -4779,12 +5838,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  true);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(3.5355339059));
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(17.6776695297));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0176776695));
+  CHECK(distance_from_planes.distance_from_plane == Approx(3.5355339059));
+  CHECK(distance_from_planes.distance_along_plane == Approx(17.6776695297));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0176776695));
 
   // add coordinate
   position[0] = 25;
@@ -4811,12 +5870,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(std::sqrt(10*10+10*10)));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_along_plane == Approx(std::sqrt(10*10+10*10)));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // different angle
   slab_segment_angles[0][0][0] = 22.5 * dtr;
@@ -4842,12 +5901,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10.8239219938));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.7653668647));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(distance_from_planes.distance_along_plane == Approx(10.8239219938));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.7653668647));
 
   // check interpolation 1 (in the middle of a segment with 22.5 degree and a segement with 45)
   position[0] = 25;
@@ -4864,12 +5923,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(12.0268977387)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.8504300948));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(12.0268977387)); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.8504300948));
 
   // check interpolation 2 (at the end of the segment at 45 degree)
   position[0] = 30;
@@ -4886,12 +5945,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(14.1421356237)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(14.1421356237)); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // check length interpolation with 90 degree angles for simplicity
   // check length interpolation first segment center 1
@@ -4929,12 +5988,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(100.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(100.0)); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // check length interpolation first segment center 2
   position[0] = 10;
@@ -4951,12 +6010,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(101.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.01));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(101.0)); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.01));
 
   // check length interpolation first segment center 3
   position[0] = 10;
@@ -4973,12 +6032,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(200.0));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(200.0));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
 
@@ -4997,12 +6056,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
 
   // Now check the center of the second segment, each segment should have a length of 75.
@@ -5021,12 +6080,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(75.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(75.0)); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // check length interpolation second segment center 2
   position[0] = 25;
@@ -5043,12 +6102,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(76.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.01333333333333));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(76.0)); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.01333333333333));
 
   // check length interpolation second segment center 3
   position[0] = 25;
@@ -5065,12 +6124,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(150.0));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(150.0));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
 
@@ -5089,12 +6148,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
   // Now check the end of the second segment, each segment should have a length of 50.
   // check length interpolation second segment center 1
@@ -5112,12 +6171,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(50.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(50.0)); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // check length interpolation second segment center 2
   position[0] = 30;
@@ -5134,12 +6193,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(51.0)); // practically zero
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.02));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(51.0)); // practically zero
+  CHECK(distance_from_planes.fraction_of_section == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.02));
 
   // check length interpolation second segment center 3
   position[0] = 30;
@@ -5156,12 +6215,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(100.0));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);
+  CHECK(distance_from_planes.distance_along_plane == Approx(100.0));
+  CHECK(distance_from_planes.fraction_of_section == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
 
@@ -5180,12 +6239,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 }
 
 TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes cartesian part 2")
@@ -5249,7 +6308,7 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
   position[1] = 0;
   position[2] = 0;
 
-  std::map<std::string,double> distance_from_planes =
+  WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance_from_planes =
     Utilities::distance_point_from_curved_planes(position,
                                                  reference_point,
                                                  coordinates,
@@ -5259,12 +6318,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 2
   position[0] = 10;
@@ -5281,12 +6340,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(5.0)); // checked that it should be about 5 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(5.0)); // checked that it should be about 5 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 3
   position[0] = 10;
@@ -5303,12 +6362,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-5.0)); // checked that it should be about -5 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-5.0)); // checked that it should be about -5 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
   // curve test 4
@@ -5326,12 +6385,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 5
   position[0] = 10;
@@ -5348,12 +6407,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-10.0)); // checked that it should be about -10 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-10.0)); // checked that it should be about -10 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 6
   position[0] = 10;
@@ -5370,16 +6429,16 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(10.0)); // checked that it should be about 10 this with a drawing
+  CHECK(distance_from_planes.distance_from_plane == Approx(10.0)); // checked that it should be about 10 this with a drawing
   // This is a special case where the point coincides with the center of the circle.
   // Because all the points on the circle are equally close, we have chosen in the
   // code to define this case as that this point belongs to the top of the top segment
   // where the check point has angle 0. This means that the distanceAlongPlate is zero.
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(0.0));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_along_plane == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
 
   // curve test 7
@@ -5397,12 +6456,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
   // curve test 8
   slab_segment_lengths[0][0] = 5 * 45 * dtr;
@@ -5424,12 +6483,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 5));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 5));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 9
   position[0] = 10;
@@ -5446,12 +6505,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45.0 * Utilities::const_pi/180 * 5));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45.0 * Utilities::const_pi/180 * 5));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
   // curve test 10
@@ -5483,12 +6542,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 11
   position[0] = 10;
@@ -5505,12 +6564,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.5));
 
   // curve test 12
   position[0] = 10;
@@ -5527,12 +6586,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(135.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(135.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.5));
 
 
   // curve test 13
@@ -5550,12 +6609,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 14
   slab_segment_angles[0][0][0] = 0.0 * dtr;
@@ -5586,12 +6645,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.5));
 
   // curve test 15
   position[0] = 10;
@@ -5608,12 +6667,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 16
   position[0] = 10;
@@ -5630,12 +6689,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-1.0)); // checked that it should be about -1 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-1.0)); // checked that it should be about -1 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 16
   position[0] = 10;
@@ -5652,12 +6711,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(1.0)); // checked that it should be about -1 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(1.0)); // checked that it should be about -1 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 17
   position[0] = 10;
@@ -5674,12 +6733,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(270.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(270.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
   // curve test 18
@@ -5697,12 +6756,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-1.0)); // checked that it should be about 1 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(270.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-1.0)); // checked that it should be about 1 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(270.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 19
   position[0] = 10;
@@ -5719,12 +6778,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(1.0)); // checked that it should be about 1 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(270.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(distance_from_planes.distance_from_plane == Approx(1.0)); // checked that it should be about 1 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(270.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
   // curve test 20
@@ -5756,12 +6815,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0/3.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0/3.0));
 
   // curve test 21
   position[0] = 10;
@@ -5778,12 +6837,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(2.0/3.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(2.0/3.0));
 
   // curve test 21
   position[0] = 10;
@@ -5800,12 +6859,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(270.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(270.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test 22
   position[0] = 10;
@@ -5822,12 +6881,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(315.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(315.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test start 45 degree 1
   slab_segment_angles[0][0][0] = 45.0 * dtr;
@@ -5861,12 +6920,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-7.3205080757)); // checked that it should be about -7.3 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(9.5531661812));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.2163468959));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-7.3205080757)); // checked that it should be about -7.3 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(9.5531661812));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.2163468959));
 
   // curve test change reference point 1
   reference_point[0] = 50;
@@ -5887,12 +6946,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false);
 
   // checked that distanceFromPlane should be infinity (it is on the other side of the circle this with a drawing
-  CHECK(distance_from_planes["distanceFromPlane"] == INFINITY);
-  CHECK(distance_from_planes["distanceAlongPlane"] == INFINITY);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(distance_from_planes.distance_from_plane == INFINITY);
+  CHECK(distance_from_planes.distance_along_plane == INFINITY);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
   // curve test change reference point 2
   position[0] = 10;
@@ -5909,12 +6968,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(2.3463313527)); // checked that it should be about 2.3 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(11.780972451));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(distance_from_planes.distance_from_plane == Approx(2.3463313527)); // checked that it should be about 2.3 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(11.780972451));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.5));
 
   // curve test angle interpolation 1
   reference_point[0] = 0;
@@ -5949,12 +7008,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(2.0/3.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(2.0/3.0));
 
   // curve test reverse angle 1
   reference_point[0] = 0;
@@ -5988,12 +7047,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test reverse angle 2
   position[0] = 10;
@@ -6010,12 +7069,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(180.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(180.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test reverse angle 3
   position[0] = 10;
@@ -6032,12 +7091,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(135.0 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(135.0 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.5));
 
   // curve test reverse angle 4
   position[0] = 10;
@@ -6056,12 +7115,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.1 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0011111111));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.1 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0011111111));
 
 
   // curve test reverse angle 5
@@ -6079,12 +7138,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90.001 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.000011111111));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90.001 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.000011111111));
 
   // curve test reverse angle 6
   slab_segment_angles[0][0][0] = 0.0 * dtr;
@@ -6115,12 +7174,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test reverse angle 6
   position[0] = 10;
@@ -6138,12 +7197,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
   // curve test reverse angle 6
   position[0] = 10;
@@ -6161,12 +7220,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(45 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(45 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
   // curve test reverse angle 7
@@ -6185,12 +7244,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(46 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0222222222));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(46 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0222222222));
 
 
 
@@ -6210,12 +7269,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(0.0697227738)); // checked that it should be small positive this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx((90 - 44.4093) * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0131266424));
+  CHECK(distance_from_planes.distance_from_plane == Approx(0.0697227738)); // checked that it should be small positive this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx((90 - 44.4093) * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0131266424));
 
   // curve test reverse angle 9
   position[0] = 10;
@@ -6233,12 +7292,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(-0.0692053058)); // checked that it should be small negative this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx((90 - 43.585) * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.031445048));
+  CHECK(distance_from_planes.distance_from_plane == Approx(-0.0692053058)); // checked that it should be small negative this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx((90 - 43.585) * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.031445048));
 
   // curve test reverse angle 10
   position[0] = 10;
@@ -6256,12 +7315,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  cartesian_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(90 * Utilities::const_pi/180 * 10));
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(1.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(1.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(90 * Utilities::const_pi/180 * 10));
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(1.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(1.0));
 
 
   // global_x_list test 1
@@ -6281,12 +7340,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,1,2});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
   // global_x_list test 2
   position[0] = 10;
@@ -6304,12 +7363,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.25));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.25));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
   // global_x_list test 3
   position[0] = 15;
@@ -6327,12 +7386,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.375));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.375));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
   // global_x_list test 4
   position[0] = 20;
@@ -6350,12 +7409,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
   // global_x_list test 5
   position[0] = 25;
@@ -6372,12 +7431,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-12);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.75));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-12);
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-12);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.75));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.fraction_of_segment) < 1e-12);
 
 
 
@@ -6397,12 +7456,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes ca
                                                  false,
   {0,0.5,1});
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // checked that it should be about 0 this with a drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(1.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // checked that it should be about 0 this with a drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.fraction_of_section == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(1.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.0));
 
 }
 
@@ -6442,7 +7501,7 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
 
   double starting_radius = 10;
 
-  std::map<std::string,double> distance_from_planes =
+  WorldBuilder::Utilities::PointDistanceFromCurvedPlanes distance_from_planes =
     Utilities::distance_point_from_curved_planes(position,
                                                  reference_point,
                                                  coordinates,
@@ -6452,12 +7511,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(std::fabs(distance_from_planes["sectionFraction"]) < 1e-14);
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14);
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(std::fabs(distance_from_planes.fraction_of_section) < 1e-14);
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.fraction_of_segment) < 1e-14);
 
 
   // spherical test 2
@@ -6474,12 +7533,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(1.0));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14);
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.fraction_of_section == Approx(1.0));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.fraction_of_segment) < 1e-14);
 
 
   // spherical test 2
@@ -6500,12 +7559,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14); // practically zero
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14);
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14);
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14); // practically zero
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14);
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.fraction_of_segment) < 1e-14);
 
 
 // spherical test 3
@@ -6522,12 +7581,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(10*sqrt(2)/4)); // checked it with a geometric drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10*sqrt(2)/4)); // checked it with a geometric drawing
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.25));
+  CHECK(distance_from_planes.distance_from_plane == Approx(10*sqrt(2)/4)); // checked it with a geometric drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(10*sqrt(2)/4)); // checked it with a geometric drawing
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.25));
 
 
 // spherical test 4
@@ -6544,12 +7603,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(10*sqrt(2)/2)); // checked it with a geometric drawing
-  CHECK(std::fabs(distance_from_planes["distanceAlongPlane"]) < 1e-14); // checked it with a geometric drawing
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(std::fabs(distance_from_planes["segmentFraction"]) < 1e-14);
+  CHECK(distance_from_planes.distance_from_plane == Approx(10*sqrt(2)/2)); // checked it with a geometric drawing
+  CHECK(std::fabs(distance_from_planes.distance_along_plane) < 1e-14); // checked it with a geometric drawing
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(std::fabs(distance_from_planes.fraction_of_segment) < 1e-14);
 
 
 // spherical test 5
@@ -6566,12 +7625,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(std::fabs(distance_from_planes["distanceFromPlane"]) < 1e-14);  // checked it with a geometric drawing
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(10*sqrt(2)/2)); // checked it with a geometric drawing
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.5));
+  CHECK(std::fabs(distance_from_planes.distance_from_plane) < 1e-14);  // checked it with a geometric drawing
+  CHECK(distance_from_planes.distance_along_plane == Approx(10*sqrt(2)/2)); // checked it with a geometric drawing
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.5));
 
 // spherical curve test 1
 // This test has not been checked analytically or with a drawing, but
@@ -6599,12 +7658,12 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
                                                  world.parameters.coordinate_system,
                                                  false);
 
-  CHECK(distance_from_planes["distanceFromPlane"] == Approx(4.072033215));  // see comment at the top of the test
-  CHECK(distance_from_planes["distanceAlongPlane"] == Approx(6.6085171895)); // see comment at the top of the test
-  CHECK(distance_from_planes["sectionFraction"] == Approx(0.5));
-  CHECK(distance_from_planes["section"] == Approx(0.0));
-  CHECK(distance_from_planes["segment"] == Approx(0.0));
-  CHECK(distance_from_planes["segmentFraction"] == Approx(0.4672927318));
+  CHECK(distance_from_planes.distance_from_plane == Approx(4.072033215));  // see comment at the top of the test
+  CHECK(distance_from_planes.distance_along_plane == Approx(6.6085171895)); // see comment at the top of the test
+  CHECK(distance_from_planes.fraction_of_section == Approx(0.5));
+  CHECK(distance_from_planes.section == Approx(0.0));
+  CHECK(distance_from_planes.segment == Approx(0.0));
+  CHECK(distance_from_planes.fraction_of_segment == Approx(0.4672927318));
 }
 
 TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes spherical depth methods")
@@ -6701,6 +7760,74 @@ TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes sp
 
 }
 
+TEST_CASE("WorldBuilder Utilities function: distance_point_from_curved_planes with precomputed geometry")
+{
+  std::unique_ptr<CoordinateSystems::Interface> cartesian_system = CoordinateSystems::Interface::create("cartesian", NULL);;
+
+  Point<2> reference_point(0,0,cartesian);
+
+  std::vector<Point<2> > coordinates;
+  coordinates.push_back(Point<2>(0,10,cartesian));
+  coordinates.push_back(Point<2>(10,10,cartesian));
+  coordinates.push_back(Point<2>(20,15,cartesian));
+
+  std::vector<std::vector<double> > slab_segment_lengths(3);
+  std::vector<std::vector<Point<2> > > slab_segment_angles(3);
+  double dtr = Utilities::const_pi/180;
+  for (unsigned int i = 0; i < 3; ++i)
+    {
+      slab_segment_lengths[i].push_back(10 + 5 * i);
+      slab_segment_lengths[i].push_back(200);
+      slab_segment_angles[i].push_back(Point<2>((30 + 5 * i) * dtr,(45 + 5 * i) * dtr,cartesian));
+      slab_segment_angles[i].push_back(Point<2>((45 + 5 * i) * dtr,(60 - 5 * i) * dtr,cartesian));
+    }
+
+  std::vector<double> one_dimensional_coordinates = {0,0.5,1,2};
+  coordinates.insert(coordinates.begin() + 1, Point<2>(5,10,cartesian));
+
+  const double starting_radius = 10;
+
+  const Utilities::CurvedPlanesGeometry geometry(reference_point,
+                                                 coordinates,
+                                                 slab_segment_lengths,
+                                                 slab_segment_angles,
+                                                 cartesian_system,
+                                                 one_dimensional_coordinates);
+
+  // The precomputed geometry should give exactly the same results.
+  for (unsigned int i = 0; i < 50; ++i)
+    {
+      const Point<3> position(i * 0.5, 5 + 0.3 * i, 10 - 0.2 * i, cartesian);
+      for (unsigned int only_positive = 0; only_positive < 2; ++only_positive)
+        {
+          const Utilities::PointDistanceFromCurvedPlanes reference =
+            Utilities::distance_point_from_curved_planes(position,
+                                                         reference_point,
+                                                         coordinates,
+                                                         slab_segment_lengths,
+                                                         slab_segment_angles,
+                                                         starting_radius,
+                                                         cartesian_system,
+                                                         only_positive == 1,
+                                                         one_dimensional_coordinates);
+          const Utilities::PointDistanceFromCurvedPlanes result =
+            Utilities::distance_point_from_curved_planes(position,
+                                                         Utilities::NaturalCoordinate(position, *cartesian_system),
+                                                         geometry,
+                                                         starting_radius,
+                                                         only_positive == 1);
+
+          CHECK(result.distance_from_plane == Approx(reference.distance_from_plane).epsilon(0.));
+          CHECK(result.distance_along_plane == Approx(reference.distance_along_plane).epsilon(0.));
+          CHECK(result.fraction_of_section == Approx(reference.fraction_of_section).epsilon(0.));
+          CHECK(result.fraction_of_segment == Approx(reference.fraction_of_segment).epsilon(0.));
+          CHECK(result.section == reference.section);
+          CHECK(result.segment == reference.segment);
+          CHECK(result.average_angle == Approx(reference.average_angle).epsilon(0.));
+        }
+    }
+}
+
 TEST_CASE("WorldBuilder parameters: invalid 1")
 {
 
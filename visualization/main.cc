@@ -25,10 +25,16 @@
 #include <cmath>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <exception>
+#include <functional>
 #include <iostream>
 #include <array>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <thread>
 
 #include <world_builder/assert.h>
@@ -44,10 +50,13 @@ using namespace WorldBuilder::Utilities;
 
 
 /**
- * A very simple threadpool class. The threadpool currently only supports a
- * parallel for function, to easily parallelize the for function.
- *
- * Todo: might need something more advanced and safe in the future.
+ * A thread pool which keeps its threads alive between the parallel for
+ * loops. The range of a loop is divided over the threads, which process
+ * their part in small chunks. A thread which has finished its part steals
+ * half of the remaining part of another thread, so that threads which get
+ * the expensive points do not hold up the other threads. The calling thread
+ * takes part in the work, so a pool of one thread does not start any
+ * threads.
  */
 class ThreadPool
 {
@@ -57,23 +66,83 @@ class ThreadPool
      * Constructor
      */
     explicit ThreadPool(size_t number_of_threads)
+      :
+      ranges(std::max(number_of_threads, static_cast<size_t>(1))),
+      chunk_size(1),
+      generation(0),
+      n_working(0),
+      stop(false),
+      failed(false)
     {
-      pool.resize(number_of_threads);
+      for (size_t thread = 1; thread < ranges.size(); ++thread)
+        pool.push_back(std::thread([this, thread]()
+      {
+        size_t last_generation = 0;
+        while (true)
+          {
+            {
+              std::unique_lock<std::mutex> lock(mutex);
+              condition.wait(lock, [&]() {return stop || generation != last_generation;});
+              if (stop)
+                return;
+              last_generation = generation;
+            }
+
+            work(thread);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--n_working == 0)
+              condition.notify_all();
+          }
+      }));
+    }
+
+    /**
+     * Destructor, which stops the threads.
+     */
+    ~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        condition.notify_all();
+      }
+      for (std::thread &t : pool)
+        t.join();
     }
 
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
     /**
-     * A function which allows to parallelize for loops.
+     * A function which allows to parallelize for loops. The function func
+     * is called for every index from start up to, but not including, end.
+     * When func throws an exception, the threads stop taking new work and
+     * the first exception is rethrown once all the threads are done.
      */
     template<typename Callable>
     void parallel_for(size_t start, size_t end, Callable func)
     {
-      // Deterimine the size of the slice for the loop
-      size_t n = end - start + 1;
-      size_t slice = static_cast<size_t>(std::round(n / static_cast<size_t>((pool.size()))));
-      slice = std::max(slice, static_cast<size_t>(1));
+      if (end <= start)
+        return;
+
+      // Divide the range evenly over the threads, where the first threads
+      // get one more index when it does not divide evenly.
+      const size_t n = end - start;
+      const size_t n_threads = ranges.size();
+      size_t begin = start;
+      for (size_t thread = 0; thread < n_threads; ++thread)
+        {
+          const size_t size = n / n_threads + (thread < n % n_threads ? 1 : 0);
+          ranges[thread].begin = begin;
+          ranges[thread].end = begin + size;
+          begin += size;
+        }
 
-      // Function which loops the passed function func
-      auto loop_function = [&func] (size_t k1, size_t k2)
+      // The chunks are small enough to balance the work, but large enough
+      // to not spend too much time on taking them.
+      chunk_size = std::max(n / (n_threads * 64), static_cast<size_t>(1));
+      loop = [&func] (size_t k1, size_t k2)
       {
         for (size_t k = k1; k < k2; k++)
           {
@@ -81,33 +150,129 @@ class ThreadPool
           }
       };
 
-      // Launch jobs
-      size_t i1 = start;
-      size_t i2 = std::min(start + slice, end);
-      for (size_t i = 0; i + 1 < pool.size() && i1 < end; ++i)
-        {
-          pool[i] = std::thread(loop_function, i1, i2);
-          i1 = i2;
-          i2 = std::min(i2 + slice, end);
-        }
-      if (i1 < end)
-        {
-          pool[pool.size()-1] = std::thread(loop_function, i1, end);
-        }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = false;
+        error = nullptr;
+        n_working = n_threads;
+        ++generation;
+        condition.notify_all();
+      }
 
-      // Wait for jobs to finish
-      for (std::thread &t : pool)
+      work(0);
+
+      std::exception_ptr loop_error;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        --n_working;
+        condition.wait(lock, [&]() {return n_working == 0;});
+        loop_error = error;
+      }
+      loop = nullptr;
+
+      if (loop_error)
+        std::rethrow_exception(loop_error);
+    }
+
+  private:
+    /**
+     * The part of the range of the loop which a thread still has to do.
+     */
+    struct Range
+    {
+      std::mutex mutex;
+      size_t begin;
+      size_t end;
+    };
+
+    /**
+     * Processes the range of the thread and then steals from the other
+     * threads until there is no work left.
+     */
+    void work(const size_t thread)
+    {
+      size_t k1 = 0;
+      size_t k2 = 0;
+      while (!failed && (take(thread, k1, k2) || steal(thread)))
         {
-          if (t.joinable())
+          if (k1 == k2)
+            continue;
+
+          try
             {
-              t.join();
+              loop(k1, k2);
             }
+          catch (...)
+            {
+              std::lock_guard<std::mutex> lock(mutex);
+              if (!failed)
+                error = std::current_exception();
+              failed = true;
+            }
+          k1 = k2;
         }
     }
 
-  private:
-    std::vector<std::thread> pool;
+    /**
+     * Takes the next chunk of the range of the thread. Returns false when
+     * the range is empty.
+     */
+    bool take(const size_t thread, size_t &k1, size_t &k2)
+    {
+      Range &range = ranges[thread];
+      std::lock_guard<std::mutex> lock(range.mutex);
+      if (range.begin == range.end)
+        return false;
+
+      k1 = range.begin;
+      k2 = std::min(range.begin + chunk_size, range.end);
+      range.begin = k2;
+      return true;
+    }
+
+    /**
+     * Moves the second half of the remaining range of another thread to the
+     * range of this thread. Returns false when all the other threads are out
+     * of work.
+     */
+    bool steal(const size_t thread)
+    {
+      for (size_t i = 1; i < ranges.size(); ++i)
+        {
+          Range &victim = ranges[(thread + i) % ranges.size()];
+          size_t begin = 0;
+          size_t end = 0;
+          {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin == victim.end)
+              continue;
 
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            end = victim.end;
+            victim.end = begin;
+          }
+
+          Range &range = ranges[thread];
+          std::lock_guard<std::mutex> lock(range.mutex);
+          range.begin = begin;
+          range.end = end;
+          return true;
+        }
+      return false;
+    }
+
+    std::vector<std::thread> pool;
+    std::vector<Range> ranges;
+    size_t chunk_size;
+    std::function<void(size_t, size_t)> loop;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t generation;
+    size_t n_working;
+    bool stop;
+    std::atomic<bool> failed;
+    std::exception_ptr error;
 };
 
 
@@ -172,6 +337,22 @@ void lay_points(double x1, double y1, double z1,
 }
 
 
+size_t group_columns(const std::vector<double> &x, const std::vector<double> &y, std::vector<size_t> &columns)
+{
+  // Points are in the same column when their surface coordinates are exactly
+  // the same, which is the case for all the grids, because the surface
+  // coordinates of the points are computed in the same way for every layer.
+  std::map<std::pair<double,double>, size_t> column_indices;
+  columns.resize(x.size());
+  for (size_t i = 0; i < x.size(); ++i)
+    {
+      const std::pair<double,double> key(x[i], y.size() == x.size() ? y[i] : 0.);
+      columns[i] = column_indices.insert(std::make_pair(key, column_indices.size())).first->second;
+    }
+  return column_indices.size();
+}
+
+
 std::vector<std::string> get_command_line_options_vector(int argc, char **argv)
 {
   std::vector<std::string> vector;
@@ -192,7 +373,7 @@ int main(int argc, char **argv)
    * First parse the command line options
    */
   std::cout << "[1/5] Parsing file...                         \r";
-  std::string wb_file;
+  std::vector<std::string> wb_files;
   std::string data_file;
 
   size_t dim = 3;
@@ -225,6 +406,8 @@ int main(int argc, char **argv)
           std::cout << "This program allows to use the world builder library directly with a world builder file and a grid file. "
                     "The data file will be filled with intitial conditions from the world as set by the world builder file." << std::endl
                     << "Besides providing two files, where the first is the world builder file and the second is the grid file, the available options are: " << std::endl
+                    << "More than one world builder file may be given before the grid file to evaluate all of them on the same grid. "
+                    "The grid is then only built once, and a paraview file is written for every world." << std::endl
                     << "-h or --help to get this help screen," << std::endl
                     << "-j the number of threads the visualizer is allowed to use." << std::endl;
           return 0;
@@ -258,16 +441,8 @@ int main(int argc, char **argv)
           return 0;
         }
 
-      if (options_vector.size() != 2)
-        {
-          std::cout << "Only two command line arguments may be given, which should be the world builder file location and the grid file location (in that order). "
-                    << "command line options where given." << std::endl;
-          return 0;
-        }
-
-
-      wb_file = options_vector[0];
-      data_file = options_vector[1];
+      wb_files.assign(options_vector.begin(), options_vector.end() - 1);
+      data_file = options_vector.back();
 
     }
   catch (std::exception &e)
@@ -287,20 +462,23 @@ int main(int argc, char **argv)
   std::cout << "[2/5] Starting the world builder with " << number_of_threads << " threads...                         \r";
   std::cout.flush();
 
-  std::unique_ptr<WorldBuilder::World> world;
-  try
+  std::vector<std::unique_ptr<WorldBuilder::World> > worlds;
+  for (const std::string &wb_file : wb_files)
     {
-      world = std::unique_ptr<WorldBuilder::World>(new WorldBuilder::World(wb_file));
-    }
-  catch (std::exception &e)
-    {
-      std::cerr << "Could not start the World builder from file '" << wb_file << "', error: " << e.what() << "\n";
-      return 1;
-    }
-  catch (...)
-    {
-      std::cerr << "Exception of unknown type!\n";
-      return 1;
+      try
+        {
+          worlds.push_back(std::unique_ptr<WorldBuilder::World>(new WorldBuilder::World(wb_file)));
+        }
+      catch (std::exception &e)
+        {
+          std::cerr << "Could not start the World builder from file '" << wb_file << "', error: " << e.what() << "\n";
+          return 1;
+        }
+      catch (...)
+        {
+          std::cerr << "Exception of unknown type!\n";
+          return 1;
+        }
     }
 
   /**
@@ -443,6 +621,11 @@ int main(int argc, char **argv)
   std::vector<double> grid_z(0);
   std::vector<double> grid_depth(0);
 
+  // The column of every point, so that all the points below the same surface
+  // point can be computed together.
+  std::vector<size_t> grid_column(0);
+  size_t n_columns = 0;
+
   std::vector<std::vector<size_t> > grid_connectivity(0);
 
 
@@ -584,6 +767,8 @@ int main(int argc, char **argv)
             }
         }
 
+      n_columns = group_columns(grid_x, grid_y, grid_column);
+
       // compute connectivity. Local to global mapping.
       grid_connectivity.resize(n_cell,std::vector<size_t>((dim-1)*4));
 
@@ -683,6 +868,8 @@ int main(int argc, char **argv)
             }
         }
 
+      n_columns = group_columns(grid_x, grid_y, grid_column);
+
       counter = 0;
       for (size_t j = 1; j <= n_cell_z+1; ++j)
         {
@@ -849,6 +1036,9 @@ int main(int argc, char **argv)
             }
         }
 
+      // The longitudes and latitudes are still stored in grid_x and grid_y.
+      n_columns = group_columns(grid_x, grid_y, grid_column);
+
       std::cout << "[4/5] Building the grid: stage 2 of 3                        \r";
       std::cout.flush();
       if (dim == 2)
@@ -1247,6 +1437,8 @@ int main(int argc, char **argv)
       grid_y.resize(n_p);
       grid_z.resize(n_p);
       grid_depth.resize(n_p);
+      grid_column.resize(n_p);
+      n_columns = shell_n_p;
       grid_connectivity.resize(n_cell,std::vector<size_t>(n_v));
 
 
@@ -1281,6 +1473,7 @@ int main(int argc, char **argv)
               grid_y[j] = temp_shell_grid_y[counter];
               grid_z[j] = temp_shell_grid_z[counter];
               grid_depth[j] = outer_radius - std::sqrt(grid_x[j] * grid_x[j] + grid_y[j] * grid_y[j] + grid_z[j] * grid_z[j]);
+              grid_column[j] = counter;
 
               counter++;
             }
@@ -1314,7 +1507,7 @@ int main(int argc, char **argv)
         }
     }
 
-  // create paraview file.
+  // create paraview files.
   std::cout << "[5/5] Writing the paraview file...                                               \r";
   std::cout.flush();
 
@@ -1322,148 +1515,219 @@ int main(int argc, char **argv)
   std::cout << "[5/5] Writing the paraview file: stage 1 of 3, writing header part 1                              \r";
   std::cout.flush();
 
-  std::string base_filename = wb_file.substr(wb_file.find_last_of("/\\") + 1);
-  std::string::size_type const p(base_filename.find_last_of('.'));
-  std::string file_without_extension = base_filename.substr(0, p);
-
-  std::ofstream myfile;
-  myfile.open (file_without_extension + ".vtu");
-  myfile << "<?xml version=\"1.0\" ?> " << std::endl;
-  myfile << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">" << std::endl;
-  myfile << "<UnstructuredGrid>" << std::endl;
-  myfile << "<FieldData>" << std::endl;
-  myfile << "<DataArray type=\"Float32\" Name=\"TIME\" NumberOfTuples=\"1\" format=\"ascii\">0</DataArray>" << std::endl;
-  myfile << "</FieldData>" << std::endl;
-  myfile << "<Piece NumberOfPoints=\""<< n_p << "\" NumberOfCells=\"" << n_cell << "\">" << std::endl;
-  myfile << "  <Points>" << std::endl;
-  myfile << "    <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">" << std::endl;
+  std::vector<std::string> vtu_files;
+  for (const std::string &wb_file : wb_files)
+    {
+      std::string base_filename = wb_file.substr(wb_file.find_last_of("/\\") + 1);
+      std::string::size_type const p(base_filename.find_last_of('.'));
+      std::string file_without_extension = base_filename.substr(0, p);
+      WBAssertThrow(std::find(vtu_files.begin(), vtu_files.end(), file_without_extension + ".vtu") == vtu_files.end(),
+                    "The paraview file of the world builder file " << wb_file << " would overwrite the paraview file of another world "
+                    "builder file: " << file_without_extension << ".vtu");
+      vtu_files.push_back(file_without_extension + ".vtu");
+    }
+
+  // The grid is the same for all the worlds, so it is only written once.
+  std::ostringstream grid_stream;
+  grid_stream << "<?xml version=\"1.0\" ?> " << std::endl;
+  grid_stream << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">" << std::endl;
+  grid_stream << "<UnstructuredGrid>" << std::endl;
+  grid_stream << "<FieldData>" << std::endl;
+  grid_stream << "<DataArray type=\"Float32\" Name=\"TIME\" NumberOfTuples=\"1\" format=\"ascii\">0</DataArray>" << std::endl;
+  grid_stream << "</FieldData>" << std::endl;
+  grid_stream << "<Piece NumberOfPoints=\""<< n_p << "\" NumberOfCells=\"" << n_cell << "\">" << std::endl;
+  grid_stream << "  <Points>" << std::endl;
+  grid_stream << "    <DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">" << std::endl;
   if (dim == 2)
     for (size_t i = 0; i < n_p; ++i)
-      myfile << grid_x[i] << " " << grid_z[i] << " " << "0.0" << std::endl;
+      grid_stream << grid_x[i] << " " << grid_z[i] << " " << "0.0" << std::endl;
   else
     for (size_t i = 0; i < n_p; ++i)
       {
-        myfile << grid_x[i] << " " << grid_y[i] << " " << grid_z[i] << std::endl;
+        grid_stream << grid_x[i] << " " << grid_y[i] << " " << grid_z[i] << std::endl;
       }
   std::cout << "[5/5] Writing the paraview file: stage 1 of 3, writing header part 2                              \r";
   std::cout.flush();
-  myfile << "    </DataArray>" << std::endl;
-  myfile << "  </Points>" << std::endl;
-  myfile << std::endl;
-  myfile << "  <Cells>" << std::endl;
-  myfile << "    <DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">" << std::endl;
+  grid_stream << "    </DataArray>" << std::endl;
+  grid_stream << "  </Points>" << std::endl;
+  grid_stream << std::endl;
+  grid_stream << "  <Cells>" << std::endl;
+  grid_stream << "    <DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">" << std::endl;
   if (dim == 2)
     for (size_t i = 0; i < n_cell; ++i)
-      myfile << grid_connectivity[i][0] << " " <<grid_connectivity[i][1] << " " << grid_connectivity[i][2] << " " << grid_connectivity[i][3] << std::endl;
+      grid_stream << grid_connectivity[i][0] << " " <<grid_connectivity[i][1] << " " << grid_connectivity[i][2] << " " << grid_connectivity[i][3] << std::endl;
   else
     for (size_t i = 0; i < n_cell; ++i)
-      myfile << grid_connectivity[i][0] << " " <<grid_connectivity[i][1] << " " << grid_connectivity[i][2] << " " << grid_connectivity[i][3]  << " "
+      grid_stream << grid_connectivity[i][0] << " " <<grid_connectivity[i][1] << " " << grid_connectivity[i][2] << " " << grid_connectivity[i][3]  << " "
              << grid_connectivity[i][4] << " " <<grid_connectivity[i][5] << " " << grid_connectivity[i][6] << " " << grid_connectivity[i][7]<< std::endl;
-  myfile << "    </DataArray>" << std::endl;
-  myfile << "    <DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">" << std::endl;
+  grid_stream << "    </DataArray>" << std::endl;
+  grid_stream << "    <DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">" << std::endl;
   if (dim == 2)
     for (size_t i = 1; i <= n_cell; ++i)
-      myfile << i * 4 << " ";
+      grid_stream << i * 4 << " ";
   else
     for (size_t i = 1; i <= n_cell; ++i)
-      myfile << i * 8 << " ";
-  myfile << std::endl << "    </DataArray>" << std::endl;
-  myfile << "    <DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">" << std::endl;
+      grid_stream << i * 8 << " ";
+  grid_stream << std::endl << "    </DataArray>" << std::endl;
+  grid_stream << "    <DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">" << std::endl;
   if (dim == 2)
     for (size_t i = 0; i < n_cell; ++i)
-      myfile << "9" << " ";
+      grid_stream << "9" << " ";
   else
     for (size_t i = 0; i < n_cell; ++i)
-      myfile << "12" << " ";
-  myfile <<  std::endl <<"    </DataArray>" << std::endl;
-  myfile << "  </Cells>" << std::endl;
+      grid_stream << "12" << " ";
+  grid_stream <<  std::endl <<"    </DataArray>" << std::endl;
+  grid_stream << "  </Cells>" << std::endl;
 
-  myfile << "  <PointData Scalars=\"scalars\">" << std::endl;
+  grid_stream << "  <PointData Scalars=\"scalars\">" << std::endl;
 
-  myfile << "<DataArray type=\"Float32\" Name=\"Depth\" format=\"ascii\">" << std::endl;
+  grid_stream << "<DataArray type=\"Float32\" Name=\"Depth\" format=\"ascii\">" << std::endl;
 
   for (size_t i = 0; i < n_p; ++i)
     {
-      myfile <<  grid_depth[i] << std::endl;
+      grid_stream <<  grid_depth[i] << std::endl;
     }
-  myfile << "</DataArray>" << std::endl;
+  grid_stream << "</DataArray>" << std::endl;
+  const std::string grid_output = grid_stream.str();
 
 
-  std::cout << "[5/5] Writing the paraview file: stage 2 of 3, computing temperatures                    \r";
+  std::cout << "[5/5] Writing the paraview file: stage 2 of 3, computing temperatures and compositions    \r";
   std::cout.flush();
 
-  myfile << "    <DataArray type=\"Float32\" Name=\"Temperature\" format=\"ascii\">" << std::endl;
-  std::vector<double> temp_vector(n_p);
-  if (dim == 2)
-    {
-      pool.parallel_for(0, n_p, [&] (size_t i)
-      {
-        std::array<double,2> coords = {{grid_x[i], grid_z[i]}};
-        temp_vector[i] = world->temperature(coords, grid_depth[i], gravity);
-      });
-    }
-  else
-    {
-      pool.parallel_for(0, n_p, [&] (size_t i)
-      {
-        std::array<double,3> coords = {{grid_x[i], grid_y[i], grid_z[i]}};
-        temp_vector[i] = world->temperature(coords, grid_depth[i], gravity);
-      });
-    }
-
-  std::cout << "[5/5] Writing the paraview file: stage 2 of 3, writing temperatures                    \r";
-  std::cout.flush();
+  // Compute the temperature and all the compositions of a point in one go.
+  std::vector<unsigned int> composition_numbers(compositions);
+  for (size_t c = 0; c < compositions; ++c)
+    composition_numbers[c] = static_cast<unsigned int>(c);
 
+  // Sort the points by column, so that all the points below the same surface
+  // point can be computed with one call to World::column.
+  std::vector<size_t> column_offsets(n_columns + 1, 0);
   for (size_t i = 0; i < n_p; ++i)
-    myfile << temp_vector[i]  << std::endl;
-  myfile << "    </DataArray>" << std::endl;
+    column_offsets[grid_column[i] + 1]++;
+  for (size_t c = 0; c < n_columns; ++c)
+    column_offsets[c + 1] += column_offsets[c];
 
+  std::vector<size_t> column_points(n_p);
+  {
+    std::vector<size_t> next_point(column_offsets.begin(), column_offsets.end() - 1);
+    for (size_t i = 0; i < n_p; ++i)
+      column_points[next_point[grid_column[i]]++] = i;
+  }
+
+  // The columns of the grid are only vertical in the world when the grid and
+  // the world use the same kind of coordinate system. Otherwise the points
+  // of a column are computed one by one.
+  const bool cartesian_grid = grid_type == "cartesian";
+  const size_t n_worlds = worlds.size();
+  std::vector<bool> use_columns(n_worlds);
+  for (size_t w = 0; w < n_worlds; ++w)
+    use_columns[w] = cartesian_grid == (worlds[w]->parameters.coordinate_system->natural_coordinate_system() == cartesian);
+
+  // The columns of all the worlds are computed in one parallel loop, so the
+  // threads share the work of all the worlds.
+  std::vector<std::vector<double> > temp_vectors(n_worlds, std::vector<double>(n_p));
+  std::vector<std::vector<std::vector<double> > > composition_vectors(n_worlds, std::vector<std::vector<double> >(compositions, std::vector<double>(n_p)));
+  pool.parallel_for(0, n_worlds * n_columns, [&] (size_t k)
+  {
+    const size_t w = k / n_columns;
+    const size_t c = k % n_columns;
+    const size_t begin = column_offsets[c];
+    const size_t end = column_offsets[c + 1];
+
+    if (use_columns[w])
+      {
+        // Move the shallowest point of the column up to the surface.
+        size_t top = column_points[begin];
+        for (size_t j = begin + 1; j < end; ++j)
+          if (grid_depth[column_points[j]] < grid_depth[top])
+            top = column_points[j];
+
+        std::array<double,3> surface_point = {{grid_x[top], dim == 3 ? grid_y[top] : 0., grid_z[top]}};
+        if (cartesian_grid)
+          surface_point[2] += grid_depth[top];
+        else
+          {
+            const double radius = std::sqrt(surface_point[0] * surface_point[0] +
+                                            surface_point[1] * surface_point[1] +
+                                            surface_point[2] * surface_point[2]);
+            for (size_t d = 0; d < 3; ++d)
+              surface_point[d] *= (radius + grid_depth[top]) / radius;
+          }
 
-  std::cout << "[5/5] Writing the paraview file: stage 3 of 3, writing compositions                     \r";
-  std::cout.flush();
+        std::vector<double> depths(end - begin);
+        for (size_t j = begin; j < end; ++j)
+          depths[j - begin] = grid_depth[column_points[j]];
 
-  for (size_t c = 0; c < compositions; ++c)
+        std::vector<WorldBuilder::properties> properties;
+        if (dim == 2)
+          worlds[w]->column(std::array<double,2> {{surface_point[0], surface_point[2]}}, depths, gravity, composition_numbers, {}, 0, properties);
+        else
+          worlds[w]->column(surface_point, depths, gravity, composition_numbers, {}, 0, properties);
+
+        for (size_t j = begin; j < end; ++j)
+          {
+            const size_t i = column_points[j];
+            temp_vectors[w][i] = properties[j - begin].temperature;
+            for (size_t n = 0; n < compositions; ++n)
+              composition_vectors[w][n][i] = properties[j - begin].compositions[n];
+          }
+      }
+    else
+      {
+        WorldBuilder::properties properties;
+        for (size_t j = begin; j < end; ++j)
+          {
+            const size_t i = column_points[j];
+            if (dim == 2)
+              worlds[w]->properties(std::array<double,2> {{grid_x[i], grid_z[i]}}, grid_depth[i], gravity, composition_numbers, {}, 0, properties);
+            else
+              worlds[w]->properties(std::array<double,3> {{grid_x[i], grid_y[i], grid_z[i]}}, grid_depth[i], gravity, composition_numbers, {}, 0, properties);
+            temp_vectors[w][i] = properties.temperature;
+            for (size_t n = 0; n < compositions; ++n)
+              composition_vectors[w][n][i] = properties.compositions[n];
+          }
+      }
+  });
+
+  for (size_t w = 0; w < n_worlds; ++w)
     {
-      std::cout << "[5/5] Writing the paraview file: stage 2 of 3, computing composition "
-                << c << " of " << compositions-1 << "            \r";
+      std::cout << "[5/5] Writing the paraview file: stage 2 of 3, writing temperatures                    \r";
       std::cout.flush();
 
-      myfile << "<DataArray type=\"Float32\" Name=\"Composition " << c << "\" Format=\"ascii\">" << std::endl;
+      std::ofstream myfile;
+      myfile.open (vtu_files[w]);
+      myfile << grid_output;
 
-      if (dim == 2)
-        {
-          pool.parallel_for(0, n_p, [&] (size_t i)
-          {
-            std::array<double,2> coords = {{grid_x[i], grid_z[i]}};
-            temp_vector[i] =  world->composition(coords, grid_depth[i], static_cast<unsigned int>(c));
-          });
-        }
-      else
-        {
-          pool.parallel_for(0, n_p, [&] (size_t i)
-          {
-            std::array<double,3> coords = {{grid_x[i], grid_y[i], grid_z[i]}};
-            temp_vector[i] =  world->composition(coords, grid_depth[i], static_cast<unsigned int>(c));
-          });
-        }
+      myfile << "    <DataArray type=\"Float32\" Name=\"Temperature\" format=\"ascii\">" << std::endl;
+      for (size_t i = 0; i < n_p; ++i)
+        myfile << temp_vectors[w][i]  << std::endl;
+      myfile << "    </DataArray>" << std::endl;
 
 
-      std::cout << "[5/5] Writing the paraview file: stage 2 of 3, writing composition "
-                << c << " of " << compositions-1 << "            \r";
+      std::cout << "[5/5] Writing the paraview file: stage 3 of 3, writing compositions                     \r";
       std::cout.flush();
 
-      for (size_t i = 0; i < n_p; ++i)
-        myfile << temp_vector[i]  << std::endl;
+      for (size_t c = 0; c < compositions; ++c)
+        {
+          std::cout << "[5/5] Writing the paraview file: stage 3 of 3, writing composition "
+                    << c << " of " << compositions-1 << "            \r";
+          std::cout.flush();
 
-      myfile << "</DataArray>" << std::endl;
-    }
+          myfile << "<DataArray type=\"Float32\" Name=\"Composition " << c << "\" Format=\"ascii\">" << std::endl;
+
+          for (size_t i = 0; i < n_p; ++i)
+            myfile << composition_vectors[w][c][i]  << std::endl;
+
+          myfile << "</DataArray>" << std::endl;
+        }
 
-  myfile << "  </PointData>" << std::endl;
+      myfile << "  </PointData>" << std::endl;
 
 
-  myfile << " </Piece>" << std::endl;
-  myfile << " </UnstructuredGrid>" << std::endl;
-  myfile << "</VTKFile>" << std::endl;
+      myfile << " </Piece>" << std::endl;
+      myfile << " </UnstructuredGrid>" << std::endl;
+      myfile << "</VTKFile>" << std::endl;
+    }
 
   std::cout << "                                                                                \r";
   std::cout.flush();